@@ -0,0 +1,150 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file   bench_acc.c
+ * \author rhae
+ *
+ * Reads and writes a clipped float vector channel by channel with
+ * vc_as_float() and with the accessors of varacc.h
+ * (#pragma accessors on).
+ */
+
+#include "bench.h"
+
+#include "../lib/varcore.h"
+#include "vardefs.h"
+#include "varacc.h"
+
+#include <stdio.h>
+
+#include "vardef.inc"
+
+enum {
+	Channels = 64000000
+};
+
+volatile uint32_t g_bench_sink;
+
+static F32 s_val[VEC_MEAS];
+
+static uint64_t write_as( void ) {
+	uint64_t t = bench_now();
+
+	for( U32 n = 0; n < Channels; n += VEC_MEAS ) {
+		for( U16 i = 0; i < VEC_MEAS; i++ ) {
+			F32 f = s_val[i];
+			(void) vc_as_float( VAR_CLIP, VarWrite, &f, i, REQ_PRG );
+		}
+	}
+	return bench_now() - t;
+}
+
+static uint64_t write_acc( void ) {
+	uint64_t t = bench_now();
+
+	for( U32 n = 0; n < Channels; n += VEC_MEAS ) {
+		for( U16 i = 0; i < VEC_MEAS; i++ ) {
+			(void) vc_set_CLIP( i, s_val[i] );
+		}
+	}
+	return bench_now() - t;
+}
+
+static uint64_t read_as( void ) {
+	uint64_t t = bench_now();
+	F32 sum = 0.0f;
+
+	for( U32 n = 0; n < Channels; n += VEC_MEAS ) {
+		for( U16 i = 0; i < VEC_MEAS; i++ ) {
+			F32 f;
+			(void) vc_as_float( VAR_CLIP, VarRead, &f, i, REQ_PRG );
+			sum += f;
+		}
+	}
+	g_bench_sink = (uint32_t) sum;
+	return bench_now() - t;
+}
+
+static uint64_t read_acc( void ) {
+	uint64_t t = bench_now();
+	F32 sum = 0.0f;
+
+	for( U32 n = 0; n < Channels; n += VEC_MEAS ) {
+		for( U16 i = 0; i < VEC_MEAS; i++ ) {
+			sum += vc_get_CLIP( i );
+		}
+	}
+	g_bench_sink = (uint32_t) sum;
+	return bench_now() - t;
+}
+
+/* best of three runs */
+static uint64_t best( uint64_t (*fn)( void )) {
+	uint64_t t = fn();
+
+	for( int i = 0; i < 2; i++ ) {
+		uint64_t t2 = fn();
+		t = ( t2 < t ) ? t2 : t;
+	}
+	return t;
+}
+
+int main( void ) {
+	uint32_t rnd = 1;
+
+	vc_init( &g_var_data );
+
+	/* every 4th value is clipped */
+	for( int i = 0; i < VEC_MEAS; i++ ) {
+		U32 r = bench_rand( &rnd );
+		s_val[i] = (F32)( r % 1600u ) - 800.0f;
+		if(( i % 4 ) == 3 ) {
+			s_val[i] *= 4.0f;
+		}
+	}
+
+	{
+		uint64_t w_as  = best( write_as );
+		uint64_t w_acc = best( write_acc );
+		uint64_t r_as  = best( read_as );
+		uint64_t r_acc = best( read_acc );
+
+		printf( "write: vc_as_float %6.2f ns  vc_set_CLIP %6.2f ns  speedup %5.2f\n",
+		        (double) w_as / Channels, (double) w_acc / Channels, (double) w_as / (double) w_acc );
+		printf( "read:  vc_as_float %6.2f ns  vc_get_CLIP %6.2f ns  speedup %5.2f\n",
+		        (double) r_as / Channels, (double) r_acc / Channels, (double) r_as / (double) r_acc );
+	}
+	return 0;
+}
+
+/*______________________________________________________________________EOF_*/
@@ -0,0 +1,485 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file   bench_api.c
+ * \author rhae
+ *
+ * Latency of the public API on the table of res.csv: vc_as_*() reads
+ * and writes of every type, vc_as_string(), vc_get_hnd(), whole
+ * vectors and vc_reset().
+ *
+ * A benchmark runs batches of calls, the batch size is doubled until
+ * a batch takes BatchNs. The percentiles are those of the ns/op of
+ * the batches. The output has a line per benchmark, separated by tabs:
+ *
+ *   # name            ns_op   ops_s      p50_ns  p90_ns  p99_ns
+ *   vc_as_int16.rd    3.41    293255131  3.40    3.52    3.98
+ *
+ * Usage: bench_api [-f filter] [-c baseline] [-t percent]
+ *
+ *   -f  only the benchmarks whose name contains filter
+ *   -c  compare the p50 with the output of an earlier run, a
+ *       benchmark that is more than percent (default 10) slower is
+ *       flagged REGRESSION and the exit code is 1
+ */
+
+#include "bench.h"
+
+#include "../lib/varcore.h"
+#include "vardefs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vardef.inc"
+
+#ifndef countof
+# define countof(x) ( sizeof(x) / sizeof(x[0]) )
+#endif
+
+enum {
+	Samples   = 200,
+	BatchNs   = 50000,
+	MaxBatch  = 1 << 24,
+	MaxBase   = 64,
+	NameSize  = 32
+};
+
+typedef struct _BENCH {
+	char const *name;
+	void      (*fn)( U32 n );
+} BENCH;
+
+typedef struct _RESULT {
+	double ns_op;
+	double p50;
+	double p90;
+	double p99;
+} RESULT;
+
+typedef struct _BASE {
+	char   name[NameSize];
+	double p50;
+} BASE;
+
+volatile uint32_t g_bench_sink;
+
+static char const *s_scpi[VAR_ADDR + 1];
+static F32 s_vec[VEC_HIST];
+static BASE s_base[MaxBase];
+static int s_base_cnt;
+
+/*** benchmarks, each runs n calls ******************************************/
+
+static void rd_int16( U32 n ) {
+	S16 v = 0;
+	S32 sum = 0;
+
+	for( U32 i = 0; i < n; i++ ) {
+		(void) vc_as_int16( VAR_STAT, VarRead, &v, (U16)( i % VEC_MEAS ), REQ_PRG );
+		sum += v;
+	}
+	g_bench_sink = (uint32_t) sum;
+}
+
+static void wr_int16( U32 n ) {
+	for( U32 i = 0; i < n; i++ ) {
+		S16 v = (S16) i;
+		(void) vc_as_int16( VAR_STAT, VarWrite, &v, (U16)( i % VEC_MEAS ), REQ_PRG );
+	}
+}
+
+static void rd_int32( U32 n ) {
+	S32 v = 0;
+	S32 sum = 0;
+
+	for( U32 i = 0; i < n; i++ ) {
+		(void) vc_as_int32( VAR_CNT, VarRead, &v, (U16)( i % VEC_MEAS ), REQ_PRG );
+		sum += v;
+	}
+	g_bench_sink = (uint32_t) sum;
+}
+
+static void wr_int32( U32 n ) {
+	for( U32 i = 0; i < n; i++ ) {
+		S32 v = (S32) i;
+		(void) vc_as_int32( VAR_CNT, VarWrite, &v, (U16)( i % VEC_MEAS ), REQ_PRG );
+	}
+}
+
+static void rd_float( U32 n ) {
+	F32 v = 0.0f;
+	F32 sum = 0.0f;
+
+	for( U32 i = 0; i < n; i++ ) {
+		(void) vc_as_float( VAR_MEAS, VarRead, &v, (U16)( i % VEC_MEAS ), REQ_PRG );
+		sum += v;
+	}
+	g_bench_sink = (uint32_t) sum;
+}
+
+static void wr_float( U32 n ) {
+	for( U32 i = 0; i < n; i++ ) {
+		F32 v = s_vec[i % VEC_MEAS];
+		(void) vc_as_float( VAR_MEAS, VarWrite, &v, (U16)( i % VEC_MEAS ), REQ_PRG );
+	}
+}
+
+/* every 4th value of s_vec is clipped */
+static void wr_clip( U32 n ) {
+	for( U32 i = 0; i < n; i++ ) {
+		F32 v = s_vec[i % VEC_MEAS];
+		(void) vc_as_float( VAR_CLIP, VarWrite, &v, (U16)( i % VEC_MEAS ), REQ_PRG );
+	}
+}
+
+static void rd_int8( U32 n ) {
+	S8 v = 0;
+	S32 sum = 0;
+
+	for( U32 i = 0; i < n; i++ ) {
+		(void) vc_as_int8( VAR_MODE, VarRead, &v, 0, REQ_PRG );
+		sum += v;
+	}
+	g_bench_sink = (uint32_t) sum;
+}
+
+static void wr_int8( U32 n ) {
+	for( U32 i = 0; i < n; i++ ) {
+		S8 v = (S8)( i & 0x3fu );
+		(void) vc_as_int8( VAR_MODE, VarWrite, &v, 0, REQ_PRG );
+	}
+}
+
+static void rd_int64( U32 n ) {
+	S64 v = 0;
+	S64 sum = 0;
+
+	for( U32 i = 0; i < n; i++ ) {
+		(void) vc_as_int64( VAR_TOTAL, VarRead, &v, 0, REQ_PRG );
+		sum += v;
+	}
+	g_bench_sink = (uint32_t) sum;
+}
+
+static void wr_int64( U32 n ) {
+	for( U32 i = 0; i < n; i++ ) {
+		S64 v = (S64) i * 1000;
+		(void) vc_as_int64( VAR_TOTAL, VarWrite, &v, 0, REQ_PRG );
+	}
+}
+
+static void rd_double( U32 n ) {
+	F64 v = 0.0;
+	F64 sum = 0.0;
+
+	for( U32 i = 0; i < n; i++ ) {
+		(void) vc_as_double( VAR_FREQ, VarRead, &v, 0, REQ_PRG );
+		sum += v;
+	}
+	g_bench_sink = (uint32_t) sum;
+}
+
+static void wr_double( U32 n ) {
+	for( U32 i = 0; i < n; i++ ) {
+		F64 v = 49.5 + (F64)( i & 0xffu ) * 0.01;
+		(void) vc_as_double( VAR_FREQ, VarWrite, &v, 0, REQ_PRG );
+	}
+}
+
+static void rd_str_float( U32 n ) {
+	STRBUF s;
+
+	for( U32 i = 0; i < n; i++ ) {
+		(void) vc_as_string( VAR_VOLT, VarRead, s, 0, REQ_PRG );
+	}
+	g_bench_sink = (uint32_t) s[0];
+}
+
+static void wr_str_float( U32 n ) {
+	static char const *val[] = { "12.5", "-3.25", "99.999", "0.001" };
+	STRBUF s;
+
+	for( U32 i = 0; i < n; i++ ) {
+		(void) strcpy( s, val[i % 4u] );
+		(void) vc_as_string( VAR_VOLT, VarWrite, s, 0, REQ_PRG );
+	}
+}
+
+static void rd_str_int( U32 n ) {
+	STRBUF s;
+
+	for( U32 i = 0; i < n; i++ ) {
+		(void) vc_as_string( VAR_CNT, VarRead, s, (U16)( i % VEC_MEAS ), REQ_PRG );
+	}
+	g_bench_sink = (uint32_t) s[0];
+}
+
+static void rd_str_str( U32 n ) {
+	STRBUF s;
+
+	for( U32 i = 0; i < n; i++ ) {
+		(void) vc_as_string( VAR_ADDR, VarRead, s, 0, REQ_PRG );
+	}
+	g_bench_sink = (uint32_t) s[0];
+}
+
+static void wr_str_str( U32 n ) {
+	STRBUF s;
+
+	for( U32 i = 0; i < n; i++ ) {
+		(void) strcpy( s, ( i & 1u ) ? "10.0.0.1" : "192.168.0.10" );
+		(void) vc_as_string( VAR_ADDR, VarWrite, s, 0, REQ_PRG );
+	}
+}
+
+static void get_hnd( U32 n ) {
+	U32 sum = 0;
+
+	for( U32 i = 0; i < n; i++ ) {
+		sum += vc_get_hnd( s_scpi[i % countof( s_scpi )] );
+	}
+	g_bench_sink = sum;
+}
+
+static void get_hnd_miss( U32 n ) {
+	static char const *miss[] = { "SOUR:CURR", "MEAS:VOLT", "SYST:ERR", "X" };
+	U32 sum = 0;
+
+	for( U32 i = 0; i < n; i++ ) {
+		sum += vc_get_hnd( miss[i % 4u] );
+	}
+	g_bench_sink = sum;
+}
+
+static void rd_vector( U32 n ) {
+	for( U32 i = 0; i < n; i++ ) {
+		(void) vc_read_vector( VAR_HIST, 0, VEC_HIST, s_vec, REQ_PRG );
+	}
+	g_bench_sink = (uint32_t) s_vec[0];
+}
+
+static void wr_vector( U32 n ) {
+	for( U32 i = 0; i < n; i++ ) {
+		(void) vc_write_vector( VAR_HIST, 0, VEC_HIST, s_vec, REQ_PRG );
+	}
+}
+
+static void reset( U32 n ) {
+	for( U32 i = 0; i < n; i++ ) {
+		(void) vc_reset();
+	}
+}
+
+static BENCH const s_bench[] = {
+	{ "vc_as_int16.rd",     rd_int16 },
+	{ "vc_as_int16.wr",     wr_int16 },
+	{ "vc_as_int32.rd",     rd_int32 },
+	{ "vc_as_int32.wr",     wr_int32 },
+	{ "vc_as_float.rd",     rd_float },
+	{ "vc_as_float.wr",     wr_float },
+	{ "vc_as_float.clip",   wr_clip },
+	{ "vc_as_int8.rd",      rd_int8 },
+	{ "vc_as_int8.wr",      wr_int8 },
+	{ "vc_as_int64.rd",     rd_int64 },
+	{ "vc_as_int64.wr",     wr_int64 },
+	{ "vc_as_double.rd",    rd_double },
+	{ "vc_as_double.wr",    wr_double },
+	{ "vc_as_string.rd_f",  rd_str_float },
+	{ "vc_as_string.wr_f",  wr_str_float },
+	{ "vc_as_string.rd_i",  rd_str_int },
+	{ "vc_as_string.rd_s",  rd_str_str },
+	{ "vc_as_string.wr_s",  wr_str_str },
+	{ "vc_get_hnd.hit",     get_hnd },
+	{ "vc_get_hnd.miss",    get_hnd_miss },
+	{ "vc_read_vector",     rd_vector },
+	{ "vc_write_vector",    wr_vector },
+	{ "vc_reset",           reset }
+};
+
+/*** measurement ************************************************************/
+
+static int cmp_double( void const *a, void const *b ) {
+	double x = *(double const *) a;
+	double y = *(double const *) b;
+
+	return ( x > y ) - ( x < y );
+}
+
+static void run( BENCH const *b, RESULT *res ) {
+	static double ns[Samples];
+	uint64_t total = 0;
+	U32 batch = 1;
+
+	/* warm up and size the batch */
+	for( ;; ) {
+		uint64_t t = bench_now();
+		b->fn( batch );
+		t = bench_now() - t;
+		if(( t >= BatchNs ) || ( batch >= MaxBatch )) {
+			break;
+		}
+		batch *= 2u;
+	}
+
+	for( int i = 0; i < Samples; i++ ) {
+		uint64_t t = bench_now();
+		b->fn( batch );
+		t = bench_now() - t;
+		total += t;
+		ns[i] = (double) t / batch;
+	}
+
+	qsort( ns, Samples, sizeof(ns[0]), cmp_double );
+	res->ns_op = (double) total / ( (double) batch * Samples );
+	res->p50   = ns[Samples / 2];
+	res->p90   = ns[Samples * 90 / 100];
+	res->p99   = ns[Samples * 99 / 100];
+}
+
+/*** baseline ***************************************************************/
+
+static int load_base( char const *path ) {
+	char line[256];
+	FILE *fp = fopen( path, "r" );
+
+	if( NULL == fp ) {
+		return -1;
+	}
+
+	while(( s_base_cnt < MaxBase ) && ( fgets( line, sizeof(line), fp ) != NULL )) {
+		BASE *b = &s_base[s_base_cnt];
+		double ns_op;
+		double ops;
+
+		if( '#' == line[0] ) {
+			continue;
+		}
+		if( 4 == sscanf( line, "%31s %lf %lf %lf", b->name, &ns_op, &ops, &b->p50 )) {
+			s_base_cnt++;
+		}
+	}
+	(void) fclose( fp );
+	return 0;
+}
+
+static BASE const *find_base( char const *name ) {
+	for( int i = 0; i < s_base_cnt; i++ ) {
+		if( 0 == strcmp( s_base[i].name, name )) {
+			return &s_base[i];
+		}
+	}
+	return NULL;
+}
+
+int main( int argc, char **argv ) {
+	char const *filter = NULL;
+	char const *base = NULL;
+	double tol = 10.0;
+	int regress = 0;
+	uint32_t rnd = 1;
+
+	for( int i = 1; i < argc; i++ ) {
+		if(( 0 == strcmp( argv[i], "-f" )) && ( i + 1 < argc )) {
+			filter = argv[++i];
+		}
+		else if(( 0 == strcmp( argv[i], "-c" )) && ( i + 1 < argc )) {
+			base = argv[++i];
+		}
+		else if(( 0 == strcmp( argv[i], "-t" )) && ( i + 1 < argc )) {
+			tol = atof( argv[++i] );
+		}
+		else {
+			fprintf( stderr, "usage: %s [-f filter] [-c baseline] [-t percent]\n", argv[0] );
+			return 2;
+		}
+	}
+
+	if(( base != NULL ) && ( load_base( base ) != 0 )) {
+		fprintf( stderr, "%s: can't read %s\n", argv[0], base );
+		return 2;
+	}
+
+	vc_init( &g_var_data );
+
+	for( HND h = 0; h < countof( s_scpi ); h++ ) {
+		s_scpi[h] = &g_var_data.data_const_str[g_var_data.vars[h].scpi_idx];
+	}
+	for( int i = 0; i < VEC_HIST; i++ ) {
+		U32 r = bench_rand( &rnd );
+		s_vec[i] = (F32)( r % 1600u ) - 800.0f;
+		if(( i % 4 ) == 3 ) {
+			s_vec[i] *= 4.0f;
+		}
+	}
+
+	printf( "# name\tns_op\tops_s\tp50_ns\tp90_ns\tp99_ns%s\n",
+	        ( base != NULL ) ? "\tbase_p50\tdelta_pct" : "" );
+
+	for( size_t i = 0; i < countof( s_bench ); i++ ) {
+		BENCH const *b = &s_bench[i];
+		RESULT res;
+
+		if(( filter != NULL ) && ( NULL == strstr( b->name, filter ))) {
+			continue;
+		}
+
+		run( b, &res );
+		printf( "%s\t%.2f\t%.0f\t%.2f\t%.2f\t%.2f",
+		        b->name, res.ns_op, 1e9 / res.ns_op, res.p50, res.p90, res.p99 );
+
+		if( base != NULL ) {
+			BASE const *old = find_base( b->name );
+
+			if( old != NULL ) {
+				double delta = ( res.p50 - old->p50 ) * 100.0 / old->p50;
+
+				printf( "\t%.2f\t%+.1f", old->p50, delta );
+				if( delta > tol ) {
+					printf( "\tREGRESSION" );
+					regress = 1;
+				}
+			}
+			else {
+				printf( "\t-\t-" );
+			}
+		}
+		printf( "\n" );
+		(void) fflush( stdout );
+	}
+
+	return regress;
+}
+
+/*______________________________________________________________________EOF_*/
@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file   bench_fmt.c
+ * \author rhae
+ *
+ * Time to read all variables with vc_as_string(), compared to
+ * the former implementation, which formatted the numbers with sprintf.
+ */
+
+#include "bench.h"
+
+#include "../lib/varcore.h"
+#include "vardefs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "vardef.inc"
+
+enum {
+	Loops = 200
+};
+
+volatile uint32_t g_bench_sink;
+
+/* vc_as_string() read with sprintf, as before vcconv.c */
+static ErrCode read_sprintf( HND hnd, char *p, U16 chan ) {
+	VAR_DESC const *var = &g_var_data.vars[hnd];
+	ErrCode ret = kErrNone;
+
+	switch( var->type & TYPE_MASK ) {
+		case TYPE_INT16: {
+			U16 n16 = 0;
+			ret = vc_as_int16( hnd, VarRead, (S16*)&n16, chan, REQ_PRG );
+			if(( FMT_HEX2 == var->fmt ) || ( FMT_HEX4 == var->fmt )) {
+				(void) sprintf( p, "%#hx", n16 );
+			}
+			else {
+				(void) sprintf( p, "%d", n16 );
+			}
+			break;
+		}
+
+		case TYPE_INT32: {
+			S32 n = 0;
+			ret = vc_as_int32( hnd, VarRead, &n, chan, REQ_PRG );
+			if(( n > 0xffff ) || ( FMT_HEX8 == var->fmt )) {
+				(void) sprintf( p, "%#x", n );
+			}
+			else {
+				(void) sprintf( p, "%d", n );
+			}
+			break;
+		}
+
+		case TYPE_FLOAT: {
+			F32 f = 0.0f;
+			ret = vc_as_float( hnd, VarRead, &f, chan, REQ_PRG );
+			if(( var->fmt >= FMT_PREC_1 ) && ( var->fmt <= FMT_PREC_4 )) {
+				(void) sprintf( p, "%.*f", var->fmt, f );
+			}
+			else {
+				(void) sprintf( p, "%f", f );
+			}
+			break;
+		}
+
+		default:
+			ret = vc_as_string( hnd, VarRead, p, chan, REQ_PRG );
+			break;
+	}
+	return ret;
+}
+
+static uint64_t read_all( int old ) {
+	STRBUF   s;
+	uint64_t t = bench_now();
+
+	for( int i = 0; i < Loops; i++ ) {
+		for( HND hnd = 0; hnd < g_var_data.var_cnt; hnd++ ) {
+			U16 items = g_var_data.vars[hnd].vec_items;
+			for( U16 ch = 0; ch < items; ch++ ) {
+				if( old != 0 ) {
+					(void) read_sprintf( hnd, s, ch );
+				}
+				else {
+					(void) vc_as_string( hnd, VarRead, s, ch, REQ_PRG );
+				}
+				g_bench_sink += (uint32_t) s[0];
+			}
+		}
+	}
+	return bench_now() - t;
+}
+
+int main( void ) {
+	uint32_t rnd = 1;
+	uint64_t t_old;
+	uint64_t t_new;
+	U32      items = 0;
+
+	vc_init( &g_var_data );
+
+	for( U16 ch = 0; ch < VEC_MEAS; ch++ ) {
+		F32 f = (F32)( bench_rand( &rnd ) % 2000000u ) / 7.0f - 100000.0f;
+		S32 n = (S32)( bench_rand( &rnd ) % 200000u ) - 100000;
+		S16 n16 = (S16) bench_rand( &rnd );
+
+		(void) vc_as_float( VAR_MEAS, VarWrite, &f, ch, REQ_PRG );
+		f /= 3.0f;
+		(void) vc_as_float( VAR_RAW, VarWrite, &f, ch, REQ_PRG );
+		(void) vc_as_int32( VAR_CNT, VarWrite, &n, ch, REQ_PRG );
+		(void) vc_as_int16( VAR_STAT, VarWrite, &n16, ch, REQ_PRG );
+	}
+	for( U16 ch = 0; ch < VEC_HIST; ch++ ) {
+		F32 f = (F32)( bench_rand( &rnd ) % 100000u ) / 1000.0f;
+		(void) vc_as_float( VAR_HIST, VarWrite, &f, ch, REQ_PRG );
+	}
+	for( HND hnd = 0; hnd < g_var_data.var_cnt; hnd++ ) {
+		items += g_var_data.vars[hnd].vec_items;
+	}
+
+	t_old = read_all( 1 );
+	t_new = read_all( 0 );
+
+	printf( "sprintf       %8.1f ns/value\n", (double) t_old / Loops / items );
+	printf( "vc_as_string  %8.1f ns/value\n", (double) t_new / Loops / items );
+	printf( "speedup       %8.2f\n", (double) t_old / (double) t_new );
+	return 0;
+}
+
+/*______________________________________________________________________EOF_*/
@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file   bench_hnd.c
+ * \author rhae
+ *
+ * Compare the lookup of a handle from its SCPI string:
+ *   - linear: strcmp over all variables (vc_get_hnd without hash table)
+ *   - phash:  perfect hash generated by varpp (vc_get_hnd with hash table)
+ *
+ * The tables are generated at runtime with the same builder varpp uses.
+ * A VC_DATA can't hold 60k SCPI strings (16 bit string offsets), so both
+ * lookups run on a plain list of strings with the code of vc_get_hnd.
+ */
+
+#include "bench.h"
+
+#include "../lib/varcore.h"
+#include "../lib/varhash.h"
+#include "../tools/varpp/phash.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+	NameSize = 24,
+	MinLookups = 1000,
+	MaxLookups = 1000000,
+	StrcmpBudget = 50000000  /* strcmp calls for the linear search */
+};
+
+volatile uint32_t g_bench_sink;
+
+static HND lookup_linear( char const **names, size_t n, char const *scpi ) {
+	for( HND i = 0; i < n; i++ ) {
+		if( 0 == strcmp( scpi, names[i] )) {
+			return i;
+		}
+	}
+	return HNON;
+}
+
+static HND lookup_phash( PHASH const *ph, char const **names, char const *scpi ) {
+	U32 slot = vc_hash_slot( scpi, ph->seed, ph->disp, (U32) ph->disp_cnt, (U32) ph->slot_cnt );
+	HND hnd  = ph->slots[slot];
+
+	if(( hnd != HNON ) && ( 0 == strcmp( scpi, names[hnd] ))) {
+		return hnd;
+	}
+	return HNON;
+}
+
+static void bench( size_t n ) {
+	char        *buf   = (char*) calloc( n, NameSize );
+	char const **names = (char const **) calloc( n, sizeof(char const *) );
+	HND         *query;
+	PHASH        ph;
+	uint32_t     rnd = 0x12345678u;
+	size_t       lookups;
+	uint64_t     t0, t_linear, t_phash;
+
+	/* SCPI like names, eg. "SUB012:VAR07" */
+	for( size_t i = 0; i < n; i++ ) {
+		char *s = &buf[i * NameSize];
+		(void) snprintf( s, NameSize, "SUB%03u:VAR%02u", (unsigned)(i / 16), (unsigned)(i % 16) );
+		names[i] = s;
+	}
+
+	if( phash_build( &ph, names, n ) != 0 ) {
+		printf( "%7zu  failed to build perfect hash\n", n );
+		free( names );
+		free( buf );
+		return;
+	}
+
+	lookups = StrcmpBudget / n;
+	lookups = (lookups < MinLookups) ? MinLookups : lookups;
+	lookups = (lookups > MaxLookups) ? MaxLookups : lookups;
+
+	query = (HND*) calloc( lookups, sizeof(HND) );
+	for( size_t i = 0; i < lookups; i++ ) {
+		query[i] = (HND)( bench_rand( &rnd ) % n );
+	}
+
+	t0 = bench_now();
+	for( size_t i = 0; i < lookups; i++ ) {
+		g_bench_sink += lookup_linear( names, n, names[query[i]] );
+	}
+	t_linear = bench_now() - t0;
+
+	t0 = bench_now();
+	for( size_t i = 0; i < lookups; i++ ) {
+		g_bench_sink += lookup_phash( &ph, names, names[query[i]] );
+	}
+	t_phash = bench_now() - t0;
+
+	for( size_t i = 0; i < n; i++ ) {
+		if( lookup_phash( &ph, names, names[i] ) != i ) {
+			printf( "%7zu  lookup of %s failed\n", n, names[i] );
+			break;
+		}
+	}
+
+	printf( "%7zu %10zu %14.1f %14.1f %10.1fx\n",
+		n, lookups,
+		(double) t_linear / (double) lookups,
+		(double) t_phash / (double) lookups,
+		(double) t_linear / (double) (t_phash ? t_phash : 1u) );
+
+	phash_free( &ph );
+	free( query );
+	free( names );
+	free( buf );
+}
+
+int main( int argc, char **argv ) {
+	static size_t const sizes[] = { 100, 1000, 10000, 60000 };
+
+	(void) argc;
+	(void) argv;
+
+	printf( "%7s %10s %14s %14s %11s\n", "vars", "lookups", "linear[ns/op]", "phash[ns/op]", "speedup" );
+	for( size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++ ) {
+		bench( sizes[i] );
+	}
+
+	return 0;
+}
@@ -0,0 +1,174 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file   bench_parse.c
+ * \author rhae
+ *
+ * Writes 1M values with vc_as_string(), compared to the former
+ * implementation, which converted the strings with strtol and strtof.
+ */
+
+#include "bench.h"
+
+#include "../lib/varcore.h"
+#include "vardefs.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "vardef.inc"
+
+enum {
+	Writes  = 1000000,
+	Strings = 1024
+};
+
+volatile uint32_t g_bench_sink;
+
+typedef struct _ITEM {
+	HND    hnd;
+	U16    chan;
+	STRBUF s;
+} ITEM;
+
+static ITEM s_items[Strings];
+
+/* vc_as_string() write with strtol and strtof, as before vcconv.c */
+static ErrCode write_strto( HND hnd, char *val, U16 chan ) {
+	ErrCode ret = kErrInvalidValue;
+	char *endp;
+
+	errno = 0;
+	switch( g_var_data.vars[hnd].type & TYPE_MASK ) {
+		case TYPE_INT16: {
+			S32 n = strtol( val, &endp, 0 );
+			if(( errno == 0 ) && ( val != endp ) && ( *endp == '\0' ) &&
+			   ( n <= SHRT_MAX ) && ( n >= SHRT_MIN )) {
+				S16 n16 = (S16) n;
+				ret = vc_as_int16( hnd, VarWrite, &n16, chan, REQ_PRG );
+			}
+			break;
+		}
+
+		case TYPE_INT32: {
+			S32 n = strtol( val, &endp, 0 );
+			if(( errno == 0 ) && ( val != endp ) && ( *endp == '\0' )) {
+				ret = vc_as_int32( hnd, VarWrite, &n, chan, REQ_PRG );
+			}
+			break;
+		}
+
+		case TYPE_FLOAT: {
+			F32 f = strtof( val, &endp );
+			if(( errno == 0 ) && ( val != endp ) && ( *endp == '\0' )) {
+				ret = vc_as_float( hnd, VarWrite, &f, chan, REQ_PRG );
+			}
+			break;
+		}
+
+		default:
+			ret = vc_as_string( hnd, VarWrite, val, chan, REQ_PRG );
+			break;
+	}
+	return ret;
+}
+
+static uint64_t write_all( int old, U32 *errors ) {
+	uint64_t t = bench_now();
+
+	*errors = 0;
+	for( int i = 0; i < Writes; i++ ) {
+		ITEM *it = &s_items[i % Strings];
+		ErrCode ret;
+
+		if( old != 0 ) {
+			ret = write_strto( it->hnd, it->s, it->chan );
+		}
+		else {
+			ret = vc_as_string( it->hnd, VarWrite, it->s, it->chan, REQ_PRG );
+		}
+		*errors += ( ret != kErrNone ) ? 1u : 0u;
+	}
+	return bench_now() - t;
+}
+
+int main( void ) {
+	uint32_t rnd = 1;
+	uint64_t t_old;
+	uint64_t t_new;
+	U32      err_old;
+	U32      err_new;
+
+	vc_init( &g_var_data );
+
+	/* a mix of a configuration: floats, integers and hex values */
+	for( int i = 0; i < Strings; i++ ) {
+		ITEM *it = &s_items[i];
+		U32   r  = bench_rand( &rnd );
+
+		switch( i % 4 ) {
+			case 0:
+				it->hnd  = VAR_HIST;
+				it->chan = (U16)( r % VEC_HIST );
+				(void) snprintf( it->s, sizeof(it->s), "%.3f", (double)( r % 100000u ) / 1000.0 );
+				break;
+			case 1:
+				it->hnd  = VAR_RAW;
+				it->chan = (U16)( r % VEC_MEAS );
+				(void) snprintf( it->s, sizeof(it->s), "%.6e", (double)( r % 1000000u ) / 3.0 );
+				break;
+			case 2:
+				it->hnd  = VAR_CNT;
+				it->chan = (U16)( r % VEC_MEAS );
+				(void) snprintf( it->s, sizeof(it->s), "%d", (int)( r % 200000u ) - 100000 );
+				break;
+			default:
+				it->hnd  = VAR_STAT;
+				it->chan = (U16)( r % VEC_MEAS );
+				(void) snprintf( it->s, sizeof(it->s), "%#x", (unsigned)( r % 0x8000u ));
+				break;
+		}
+	}
+
+	t_old = write_all( 1, &err_old );
+	t_new = write_all( 0, &err_new );
+
+	printf( "strtol/strtof %8.1f ms  (%u errors)\n", (double) t_old / 1e6, err_old );
+	printf( "vc_as_string  %8.1f ms  (%u errors)\n", (double) t_new / 1e6, err_new );
+	printf( "speedup       %8.2f\n", (double) t_old / (double) t_new );
+	return ( err_old != err_new ) ? 1 : 0;
+}
+
+/*______________________________________________________________________EOF_*/
@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file   bench_scan.c
+ * \author rhae
+ *
+ * Full-table scan over float values in the layout of varcore, where
+ * the current values are kept apart from their limits, and in the
+ * former layout, where every value is interleaved with its minimum
+ * and maximum (DATA_F32).
+ *
+ * The sum scan reads the values only (four partial sums, so that
+ * the adder latency doesn't hide the memory traffic), the range
+ * scan reads values and limits. The tables range from L1 sized to larger than the last
+ * level cache; "lines" is the number of 64 byte cache lines the scan
+ * has to load.
+ */
+
+#include "bench.h"
+
+#include "../lib/varcore.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+enum {
+	Values    = 64000000,  /* values scanned per table size */
+	CacheLine = 64
+};
+
+volatile uint32_t g_bench_sink;
+
+static F32      *s_val;
+static LIM_F32  *s_lim;
+static DATA_F32 *s_aos;
+
+static uint64_t sum_split( U32 cnt ) {
+	uint64_t t = bench_now();
+	F32 sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	for( U32 n = 0; n < Values; n += cnt ) {
+		for( U32 i = 0; i < cnt; i += 4 ) {
+			sum[0] += s_val[i];
+			sum[1] += s_val[i + 1];
+			sum[2] += s_val[i + 2];
+			sum[3] += s_val[i + 3];
+		}
+	}
+	g_bench_sink = (uint32_t)( sum[0] + sum[1] + sum[2] + sum[3] );
+	return bench_now() - t;
+}
+
+static uint64_t sum_aos( U32 cnt ) {
+	uint64_t t = bench_now();
+	F32 sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	for( U32 n = 0; n < Values; n += cnt ) {
+		for( U32 i = 0; i < cnt; i += 4 ) {
+			sum[0] += s_aos[i].def_value;
+			sum[1] += s_aos[i + 1].def_value;
+			sum[2] += s_aos[i + 2].def_value;
+			sum[3] += s_aos[i + 3].def_value;
+		}
+	}
+	g_bench_sink = (uint32_t)( sum[0] + sum[1] + sum[2] + sum[3] );
+	return bench_now() - t;
+}
+
+static uint64_t range_split( U32 cnt ) {
+	uint64_t t = bench_now();
+	U32 out = 0;
+
+	for( U32 n = 0; n < Values; n += cnt ) {
+		for( U32 i = 0; i < cnt; i++ ) {
+			out += ( s_val[i] < s_lim[i].min ) | ( s_val[i] > s_lim[i].max );
+		}
+	}
+	g_bench_sink = out;
+	return bench_now() - t;
+}
+
+static uint64_t range_aos( U32 cnt ) {
+	uint64_t t = bench_now();
+	U32 out = 0;
+
+	for( U32 n = 0; n < Values; n += cnt ) {
+		for( U32 i = 0; i < cnt; i++ ) {
+			out += ( s_aos[i].def_value < s_aos[i].min ) | ( s_aos[i].def_value > s_aos[i].max );
+		}
+	}
+	g_bench_sink = out;
+	return bench_now() - t;
+}
+
+/* best of three runs */
+static uint64_t best( uint64_t (*fn)( U32 ), U32 cnt ) {
+	uint64_t t = fn( cnt );
+
+	for( int i = 0; i < 2; i++ ) {
+		uint64_t t2 = fn( cnt );
+		t = ( t2 < t ) ? t2 : t;
+	}
+	return t;
+}
+
+static void report( char const *name, U32 cnt, size_t item, uint64_t t ) {
+	size_t bytes = cnt * item;
+
+	printf( "%-12s %8u values  %9zu bytes  %7zu lines  %6.2f ns/value  %8.0f MB/s\n",
+	        name, cnt, bytes, ( bytes + CacheLine - 1 ) / CacheLine,
+	        (double) t / Values, (double) Values * item / ( (double) t / 1e9 ) / 1e6 );
+}
+
+int main( void ) {
+	static U32 const cnt[] = { 1024u, 65536u, 4u * 1024u * 1024u };
+	U32 max = cnt[sizeof(cnt) / sizeof(cnt[0]) - 1];
+	uint32_t rnd = 1;
+
+	s_val = malloc( max * sizeof(*s_val) );
+	s_lim = malloc( max * sizeof(*s_lim) );
+	s_aos = malloc( max * sizeof(*s_aos) );
+	if(( NULL == s_val ) || ( NULL == s_lim ) || ( NULL == s_aos )) {
+		return 1;
+	}
+
+	for( U32 i = 0; i < max; i++ ) {
+		F32 f = (F32)( bench_rand( &rnd ) % 2000u ) - 1000.0f;
+
+		s_val[i] = f;
+		s_lim[i].min = -900.0f;
+		s_lim[i].max = 900.0f;
+		s_aos[i].def_value = f;
+		s_aos[i].min = -900.0f;
+		s_aos[i].max = 900.0f;
+	}
+
+	for( size_t k = 0; k < sizeof(cnt) / sizeof(cnt[0]); k++ ) {
+		report( "sum split", cnt[k], sizeof(F32), best( sum_split, cnt[k] ));
+		report( "sum aos", cnt[k], sizeof(DATA_F32), best( sum_aos, cnt[k] ));
+		report( "range split", cnt[k], sizeof(F32) + sizeof(LIM_F32), best( range_split, cnt[k] ));
+		report( "range aos", cnt[k], sizeof(DATA_F32), best( range_aos, cnt[k] ));
+	}
+
+	free( s_val );
+	free( s_lim );
+	free( s_aos );
+	return 0;
+}
+
+/*______________________________________________________________________EOF_*/
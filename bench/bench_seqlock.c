@@ -0,0 +1,228 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file   bench_seqlock.c
+ * \author rhae
+ *
+ * Stress and throughput test of the varcore built with VC_THREAD_SAFE.
+ *
+ * One writer thread updates 64 measurement values, 64 counters and a
+ * string as fast as it can, 1..8 reader threads read them. Two modes
+ * are compared:
+ *   - seqlock: the readers and the writer call the varcore directly.
+ *   - mutex:   every call is wrapped by one global mutex, as users had
+ *              to do without VC_THREAD_SAFE.
+ *
+ * The readers check that no counter goes backwards and that no string
+ * is torn (the writer fills the string with one letter only).
+ */
+
+#include "bench.h"
+
+#include "../lib/varcore.h"
+#include "vardefs.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "vardef.inc"
+
+enum {
+	RunTimeMs  = 300,
+	MaxReaders = 8
+};
+
+typedef struct _READER {
+	pthread_t thread;
+	uint64_t  reads;
+	uint64_t  errors;
+	uint32_t  rnd;
+	S32       last[VEC_MEAS];
+} READER;
+
+volatile uint32_t g_bench_sink;
+
+static atomic_int      s_stop;
+static int             s_use_mutex;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t        s_writes;
+
+static inline void lock( void ) {
+	if( s_use_mutex != 0 ) {
+		(void) pthread_mutex_lock( &s_lock );
+	}
+}
+
+static inline void unlock( void ) {
+	if( s_use_mutex != 0 ) {
+		(void) pthread_mutex_unlock( &s_lock );
+	}
+}
+
+static void *writer( void *arg ) {
+	S32 cnt = 0;
+	STRBUF s;
+	(void) arg;
+
+	s_writes = 0;
+	while( 0 == atomic_load_explicit( &s_stop, memory_order_relaxed )) {
+		cnt++;
+		for( U16 ch = 0; ch < VEC_MEAS; ch++ ) {
+			S32 n = cnt;
+			F32 f = (F32) cnt * 0.5f;
+
+			lock();
+			(void) vc_as_int32( VAR_CNT, VarWrite, &n, ch, REQ_PRG );
+			unlock();
+
+			lock();
+			(void) vc_as_float( VAR_MEAS, VarWrite, &f, ch, REQ_PRG );
+			unlock();
+		}
+
+		(void) memset( s, 'a' + (cnt % 26), sizeof(s) - 1u );
+		s[sizeof(s) - 1u] = '\0';
+		lock();
+		(void) vc_as_string( VAR_TXT, VarWrite, s, 0, REQ_PRG );
+		unlock();
+
+		s_writes += 2u * VEC_MEAS + 1u;
+	}
+	return NULL;
+}
+
+static void *reader( void *arg ) {
+	READER *r = (READER*) arg;
+	STRBUF s;
+
+	while( 0 == atomic_load_explicit( &s_stop, memory_order_relaxed )) {
+		U16 ch = (U16)( bench_rand( &r->rnd ) % VEC_MEAS );
+		S32 n;
+		F32 f;
+
+		lock();
+		(void) vc_as_int32( VAR_CNT, VarRead, &n, ch, REQ_PRG );
+		unlock();
+		if( n < r->last[ch] ) {
+			r->errors++;
+		}
+		r->last[ch] = n;
+
+		lock();
+		(void) vc_as_float( VAR_MEAS, VarRead, &f, ch, REQ_PRG );
+		unlock();
+		g_bench_sink += (uint32_t) f;
+
+		r->reads += 2u;
+
+		if(( r->reads & 0xfu ) == 0u ) {
+			lock();
+			(void) vc_as_string( VAR_TXT, VarRead, s, 0, REQ_PRG );
+			unlock();
+			for( size_t i = 1; i < sizeof(s) - 1u; i++ ) {
+				if( s[i] != s[0] ) {
+					r->errors++;
+					break;
+				}
+			}
+			r->reads++;
+		}
+	}
+	return NULL;
+}
+
+static int bench( int readers, int use_mutex ) {
+	static READER r[MaxReaders];
+	pthread_t w;
+	uint64_t t0, t, reads = 0, errors = 0;
+
+	(void) vc_reset();
+	s_use_mutex = use_mutex;
+	atomic_store( &s_stop, 0 );
+
+	(void) memset( r, 0, sizeof(r) );
+	for( int i = 0; i < readers; i++ ) {
+		r[i].rnd = 0x12345678u + (uint32_t) i;
+	}
+
+	t0 = bench_now();
+	(void) pthread_create( &w, NULL, writer, NULL );
+	for( int i = 0; i < readers; i++ ) {
+		(void) pthread_create( &r[i].thread, NULL, reader, &r[i] );
+	}
+
+	do {
+		t = bench_now() - t0;
+	} while( t < (uint64_t) RunTimeMs * 1000000u );
+	atomic_store( &s_stop, 1 );
+
+	for( int i = 0; i < readers; i++ ) {
+		(void) pthread_join( r[i].thread, NULL );
+		reads  += r[i].reads;
+		errors += r[i].errors;
+	}
+	(void) pthread_join( w, NULL );
+
+	printf( "%7d %8s %14.2f %14.2f %14.2f %7llu\n",
+		readers, use_mutex ? "mutex" : "seqlock",
+		(double) reads * 1e3 / (double) t,
+		(double) reads * 1e3 / (double) t / readers,
+		(double) s_writes * 1e3 / (double) t,
+		(unsigned long long) errors );
+
+	return (errors != 0u) ? 1 : 0;
+}
+
+int main( int argc, char **argv ) {
+	static int const readers[] = { 1, 2, 4, 8 };
+	int failed = 0;
+
+	(void) argc;
+	(void) argv;
+
+	(void) vc_init( &g_var_data );
+
+	printf( "%7s %8s %14s %14s %14s %7s\n",
+		"readers", "mode", "reads[M/s]", "per thread", "writes[M/s]", "errors" );
+	for( size_t i = 0; i < sizeof(readers) / sizeof(readers[0]); i++ ) {
+		failed |= bench( readers[i], 0 );
+		failed |= bench( readers[i], 1 );
+	}
+
+	if( failed != 0 ) {
+		printf( "torn or stale reads detected\n" );
+	}
+	return failed;
+}
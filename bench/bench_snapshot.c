@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file   bench_snapshot.c
+ * \author rhae
+ *
+ * Time of a snapshot and a restore of the whole variable table
+ * (about 4200 values), compared to reading each value with
+ * vc_as_string().
+ */
+
+#include "bench.h"
+
+#include "../lib/varcore.h"
+#include "vardefs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "vardef.inc"
+
+enum {
+	Loops = 2000
+};
+
+volatile uint32_t g_bench_sink;
+
+static void report( char const *name, uint64_t ns, int loops ) {
+	printf( "%-12s %10.2f us\n", name, (double) ns / loops / 1000.0 );
+}
+
+static void read_all( void ) {
+	STRBUF s;
+
+	for( HND hnd = 0; hnd < g_var_data.var_cnt; hnd++ ) {
+		U16 items = g_var_data.vars[hnd].vec_items;
+		for( U16 ch = 0; ch < items; ch++ ) {
+			(void) vc_as_string( hnd, VarRead, s, ch, REQ_PRG );
+			g_bench_sink += (uint32_t) s[0];
+		}
+	}
+}
+
+int main( void ) {
+	size_t size;
+	void *buf;
+	uint64_t t;
+
+	vc_init( &g_var_data );
+
+	size = vc_snapshot_size();
+	buf = malloc( size );
+	if( NULL == buf ) {
+		return 1;
+	}
+	printf( "snapshot size: %zu bytes\n", size );
+
+	t = bench_now();
+	for( int i = 0; i < Loops; i++ ) {
+		(void) vc_snapshot( buf );
+		g_bench_sink += ((uint8_t *) buf)[size - 1u];
+	}
+	report( "snapshot", bench_now() - t, Loops );
+
+	t = bench_now();
+	for( int i = 0; i < Loops; i++ ) {
+		if( kErrNone != vc_restore( buf )) {
+			return 1;
+		}
+	}
+	report( "restore", bench_now() - t, Loops );
+
+	t = bench_now();
+	for( int i = 0; i < Loops / 100; i++ ) {
+		read_all();
+	}
+	report( "vc_as_string", bench_now() - t, Loops / 100 );
+
+	free( buf );
+	return 0;
+}
+
+/*______________________________________________________________________EOF_*/
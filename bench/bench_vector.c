@@ -0,0 +1,152 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file   bench_vector.c
+ * \author rhae
+ *
+ * Writes and reads a clipped float vector channel by channel with
+ * vc_as_float() and with one vc_write_vector()/vc_read_vector() call,
+ * for 8 and 64 channels.
+ */
+
+#include "bench.h"
+
+#include "../lib/varcore.h"
+#include "vardefs.h"
+
+#include <stdio.h>
+
+#include "vardef.inc"
+
+enum {
+	Channels = 8000000
+};
+
+volatile uint32_t g_bench_sink;
+
+static F32 s_val[VEC_MEAS];
+
+static uint64_t write_chan( U16 cnt ) {
+	uint64_t t = bench_now();
+
+	for( U32 n = 0; n < Channels; n += cnt ) {
+		for( U16 i = 0; i < cnt; i++ ) {
+			F32 f = s_val[i];
+			(void) vc_as_float( VAR_CLIP, VarWrite, &f, i, REQ_PRG );
+		}
+	}
+	return bench_now() - t;
+}
+
+static uint64_t write_vec( U16 cnt ) {
+	uint64_t t = bench_now();
+	F32 f[VEC_MEAS];
+
+	for( U32 n = 0; n < Channels; n += cnt ) {
+		for( U16 i = 0; i < cnt; i++ ) {
+			f[i] = s_val[i];
+		}
+		(void) vc_write_vector( VAR_CLIP, 0, cnt, f, REQ_PRG );
+	}
+	return bench_now() - t;
+}
+
+static uint64_t read_chan( U16 cnt ) {
+	uint64_t t = bench_now();
+	F32 sum = 0.0f;
+
+	for( U32 n = 0; n < Channels; n += cnt ) {
+		for( U16 i = 0; i < cnt; i++ ) {
+			F32 f;
+			(void) vc_as_float( VAR_CLIP, VarRead, &f, i, REQ_PRG );
+			sum += f;
+		}
+	}
+	g_bench_sink = (uint32_t) sum;
+	return bench_now() - t;
+}
+
+static uint64_t read_vec( U16 cnt ) {
+	uint64_t t = bench_now();
+	F32 f[VEC_MEAS];
+	F32 sum = 0.0f;
+
+	for( U32 n = 0; n < Channels; n += cnt ) {
+		(void) vc_read_vector( VAR_CLIP, 0, cnt, f, REQ_PRG );
+		sum += f[n % cnt];
+	}
+	g_bench_sink = (uint32_t) sum;
+	return bench_now() - t;
+}
+
+/* best of three runs */
+static uint64_t best( uint64_t (*fn)( U16 ), U16 cnt ) {
+	uint64_t t = fn( cnt );
+
+	for( int i = 0; i < 2; i++ ) {
+		uint64_t t2 = fn( cnt );
+		t = ( t2 < t ) ? t2 : t;
+	}
+	return t;
+}
+
+int main( void ) {
+	static U16 const cnt[] = { 8, VEC_MEAS };
+	uint32_t rnd = 1;
+
+	vc_init( &g_var_data );
+
+	/* every 4th value is clipped */
+	for( int i = 0; i < VEC_MEAS; i++ ) {
+		U32 r = bench_rand( &rnd );
+		s_val[i] = (F32)( r % 1600u ) - 800.0f;
+		if(( i % 4 ) == 3 ) {
+			s_val[i] *= 4.0f;
+		}
+	}
+
+	for( size_t k = 0; k < sizeof(cnt) / sizeof(cnt[0]); k++ ) {
+		uint64_t t_chan = best( write_chan, cnt[k] );
+		uint64_t t_vec  = best( write_vec, cnt[k] );
+		uint64_t r_chan = best( read_chan, cnt[k] );
+		uint64_t r_vec  = best( read_vec, cnt[k] );
+
+		printf( "%2u channels  write: vc_as_float %7.1f ms  vc_write_vector %7.1f ms  speedup %5.2f\n",
+		        cnt[k], (double) t_chan / 1e6, (double) t_vec / 1e6, (double) t_chan / (double) t_vec );
+		printf( "%2u channels  read:  vc_as_float %7.1f ms  vc_read_vector  %7.1f ms  speedup %5.2f\n",
+		        cnt[k], (double) r_chan / 1e6, (double) r_vec / 1e6, (double) r_chan / (double) r_vec );
+	}
+	return 0;
+}
+
+/*______________________________________________________________________EOF_*/
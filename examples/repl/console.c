@@ -16,7 +16,7 @@ struct CONSOLE_DATA {
   FILE *fd_out;
 };
 
-struct CONSOLE_DATA data;
+static struct CONSOLE_DATA data;
 
 int console_open( char const *args, void *priv ) {
   UNUSED_PARAM( args );
@@ -24,6 +24,7 @@ struct SCPI {
 
 void  repl_run(char const *prompt);
 int   repl_eval( char*, int, char const *, int );
+ErrCode repl_write( void*, char const *, size_t );
 char *skip_space( char* );
 int   isscpi( char );
 int   parse_scpi( struct SCPI *, char const *line );
@@ -83,6 +84,14 @@ int repl_eval( char *resp, int respsz, char const *req, int reqsz ) {
   memset( &S, 0, sizeof(struct SCPI));
 
   char *p = skip_space( (char*)req );
+  if( strncmp( p, "stats", 5 ) == 0 ) {
+    ret = vc_stats_dump( repl_write, NULL, VC_DUMP_TEXT );
+    if( ret == kErrEmpty ) {
+      return snprintf( resp, respsz, "ERROR: built without VC_STATISTICS" );
+    }
+    return snprintf( resp, respsz, "%s", ( ret == kErrNone ) ? "" : "ERROR: stats" );
+  }
+
   if( !isscpi( *p )) {
     return snprintf( resp, respsz, "ERROR: not a SCPI!" );
   }
@@ -115,6 +124,12 @@ int repl_eval( char *resp, int respsz, char const *req, int reqsz ) {
   
 }
 
+ErrCode repl_write( void *arg, char const *data, size_t len ) {
+  UNUSED_PARAM( arg );
+  textio_write( data, (int) len );
+  return kErrNone;
+}
+
 int parse_scpi( struct SCPI *scpi, char const *line ) {
   enum {
     stBegin,
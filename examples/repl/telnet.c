@@ -46,7 +46,7 @@ struct TELNET_DATA {
   
 };
 
-struct TELNET_DATA data;
+static struct TELNET_DATA data;
 
 static int find_opt( char const *p, char const **opt_list, char **endp, int *idx ) {
 
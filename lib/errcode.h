@@ -53,6 +53,11 @@ enum {
 	kErrInvalidArg        = (kErrBase +  9),
 	kErrInvalidEnum       = (kErrBase + 10),
 	kErrUnknownCmd        = (kErrBase + 11),
+	kErrValueChanged      = (kErrBase + 12),
+	kErrEmpty             = (kErrBase + 13),
+	kErrFull              = (kErrBase + 14),
+	kErrLayout            = (kErrBase + 15),
+	kErrIO                = (kErrBase + 16),
 };
 
 /* global defined data types
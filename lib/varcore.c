@@ -41,8 +41,15 @@
  * outside.
  */
 
+/* clock_gettime() of the default VC_STATS_NOW() */
+#if defined(VC_STATISTICS) && !defined(VC_STATS_NOW) && !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+# define _POSIX_C_SOURCE 199309L
+#endif
+
 /* local header */
 #include "varcore.h"
+#include "varhash.h"
+#include "vcconv.h"
 
 /* project headers */
 
@@ -57,9 +64,27 @@
 #include <limits.h>
 #include <stdlib.h>
 #include <stdio.h>
-#include <errno.h>
 #include <string.h>
 
+#ifdef VC_HAS_ATOMIC
+# include <stdatomic.h>
+#endif
+
+#if defined(VC_STATISTICS) && !defined(VC_STATS_NOW)
+# include <time.h>
+#endif
+
+/* SIMD paths of vc_ctx_write_vector(), VC_NO_SIMD keeps the scalar loops */
+#if !defined(VC_NO_SIMD) && defined(__AVX2__)
+# define VC_AVX2 1
+# include <immintrin.h>
+#endif
+#if !defined(VC_NO_SIMD) && ( defined(__SSE2__) || defined(_M_X64) || \
+    ( defined(_M_IX86_FP) && ( _M_IX86_FP >= 2 )))
+# define VC_SSE2 1
+# include <emmintrin.h>
+#endif
+
 /* constant definitions
 ----------------------------------------------------------------------------*/
 #ifndef UNUSED_PARAM
@@ -78,8 +103,105 @@
 # define countof(x) ( sizeof(x) / sizeof(x[0]) )
 #endif
 
+#ifdef VC_HAS_ATOMIC
+/* The values are plain arrays of S16, S32 and F32.
+ * The atomic accessors require the atomic types to have the same
+ * representation, which is true for lock-free 16/32 bit types. */
+# define ATOMIC_S16(p)  ((_Atomic S16 *)(p))
+# define ATOMIC_S32(p)  ((_Atomic S32 *)(p))
+# define ATOMIC_F32(p)  ((_Atomic F32 *)(p))
+#endif
+
+/* Access to a VC_SEQ that isn't a seqlock (event ring, subscriptions) */
+#ifdef VC_THREAD_SAFE
+# define SEQ_LOAD(p, mo)      atomic_load_explicit( (p), memory_order_##mo )
+# define SEQ_STORE(p, v, mo)  atomic_store_explicit( (p), (v), memory_order_##mo )
+# define SEQ_CAS(p, e, v)     atomic_compare_exchange_weak_explicit( (p), (e), (v), \
+                                  memory_order_relaxed, memory_order_relaxed )
+# define SEQ_ADD(p, v)        atomic_fetch_add_explicit( (p), (v), memory_order_relaxed )
+# define SEQ_OR(p, v)         atomic_fetch_or_explicit( (p), (v), memory_order_relaxed )
+# define SEQ_XCHG(p, v)       atomic_exchange_explicit( (p), (v), memory_order_acq_rel )
+#else
+# define SEQ_LOAD(p, mo)      (*(p))
+# define SEQ_STORE(p, v, mo)  (*(p) = (v))
+# define SEQ_CAS(p, e, v)     ((*(p) == *(e)) ? ((*(p) = (v)), 1) : ((*(e) = *(p)), 0))
+# define SEQ_ADD(p, v)        (*(p) += (v))
+# define SEQ_OR(p, v)         (*(p) |= (v))
+# define SEQ_XCHG(p, v)       seq_xchg( (p), (v) )
+
+static inline U32 seq_xchg( VC_SEQ *p, U32 v ) {
+	U32 old = *p;
+	*p = v;
+	return old;
+}
+#endif
+
+/* Instrumentation of the API functions, see vc_ctx_stats_var().
+ * STATS_TIME adds the latency of stmt to the histogram of fn,
+ * STATS_VAR also counts the call for the variable hnd. */
+#ifdef VC_STATISTICS
+# ifndef VC_STATS_NOW
+#  define VC_STATS_NOW()  stats_now()
+#  define STATS_CLOCK
+# endif
+# define STATS_TIME( fn, stmt ) \
+	do { U64 t0_ = VC_STATS_NOW(); stmt; stats_latency( (fn), TYPE_LAST, t0_ ); } while( 0 )
+# define STATS_VAR( ctx, fn, hnd, rdwr, ret, call ) \
+	do { U64 t0_ = VC_STATS_NOW(); (ret) = (call); stats_var( (ctx), (fn), (hnd), (rdwr), (ret), t0_ ); } while( 0 )
+# define STATS_ITEMS( ctx, hnd, err, n, rdwr ) \
+	stats_items( (ctx), (hnd), (err), (n), (rdwr) )
+#else
+# define STATS_TIME( fn, stmt )                       do { stmt; } while( 0 )
+# define STATS_VAR( ctx, fn, hnd, rdwr, ret, call )   do { (ret) = (call); } while( 0 )
+# define STATS_ITEMS( ctx, hnd, err, n, rdwr )        do { } while( 0 )
+#endif
+
 /* local defined data types
 ----------------------------------------------------------------------------*/
+/* arrays of VC_DATA with the values, see store_size() */
+enum {
+	kStoreS16,
+	kStoreS32,
+	kStoreF32,
+	kStoreF64,
+	kStoreS8,
+	kStoreS64,
+	kStoreEnum,
+	kStoreStr,
+	kStoreLimS16,         /* same order as the values, see reset_var() */
+	kStoreLimS32,
+	kStoreLimF32,
+	kStoreLimF64,
+	kStoreLimS8,
+	kStoreLimS64,
+	kStoreSeq,
+	kStoreDirty,
+	kStoreStale,
+	kStoreAction,
+	kStoreHistRing,
+	kStoreHistCell,
+
+	kStoreLast
+};
+
+#define SNAP_MAGIC  0x4e534356u   /* "VCSN" */
+
+/* header of a snapshot, followed by the arrays kStoreS16 ... kStoreLimS64 */
+typedef struct _SNAP_HDR {
+	U32 magic;
+	U32 layout;
+	U32 size;
+	U32 stored;     /* storage classes in the snapshot, EEPROM | FLASH */
+} SNAP_HDR;
+
+/* output buffer of vc_ctx_dump_all() */
+typedef struct _DUMP_OUT {
+	VC_WRITER  wr;
+	void      *arg;
+	ErrCode    err;
+	size_t     len;
+	char       buf[VC_DUMP_CHUNK];
+} DUMP_OUT;
 
 /* list of external used functions, if not in headers
 ----------------------------------------------------------------------------*/
@@ -90,15 +212,85 @@
 /* list of local defined functions
 ----------------------------------------------------------------------------*/
 static int     vc_chk_vector( VAR_DESC const *, U16 );
-static int     init_s16( VAR_DESC const *);
-static int     init_s32( VAR_DESC const *);
-static int     init_f32( VAR_DESC const *);
-static int     init_f64( VAR_DESC const *);
-static int     init_enum( VAR_DESC const *);
-static int     init_string( VAR_DESC const *);
+static int     init_s16( VC_CTX *, VAR_DESC const *);
+static int     init_s32( VC_CTX *, VAR_DESC const *);
+static int     init_f32( VC_CTX *, VAR_DESC const *);
+static int     init_f64( VC_CTX *, VAR_DESC const *);
+static int     init_s8( VC_CTX *, VAR_DESC const *);
+static int     init_s64( VC_CTX *, VAR_DESC const *);
+static int     init_enum( VC_CTX *, VAR_DESC const *);
+static int     init_string( VC_CTX *, VAR_DESC const *);
+static ErrCode init_var( VC_CTX *, VAR_DESC const *);
+static ErrCode reset_var( VC_CTX *, VAR_DESC const *);
 
 static ErrCode valid_enum( DESCR_ENUM const *, S16 );
-static ErrCode rw_min_max( HND hnd, U8* val, U16 chan, U16 flag );
+static ENUM_MBR const *enum_by_value( DESCR_ENUM const *, S16 );
+static ENUM_MBR const *enum_by_symbol( VC_CTX *, DESCR_ENUM const *, char const * );
+static ErrCode rw_many( VC_CTX *, HND const *, U16 const *, VC_VALUE *, ErrCode *, size_t, int, U16 );
+static ErrCode txn_limit( VC_CTX *, VC_TXN_ITEM * );
+static int     txn_store( VC_CTX *, VC_TXN_ITEM const * );
+static ErrCode rw_min_max( VC_CTX *ctx, HND hnd, U8* val, U16 chan, U16 flag );
+#ifdef VC_HAS_ATOMIC
+static ErrCode atomic_var( VC_CTX *, HND, U16, U16, int, U16, VAR_DESC const ** );
+#endif
+static ErrCode vec_check( VC_CTX *, HND, int, U16, U16, void const *, U16, VAR_DESC const ** );
+static ErrCode vec_write_s16( U16, S16 *, LIM_S16 const *, S16 *, U16, U32 * );
+static ErrCode vec_write_s32( U16, S32 *, LIM_S32 const *, S32 *, U16, U32 * );
+static ErrCode vec_write_f32( U16, F32 *, LIM_F32 const *, F32 *, U16, U32 * );
+static ErrCode vec_write_enum( DESCR_ENUM const *, DATA_ENUM *, S16 *, U16, U32 * );
+static void    var_changed( VC_CTX *, HND, U16, VC_VALUE const * );
+static void    var_written( VC_CTX *, HND, U16, VC_VALUE const *, int );
+static VC_DERIVE const *derive_find( VC_CTX *, HND );
+static F64     derive_input( VC_CTX *, HND, U16 );
+static F64     derive_eval( VC_CTX *, VC_DERIVE const *, U16 );
+static S64     derive_int( F64, S64, S64 );
+static void    derive_store( VC_CTX *, VAR_DESC const *, U16, F64 );
+static void    derive_update( VC_CTX *, VAR_DESC const *, HND, U16, U16 );
+static void    derive_stale( VC_CTX *, HND, U16 );
+static void    derive_stale_all( VC_CTX * );
+static VC_HIST const *hist_find( VC_CTX *, HND );
+static F32     hist_value( U16, VC_VALUE const * );
+static void    hist_push( VC_HIST_RING *, U32, VC_HIST_CELL *, U32, F32, F32, F32 );
+static void    hist_close( VC_HIST_RING *, VC_HIST_TIER const *, VC_HIST_CELL *, U32 );
+static U32     hist_now( VC_CTX *, VC_HIST const *, U16 );
+static void    hist_add( VC_CTX *, VC_HIST const *, U16, F32 );
+static ErrCode as_int16( VC_CTX *, HND, int, S16 *, U16, U16 );
+static ErrCode as_int32( VC_CTX *, HND, int, S32 *, U16, U16 );
+static ErrCode as_float( VC_CTX *, HND, int, F32 *, U16, U16 );
+static ErrCode as_int8( VC_CTX *, HND, int, S8 *, U16, U16 );
+static ErrCode as_int64( VC_CTX *, HND, int, S64 *, U16, U16 );
+static ErrCode as_double( VC_CTX *, HND, int, F64 *, U16, U16 );
+static ErrCode as_string( VC_CTX *, HND, int, char *, U16, U16 );
+static ErrCode read_vector( VC_CTX *, HND, U16, U16, void *, U16 );
+static ErrCode write_vector( VC_CTX *, HND, U16, U16, void *, U16 );
+static ErrCode reset_all( VC_CTX * );
+static HND     get_hnd( VC_CTX *, char const * );
+#ifdef STATS_CLOCK
+static U64     stats_now( void );
+#endif
+#ifdef VC_STATISTICS
+static U32     stats_shard( void );
+static void    stats_latency( int, U16, U64 );
+static void    stats_var( VC_CTX *, int, HND, int, ErrCode, U64 );
+static void    stats_items( VC_CTX *, HND const *, ErrCode const *, size_t, int );
+static void    stats_sum( VC_COUNT const *, size_t, U64 * );
+static void    stats_dump_hist( DUMP_OUT *, char const *, U64 const *, int );
+#endif
+static void    mark_dirty( VC_CTX *, HND );
+static U8     *var_image( VC_CTX *, VAR_DESC const *, U32 *, size_t * );
+static int     var_store( VAR_DESC const *, size_t * );
+static ErrCode flush_run( VC_CTX *, VC_BACKEND const *, HND, HND, U8 const *, U32, size_t );
+static VC_DIRTY *dirty_words( VC_CTX *, U16, U32 * );
+static U32     dirty_take( VC_DIRTY * );
+static ErrCode ring_push( VC_RING *, VC_EVENT const * );
+static void    out_flush( DUMP_OUT * );
+static void    out_mem( DUMP_OUT *, char const *, size_t );
+static void    out_str( DUMP_OUT *, char const * );
+static void    out_json_str( DUMP_OUT *, char const * );
+static void    dump_read( VC_CTX *, VAR_DESC const *, HND, U16, VC_VALUE *, char * );
+static void    dump_num( DUMP_OUT *, U16, U16, VC_VALUE const *, int );
+static void    dump_value( VC_CTX *, DUMP_OUT *, HND, VC_VALUE const *, char const *, int );
+static void    dump_one( VC_CTX *, DUMP_OUT *, HND, int );
 
 /* external variables
 ----------------------------------------------------------------------------*/
@@ -108,7 +300,36 @@ static ErrCode rw_min_max( HND hnd, U8* val, U16 chan, U16 flag );
 
 /* local defined variables
 ----------------------------------------------------------------------------*/
-VC_DATA const *s_vc_data;
+/* context of vc_init() and of all functions without a context */
+static VC_CTX s_vc_ctx;
+
+#ifdef VC_STATISTICS
+/* latency histograms of all contexts, see vc_stats_latency() */
+static VC_COUNT s_stats_lat[VC_STATS_SHARDS][VC_STAT_LAST][VC_STATS_BUCKETS];
+static VC_COUNT s_stats_type[VC_STATS_SHARDS][TYPE_LAST][VC_STATS_BUCKETS];
+
+# ifdef VC_THREAD_SAFE
+/* shard of a thread + 1, 0 until the first call */
+static _Thread_local U32 s_stats_shard;
+static VC_SEQ s_stats_next;
+# endif
+
+static char const *s_stat_str[VC_STAT_LAST] = {
+	"vc_as_int16",
+	"vc_as_int32",
+	"vc_as_float",
+	"vc_as_int8",
+	"vc_as_int64",
+	"vc_as_double",
+	"vc_as_string",
+	"vc_read_vector",
+	"vc_write_vector",
+	"vc_read_many",
+	"vc_write_many",
+	"vc_get_hnd",
+	"vc_reset"
+};
+#endif
 
 char const *s_type_str[] = {
 	"TYPE_INT8",
@@ -141,13 +362,13 @@ char const *s_format_str[] = {
 };
 
 char const *s_storage_str[] = {
-	"RAM_VLOATILE",
+	"RAM_VOLATILE",
 	"EEPROM",
 	"FLASH"
 };
 
-static VAR_DESC const* get_var( HND hnd ) {
-	return &s_vc_data->vars[hnd];
+static VAR_DESC const* get_var( VC_CTX *ctx, HND hnd ) {
+	return &ctx->data->vars[hnd];
 }
 
 
@@ -178,6 +399,11 @@ static inline ErrCode acc_allowed( VAR_DESC const *var, int rdwr, U16 req ) {
 		return kErrAccessDenied;
 	}
 
+	/* derived variables are computed only */
+	if( (rdwr == VarWrite) && (( var->type & TYPE_DERIVED ) != 0u )) {
+		return kErrAccessDenied;
+	}
+
 	U16 acc = var->acc_rights & MSK_ACC;
 	U16 match = acc & req;
 	if( match != (req & MSK_ACC)) {
@@ -186,6 +412,363 @@ static inline ErrCode acc_allowed( VAR_DESC const *var, int rdwr, U16 req ) {
 	return kErrNone;
 }
 
+/*** derive_fresh ***********************************************************/
+/**
+ *   Recompute the stale channels chan ... chan+cnt-1 of a derived
+ *   variable before they are read, see derive_update().
+ */
+static inline void derive_fresh( VC_CTX *ctx, VAR_DESC const *var, HND hnd, U16 chan, U16 cnt ) {
+	if(( var->type & TYPE_DERIVED ) != 0u ) {
+		derive_update( ctx, var, hnd, chan, cnt );
+	}
+}
+
+/*** limit_s16 **************************************************************/
+/**
+ *   Apply FLAG_LIMIT or FLAG_CLIP of a variable to a value.
+ *
+ *   FLAG_LIMIT rejects a value outside [min, max], FLAG_CLIP moves
+ *   the value into [min, max].
+ *
+ *   @param flags  acc_rights of the variable
+ *   @param lim    min and max
+ *   @param val    Pointer to value
+ *
+ *   @return kErrNone, when val may be written.
+ */
+static inline ErrCode limit_s16( U16 flags, LIM_S16 const *lim, S16 *val ) {
+	flags &= REQ_FLAG;
+	if(( flags & FLAG_LIMIT ) != 0u ) {
+		if( *val > lim->max ) {
+			return kErrUpperLimit;
+		}
+		else if ( *val < lim->min ) {
+			return kErrLowerLimit;
+		}
+		else {
+			; /* misra-c2012-15.7 */
+		}
+	}
+	else if (( flags & FLAG_CLIP ) != 0u ) {
+		if( *val > lim->max ) {
+			*val = lim->max;
+		}
+		else if ( *val < lim->min ) {
+			*val = lim->min;
+		}
+		else {
+			; /* misra-c2012-15.7 */
+		}
+	}
+	else {
+		; /* misra-c2012-15.7 */
+	}
+	return kErrNone;
+}
+
+/*** limit_s32 **************************************************************/
+/**
+ *   Apply FLAG_LIMIT or FLAG_CLIP of a variable to a value.
+ *   See limit_s16().
+ */
+static inline ErrCode limit_s32( U16 flags, LIM_S32 const *lim, S32 *val ) {
+	flags &= REQ_FLAG;
+	if(( flags & FLAG_LIMIT ) != 0u ) {
+		if( *val > lim->max ) {
+			return kErrUpperLimit;
+		}
+		else if ( *val < lim->min ) {
+			return kErrLowerLimit;
+		}
+		else {
+			; /* misra-c2012-15.7 */
+		}
+	}
+	else if (( flags & FLAG_CLIP ) != 0u ) {
+		if( *val > lim->max ) {
+			*val = lim->max;
+		}
+		else if ( *val < lim->min ) {
+			*val = lim->min;
+		}
+		else {
+			; /* misra-c2012-15.7 */
+		}
+	}
+	else {
+		; /* misra-c2012-15.7 */
+	}
+	return kErrNone;
+}
+
+/*** limit_f32 **************************************************************/
+/**
+ *   Apply FLAG_LIMIT or FLAG_CLIP of a variable to a value.
+ *   See limit_s16().
+ */
+static inline ErrCode limit_f32( U16 flags, LIM_F32 const *lim, F32 *val ) {
+	flags &= REQ_FLAG;
+	if(( flags & FLAG_LIMIT ) != 0u ) {
+		if( *val > lim->max ) {
+			return kErrUpperLimit;
+		}
+		else if ( *val < lim->min ) {
+			return kErrLowerLimit;
+		}
+		else {
+			; /* misra-c2012-15.7 */
+		}
+	}
+	else if (( flags & FLAG_CLIP ) != 0u ) {
+		if( *val > lim->max ) {
+			*val = lim->max;
+		}
+		else if ( *val < lim->min ) {
+			*val = lim->min;
+		}
+		else {
+			; /* misra-c2012-15.7 */
+		}
+	}
+	else {
+		; /* misra-c2012-15.7 */
+	}
+	return kErrNone;
+}
+
+/*** limit_s8 ***************************************************************/
+/**
+ *   Apply FLAG_LIMIT or FLAG_CLIP of a variable to a value.
+ *   See limit_s16().
+ */
+static inline ErrCode limit_s8( U16 flags, LIM_S8 const *lim, S8 *val ) {
+	flags &= REQ_FLAG;
+	if(( flags & FLAG_LIMIT ) != 0u ) {
+		if( *val > lim->max ) {
+			return kErrUpperLimit;
+		}
+		else if ( *val < lim->min ) {
+			return kErrLowerLimit;
+		}
+		else {
+			; /* misra-c2012-15.7 */
+		}
+	}
+	else if (( flags & FLAG_CLIP ) != 0u ) {
+		if( *val > lim->max ) {
+			*val = lim->max;
+		}
+		else if ( *val < lim->min ) {
+			*val = lim->min;
+		}
+		else {
+			; /* misra-c2012-15.7 */
+		}
+	}
+	else {
+		; /* misra-c2012-15.7 */
+	}
+	return kErrNone;
+}
+
+/*** limit_s64 **************************************************************/
+/**
+ *   Apply FLAG_LIMIT or FLAG_CLIP of a variable to a value.
+ *   See limit_s16().
+ */
+static inline ErrCode limit_s64( U16 flags, LIM_S64 const *lim, S64 *val ) {
+	flags &= REQ_FLAG;
+	if(( flags & FLAG_LIMIT ) != 0u ) {
+		if( *val > lim->max ) {
+			return kErrUpperLimit;
+		}
+		else if ( *val < lim->min ) {
+			return kErrLowerLimit;
+		}
+		else {
+			; /* misra-c2012-15.7 */
+		}
+	}
+	else if (( flags & FLAG_CLIP ) != 0u ) {
+		if( *val > lim->max ) {
+			*val = lim->max;
+		}
+		else if ( *val < lim->min ) {
+			*val = lim->min;
+		}
+		else {
+			; /* misra-c2012-15.7 */
+		}
+	}
+	else {
+		; /* misra-c2012-15.7 */
+	}
+	return kErrNone;
+}
+
+/*** limit_f64 **************************************************************/
+/**
+ *   Apply FLAG_LIMIT or FLAG_CLIP of a variable to a value.
+ *   See limit_s16().
+ */
+static inline ErrCode limit_f64( U16 flags, LIM_F64 const *lim, F64 *val ) {
+	flags &= REQ_FLAG;
+	if(( flags & FLAG_LIMIT ) != 0u ) {
+		if( *val > lim->max ) {
+			return kErrUpperLimit;
+		}
+		else if ( *val < lim->min ) {
+			return kErrLowerLimit;
+		}
+		else {
+			; /* misra-c2012-15.7 */
+		}
+	}
+	else if (( flags & FLAG_CLIP ) != 0u ) {
+		if( *val > lim->max ) {
+			*val = lim->max;
+		}
+		else if ( *val < lim->min ) {
+			*val = lim->min;
+		}
+		else {
+			; /* misra-c2012-15.7 */
+		}
+	}
+	else {
+		; /* misra-c2012-15.7 */
+	}
+	return kErrNone;
+}
+
+#ifdef VC_THREAD_SAFE
+/*** seq_read_begin *********************************************************/
+/**
+ *   Start reading a variable. Waits while a writer is active.
+ *
+ *   @param hnd    Variable handle
+ *
+ *   @return sequence number, to be passed to seq_read_retry().
+ */
+static inline U32 seq_read_begin( VC_CTX *ctx, HND hnd ) {
+	VC_SEQ *seq = &ctx->data->seq[hnd];
+	U32 s;
+
+	s = atomic_load_explicit( seq, memory_order_acquire );
+	while(( s & 1u ) != 0u ) {
+		s = atomic_load_explicit( seq, memory_order_acquire );
+	}
+	return s;
+}
+
+/*** seq_read_retry *********************************************************/
+/**
+ *   Finish reading a variable.
+ *
+ *   @param hnd    Variable handle
+ *   @param s      sequence number from seq_read_begin()
+ *
+ *   @return 1, when a writer changed the variable and the read
+ *           has to be repeated.
+ */
+static inline int seq_read_retry( VC_CTX *ctx, HND hnd, U32 s ) {
+	atomic_thread_fence( memory_order_acquire );
+	return ( atomic_load_explicit( &ctx->data->seq[hnd], memory_order_relaxed ) != s ) ? 1 : 0;
+}
+
+/*** seq_write_begin ********************************************************/
+/**
+ *   Start writing a variable. The sequence number becomes odd,
+ *   concurrent writers of the same variable wait.
+ *
+ *   @param hnd    Variable handle
+ */
+static inline void seq_write_begin( VC_CTX *ctx, HND hnd ) {
+	VC_SEQ *seq = &ctx->data->seq[hnd];
+	U32 s = atomic_load_explicit( seq, memory_order_relaxed );
+
+	for( ;; ) {
+		if(( s & 1u ) != 0u ) {
+			s = atomic_load_explicit( seq, memory_order_relaxed );
+		}
+		else if( atomic_compare_exchange_weak_explicit( seq, &s, s + 1u,
+		                                                memory_order_acquire,
+		                                                memory_order_relaxed )) {
+			break;
+		}
+		else {
+			; /* misra-c2012-15.7 */
+		}
+	}
+	atomic_thread_fence( memory_order_release );
+}
+
+/*** seq_write_end **********************************************************/
+/**
+ *   Finish writing a variable. The sequence number becomes even.
+ *
+ *   @param hnd    Variable handle
+ */
+static inline void seq_write_end( VC_CTX *ctx, HND hnd ) {
+	(void) atomic_fetch_add_explicit( &ctx->data->seq[hnd], 1u, memory_order_release );
+}
+#else
+static inline U32 seq_read_begin( VC_CTX *ctx, HND hnd ) {
+	UNUSED_PARAM( ctx );
+	UNUSED_PARAM( hnd );
+	return 0u;
+}
+
+static inline int seq_read_retry( VC_CTX *ctx, HND hnd, U32 s ) {
+	UNUSED_PARAM( ctx );
+	UNUSED_PARAM( hnd );
+	UNUSED_PARAM( s );
+	return 0;
+}
+
+static inline void seq_write_begin( VC_CTX *ctx, HND hnd ) {
+	UNUSED_PARAM( ctx );
+	UNUSED_PARAM( hnd );
+}
+
+static inline void seq_write_end( VC_CTX *ctx, HND hnd ) {
+	UNUSED_PARAM( ctx );
+	UNUSED_PARAM( hnd );
+}
+#endif
+
+#ifdef VC_THREAD_SAFE
+/*** hist_lock **************************************************************/
+/**
+ *   Lock the ring of a history against other writers and readers.
+ */
+static inline void hist_lock( VC_HIST_RING *ring ) {
+	U32 expected = 0u;
+
+	while( !atomic_compare_exchange_weak_explicit( &ring->lock, &expected, 1u,
+	                                               memory_order_acquire,
+	                                               memory_order_relaxed )) {
+		expected = 0u;
+	}
+}
+
+/*** hist_unlock ************************************************************/
+/**
+ *   Unlock the ring of a history.
+ */
+static inline void hist_unlock( VC_HIST_RING *ring ) {
+	atomic_store_explicit( &ring->lock, 0u, memory_order_release );
+}
+#else
+static inline void hist_lock( VC_HIST_RING *ring ) {
+	UNUSED_PARAM( ring );
+}
+
+static inline void hist_unlock( VC_HIST_RING *ring ) {
+	UNUSED_PARAM( ring );
+}
+#endif
+
 static inline char const* type2str( U16 n ) {
 	if( n >= TYPE_LAST ) {
 		return "UNKNOWN";
@@ -203,150 +786,475 @@ static inline char const* format2str( U16 n ) {
 
 static inline char const* storage2str( U16 n ) {
 	U16 storage = n & MSK_STORAGE;
-	if( storage >= FLASH ) {
+	if( storage > FLASH ) {
 		return "UNKNOWN";
 	}
 	storage >>= 8u;
 	return s_storage_str[storage];
 }
 
-static inline char const *get_scpi( HND hnd ) {
+static inline char const *get_scpi( VC_CTX *ctx, HND hnd ) {
 	VAR_DESC const *var;
 
-	var = get_var( hnd );
+	var = get_var( ctx, hnd );
 	if( !var ) {
 		return 0;
 	}
-	return (var->scpi_idx == HNON) ? "---" : &s_vc_data->data_const_str[var->scpi_idx];
+	return (var->scpi_idx == HNON) ? "---" : &ctx->data->data_const_str[var->scpi_idx];
 }
 
-static inline DESCR_ENUM const *get_enum_dscr( HND hnd ) {
+static inline DESCR_ENUM const *get_enum_dscr( VC_CTX *ctx, HND hnd ) {
 	VAR_DESC const *var;
 
-	var = get_var( hnd );
+	var = get_var( ctx, hnd );
 	if( !var ) {
 		return 0;
 	}
 	/* cppcheck-suppress misra-c2012-11.3 */
-	return (DESCR_ENUM const *)&s_vc_data->data_mbr[var->descr_idx];
+	return (DESCR_ENUM const *)&ctx->data->data_mbr[var->descr_idx];
 }
 
-/*** vc_init ****************************************************************/
+/*** store_size *************************************************************/
 /**
+ *   Size of one of the arrays with the values of a table.
  *
+ *   @param vc     Variable table
+ *   @param i      kStoreS16 ... kStoreHistCell
+ */
+static size_t store_size( VC_DATA const *vc, int i ) {
+	size_t size = 0;
+
+	switch( i ) {
+		case kStoreS16:  size = sizeof(S16) * vc->data_s16_cnt; break;
+		case kStoreS32:  size = sizeof(S32) * vc->data_s32_cnt; break;
+		case kStoreF32:  size = sizeof(F32) * vc->data_f32_cnt; break;
+		case kStoreF64:  size = sizeof(F64) * vc->data_f64_cnt; break;
+		case kStoreS8:   size = sizeof(S8) * vc->data_s8_cnt; break;
+		case kStoreS64:  size = sizeof(S64) * vc->data_s64_cnt; break;
+		case kStoreEnum: size = sizeof(S16) * vc->data_enum_cnt; break;
+		case kStoreStr:  size = sizeof(STRBUF) * vc->data_str_cnt; break;
+		case kStoreLimS16: size = sizeof(LIM_S16) * vc->data_s16_cnt; break;
+		case kStoreLimS32: size = sizeof(LIM_S32) * vc->data_s32_cnt; break;
+		case kStoreLimF32: size = sizeof(LIM_F32) * vc->data_f32_cnt; break;
+		case kStoreLimF64: size = sizeof(LIM_F64) * vc->data_f64_cnt; break;
+		case kStoreLimS8:  size = sizeof(LIM_S8) * vc->data_s8_cnt; break;
+		case kStoreLimS64: size = sizeof(LIM_S64) * vc->data_s64_cnt; break;
+#ifdef VC_THREAD_SAFE
+		case kStoreSeq:  size = sizeof(VC_SEQ) * vc->var_cnt; break;
+#endif
+		case kStoreDirty: size = sizeof(VC_DIRTY) * VC_DIRTY_WORDS( vc->var_cnt ); break;
+		case kStoreStale: size = sizeof(VC_SEQ) * vc->stale_cnt; break;
+		case kStoreAction: size = sizeof(VC_ACTION_SLOT) * vc->action_cnt; break;
+		case kStoreHistRing: size = sizeof(VC_HIST_RING) * vc->hist_ring_cnt; break;
+		case kStoreHistCell: size = sizeof(VC_HIST_CELL) * vc->hist_cell_cnt; break;
+		default:
+			break;
+	}
+	return size;
+}
+
+/*** store_set **************************************************************/
+/**
+ *   Set the pointer to one of the arrays with the values of a table.
  *
+ *   @param vc     Variable table
+ *   @param i      kStoreS16 ... kStoreHistCell
+ *   @param p      Array
  */
-ErrCode vc_init( VC_DATA const *vc ) {
+static void store_set( VC_DATA *vc, int i, void *p ) {
+	switch( i ) {
+		case kStoreS16:  vc->data_s16  = (S16*) p; break;
+		case kStoreS32:  vc->data_s32  = (S32*) p; break;
+		case kStoreF32:  vc->data_f32  = (F32*) p; break;
+		case kStoreF64:  vc->data_f64  = (F64*) p; break;
+		case kStoreS8:   vc->data_s8   = (S8*) p; break;
+		case kStoreS64:  vc->data_s64  = (S64*) p; break;
+		case kStoreEnum: vc->data_enum = (S16*) p; break;
+		case kStoreStr:  vc->data_str  = (DATA_STRING*) p; break;
+		case kStoreLimS16: vc->lim_s16 = (LIM_S16*) p; break;
+		case kStoreLimS32: vc->lim_s32 = (LIM_S32*) p; break;
+		case kStoreLimF32: vc->lim_f32 = (LIM_F32*) p; break;
+		case kStoreLimF64: vc->lim_f64 = (LIM_F64*) p; break;
+		case kStoreLimS8:  vc->lim_s8  = (LIM_S8*) p; break;
+		case kStoreLimS64: vc->lim_s64 = (LIM_S64*) p; break;
+		case kStoreSeq:  vc->seq       = (VC_SEQ*) p; break;
+		case kStoreDirty: vc->dirty    = (VC_DIRTY*) p; break;
+		case kStoreStale: vc->stale    = (VC_SEQ*) p; break;
+		case kStoreAction: vc->action  = (VC_ACTION_SLOT*) p; break;
+		case kStoreHistRing: vc->hist_ring = (VC_HIST_RING*) p; break;
+		case kStoreHistCell: vc->hist_cell = (VC_HIST_CELL*) p; break;
+		default:
+			break;
+	}
+}
 
-	s_vc_data = vc;
-	
-	return vc_reset();
+/*** store_get **************************************************************/
+/**
+ *   Get one of the arrays with the values of a table.
+ *
+ *   @param vc     Variable table
+ *   @param i      kStoreS16 ... kStoreHistCell
+ */
+static void *store_get( VC_DATA const *vc, int i ) {
+	void *p = NULL;
+
+	switch( i ) {
+		case kStoreS16:  p = vc->data_s16; break;
+		case kStoreS32:  p = vc->data_s32; break;
+		case kStoreF32:  p = vc->data_f32; break;
+		case kStoreF64:  p = vc->data_f64; break;
+		case kStoreS8:   p = vc->data_s8; break;
+		case kStoreS64:  p = vc->data_s64; break;
+		case kStoreEnum: p = vc->data_enum; break;
+		case kStoreStr:  p = vc->data_str; break;
+		case kStoreLimS16: p = vc->lim_s16; break;
+		case kStoreLimS32: p = vc->lim_s32; break;
+		case kStoreLimF32: p = vc->lim_f32; break;
+		case kStoreLimF64: p = vc->lim_f64; break;
+		case kStoreLimS8:  p = vc->lim_s8; break;
+		case kStoreLimS64: p = vc->lim_s64; break;
+		case kStoreSeq:  p = vc->seq; break;
+		case kStoreDirty: p = vc->dirty; break;
+		case kStoreStale: p = vc->stale; break;
+		case kStoreAction: p = vc->action; break;
+		case kStoreHistRing: p = vc->hist_ring; break;
+		case kStoreHistCell: p = vc->hist_cell; break;
+		default:
+			break;
+	}
+	return p;
 }
 
-ErrCode vc_reset() {
+/*** store_dflt *************************************************************/
+/**
+ *   Get the defaults image of one of the value or limit arrays.
+ *
+ *   @param vc     Variable table
+ *   @param i      kStoreS16 ... kStoreLimS64
+ *
+ *   @return NULL, when the table has no image.
+ */
+static void const *store_dflt( VC_DATA const *vc, int i ) {
+	void const *p = NULL;
+
+	switch( i ) {
+		case kStoreS16:  p = vc->dflt_s16; break;
+		case kStoreS32:  p = vc->dflt_s32; break;
+		case kStoreF32:  p = vc->dflt_f32; break;
+		case kStoreF64:  p = vc->dflt_f64; break;
+		case kStoreS8:   p = vc->dflt_s8; break;
+		case kStoreS64:  p = vc->dflt_s64; break;
+		case kStoreEnum: p = vc->dflt_enum; break;
+		case kStoreStr:  p = vc->dflt_str; break;
+		case kStoreLimS16: p = vc->dflt_lim_s16; break;
+		case kStoreLimS32: p = vc->dflt_lim_s32; break;
+		case kStoreLimF32: p = vc->dflt_lim_f32; break;
+		case kStoreLimF64: p = vc->dflt_lim_f64; break;
+		case kStoreLimS8:  p = vc->dflt_lim_s8; break;
+		case kStoreLimS64: p = vc->dflt_lim_s64; break;
+		default:
+			break;
+	}
+	return p;
+}
 
-	assert( s_vc_data );
-	HND     var_cnt = s_vc_data->var_cnt;
-	ErrCode E       = kErrNone;
+/*** layout_hash ************************************************************/
+/**
+ *   Hash of the layout of the value arrays. A snapshot can only be
+ *   restored into a table with the same layout.
+ *
+ *   @param vc     Variable table
+ */
+static U32 layout_hash( VC_DATA const *vc ) {
+	U32 h = VC_HASH_FNV_BASIS;
 
-	for( HND hVar = 0; (E == kErrNone) && (hVar < var_cnt); hVar++ ) {
-		VAR_DESC const *var  = get_var(hVar);
-		U16             type = var->type & TYPE_MASK;
-		
-		switch( type ) {
-			case TYPE_INT16:
-				E = init_s16( var );
-				break;
+	h = vc_hash_u32( h, vc->var_cnt );
+	for( int i = 0; i < kStoreSeq; i++ ) {
+		h = vc_hash_u32( h, (U32) store_size( vc, i ));
+	}
+	for( HND i = 0; i < vc->var_cnt; i++ ) {
+		VAR_DESC const *var = &vc->vars[i];
+		h = vc_hash_u32( h, ((U32) var->type << 16) | var->vec_items );
+		h = vc_hash_u32( h, var->data_idx );
+	}
+	return h;
+}
 
-			case TYPE_INT32:
-				E = init_s32( var );
-				break;
+/*** store_align ************************************************************/
+/**
+ *   Align an offset in the storage of a context.
+ */
+static inline size_t store_align( size_t n ) {
+	return ( n + sizeof(F64) - 1u ) & ~( sizeof(F64) - 1u );
+}
 
-			case TYPE_ENUM:
-				E = init_enum( var );
-				break;
+/*** vc_ctx_init ************************************************************/
+/**
+ *   Initialize a context with the variable table generated by varpp.
+ *   All variables get their default values.
+ *
+ *   The context uses the storage of the table, ie. the g_data_*
+ *   arrays. Use vc_ctx_init_storage() for more than one context
+ *   of the same table.
+ *
+ *   @param ctx    Context
+ *   @param vc     Variable table
+ */
+ErrCode vc_ctx_init( VC_CTX *ctx, VC_DATA const *vc ) {
 
-			case TYPE_FLOAT:
-				E = init_f32( var );
-				break;
+	assert( ctx );
+	ctx->data = vc;
+#ifdef VC_THREAD_SAFE
+	assert( ctx->data->seq );
+#endif
+	ctx->layout = layout_hash( vc );
 
-			case TYPE_DOUBLE:
-				E = init_f64( var );
-				break;
+	if( vc->dirty != NULL ) {
+		for( U32 i = 0; i < VC_DIRTY_WORDS( vc->var_cnt ); i++ ) {
+			SEQ_STORE( &vc->dirty[i], 0u, relaxed );
+		}
+	}
 
-			case TYPE_STRING:
-				E = init_string( var );
-				break;
+	for( int i = 0; i < VC_MAX_SUB; i++ ) {
+		SEQ_STORE( &ctx->sub[i].active, 0u, relaxed );
+	}
+	SEQ_STORE( &ctx->sub_cnt, 0u, relaxed );
 
-			case TYPE_ACTION:
-				break;
+	if( vc->action != NULL ) {
+		(void) memset( vc->action, 0, sizeof(VC_ACTION_SLOT) * vc->action_cnt );
+	}
 
-			default:
-				LOG_UNH_CASE( type );
-				break;
+	ctx->clock     = NULL;
+	ctx->clock_arg = NULL;
+	if( vc->hist_ring != NULL ) {
+		(void) memset( vc->hist_ring, 0, sizeof(VC_HIST_RING) * vc->hist_ring_cnt );
+	}
+	
+	return vc_ctx_reset( ctx );
+}
+
+/*** vc_ctx_storage_size ****************************************************/
+/**
+ *   Size of the storage for vc_ctx_init_storage().
+ *
+ *   @param vc     Variable table
+ */
+size_t vc_ctx_storage_size( VC_DATA const *vc ) {
+	size_t size = 0;
+
+	assert( vc );
+
+	for( int i = 0; i < kStoreLast; i++ ) {
+		size = store_align( size );
+		size += store_size( vc, i );
+	}
+	return size;
+}
+
+/*** vc_ctx_init_storage ****************************************************/
+/**
+ *   Initialize a context with its own storage.
+ *
+ *   The context uses the descriptors, SCPI strings and enums of the
+ *   table, but the values are kept in storage. This way many
+ *   instances of one table can be used, eg. to simulate devices.
+ *
+ *   @param ctx      Context
+ *   @param vc       Variable table
+ *   @param storage  Storage, at least vc_ctx_storage_size() bytes,
+ *                   aligned for double
+ *   @param size     Size of storage
+ */
+ErrCode vc_ctx_init_storage( VC_CTX *ctx, VC_DATA const *vc, void *storage, size_t size ) {
+	U8 *p = (U8*) storage;
+	size_t ofs = 0;
+
+	assert( ctx );
+	assert( vc );
+
+	if(( NULL == storage ) || ( size < vc_ctx_storage_size( vc ))) {
+		return kErrInvalidArg;
+	}
+
+	(void) memcpy( &ctx->own, vc, sizeof(VC_DATA));
+	(void) memset( storage, 0, size );
+
+	for( int i = 0; i < kStoreLast; i++ ) {
+		ofs = store_align( ofs );
+		store_set( &ctx->own, i, ( store_size( vc, i ) > 0u ) ? &p[ofs] : NULL );
+		ofs += store_size( vc, i );
+	}
+
+	return vc_ctx_init( ctx, &ctx->own );
+}
+
+/*** vc_ctx_reset ***********************************************************/
+/**
+ *   Set all variables to their default values.
+ *   The non-volatile variables are marked dirty, see vc_ctx_flush().
+ *
+ *   Tables generated by varpp have a defaults image of each value and
+ *   limit array, these are copied with one memcpy per array. Other
+ *   tables are initialized variable by variable from the descriptors.
+ *
+ *   @param ctx    Context
+ */
+ErrCode vc_ctx_reset( VC_CTX *ctx ) {
+	ErrCode ret;
+
+	STATS_TIME( VC_STAT_RESET, ret = reset_all( ctx ));
+	return ret;
+}
+
+/*** reset_all **************************************************************/
+/**
+ *   See vc_ctx_reset().
+ */
+static ErrCode reset_all( VC_CTX *ctx ) {
+
+	assert( ctx->data );
+	VC_DATA const *vc      = ctx->data;
+	HND            var_cnt = vc->var_cnt;
+	ErrCode        E       = kErrNone;
+
+	if( NULL == vc->dflt_s16 ) {
+		for( HND hVar = 0; (E == kErrNone) && (hVar < var_cnt); hVar++ ) {
+			seq_write_begin( ctx, hVar );
+			E = init_var( ctx, get_var( ctx, hVar ));
+			seq_write_end( ctx, hVar );
+			mark_dirty( ctx, hVar );
+		}
+		derive_stale_all( ctx );
+		return E;
+	}
+
+	for( HND hVar = 0; hVar < var_cnt; hVar++ ) {
+		seq_write_begin( ctx, hVar );
+	}
+	for( int i = 0; i < kStoreSeq; i++ ) {
+		void       *data = store_get( vc, i );
+		void const *dflt = store_dflt( vc, i );
+		size_t      size = store_size( vc, i );
+
+		if(( size > 0u ) && ( data != NULL ) && ( dflt != NULL )) {
+			(void) memcpy( data, dflt, size );
+		}
+	}
+	for( HND hVar = 0; hVar < var_cnt; hVar++ ) {
+		seq_write_end( ctx, hVar );
+		mark_dirty( ctx, hVar );
+	}
+	derive_stale_all( ctx );
+
+	return E;
+}
+
+/*** vc_ctx_reset_storage ***************************************************/
+/**
+ *   Set the variables of one storage class to their default values,
+ *   eg. the RAM_VOLATILE ones after a soft restart. See vc_ctx_reset().
+ *
+ *   @param ctx      Context
+ *   @param storage  RAM_VOLATILE, EEPROM or FLASH
+ */
+ErrCode vc_ctx_reset_storage( VC_CTX *ctx, U16 storage ) {
+
+	assert( ctx->data );
+	HND     var_cnt = ctx->data->var_cnt;
+	ErrCode E       = kErrNone;
+
+	if(( storage != RAM_VOLATILE ) && ( storage != EEPROM ) && ( storage != FLASH )) {
+		return kErrInvalidArg;
+	}
+
+	for( HND hVar = 0; (E == kErrNone) && (hVar < var_cnt); hVar++ ) {
+		VAR_DESC const *var = get_var( ctx, hVar );
+
+		if(( var->type & MSK_STORAGE ) != storage ) {
+			continue;
 		}
+		seq_write_begin( ctx, hVar );
+		E = reset_var( ctx, var );
+		seq_write_end( ctx, hVar );
+		mark_dirty( ctx, hVar );
 	}
+	derive_stale_all( ctx );
 
 	return E;
 }
 
-/*** vc_get_access ***************************************************/
+/*** vc_ctx_get_access ***********************************************/
 /**
  *   Return access rights from handle.
  * 
  *   @note:
  *   At the moment chan is not used.
  * 
+ *   @param ctx    Context
  *   @param hnd     Variable-handle
  *   @param chan    Channel
  */
-int vc_get_access( HND hnd, int chan ) {
+int vc_ctx_get_access( VC_CTX *ctx, HND hnd, int chan ) {
 	VAR_DESC const *var;
 	UNUSED_PARAM( chan );
 
-	assert( s_vc_data );
-	assert( hnd < s_vc_data->var_cnt );
+	assert( ctx->data );
+	assert( hnd < ctx->data->var_cnt );
 
-	var = get_var( hnd );
+	var = get_var( ctx, hnd );
 	return var->acc_rights;
 }
 
-/*** vc_get_datatype *************************************************/
+/*** vc_ctx_get_datatype *********************************************/
 /**
  *   Return datatype from handle.
  * 
+ *   @param ctx    Context
  *   @param hnd     Variable-handle
  */
-int vc_get_datatype( HND hnd ) {
+int vc_ctx_get_datatype( VC_CTX *ctx, HND hnd ) {
 	VAR_DESC const *var;
 
-	assert( s_vc_data );
-	assert( hnd < s_vc_data->var_cnt );
+	assert( ctx->data );
+	assert( hnd < ctx->data->var_cnt );
 
-	var = get_var( hnd );
+	var = get_var( ctx, hnd );
 	return var->type;
 }
 
-/*** vc_as_int16 *****************************************************/
+/*** vc_ctx_as_int16 *************************************************/
 /**
  *   Read or write a variable of TYPE_INT16 and TYPE_ENUM
  *
+ *   @param ctx    Context
  *   @param hnd    Variable handle
  *   @param rdwr   Read/Write access
  *   @param val    Pointer to value
  *   @param chan   Channel
  *   @param req    Request source
  */
-ErrCode vc_as_int16( HND hnd, int rdwr, S16 *val, U16 chan, U16 req ) {
+ErrCode vc_ctx_as_int16( VC_CTX *ctx, HND hnd, int rdwr, S16 *val, U16 chan, U16 req ) {
+	ErrCode ret;
+
+	STATS_VAR( ctx, VC_STAT_AS_INT16, hnd, rdwr, ret, as_int16( ctx, hnd, rdwr, val, chan, req ));
+	return ret;
+}
+
+/*** as_int16 ***************************************************************/
+/**
+ *   See vc_ctx_as_int16().
+ */
+static ErrCode as_int16( VC_CTX *ctx, HND hnd, int rdwr, S16 *val, U16 chan, U16 req ) {
 	ErrCode ret = kErrNone;
 	VAR_DESC const *var;
-	DATA_S16 *data;
-	DATA_ENUM *data_enum;
+	S16 *data = NULL;
+	DATA_ENUM *data_enum = NULL;
 	U16 type;
+	int changed = 0;
 
-	assert( s_vc_data );
+	assert( ctx->data );
 	
-	if( hnd >= s_vc_data->var_cnt ) {
+	if( hnd >= ctx->data->var_cnt ) {
 		return kErrUnknownCmd;
 	}
 
@@ -354,16 +1262,16 @@ ErrCode vc_as_int16( HND hnd, int rdwr, S16 *val, U16 chan, U16 req ) {
 		return kErrInvalidArg;
 	}
 
-	var = get_var( hnd );
+	var = get_var( ctx, hnd );
 	type = var->type & TYPE_MASK;
 
 	switch( type ) {
 		case TYPE_INT16:
-			data = &s_vc_data->data_s16[var->data_idx + chan];
+			data = &ctx->data->data_s16[var->data_idx + chan];
 			break;
 
 		case TYPE_ENUM:
-			data_enum = &s_vc_data->data_enum[var->data_idx + chan];
+			data_enum = &ctx->data->data_enum[var->data_idx + chan];
 			break;
 
 		default:
@@ -383,71 +1291,73 @@ ErrCode vc_as_int16( HND hnd, int rdwr, S16 *val, U16 chan, U16 req ) {
 	}
 
 	if( rdwr == VarRead ) {
-		*val = (TYPE_INT16 == type) ? data->def_value : *data_enum;
+		U32 seq;
+		derive_fresh( ctx, var, hnd, chan, 1u );
+		do {
+			seq = seq_read_begin( ctx, hnd );
+			*val = (TYPE_INT16 == type) ? *data : *data_enum;
+		} while( seq_read_retry( ctx, hnd, seq ) != 0 );
 	}
 	else {
+		seq_write_begin( ctx, hnd );
 		if( TYPE_INT16 == type ) {
-			U16 flags = var->acc_rights & REQ_FLAG;
-			if( flags != 0u ) {
-				if(( flags & FLAG_LIMIT ) != 0u ) {
-					if( *val > data->max ) {
-						return kErrUpperLimit;
-					}
-					else if ( *val < data->min ) {
-						return kErrLowerLimit;
-					}
-					else {
-						; /* misra-c2012-15.7 */
-					}
-				}
-				else if (( flags & FLAG_CLIP ) != 0u ) {
-					if( *val > data->max ) {
-						*val = data->max;
-					}
-					else if ( *val < data->min ) {
-						*val = data->min;
-					}
-					else {
-						; /* misra-c2012-15.7 */
-					}
-				}
-				else {
-					; /* misra-c2012-15.7 */
-				}
+			ret = limit_s16( var->acc_rights, &ctx->data->lim_s16[var->data_idx + chan], val );
+			if( ret == kErrNone ) {
+				changed = ( *data != *val ) ? 1 : 0;
+				*data = *val;
 			}
-
-			data->def_value = *val;
 		}
 		else {
-			DESCR_ENUM const *dscr = get_enum_dscr( hnd );
+			DESCR_ENUM const *dscr = get_enum_dscr( ctx, hnd );
 			ret = valid_enum( dscr, *val );
 			if( ret == kErrNone ) {
+				changed = ( *data_enum != *val ) ? 1 : 0;
 				*data_enum = *val;
 			}
 		}
+		seq_write_end( ctx, hnd );
+
+		if( ret == kErrNone ) {
+			VC_VALUE v;
+			v.s16 = *val;
+			var_written( ctx, hnd, chan, &v, changed );
+		}
 	}
 	
 	return ret;
 }
 
-/*** vc_as_int32 ************************************************************/
+/*** vc_ctx_as_int32 ********************************************************/
 /**
  *   Read or write a variable of TYPE_INT32
  *
+ *   @param ctx    Context
  *   @param hnd    Variable handle
  *   @param rdwr   Read/Write access
  *   @param val    Pointer to value
  *   @param chan   Channel
  *   @param req    Request source
  */
-ErrCode vc_as_int32( HND hnd, int rdwr, S32 *val, U16 chan, U16 req ) {
+ErrCode vc_ctx_as_int32( VC_CTX *ctx, HND hnd, int rdwr, S32 *val, U16 chan, U16 req ) {
+	ErrCode ret;
+
+	STATS_VAR( ctx, VC_STAT_AS_INT32, hnd, rdwr, ret, as_int32( ctx, hnd, rdwr, val, chan, req ));
+	return ret;
+}
+
+/*** as_int32 ***************************************************************/
+/**
+ *   See vc_ctx_as_int32().
+ */
+static ErrCode as_int32( VC_CTX *ctx, HND hnd, int rdwr, S32 *val, U16 chan, U16 req ) {
 	ErrCode ret = kErrNone;
 	VAR_DESC const *var;
-	DATA_S32 *data;
+	S32 *data;
+	int changed = 0;
 
-	assert( s_vc_data );
+	assert( ctx->data );
 
-	if( hnd >= s_vc_data->var_cnt ) {
+	if( hnd >= ctx->data->var_cnt ) {
 		return kErrUnknownCmd;
 	}
 
@@ -455,8 +1365,8 @@ ErrCode vc_as_int32( HND hnd, int rdwr, S32 *val, U16 chan, U16 req ) {
 		return kErrInvalidArg;
 	}
 
-	var = get_var( hnd );
-	data = &s_vc_data->data_s32[var->data_idx + chan];
+	var = get_var( ctx, hnd );
+	data = &ctx->data->data_s32[var->data_idx + chan];
 
 	if((var->type & TYPE_MASK) != TYPE_INT32 ) {
 		return kErrInvalidType;
@@ -475,61 +1385,63 @@ ErrCode vc_as_int32( HND hnd, int rdwr, S32 *val, U16 chan, U16 req ) {
 	}
 
 	if( rdwr == VarRead ) {
-		*val = data->def_value;
+		U32 seq;
+		derive_fresh( ctx, var, hnd, chan, 1u );
+		do {
+			seq = seq_read_begin( ctx, hnd );
+			*val = *data;
+		} while( seq_read_retry( ctx, hnd, seq ) != 0 );
 	}
 	else {
-		U16 flags = var->acc_rights & REQ_FLAG;
-		if( flags != 0u ) {
-			if(( flags & FLAG_LIMIT ) != 0u ) {
-				if( *val > data->max ) {
-					return kErrUpperLimit;
-				}
-				else if ( *val < data->min ) {
-					return kErrLowerLimit;
-				}
-				else {
-					; /* misra-c2012-15.7 */
-				}
-			}
-			else if (( flags & FLAG_CLIP ) != 0u ) {
-				if( *val > data->max ) {
-					*val = data->max;
-				}
-				else if ( *val < data->min ) {
-					*val = data->min;
-				}
-				else {
-					; /* misra-c2012-15.7 */
-				}
-			}
-			else {
-				; /* misra-c2012-15.7 */
-			}
+		seq_write_begin( ctx, hnd );
+		ret = limit_s32( var->acc_rights, &ctx->data->lim_s32[var->data_idx + chan], val );
+		if( ret == kErrNone ) {
+			changed = ( *data != *val ) ? 1 : 0;
+			*data = *val;
+		}
+		seq_write_end( ctx, hnd );
+
+		if( ret == kErrNone ) {
+			VC_VALUE v;
+			v.s32 = *val;
+			var_written( ctx, hnd, chan, &v, changed );
 		}
-		data->def_value = *val;
 	}
 	
 	return ret;
 }
 
-/*** vc_as_float ************************************************************/
+/*** vc_ctx_as_float ********************************************************/
 /**
  *   Read or write a variable of TYPE_FLOAT
  *
+ *   @param ctx    Context
  *   @param hnd    Variable handle
  *   @param rdwr   Read/Write access
  *   @param val    Pointer to value
  *   @param chan   Channel
  *   @param req    Request source
  */
-ErrCode vc_as_float( HND hnd, int rdwr, F32 *val, U16 chan, U16 req ) {
+ErrCode vc_ctx_as_float( VC_CTX *ctx, HND hnd, int rdwr, F32 *val, U16 chan, U16 req ) {
+	ErrCode ret;
+
+	STATS_VAR( ctx, VC_STAT_AS_FLOAT, hnd, rdwr, ret, as_float( ctx, hnd, rdwr, val, chan, req ));
+	return ret;
+}
+
+/*** as_float ***************************************************************/
+/**
+ *   See vc_ctx_as_float().
+ */
+static ErrCode as_float( VC_CTX *ctx, HND hnd, int rdwr, F32 *val, U16 chan, U16 req ) {
 	ErrCode ret = kErrNone;
 	VAR_DESC const *var;
-	DATA_F32 *data;
+	F32 *data;
+	int changed = 0;
 
-	assert( s_vc_data );
+	assert( ctx->data );
 
-	if( hnd >= s_vc_data->var_cnt ) {
+	if( hnd >= ctx->data->var_cnt ) {
 		return kErrUnknownCmd;
 	}
 
@@ -537,8 +1449,8 @@ ErrCode vc_as_float( HND hnd, int rdwr, F32 *val, U16 chan, U16 req ) {
 		return kErrInvalidArg;
 	}
 
-	var = get_var( hnd );
-	data = &s_vc_data->data_f32[var->data_idx + chan];
+	var = get_var( ctx, hnd );
+	data = &ctx->data->data_f32[var->data_idx + chan];
 
 	if((var->type & TYPE_MASK) != TYPE_FLOAT ) {
 		return kErrInvalidType;
@@ -557,868 +1469,6364 @@ ErrCode vc_as_float( HND hnd, int rdwr, F32 *val, U16 chan, U16 req ) {
 	}
 
 	if( rdwr == VarRead ) {
-		*(F32 *)val = data->def_value;
+		U32 seq;
+		derive_fresh( ctx, var, hnd, chan, 1u );
+		do {
+			seq = seq_read_begin( ctx, hnd );
+			*val = *data;
+		} while( seq_read_retry( ctx, hnd, seq ) != 0 );
 	}
 	else {
-		U16 flags = var->acc_rights & REQ_FLAG;
-		if( flags != 0u ) {
-			if(( flags & FLAG_LIMIT ) != 0u ) {
-				if( *val > data->max ) {
-					return kErrUpperLimit;
-				}
-				else if ( *val < data->min ) {
-					return kErrLowerLimit;
-				}
-				else {
-					; /* misra-c2012-15.7 */
-				}
-			}
-			else if (( flags & FLAG_CLIP ) != 0u ) {
-				if( *val > data->max ) {
-					*val = data->max;
-				}
-				else if ( *val < data->min ) {
-					*val = data->min;
-				}
-				else {
-					; /* misra-c2012-15.7 */
-				}
-			}
-			else {
-					; /* misra-c2012-15.7 */
-			}
+		seq_write_begin( ctx, hnd );
+		ret = limit_f32( var->acc_rights, &ctx->data->lim_f32[var->data_idx + chan], val );
+		if( ret == kErrNone ) {
+			changed = ( *data != *val ) ? 1 : 0;
+			*data = *val;
+		}
+		seq_write_end( ctx, hnd );
+
+		if( ret == kErrNone ) {
+			VC_VALUE v;
+			v.f32 = *val;
+			var_written( ctx, hnd, chan, &v, changed );
 		}
-		data->def_value = *val;
 	}
 	
 	return ret;
 }
 
-
-/*** vc_as_string ***********************************************************/
+/*** vc_ctx_as_int8 *********************************************************/
 /**
- *   Read or write a variable of any type.
- * 
- *   VarWrite:
- *   - The data is converted to the underlying data type with
- *     one of the functions strtol, strtof, strtod
- * 
- *   VarRead:
- *   - The data is converted to a string.
+ *   Read or write a variable of TYPE_INT8
  *
+ *   @param ctx    Context
  *   @param hnd    Variable handle
  *   @param rdwr   Read/Write access
  *   @param val    Pointer to value
  *   @param chan   Channel
  *   @param req    Request source
  */
-ErrCode vc_as_string( HND hnd, int rdwr, char *val, U16 chan, U16 req ) {
+ErrCode vc_ctx_as_int8( VC_CTX *ctx, HND hnd, int rdwr, S8 *val, U16 chan, U16 req ) {
+	ErrCode ret;
+
+	STATS_VAR( ctx, VC_STAT_AS_INT8, hnd, rdwr, ret, as_int8( ctx, hnd, rdwr, val, chan, req ));
+	return ret;
+}
+
+/*** as_int8 ****************************************************************/
+/**
+ *   See vc_ctx_as_int8().
+ */
+static ErrCode as_int8( VC_CTX *ctx, HND hnd, int rdwr, S8 *val, U16 chan, U16 req ) {
 	ErrCode ret = kErrNone;
 	VAR_DESC const *var;
-	U16 type;
-	U16 flags;
-	
-	assert( s_vc_data );
+	S8 *data;
+	int changed = 0;
+
+	assert( ctx->data );
 
-	if( hnd >= s_vc_data->var_cnt ) {
+	if( hnd >= ctx->data->var_cnt ) {
 		return kErrUnknownCmd;
 	}
-	
+
 	if( NULL == val ) {
 		return kErrInvalidArg;
 	}
 
-	var = get_var( hnd );
-	type = var->type & TYPE_MASK;
-	flags = var->type & TYPE_FLAG;
-	switch( type ) {
+	var = get_var( ctx, hnd );
+	data = &ctx->data->data_s8[var->data_idx + chan];
 
-		case TYPE_INT16:
-			if( rdwr == VarWrite ) {
-				S32 n;
-				S16 n16;
-				char *endp;
+	if((var->type & TYPE_MASK) != TYPE_INT8 ) {
+		return kErrInvalidType;
+	}
 
-				errno = 0;
-				n = strtol( (char*)val, &endp, 0 );
-				if(( errno != 0 ) || ((char*)val == endp ) || (*endp != '\0') ||
-				   ( n > SHRT_MAX ) || ( n < SHRT_MIN )) {
-					return kErrInvalidValue;
-				}
-				n16 = (S16) n;
-				ret = vc_as_int16( hnd, rdwr, &n16, chan, req );
-			}
-			else {
-				U16 n16 = 0;
-				char *p = val;
-				ret = vc_as_int16( hnd, rdwr, (S16*)&n16, chan, req );
-				if( ret == kErrNone ) {
-					switch( var->fmt ) {
+	ret = acc_allowed( var, rdwr, req );
+	if( ret != kErrNone ) {
+		return ret;
+	}
 
-						case FMT_HEX2:
-							(void) sprintf( p, "%#hx", n16 );
-							break;
+	if( chan > 0u ) {
+		ret = vc_chk_vector( var, chan );
+		if( ret != kErrNone ) {
+			return ret;
+		}
+	}
 
-						case FMT_HEX4:
-						  (void) sprintf( p, "%#hx", n16 );
-							break;
+	if( rdwr == VarRead ) {
+		U32 seq;
+		derive_fresh( ctx, var, hnd, chan, 1u );
+		do {
+			seq = seq_read_begin( ctx, hnd );
+			*val = *data;
+		} while( seq_read_retry( ctx, hnd, seq ) != 0 );
+	}
+	else {
+		seq_write_begin( ctx, hnd );
+		ret = limit_s8( var->acc_rights, &ctx->data->lim_s8[var->data_idx + chan], val );
+		if( ret == kErrNone ) {
+			changed = ( *data != *val ) ? 1 : 0;
+			*data = *val;
+		}
+		seq_write_end( ctx, hnd );
 
-						default:
-							(void) sprintf( p, "%d", n16 );
-							break;
-					}
-				}
-			}
-			break;
+		if( ret == kErrNone ) {
+			VC_VALUE v;
+			v.s8 = *val;
+			var_written( ctx, hnd, chan, &v, changed );
+		}
+	}
+	
+	return ret;
+}
 
-		case TYPE_INT32:
-			if( rdwr == VarWrite ) {
-				S32 n;
-				char *endp;
+/*** vc_ctx_as_int64 ********************************************************/
+/**
+ *   Read or write a variable of TYPE_INT64
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param rdwr   Read/Write access
+ *   @param val    Pointer to value
+ *   @param chan   Channel
+ *   @param req    Request source
+ */
+ErrCode vc_ctx_as_int64( VC_CTX *ctx, HND hnd, int rdwr, S64 *val, U16 chan, U16 req ) {
+	ErrCode ret;
 
-				errno = 0;
-				n = strtol( (char*)val, &endp, 0 );
-				if(( errno != 0 ) || ((char*)val == endp ) || ( *endp != '\0' )) {
-					return kErrInvalidValue;
-				}
-				ret = vc_as_int32( hnd, rdwr, &n, chan, req );
-			}
-			else {
-				S32 n = 0;
-				char *p = val;
-				ret = vc_as_int32( hnd, rdwr, &n, chan, req );
-				if( ret == kErrNone ) {
-					U16 n16 = 0;
-					U16 fmt = var->fmt;
-					if( n > 0xffff ) {
-						fmt = FMT_HEX8;
-					}
-					else {
-						n16 = (U16) n;
-					}
+	STATS_VAR( ctx, VC_STAT_AS_INT64, hnd, rdwr, ret, as_int64( ctx, hnd, rdwr, val, chan, req ));
+	return ret;
+}
 
-					switch( fmt ) {
+/*** as_int64 ***************************************************************/
+/**
+ *   See vc_ctx_as_int64().
+ */
+static ErrCode as_int64( VC_CTX *ctx, HND hnd, int rdwr, S64 *val, U16 chan, U16 req ) {
+	ErrCode ret = kErrNone;
+	VAR_DESC const *var;
+	S64 *data;
+	int changed = 0;
 
-						case FMT_HEX2:
-							(void) sprintf( p, "%#hx", n16 );
-							break;
+	assert( ctx->data );
 
-						case FMT_HEX4:
-							(void) sprintf( p, "%#hx", n16 );
-							break;
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
 
-						case FMT_HEX8:
-						  (void) sprintf( p, "%#x", n );
-							break;
+	if( NULL == val ) {
+		return kErrInvalidArg;
+	}
 
-						default:
-							(void) sprintf( p, "%d", n );
-							break;
-					}
-				}
-			}
-			break;
+	var = get_var( ctx, hnd );
+	data = &ctx->data->data_s64[var->data_idx + chan];
 
-		case TYPE_FLOAT:
-			if( rdwr == VarWrite ) {
-				F32 f;
-				char *endp;
+	if((var->type & TYPE_MASK) != TYPE_INT64 ) {
+		return kErrInvalidType;
+	}
 
-				errno = 0;
-				f = strtof( (char*)val, &endp );
-				if(( errno != 0 ) || ((char*)val == endp) || ( *endp != '\0' )) {
-					return kErrInvalidValue;
-				}
-				ret = vc_as_float( hnd, rdwr, &f, chan, req );
-			}
-			else {
-				F32 f;
-				char *p = val;
-				ret = vc_as_float( hnd, rdwr, &f, chan, req );
-				if( ret == kErrNone ) {
-
-					switch( var->fmt ) {
-
-						case FMT_PREC_1:
-						case FMT_PREC_2:
-						case FMT_PREC_3:
-						case FMT_PREC_4:
-						  (void) sprintf( p, "%.*f", var->fmt, f );
-							break;
-
-						default:
-							(void) sprintf( p, "%f", f );
-							break;
-					}
-					
-				}
-			}
-			break;
-
-		case TYPE_STRING:
-		{
-			if( chan > 0u ) {
-				ret = vc_chk_vector( var, chan );
-				if( ret != kErrNone ) {
-					return ret;
-				}
-			}
-
-			if(( flags & TYPE_CONST ) != 0 ) {
-
-				if( rdwr == VarWrite ) {
-					return kErrAccessDenied;
-				}
-
-				S32 idx = var->descr_idx;
-				DATA_STRING const *data = &s_vc_data->data_const_str[idx];
-				size_t len = strlen(data);
-				len = (len >= sizeof(STRBUF)) ? (sizeof(STRBUF) - 1u ) : len;
-				(void) memcpy( val, data, len );
-				val[len] = '\0';
-			}
-			else {
-				S32 idx = var->data_idx + (chan * sizeof(STRBUF));
-				S32 max_idx = sizeof(STRBUF) * s_vc_data->data_str_cnt;
-				if( idx > max_idx ) {
-					return kErrInvalidChan;
-				}
-				DATA_STRING *data = &s_vc_data->data_str[idx];
+	ret = acc_allowed( var, rdwr, req );
+	if( ret != kErrNone ) {
+		return ret;
+	}
 
-				if( rdwr == VarWrite ) {
-					size_t len = strlen( val );
-					if( len > sizeof(STRBUF)) {
-						return kErrSizeTooBig;
-					}
-					(void) memcpy( data, val, sizeof(STRBUF));
-				}
-				else {
-					(void) memcpy( val, data, sizeof(STRBUF));
-					val[sizeof(STRBUF)-1u] = '\0';
-				}
-			}
+	if( chan > 0u ) {
+		ret = vc_chk_vector( var, chan );
+		if( ret != kErrNone ) {
+			return ret;
 		}
-		break;
+	}
 
-		case TYPE_ENUM:
-			LOG_NOT_IMPL( "TYPE_ENUM" );
-			break;
+	if( rdwr == VarRead ) {
+		U32 seq;
+		derive_fresh( ctx, var, hnd, chan, 1u );
+		do {
+			seq = seq_read_begin( ctx, hnd );
+			*val = *data;
+		} while( seq_read_retry( ctx, hnd, seq ) != 0 );
+	}
+	else {
+		seq_write_begin( ctx, hnd );
+		ret = limit_s64( var->acc_rights, &ctx->data->lim_s64[var->data_idx + chan], val );
+		if( ret == kErrNone ) {
+			changed = ( *data != *val ) ? 1 : 0;
+			*data = *val;
+		}
+		seq_write_end( ctx, hnd );
 
-		default:
-			LOG_UNH_CASE( type );
-			break;
+		if( ret == kErrNone ) {
+			VC_VALUE v;
+			v.s64 = *val;
+			var_written( ctx, hnd, chan, &v, changed );
+		}
 	}
 	
 	return ret;
 }
 
-/*** vc_get_min ***********************************************************/
+/*** vc_ctx_as_double *******************************************************/
 /**
- *   Read minimum value of a variable of types:
- *      TYPE_INT16, TYPE_INT32, TYPE_F32.
+ *   Read or write a variable of TYPE_DOUBLE
  *
+ *   @param ctx    Context
  *   @param hnd    Variable handle
+ *   @param rdwr   Read/Write access
  *   @param val    Pointer to value
  *   @param chan   Channel
+ *   @param req    Request source
  */
-ErrCode vc_get_min( HND hnd, U8* val, U16 chan ) {
-	return rw_min_max( hnd, val, chan, 0 );
-}
+ErrCode vc_ctx_as_double( VC_CTX *ctx, HND hnd, int rdwr, F64 *val, U16 chan, U16 req ) {
+	ErrCode ret;
 
-/*** vc_get_max ***********************************************************/
-/**
- *   Read maximum value of a variable of types:
- *      TYPE_INT16, TYPE_INT32, TYPE_F32.
- *
- *   @param hnd    Variable handle
- *   @param val    Pointer to value
- *   @param chan   Channel
- */
-ErrCode vc_get_max( HND hnd, U8* val, U16 chan ) {
-	return rw_min_max( hnd, val, chan, 1 );
+	STATS_VAR( ctx, VC_STAT_AS_DOUBLE, hnd, rdwr, ret, as_double( ctx, hnd, rdwr, val, chan, req ));
+	return ret;
 }
 
-/*** vc_get_min ***********************************************************/
+/*** as_double **************************************************************/
 /**
- *   Read minimum value of a variable of types:
- *      TYPE_INT16, TYPE_INT32, TYPE_F32.
- *
- *   @param hnd    Variable handle
- *   @param val    Pointer to value
- *   @param chan   Channel
+ *   See vc_ctx_as_double().
  */
-ErrCode vc_set_min( HND hnd, U8* val, U16 chan ) {
-	return rw_min_max( hnd, val, chan, 2 );
+static ErrCode as_double( VC_CTX *ctx, HND hnd, int rdwr, F64 *val, U16 chan, U16 req ) {
+	ErrCode ret = kErrNone;
+	VAR_DESC const *var;
+	F64 *data;
+	int changed = 0;
+
+	assert( ctx->data );
+
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
+
+	if( NULL == val ) {
+		return kErrInvalidArg;
+	}
+
+	var = get_var( ctx, hnd );
+	data = &ctx->data->data_f64[var->data_idx + chan];
+
+	if((var->type & TYPE_MASK) != TYPE_DOUBLE ) {
+		return kErrInvalidType;
+	}
+
+	ret = acc_allowed( var, rdwr, req );
+	if( ret != kErrNone ) {
+		return ret;
+	}
+
+	if( chan > 0u ) {
+		ret = vc_chk_vector( var, chan );
+		if( ret != kErrNone ) {
+			return ret;
+		}
+	}
+
+	if( rdwr == VarRead ) {
+		U32 seq;
+		derive_fresh( ctx, var, hnd, chan, 1u );
+		do {
+			seq = seq_read_begin( ctx, hnd );
+			*val = *data;
+		} while( seq_read_retry( ctx, hnd, seq ) != 0 );
+	}
+	else {
+		seq_write_begin( ctx, hnd );
+		ret = limit_f64( var->acc_rights, &ctx->data->lim_f64[var->data_idx + chan], val );
+		if( ret == kErrNone ) {
+			changed = ( *data != *val ) ? 1 : 0;
+			*data = *val;
+		}
+		seq_write_end( ctx, hnd );
+
+		if( ret == kErrNone ) {
+			VC_VALUE v;
+			v.f64 = *val;
+			var_written( ctx, hnd, chan, &v, changed );
+		}
+	}
+	
+	return ret;
 }
 
-/*** vc_set_max ***********************************************************/
+/*** vc_ctx_read_vector **********************************************************/
 /**
- *   Write maximum value of a variable of types:
- *      TYPE_INT16, TYPE_INT32, TYPE_F32.
+ *   Read the channels chan ... chan+cnt-1 of a variable of
+ *   TYPE_INT16, TYPE_ENUM, TYPE_INT32 or TYPE_FLOAT.
+ *
+ *   Access rights and channels are checked once, all channels are
+ *   read consistently.
  *
+ *   @param ctx    Context
  *   @param hnd    Variable handle
- *   @param val    Pointer to value
- *   @param chan   Channel
+ *   @param chan   first channel
+ *   @param cnt    number of channels
+ *   @param val    cnt values of S16, S32 or F32, depending on the type
+ *   @param req    Request source
  */
-ErrCode vc_set_max( HND hnd, U8* val, U16 chan ) {
-	return rw_min_max( hnd, val, chan, 3 );
+ErrCode vc_ctx_read_vector( VC_CTX *ctx, HND hnd, U16 chan, U16 cnt, void *val, U16 req ) {
+	ErrCode ret;
+
+	STATS_VAR( ctx, VC_STAT_READ_VECTOR, hnd, VarRead, ret, read_vector( ctx, hnd, chan, cnt, val, req ));
+	return ret;
 }
 
-/*** vc_get_format ***************************************************/
+/*** read_vector ************************************************************/
 /**
- *   Get format of the variable
- *
- *   @param hnd    Variable handle
- *   @param fmt    Pointer to format
+ *   See vc_ctx_read_vector().
  */
-ErrCode vc_get_format( HND hnd, U16 *fmt ) {
+static ErrCode read_vector( VC_CTX *ctx, HND hnd, U16 chan, U16 cnt, void *val, U16 req ) {
+	ErrCode ret;
 	VAR_DESC const *var;
+	U32 seq;
 
-	assert( hnd < s_vc_data->var_cnt );
+	ret = vec_check( ctx, hnd, VarRead, chan, cnt, val, req, &var );
+	if( ret != kErrNone ) {
+		return ret;
+	}
 
-	var = get_var( hnd );
-	*(U16*)fmt = var->fmt;
+	derive_fresh( ctx, var, hnd, chan, cnt );
 
-	return kErrNone;
-}
+	switch( var->type & TYPE_MASK ) {
+		case TYPE_INT16: {
+			S16 const *data = &ctx->data->data_s16[var->data_idx + chan];
+			do {
+				seq = seq_read_begin( ctx, hnd );
+				(void) memcpy( val, data, cnt * sizeof(S16));
+			} while( seq_read_retry( ctx, hnd, seq ) != 0 );
+			break;
+		}
 
-/*** vc_get_storage *********************************************************/
-/**
- *   Get the storage modifier of the variable.
- *
- *   @param hnd    Variable handle
- *   @param store  Storage
- */
-ErrCode vc_get_storage( HND hnd, U16 *store ) {
-	VAR_DESC const *var;
+		case TYPE_ENUM: {
+			DATA_ENUM const *data = &ctx->data->data_enum[var->data_idx + chan];
+			do {
+				seq = seq_read_begin( ctx, hnd );
+				(void) memcpy( val, data, cnt * sizeof(DATA_ENUM));
+			} while( seq_read_retry( ctx, hnd, seq ) != 0 );
+			break;
+		}
 
-	assert( s_vc_data );
-	
-	if( hnd >= s_vc_data->var_cnt ) {
-		return kErrUnknownCmd;
-	}
+		case TYPE_INT32: {
+			S32 const *data = &ctx->data->data_s32[var->data_idx + chan];
+			do {
+				seq = seq_read_begin( ctx, hnd );
+				(void) memcpy( val, data, cnt * sizeof(S32));
+			} while( seq_read_retry( ctx, hnd, seq ) != 0 );
+			break;
+		}
 
-	if( NULL == store ) {
-		return kErrInvalidArg;
+		default: {
+			F32 const *data = &ctx->data->data_f32[var->data_idx + chan];
+			do {
+				seq = seq_read_begin( ctx, hnd );
+				(void) memcpy( val, data, cnt * sizeof(F32));
+			} while( seq_read_retry( ctx, hnd, seq ) != 0 );
+			break;
+		}
 	}
 
-	var = get_var( hnd );
-	*store = var->type & MSK_STORAGE;
-
 	return kErrNone;
 }
 
-/*** vc_get_hnd *************************************************************/
+/*** vc_ctx_write_vector *********************************************************/
 /**
- *   Get the storage modifier of the variable.
+ *   Write the channels chan ... chan+cnt-1 of a variable of
+ *   TYPE_INT16, TYPE_ENUM, TYPE_INT32 or TYPE_FLOAT.
  *
- *   @param scpi   SCPI string
+ *   Access rights and channels are checked once. FLAG_LIMIT rejects
+ *   the write if one value is outside [min, max], nothing is written
+ *   then. FLAG_CLIP clips the values in \b val, like vc_ctx_as_int16().
  *
- *   @return HNON, when scpi was not found.
+ *   All channels are written under one lock, readers see either none
+ *   or all of them. Subscribers are notified for every changed channel
+ *   after the write.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param chan   first channel
+ *   @param cnt    number of channels
+ *   @param val    cnt values of S16, S32 or F32, depending on the type
+ *   @param req    Request source
+ *
+ *   @return kErrSizeTooBig, when cnt is above VC_VEC_MAX.
  */
-HND vc_get_hnd( char const *scpi ) {
+ErrCode vc_ctx_write_vector( VC_CTX *ctx, HND hnd, U16 chan, U16 cnt, void *val, U16 req ) {
+	ErrCode ret;
 
-	for( HND i = 0; i < s_vc_data->var_cnt; i++ ) {
+	STATS_VAR( ctx, VC_STAT_WRITE_VECTOR, hnd, VarWrite, ret, write_vector( ctx, hnd, chan, cnt, val, req ));
+	return ret;
+}
 
-		char const *s = get_scpi( i );
+/*** write_vector ***********************************************************/
+/**
+ *   See vc_ctx_write_vector().
+ */
+static ErrCode write_vector( VC_CTX *ctx, HND hnd, U16 chan, U16 cnt, void *val, U16 req ) {
+	U32 changed[VC_VEC_MAX / 32u];
+	ErrCode ret;
+	VAR_DESC const *var;
+	U16 type;
+	U32 first;
+	int sample;
 
-		if( s != NULL ) {
-			int res = strcmp( scpi, s );
-			if( 0 == res ) {
-				return i;
-			}
-		}
+	ret = vec_check( ctx, hnd, VarWrite, chan, cnt, val, req, &var );
+	if( ret != kErrNone ) {
+		return ret;
 	}
+	if( cnt > VC_VEC_MAX ) {
+		return kErrSizeTooBig;
+	}
+	type  = var->type & TYPE_MASK;
+	first = (U32) var->data_idx + chan;
 
-	return HNON;
-}
+	/* vec_write_* check all values before they store any */
+	seq_write_begin( ctx, hnd );
+	switch( type ) {
+		case TYPE_INT16:
+			ret = vec_write_s16( var->acc_rights, &ctx->data->data_s16[first], &ctx->data->lim_s16[first],
+			                     (S16 *) val, cnt, changed );
+			break;
 
-static int add_sep( char *buf, int bufsz, char c, int len ) {
-	int n;
+		case TYPE_ENUM:
+			ret = vec_write_enum( get_enum_dscr( ctx, hnd ), &ctx->data->data_enum[first],
+			                      (S16 *) val, cnt, changed );
+			break;
 
-	assert( buf );
-	assert( len > 0 );
+		case TYPE_INT32:
+			ret = vec_write_s32( var->acc_rights, &ctx->data->data_s32[first], &ctx->data->lim_s32[first],
+			                     (S32 *) val, cnt, changed );
+			break;
 
-	n = (len > bufsz) ? bufsz : len;
-	(void) memset( buf, c, n );
+		default:
+			ret = vec_write_f32( var->acc_rights, &ctx->data->data_f32[first], &ctx->data->lim_f32[first],
+			                     (F32 *) val, cnt, changed );
+			break;
+	}
+	seq_write_end( ctx, hnd );
 
-	if(( n+2 ) < bufsz ) {
-		buf[n] = '\n'; n++;
-		buf[n] = '\0';
+	if( ret != kErrNone ) {
+		return ret;
 	}
-	return n;
 
-}
+	/* with a history every item is a sample, else only the changed ones */
+	sample = ( hist_find( ctx, hnd ) != NULL ) ? 1 : 0;
+	for( U16 k = 0; k < cnt; k++ ) {
+		int bit = (int)(( changed[k / 32u] >> ( k % 32u )) & 1u );
 
+		if(( bit != 0 ) || ( sample != 0 )) {
+			VC_VALUE v;
 
-/*** vc_dump_var ************************************************************/
+			switch( type ) {
+				case TYPE_INT16:
+				case TYPE_ENUM:  v.s16 = ((S16 *) val)[k]; break;
+				case TYPE_INT32: v.s32 = ((S32 *) val)[k]; break;
+				default:         v.f32 = ((F32 *) val)[k]; break;
+			}
+			var_written( ctx, hnd, chan + k, &v, bit );
+		}
+	}
+
+	return kErrNone;
+}
+
+/*** vc_ctx_as_string *******************************************************/
 /**
- *   Write the contents of the variable to a string buffer.
+ *   Read or write a variable of any type.
  * 
- *   This function is for introspection and debugging purposes.
+ *   VarWrite:
+ *   - The data is converted to the underlying data type with
+ *     vc_parse_s32(), vc_parse_s64(), vc_parse_f32() or vc_parse_f64().
+ * 
+ *   VarRead:
+ *   - The data is converted to a string with the format of the
+ *     variable, see vc_fmt_s32(), vc_fmt_s64(), vc_fmt_hex(),
+ *     vc_fmt_f32() and vc_fmt_f64().
  *
- *   @param buf    Pointer to atring buffer
- *   @param bufsz  Buffer size
+ *   @param ctx    Context
  *   @param hnd    Variable handle
+ *   @param rdwr   Read/Write access
+ *   @param val    Pointer to value
  *   @param chan   Channel
+ *   @param req    Request source
  */
-int vc_dump_var( char *buf, int bufsz, HND hnd, U16 chan ) {
-	#define CHECK_LEN( b, n, l, s ) do { \
-     if( ((n) < 0) || ((l)+(n)) >= (s) ) {  \
-			 (b)[(l)] = '\0'; \
-			 return (l); \
-		 } \
-	} while(0)
+ErrCode vc_ctx_as_string( VC_CTX *ctx, HND hnd, int rdwr, char *val, U16 chan, U16 req ) {
+	ErrCode ret;
 
+	STATS_VAR( ctx, VC_STAT_AS_STRING, hnd, rdwr, ret, as_string( ctx, hnd, rdwr, val, chan, req ));
+	return ret;
+}
 
+/*** as_string **************************************************************/
+/**
+ *   See vc_ctx_as_string().
+ */
+static ErrCode as_string( VC_CTX *ctx, HND hnd, int rdwr, char *val, U16 chan, U16 req ) {
+	ErrCode ret = kErrNone;
 	VAR_DESC const *var;
-	STRBUF spaces;
 	U16 type;
-	U16 storage;
-	int n;
-	int len = 0;
-	char const *scpi;
+	U16 flags;
+	
+	assert( ctx->data );
 
-	if( hnd >= s_vc_data->var_cnt ) {
+	if( hnd >= ctx->data->var_cnt ) {
 		return kErrUnknownCmd;
 	}
+	
+	if( NULL == val ) {
+		return kErrInvalidArg;
+	}
 
-	(void) memset( spaces, ' ', sizeof(STRBUF));
+	var = get_var( ctx, hnd );
+	type = var->type & TYPE_MASK;
+	flags = var->type & TYPE_FLAG;
+	switch( type ) {
 
-	var     = get_var( hnd );
-	type    = var->type & TYPE_MASK;
-	storage = (var->type & (U16)MSK_STORAGE) >> 8u;
-	scpi    = get_scpi( hnd );
+		case TYPE_INT16:
+			if( rdwr == VarWrite ) {
+				S32 n;
+				S16 n16;
 
-	n = add_sep( &buf[len], bufsz - len, '=', 50 );
-	CHECK_LEN( buf, n, len, bufsz );
-	len += n;
+				if(( vc_parse_s32( val, &n ) != kErrNone ) ||
+				   ( n > SHRT_MAX ) || ( n < SHRT_MIN )) {
+					return kErrInvalidValue;
+				}
+				n16 = (S16) n;
+				ret = as_int16( ctx, hnd, rdwr, &n16, chan, req );
+			}
+			else {
+				S16 n16 = 0;
+				char *p = val;
+				ret = as_int16( ctx, hnd, rdwr, &n16, chan, req );
+				if( ret == kErrNone ) {
+					switch( var->fmt ) {
 
-	n = snprintf( &buf[len], bufsz - len,
-		"SCPI:               %s\n"
-		"Hnd:                %#04X\n"
-		"Data type:          %s (%#04hX)\n"
-		"Items:              %d\n"
-		"Access:             %#04hX\n"
-		"Storage:            %s (%#04hX)\n"
-		"Format:             %s (%#04hX)\n"
-		"Descriptor Idx:     %d\n"
-		"Data Idx:           %d\n"
-		"Data\n"
-		,
-		scpi,
-		hnd,
-		type2str(type), var->type,
-		var->vec_items,
-		var->acc_rights,
-		storage2str(storage), storage,
-		format2str(var->fmt), var->fmt,
-		var->descr_idx,
-		var->data_idx
-	);
+						case FMT_HEX2:
+						case FMT_HEX4:
+							(void) vc_fmt_hex( p, (U16) n16 );
+							break;
 
-	CHECK_LEN( buf, n, len, bufsz );
-	len += n;
+						default:
+							(void) vc_fmt_s32( p, n16 );
+							break;
+					}
+				}
+			}
+			break;
 
-	n = add_sep( &buf[len], bufsz - len, '-', 50 );
-	CHECK_LEN( buf, n, len, bufsz );
-	len += n;
+		case TYPE_INT32:
+			if( rdwr == VarWrite ) {
+				S32 n;
 
-	switch( type ) {
-		case TYPE_INT16:
+				if( vc_parse_s32( val, &n ) != kErrNone ) {
+					return kErrInvalidValue;
+				}
+				ret = as_int32( ctx, hnd, rdwr, &n, chan, req );
+			}
+			else {
+				S32 n = 0;
+				char *p = val;
+				ret = as_int32( ctx, hnd, rdwr, &n, chan, req );
+				if( ret == kErrNone ) {
+					U16 n16 = 0;
+					U16 fmt = var->fmt;
+					if( n > 0xffff ) {
+						fmt = FMT_HEX8;
+					}
+					else {
+						n16 = (U16) n;
+					}
 
-		  n = snprintf( &buf[len], bufsz - len, "          val    min    max\n");
-			CHECK_LEN( buf, n, len, bufsz );
-			len += n;
+					switch( fmt ) {
 
-			if( var->vec_items == 1u ) {
-				n = snprintf( &buf[len], bufsz - len, "     ");
-				CHECK_LEN( buf, n, len, bufsz );
-				len += n;
-			}
+						case FMT_HEX2:
+						case FMT_HEX4:
+							(void) vc_fmt_hex( p, n16 );
+							break;
 
-			for( U16 i = 0; i < var->vec_items; i++ ) {
-				DATA_S16 *d = &s_vc_data->data_s16[var->data_idx + i];
+						case FMT_HEX8:
+							(void) vc_fmt_hex( p, (U32) n );
+							break;
 
-				if( var->vec_items > 1u ) {
-					n = snprintf( &buf[len], bufsz - len, " %3d:", i );
-					CHECK_LEN( buf, n, len, bufsz );
-					len += n;	
+						default:
+							(void) vc_fmt_s32( p, n );
+							break;
+					}
 				}
-				n = snprintf( &buf[len], bufsz - len, "  %6hd %6hd %6hd\n", d->def_value, d->min, d->max );
-				CHECK_LEN( buf, n, len, bufsz );
-				len += n;
 			}
 			break;
 
-		case TYPE_INT32:
+		case TYPE_FLOAT:
+			if( rdwr == VarWrite ) {
+				F32 f;
 
-		  n = snprintf( &buf[len], bufsz - len, "          val    min    max\n");
-			CHECK_LEN( buf, n, len, bufsz );
-			len += n;
+				if( vc_parse_f32( val, &f ) != kErrNone ) {
+					return kErrInvalidValue;
+				}
+				ret = as_float( ctx, hnd, rdwr, &f, chan, req );
+			}
+			else {
+				F32 f;
+				char *p = val;
+				ret = as_float( ctx, hnd, rdwr, &f, chan, req );
+				if( ret == kErrNone ) {
+					(void) vc_fmt_f32( p, f, var->fmt );
+				}
+			}
+			break;
 
-			if( var->vec_items == 1u ) {
-				n = snprintf( &buf[len], bufsz - len, "     ");
-				CHECK_LEN( buf, n, len, bufsz );
-				len += n;
+		case TYPE_INT8:
+			if( rdwr == VarWrite ) {
+				S32 n;
+				S8 n8;
+
+				if( vc_parse_s32( val, &n ) != kErrNone ) {
+					return kErrInvalidValue;
+				}
+				/* hex variables read back as 0x80..0xff */
+				if(( FMT_HEX2 == var->fmt ) && ( n > SCHAR_MAX ) && ( n <= UCHAR_MAX )) {
+					n -= UCHAR_MAX + 1;
+				}
+				if(( n > SCHAR_MAX ) || ( n < SCHAR_MIN )) {
+					return kErrInvalidValue;
+				}
+				n8 = (S8) n;
+				ret = as_int8( ctx, hnd, rdwr, &n8, chan, req );
+			}
+			else {
+				S8 n8 = 0;
+				ret = as_int8( ctx, hnd, rdwr, &n8, chan, req );
+				if( ret == kErrNone ) {
+					if( FMT_HEX2 == var->fmt ) {
+						(void) vc_fmt_hex( val, (U8) n8 );
+					}
+					else {
+						(void) vc_fmt_s32( val, n8 );
+					}
+				}
 			}
+			break;
 
-			for( U16 i = 0; i < var->vec_items; i++ ) {
-				DATA_S32 *d = &s_vc_data->data_s32[var->data_idx + i];
+		case TYPE_INT64:
+			if( rdwr == VarWrite ) {
+				S64 n;
 
-				if( var->vec_items > 1u ) {
-					n = snprintf( &buf[len], bufsz - len, " %3d:", i );
-					CHECK_LEN( buf, n, len, bufsz );
-					len += n;	
+				if( vc_parse_s64( val, &n ) != kErrNone ) {
+					return kErrInvalidValue;
+				}
+				ret = as_int64( ctx, hnd, rdwr, &n, chan, req );
+			}
+			else {
+				S64 n = 0;
+				ret = as_int64( ctx, hnd, rdwr, &n, chan, req );
+				if( ret == kErrNone ) {
+					/* hex up to 32 bits */
+					if((( FMT_HEX2 == var->fmt ) || ( FMT_HEX4 == var->fmt ) || ( FMT_HEX8 == var->fmt )) &&
+					   ( n >= 0 ) && ( n <= (S64) 0xffffffffu )) {
+						(void) vc_fmt_hex( val, (U32) n );
+					}
+					else {
+						(void) vc_fmt_s64( val, n );
+					}
 				}
-				n = snprintf( &buf[len], bufsz - len, " %6d %6d %6d\n", d->def_value, d->min, d->max );
-				CHECK_LEN( buf, n, len, bufsz );
-				len += n;
 			}
 			break;
 
-		case TYPE_FLOAT:
-			n = snprintf( &buf[len], bufsz - len, "                val           min           max\n");
-			CHECK_LEN( buf, n, len, bufsz );
-			len += n;
+		case TYPE_DOUBLE:
+			if( rdwr == VarWrite ) {
+				F64 f;
 
-			if( var->vec_items == 1u ) {
-				n = snprintf( &buf[len], bufsz - len, "     ");
-				CHECK_LEN( buf, n, len, bufsz );
-				len += n;
+				if( vc_parse_f64( val, &f ) != kErrNone ) {
+					return kErrInvalidValue;
+				}
+				ret = as_double( ctx, hnd, rdwr, &f, chan, req );
+			}
+			else {
+				F64 f;
+				ret = as_double( ctx, hnd, rdwr, &f, chan, req );
+				if( ret == kErrNone ) {
+					(void) vc_fmt_f64( val, f, var->fmt );
+				}
 			}
+			break;
 
-			for( U16 i = 0; i < var->vec_items; i++ ) {
-				DATA_F32 *d = &s_vc_data->data_f32[var->data_idx + i];
+		case TYPE_STRING:
+		{
+			if( chan > 0u ) {
+				ret = vc_chk_vector( var, chan );
+				if( ret != kErrNone ) {
+					return ret;
+				}
+			}
 
-				if( var->vec_items > 1u ) {
-					n = snprintf( &buf[len], bufsz - len, " %3d:", i );
-					CHECK_LEN( buf, n, len, bufsz );
-					len += n;	
+			if(( flags & TYPE_CONST ) != 0 ) {
+
+				if( rdwr == VarWrite ) {
+					return kErrAccessDenied;
 				}
 
-				n = snprintf( &buf[len], bufsz - len, " %13.*f %13.*f %13.*f\n", 
-											var->fmt, d->def_value, var->fmt, d->min, var->fmt, d->max );
-				CHECK_LEN( buf, n, len, bufsz );
-				len += n;
+				S32 idx = var->descr_idx;
+				DATA_STRING const *data = &ctx->data->data_const_str[idx];
+				size_t len = strlen(data);
+				len = (len >= sizeof(STRBUF)) ? (sizeof(STRBUF) - 1u ) : len;
+				(void) memcpy( val, data, len );
+				val[len] = '\0';
 			}
-			break;
+			else {
+				S32 idx = var->data_idx + (chan * sizeof(STRBUF));
+				S32 max_idx = sizeof(STRBUF) * ctx->data->data_str_cnt;
+				if( idx > max_idx ) {
+					return kErrInvalidChan;
+				}
+				DATA_STRING *data = &ctx->data->data_str[idx];
+
+				if( rdwr == VarWrite ) {
+					size_t len = strlen( val );
+					if( len > sizeof(STRBUF)) {
+						return kErrSizeTooBig;
+					}
+					int changed;
+
+					seq_write_begin( ctx, hnd );
+					changed = strncmp( data, val, sizeof(STRBUF));
+					(void) memcpy( data, val, sizeof(STRBUF));
+					seq_write_end( ctx, hnd );
+
+					if( changed != 0 ) {
+						var_changed( ctx, hnd, chan, NULL );
+					}
+				}
+				else {
+					U32 seq;
+					do {
+						seq = seq_read_begin( ctx, hnd );
+						(void) memcpy( val, data, sizeof(STRBUF));
+					} while( seq_read_retry( ctx, hnd, seq ) != 0 );
+					val[sizeof(STRBUF)-1u] = '\0';
+				}
+			}
+		}
+		break;
 
 		case TYPE_ENUM:
-			{
-				DESCR_ENUM const *dscr = get_enum_dscr( hnd );
-				for( U16 i = 0; i < dscr->cnt; i++ ) {
-					ENUM_MBR const *mbr = (ENUM_MBR const *)&dscr->mbr[i];
-					STRBUF S;
+			if( rdwr == VarWrite ) {
+				S16 n16;
 
-					ErrCode E = vc_as_string( mbr->hnd, VarRead, S, chan, REQ_PRG );
-					if( kErrNone == E ) {
-						int flag = 0;
-						size_t x;
+				if( vc_ctx_enum_value( ctx, hnd, val, &n16 ) != kErrNone ) {
+					S32 n;
 
-						x = strlen( S );
-						spaces[11-x] = '\0';
-						n = snprintf( &buf[len], bufsz - len, "%2d:  %s%s %4d", i, S, spaces, mbr->value );
-						spaces[11-x] = ' ';
-						CHECK_LEN( buf, n, len, bufsz );
-						len += n;
-							
-						for( U16 c = 0; c < var->vec_items; c++ ) {
-							U16 idx = var->data_idx + c;
-							/* cppcheck-suppress misra-c2012-11.8 */
-							DATA_ENUM *d = (DATA_ENUM *)&s_vc_data->data_enum[idx];
+					if(( vc_parse_s32( val, &n ) != kErrNone ) ||
+					   ( n > SHRT_MAX ) || ( n < SHRT_MIN )) {
+						return kErrInvalidEnum;
+					}
+					n16 = (S16) n;
+				}
+				ret = as_int16( ctx, hnd, rdwr, &n16, chan, req );
+			}
+			else {
+				S16 n16 = 0;
+				ret = as_int16( ctx, hnd, rdwr, &n16, chan, req );
+				if( ret == kErrNone ) {
+					char const *sym;
 
-							if( *d == mbr->value ) {
-								if( !flag ) {
-									n = snprintf( &buf[len], bufsz - len, " <= [" );
-									flag = 1;
-								}
+					if( vc_ctx_enum_symbol( ctx, hnd, n16, &sym ) == kErrNone ) {
+						size_t len = strlen( sym );
+						len = (len >= sizeof(STRBUF)) ? (sizeof(STRBUF) - 1u ) : len;
+						(void) memcpy( val, sym, len );
+						val[len] = '\0';
+					}
+					else {
+						(void) vc_fmt_s32( val, n16 );
+					}
+				}
+			}
+			break;
+
+		case TYPE_ACTION:
+			/* a write triggers the action, the value is ignored */
+			if( rdwr == VarWrite ) {
+				ret = vc_ctx_invoke( ctx, hnd, chan, req );
+			}
+			else {
+				ret = kErrInvalidType;
+			}
+			break;
+
+		default:
+			LOG_UNH_CASE( type );
+			break;
+	}
+	
+	return ret;
+}
+
+/*** vc_ctx_read_many *****************************************************/
+/**
+ *   Read many variables of TYPE_INT16, TYPE_ENUM, TYPE_INT32 and
+ *   TYPE_FLOAT with one call.
+ *
+ *   The items are grouped by their data table, ie. all int16 items
+ *   are read in one loop, then all int32 items and so on.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handles
+ *   @param chan   Channels, NULL to use channel 0 for all items
+ *   @param val    Values, see VC_VALUE for the member used
+ *   @param err    Error code of each item
+ *   @param n      Number of items
+ *   @param req    Request source
+ *
+ *   @return kErrNone, when all items were read.
+ *           Otherwise the error code of the first failed item.
+ */
+ErrCode vc_ctx_read_many( VC_CTX *ctx, HND const *hnd, U16 const *chan, VC_VALUE *val, ErrCode *err, size_t n, U16 req ) {
+	ErrCode ret;
+
+	STATS_TIME( VC_STAT_READ_MANY, ret = rw_many( ctx, hnd, chan, val, err, n, VarRead, req ));
+	/* err is only set when the arguments are valid */
+	if( ret != kErrInvalidArg ) {
+		STATS_ITEMS( ctx, hnd, err, n, VarRead );
+	}
+	return ret;
+}
+
+/*** vc_ctx_write_many ****************************************************/
+/**
+ *   Write many variables of TYPE_INT16, TYPE_ENUM, TYPE_INT32 and
+ *   TYPE_FLOAT with one call.
+ *
+ *   Each item is checked like in vc_ctx_as_int16(), vc_ctx_as_int32() and
+ *   vc_ctx_as_float(). A failed item doesn't stop the other items
+ *   from being written. Clipped values are returned in val.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handles
+ *   @param chan   Channels, NULL to use channel 0 for all items
+ *   @param val    Values, see VC_VALUE for the member used
+ *   @param err    Error code of each item
+ *   @param n      Number of items
+ *   @param req    Request source
+ *
+ *   @return kErrNone, when all items were written.
+ *           Otherwise the error code of the first failed item.
+ */
+ErrCode vc_ctx_write_many( VC_CTX *ctx, HND const *hnd, U16 const *chan, VC_VALUE *val, ErrCode *err, size_t n, U16 req ) {
+	ErrCode ret;
+
+	STATS_TIME( VC_STAT_WRITE_MANY, ret = rw_many( ctx, hnd, chan, val, err, n, VarWrite, req ));
+	/* err is only set when the arguments are valid */
+	if( ret != kErrInvalidArg ) {
+		STATS_ITEMS( ctx, hnd, err, n, VarWrite );
+	}
+	return ret;
+}
+
+/*** vc_ctx_txn_begin *******************************************************/
+/**
+ *   Start a transaction: writes of several variables, that are
+ *   published together or not at all.
+ *
+ *   vc_txn_write() stages the writes in txn, nothing is changed
+ *   until vc_txn_commit(). The commit locks the written variables,
+ *   checks all values, stores them and unlocks the variables, it
+ *   costs O(writes). Readers of a variable never see a staged value
+ *   before the commit, and after they saw one of the new values
+ *   they see all of them. vc_txn_abort() drops the staged writes.
+ *
+ *   Variables of TYPE_INT8, TYPE_INT16, TYPE_INT32, TYPE_INT64,
+ *   TYPE_FLOAT, TYPE_DOUBLE and TYPE_ENUM can be written, up to
+ *   VC_TXN_MAX channels per transaction.
+ *
+ *   @param ctx    Context
+ *   @param txn    Transaction
+ *   @param req    Request source of the writes
+ */
+ErrCode vc_ctx_txn_begin( VC_CTX *ctx, VC_TXN *txn, U16 req ) {
+
+	assert( ctx->data );
+
+	if( NULL == txn ) {
+		return kErrInvalidArg;
+	}
+
+	txn->ctx     = ctx;
+	txn->req     = req;
+	txn->cnt     = 0;
+	txn->err     = kErrNone;
+	txn->err_hnd = HNON;
+	return kErrNone;
+}
+
+/*** vc_txn_write ***********************************************************/
+/**
+ *   Stage a write, see vc_ctx_txn_begin().
+ *
+ *   Handle, type, access rights and channel are checked here, limits
+ *   and enum values by vc_txn_commit(). A second write of the same
+ *   channel replaces the first one. A failed write fails the commit.
+ *
+ *   @param txn    Transaction
+ *   @param hnd    Variable handle
+ *   @param chan   Channel
+ *   @param val    Value, see VC_VALUE for the member used
+ *
+ *   @return kErrFull, when VC_TXN_MAX channels are staged.
+ */
+ErrCode vc_txn_write( VC_TXN *txn, HND hnd, U16 chan, VC_VALUE const *val ) {
+	VC_CTX         *ctx;
+	VAR_DESC const *var;
+	ErrCode         E = kErrNone;
+	U16             pos;
+
+	if(( NULL == txn ) || ( NULL == txn->ctx ) || ( NULL == val )) {
+		return kErrInvalidArg;
+	}
+	ctx = txn->ctx;
+
+	if( hnd >= ctx->data->var_cnt ) {
+		E = kErrUnknownCmd;
+	}
+	else {
+		var = get_var( ctx, hnd );
+		switch( var->type & TYPE_MASK ) {
+			case TYPE_INT8:
+			case TYPE_INT16:
+			case TYPE_INT32:
+			case TYPE_INT64:
+			case TYPE_FLOAT:
+			case TYPE_DOUBLE:
+			case TYPE_ENUM:
+				E = acc_allowed( var, VarWrite, txn->req );
+				break;
+
+			default:
+				E = kErrInvalidType;
+				break;
+		}
+		if(( E == kErrNone ) && ( chan > 0u )) {
+			E = vc_chk_vector( var, chan );
+		}
+	}
+
+	/* sorted by handle and channel, the commit locks in this order */
+	pos = 0;
+	while(( E == kErrNone ) && ( pos < txn->cnt ) &&
+	      (( txn->item[pos].hnd < hnd ) || (( txn->item[pos].hnd == hnd ) && ( txn->item[pos].chan < chan )))) {
+		pos++;
+	}
+
+	if( E == kErrNone ) {
+		if(( pos < txn->cnt ) && ( txn->item[pos].hnd == hnd ) && ( txn->item[pos].chan == chan )) {
+			txn->item[pos].val = *val;
+			return kErrNone;
+		}
+		if( txn->cnt >= VC_TXN_MAX ) {
+			E = kErrFull;
+		}
+	}
+
+	if( E != kErrNone ) {
+		if( txn->err == kErrNone ) {
+			txn->err     = E;
+			txn->err_hnd = hnd;
+		}
+		return E;
+	}
+
+	(void) memmove( &txn->item[pos + 1u], &txn->item[pos], ( txn->cnt - pos ) * sizeof(VC_TXN_ITEM));
+	txn->item[pos].hnd     = hnd;
+	txn->item[pos].chan    = chan;
+	txn->item[pos].changed = 0;
+	txn->item[pos].val     = *val;
+	txn->cnt++;
+	return kErrNone;
+}
+
+/*** vc_txn_commit **********************************************************/
+/**
+ *   Publish the staged writes, see vc_ctx_txn_begin().
+ *
+ *   Nothing is written if a write failed or one of the values is out
+ *   of its limits (FLAG_LIMIT) or not a member of its enum. FLAG_CLIP
+ *   values are clipped. The subscribers are notified after all
+ *   variables were unlocked. The transaction is finished in any case.
+ *
+ *   @param txn      Transaction
+ *   @param err_hnd  Handle of the failed write or value, may be NULL
+ *
+ *   @return kErrNone, when all values were written.
+ */
+ErrCode vc_txn_commit( VC_TXN *txn, HND *err_hnd ) {
+	VC_CTX      *ctx;
+	ErrCode      E;
+	HND          bad = HNON;
+
+	if(( NULL == txn ) || ( NULL == txn->ctx )) {
+		return kErrInvalidArg;
+	}
+	ctx = txn->ctx;
+	E   = txn->err;
+	bad = txn->err_hnd;
+
+	if( E == kErrNone ) {
+		for( U16 i = 0; i < txn->cnt; i++ ) {
+			if(( 0u == i ) || ( txn->item[i].hnd != txn->item[i - 1u].hnd )) {
+				seq_write_begin( ctx, txn->item[i].hnd );
+			}
+		}
+
+		for( U16 i = 0; ( E == kErrNone ) && ( i < txn->cnt ); i++ ) {
+			E = txn_limit( ctx, &txn->item[i] );
+			bad = ( E == kErrNone ) ? HNON : txn->item[i].hnd;
+		}
+		for( U16 i = 0; ( E == kErrNone ) && ( i < txn->cnt ); i++ ) {
+			txn->item[i].changed = (U16) txn_store( ctx, &txn->item[i] );
+		}
+
+		for( U16 i = 0; i < txn->cnt; i++ ) {
+			if(( 0u == i ) || ( txn->item[i].hnd != txn->item[i - 1u].hnd )) {
+				seq_write_end( ctx, txn->item[i].hnd );
+			}
+		}
+
+		for( U16 i = 0; ( E == kErrNone ) && ( i < txn->cnt ); i++ ) {
+			var_written( ctx, txn->item[i].hnd, txn->item[i].chan, &txn->item[i].val, (int) txn->item[i].changed );
+		}
+	}
+
+	if( err_hnd != NULL ) {
+		*err_hnd = bad;
+	}
+	vc_txn_abort( txn );
+	return E;
+}
+
+/*** vc_txn_abort ***********************************************************/
+/**
+ *   Drop the staged writes, see vc_ctx_txn_begin(). The transaction
+ *   can be used for new writes.
+ *
+ *   @param txn    Transaction
+ */
+void vc_txn_abort( VC_TXN *txn ) {
+	if( NULL == txn ) {
+		return;
+	}
+	txn->cnt     = 0;
+	txn->err     = kErrNone;
+	txn->err_hnd = HNON;
+}
+
+#ifdef VC_HAS_ATOMIC
+/*** vc_ctx_atomic_load_s16 *************************************************/
+/**
+ *   Read a variable of TYPE_INT16 with an atomic load.
+ *
+ *   Without VC_THREAD_SAFE the vc_atomic_* functions don't lock, they
+ *   can be used from different threads on the same variable, but not
+ *   together with the other accessors. With VC_THREAD_SAFE they lock
+ *   like vc_ctx_as_int16(), so they can be mixed with all accessors
+ *   and transactions: a load waits while a writer of the variable is
+ *   active, the stores, vc_ctx_atomic_fetch_add_s16() and
+ *   vc_ctx_atomic_cas_s16() take the write lock of the variable and
+ *   check its limits under it, like vc_set_min() and vc_set_max().
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param chan   Channel
+ *   @param val    Pointer to value
+ *   @param req    Request source
+ */
+ErrCode vc_ctx_atomic_load_s16( VC_CTX *ctx, HND hnd, U16 chan, S16 *val, U16 req ) {
+	VAR_DESC const *var;
+	ErrCode ret;
+
+	if( NULL == val ) {
+		return kErrInvalidArg;
+	}
+
+	ret = atomic_var( ctx, hnd, chan, TYPE_INT16, VarRead, req, &var );
+	if( ret == kErrNone ) {
+		S16 *data = &ctx->data->data_s16[var->data_idx + chan];
+		U32 seq;
+		do {
+			seq  = seq_read_begin( ctx, hnd );
+			*val = atomic_load_explicit( ATOMIC_S16( data ), memory_order_acquire );
+		} while( seq_read_retry( ctx, hnd, seq ) != 0 );
+	}
+	return ret;
+}
+
+/*** vc_ctx_atomic_load_s32 *************************************************/
+/**
+ *   Read a variable of TYPE_INT32 with an atomic load.
+ *   See vc_ctx_atomic_load_s16().
+ */
+ErrCode vc_ctx_atomic_load_s32( VC_CTX *ctx, HND hnd, U16 chan, S32 *val, U16 req ) {
+	VAR_DESC const *var;
+	ErrCode ret;
+
+	if( NULL == val ) {
+		return kErrInvalidArg;
+	}
+
+	ret = atomic_var( ctx, hnd, chan, TYPE_INT32, VarRead, req, &var );
+	if( ret == kErrNone ) {
+		S32 *data = &ctx->data->data_s32[var->data_idx + chan];
+		U32 seq;
+		do {
+			seq  = seq_read_begin( ctx, hnd );
+			*val = atomic_load_explicit( ATOMIC_S32( data ), memory_order_acquire );
+		} while( seq_read_retry( ctx, hnd, seq ) != 0 );
+	}
+	return ret;
+}
+
+/*** vc_ctx_atomic_load_f32 *************************************************/
+/**
+ *   Read a variable of TYPE_FLOAT with an atomic load.
+ *   See vc_ctx_atomic_load_s16().
+ */
+ErrCode vc_ctx_atomic_load_f32( VC_CTX *ctx, HND hnd, U16 chan, F32 *val, U16 req ) {
+	VAR_DESC const *var;
+	ErrCode ret;
+
+	if( NULL == val ) {
+		return kErrInvalidArg;
+	}
+
+	ret = atomic_var( ctx, hnd, chan, TYPE_FLOAT, VarRead, req, &var );
+	if( ret == kErrNone ) {
+		F32 *data = &ctx->data->data_f32[var->data_idx + chan];
+		U32 seq;
+		do {
+			seq  = seq_read_begin( ctx, hnd );
+			*val = atomic_load_explicit( ATOMIC_F32( data ), memory_order_acquire );
+		} while( seq_read_retry( ctx, hnd, seq ) != 0 );
+	}
+	return ret;
+}
+
+/*** vc_ctx_atomic_store_s16 ************************************************/
+/**
+ *   Write a variable of TYPE_INT16 with an atomic store.
+ *
+ *   FLAG_LIMIT and FLAG_CLIP are applied like in vc_ctx_as_int16(),
+ *   the limits are read under the write lock of the variable.
+ *   A clipped value is returned in val.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param chan   Channel
+ *   @param val    Pointer to value
+ *   @param req    Request source
+ */
+ErrCode vc_ctx_atomic_store_s16( VC_CTX *ctx, HND hnd, U16 chan, S16 *val, U16 req ) {
+	VAR_DESC const *var;
+	ErrCode ret;
+
+	if( NULL == val ) {
+		return kErrInvalidArg;
+	}
+
+	ret = atomic_var( ctx, hnd, chan, TYPE_INT16, VarWrite, req, &var );
+	if( ret == kErrNone ) {
+		S16 *data = &ctx->data->data_s16[var->data_idx + chan];
+		S16 prev = 0;
+
+		seq_write_begin( ctx, hnd );
+		ret = limit_s16( var->acc_rights, &ctx->data->lim_s16[var->data_idx + chan], val );
+		if( ret == kErrNone ) {
+			prev = atomic_exchange_explicit( ATOMIC_S16( data ), *val, memory_order_acq_rel );
+		}
+		seq_write_end( ctx, hnd );
+		if( ret == kErrNone ) {
+			VC_VALUE v;
+
+			v.s16 = *val;
+			var_written( ctx, hnd, chan, &v, ( prev != *val ) ? 1 : 0 );
+		}
+	}
+	return ret;
+}
+
+/*** vc_ctx_atomic_store_s32 ************************************************/
+/**
+ *   Write a variable of TYPE_INT32 with an atomic store.
+ *   See vc_ctx_atomic_store_s16().
+ */
+ErrCode vc_ctx_atomic_store_s32( VC_CTX *ctx, HND hnd, U16 chan, S32 *val, U16 req ) {
+	VAR_DESC const *var;
+	ErrCode ret;
+
+	if( NULL == val ) {
+		return kErrInvalidArg;
+	}
+
+	ret = atomic_var( ctx, hnd, chan, TYPE_INT32, VarWrite, req, &var );
+	if( ret == kErrNone ) {
+		S32 *data = &ctx->data->data_s32[var->data_idx + chan];
+		S32 prev = 0;
+
+		seq_write_begin( ctx, hnd );
+		ret = limit_s32( var->acc_rights, &ctx->data->lim_s32[var->data_idx + chan], val );
+		if( ret == kErrNone ) {
+			prev = atomic_exchange_explicit( ATOMIC_S32( data ), *val, memory_order_acq_rel );
+		}
+		seq_write_end( ctx, hnd );
+		if( ret == kErrNone ) {
+			VC_VALUE v;
+
+			v.s32 = *val;
+			var_written( ctx, hnd, chan, &v, ( prev != *val ) ? 1 : 0 );
+		}
+	}
+	return ret;
+}
+
+/*** vc_ctx_atomic_store_f32 ************************************************/
+/**
+ *   Write a variable of TYPE_FLOAT with an atomic store.
+ *   See vc_ctx_atomic_store_s16().
+ */
+ErrCode vc_ctx_atomic_store_f32( VC_CTX *ctx, HND hnd, U16 chan, F32 *val, U16 req ) {
+	VAR_DESC const *var;
+	ErrCode ret;
+
+	if( NULL == val ) {
+		return kErrInvalidArg;
+	}
+
+	ret = atomic_var( ctx, hnd, chan, TYPE_FLOAT, VarWrite, req, &var );
+	if( ret == kErrNone ) {
+		F32 *data = &ctx->data->data_f32[var->data_idx + chan];
+		F32 prev = 0;
+
+		seq_write_begin( ctx, hnd );
+		ret = limit_f32( var->acc_rights, &ctx->data->lim_f32[var->data_idx + chan], val );
+		if( ret == kErrNone ) {
+			prev = atomic_exchange_explicit( ATOMIC_F32( data ), *val, memory_order_acq_rel );
+		}
+		seq_write_end( ctx, hnd );
+		if( ret == kErrNone ) {
+			VC_VALUE v;
+
+			v.f32 = *val;
+			var_written( ctx, hnd, chan, &v, ( prev != *val ) ? 1 : 0 );
+		}
+	}
+	return ret;
+}
+
+/*** vc_ctx_atomic_fetch_add_s16 ********************************************/
+/**
+ *   Add to a variable of TYPE_INT16.
+ *
+ *   The sum saturates at the limits of the data type. Then FLAG_LIMIT
+ *   and FLAG_CLIP are applied to the sum inside a compare and swap
+ *   loop. With FLAG_LIMIT a sum outside [min, max] isn't written.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param chan   Channel
+ *   @param add    Value to add
+ *   @param old    Value before the addition, may be NULL
+ *   @param req    Request source
+ */
+ErrCode vc_ctx_atomic_fetch_add_s16( VC_CTX *ctx, HND hnd, U16 chan, S16 add, S16 *old, U16 req ) {
+	VAR_DESC const *var;
+	S16 *data;
+	S16 cur;
+	S16 next;
+	ErrCode ret;
+
+	ret = atomic_var( ctx, hnd, chan, TYPE_INT16, VarWrite, req, &var );
+	if( ret != kErrNone ) {
+		return ret;
+	}
+
+	data = &ctx->data->data_s16[var->data_idx + chan];
+	seq_write_begin( ctx, hnd );
+	cur  = atomic_load_explicit( ATOMIC_S16( data ), memory_order_relaxed );
+	do {
+		S32 sum = (S32) cur + (S32) add;
+		sum  = (sum > SHRT_MAX) ? SHRT_MAX : ((sum < SHRT_MIN) ? SHRT_MIN : sum);
+		next = (S16) sum;
+		ret  = limit_s16( var->acc_rights, &ctx->data->lim_s16[var->data_idx + chan], &next );
+	} while(( ret == kErrNone ) &&
+	        !atomic_compare_exchange_weak_explicit( ATOMIC_S16( data ), &cur, next,
+	                                                memory_order_acq_rel, memory_order_relaxed ));
+	seq_write_end( ctx, hnd );
+
+	if( ret == kErrNone ) {
+		VC_VALUE v;
+		v.s16 = next;
+		var_written( ctx, hnd, chan, &v, ( cur != next ) ? 1 : 0 );
+	}
+
+	if( old != NULL ) {
+		*old = cur;
+	}
+	return ret;
+}
+
+/*** vc_ctx_atomic_fetch_add_s32 ********************************************/
+/**
+ *   Add to a variable of TYPE_INT32.
+ *   See vc_ctx_atomic_fetch_add_s16().
+ */
+ErrCode vc_ctx_atomic_fetch_add_s32( VC_CTX *ctx, HND hnd, U16 chan, S32 add, S32 *old, U16 req ) {
+	VAR_DESC const *var;
+	S32 *data;
+	S32 cur;
+	S32 next;
+	ErrCode ret;
+
+	ret = atomic_var( ctx, hnd, chan, TYPE_INT32, VarWrite, req, &var );
+	if( ret != kErrNone ) {
+		return ret;
+	}
+
+	data = &ctx->data->data_s32[var->data_idx + chan];
+	seq_write_begin( ctx, hnd );
+	cur  = atomic_load_explicit( ATOMIC_S32( data ), memory_order_relaxed );
+	do {
+		int64_t sum = (int64_t) cur + (int64_t) add;
+		sum  = (sum > INT32_MAX) ? INT32_MAX : ((sum < INT32_MIN) ? INT32_MIN : sum);
+		next = (S32) sum;
+		ret  = limit_s32( var->acc_rights, &ctx->data->lim_s32[var->data_idx + chan], &next );
+	} while(( ret == kErrNone ) &&
+	        !atomic_compare_exchange_weak_explicit( ATOMIC_S32( data ), &cur, next,
+	                                                memory_order_acq_rel, memory_order_relaxed ));
+	seq_write_end( ctx, hnd );
+
+	if( ret == kErrNone ) {
+		VC_VALUE v;
+		v.s32 = next;
+		var_written( ctx, hnd, chan, &v, ( cur != next ) ? 1 : 0 );
+	}
+
+	if( old != NULL ) {
+		*old = cur;
+	}
+	return ret;
+}
+
+/*** vc_ctx_atomic_fetch_add_f32 ********************************************/
+/**
+ *   Add to a variable of TYPE_FLOAT.
+ *   See vc_ctx_atomic_fetch_add_s16().
+ */
+ErrCode vc_ctx_atomic_fetch_add_f32( VC_CTX *ctx, HND hnd, U16 chan, F32 add, F32 *old, U16 req ) {
+	VAR_DESC const *var;
+	F32 *data;
+	F32 cur;
+	F32 next;
+	ErrCode ret;
+
+	ret = atomic_var( ctx, hnd, chan, TYPE_FLOAT, VarWrite, req, &var );
+	if( ret != kErrNone ) {
+		return ret;
+	}
+
+	data = &ctx->data->data_f32[var->data_idx + chan];
+	seq_write_begin( ctx, hnd );
+	cur  = atomic_load_explicit( ATOMIC_F32( data ), memory_order_relaxed );
+	do {
+		next = cur + add;
+		ret  = limit_f32( var->acc_rights, &ctx->data->lim_f32[var->data_idx + chan], &next );
+	} while(( ret == kErrNone ) &&
+	        !atomic_compare_exchange_weak_explicit( ATOMIC_F32( data ), &cur, next,
+	                                                memory_order_acq_rel, memory_order_relaxed ));
+	seq_write_end( ctx, hnd );
+
+	if( ret == kErrNone ) {
+		VC_VALUE v;
+		v.f32 = next;
+		var_written( ctx, hnd, chan, &v, ( cur != next ) ? 1 : 0 );
+	}
+
+	if( old != NULL ) {
+		*old = cur;
+	}
+	return ret;
+}
+
+/*** vc_ctx_atomic_cas_s16 **************************************************/
+/**
+ *   Compare and swap a variable of TYPE_INT16.
+ *
+ *   FLAG_LIMIT and FLAG_CLIP are applied to desired under the write
+ *   lock of the variable. The variable is only written, when it
+ *   still has the value of expected.
+ *
+ *   @param ctx    Context
+ *   @param hnd       Variable handle
+ *   @param chan      Channel
+ *   @param expected  Expected value, returns the current value
+ *                    when the variable was changed
+ *   @param desired   New value
+ *   @param req       Request source
+ *
+ *   @return kErrNone, when desired was written.
+ *           kErrValueChanged, when the value isn't expected.
+ */
+ErrCode vc_ctx_atomic_cas_s16( VC_CTX *ctx, HND hnd, U16 chan, S16 *expected, S16 desired, U16 req ) {
+	VAR_DESC const *var;
+	ErrCode ret;
+
+	if( NULL == expected ) {
+		return kErrInvalidArg;
+	}
+
+	ret = atomic_var( ctx, hnd, chan, TYPE_INT16, VarWrite, req, &var );
+	if( ret == kErrNone ) {
+		S16 *data = &ctx->data->data_s16[var->data_idx + chan];
+		int swapped = 0;
+
+		seq_write_begin( ctx, hnd );
+		ret = limit_s16( var->acc_rights, &ctx->data->lim_s16[var->data_idx + chan], &desired );
+		if( ret == kErrNone ) {
+			swapped = atomic_compare_exchange_strong_explicit( ATOMIC_S16( data ), expected, desired,
+			                                                   memory_order_acq_rel, memory_order_acquire );
+		}
+		seq_write_end( ctx, hnd );
+		if( ret == kErrNone ) {
+			if( !swapped ) {
+				ret = kErrValueChanged;
+			}
+			else {
+				VC_VALUE v;
+				v.s16 = desired;
+				var_written( ctx, hnd, chan, &v, ( *expected != desired ) ? 1 : 0 );
+			}
+		}
+	}
+	return ret;
+}
+
+/*** vc_ctx_atomic_cas_s32 **************************************************/
+/**
+ *   Compare and swap a variable of TYPE_INT32.
+ *   See vc_ctx_atomic_cas_s16().
+ */
+ErrCode vc_ctx_atomic_cas_s32( VC_CTX *ctx, HND hnd, U16 chan, S32 *expected, S32 desired, U16 req ) {
+	VAR_DESC const *var;
+	ErrCode ret;
+
+	if( NULL == expected ) {
+		return kErrInvalidArg;
+	}
+
+	ret = atomic_var( ctx, hnd, chan, TYPE_INT32, VarWrite, req, &var );
+	if( ret == kErrNone ) {
+		S32 *data = &ctx->data->data_s32[var->data_idx + chan];
+		int swapped = 0;
+
+		seq_write_begin( ctx, hnd );
+		ret = limit_s32( var->acc_rights, &ctx->data->lim_s32[var->data_idx + chan], &desired );
+		if( ret == kErrNone ) {
+			swapped = atomic_compare_exchange_strong_explicit( ATOMIC_S32( data ), expected, desired,
+			                                                   memory_order_acq_rel, memory_order_acquire );
+		}
+		seq_write_end( ctx, hnd );
+		if( ret == kErrNone ) {
+			if( !swapped ) {
+				ret = kErrValueChanged;
+			}
+			else {
+				VC_VALUE v;
+				v.s32 = desired;
+				var_written( ctx, hnd, chan, &v, ( *expected != desired ) ? 1 : 0 );
+			}
+		}
+	}
+	return ret;
+}
+
+/*** vc_ctx_atomic_cas_f32 **************************************************/
+/**
+ *   Compare and swap a variable of TYPE_FLOAT.
+ *   See vc_ctx_atomic_cas_s16().
+ */
+ErrCode vc_ctx_atomic_cas_f32( VC_CTX *ctx, HND hnd, U16 chan, F32 *expected, F32 desired, U16 req ) {
+	VAR_DESC const *var;
+	ErrCode ret;
+
+	if( NULL == expected ) {
+		return kErrInvalidArg;
+	}
+
+	ret = atomic_var( ctx, hnd, chan, TYPE_FLOAT, VarWrite, req, &var );
+	if( ret == kErrNone ) {
+		F32 *data = &ctx->data->data_f32[var->data_idx + chan];
+		int swapped = 0;
+
+		seq_write_begin( ctx, hnd );
+		ret = limit_f32( var->acc_rights, &ctx->data->lim_f32[var->data_idx + chan], &desired );
+		if( ret == kErrNone ) {
+			swapped = atomic_compare_exchange_strong_explicit( ATOMIC_F32( data ), expected, desired,
+			                                                   memory_order_acq_rel, memory_order_acquire );
+		}
+		seq_write_end( ctx, hnd );
+		if( ret == kErrNone ) {
+			if( !swapped ) {
+				ret = kErrValueChanged;
+			}
+			else {
+				VC_VALUE v;
+				v.f32 = desired;
+				var_written( ctx, hnd, chan, &v, ( *expected != desired ) ? 1 : 0 );
+			}
+		}
+	}
+	return ret;
+}
+#endif
+
+/*** vc_ring_init ***********************************************************/
+/**
+ *   Initialize an event ring for vc_ctx_subscribe().
+ *
+ *   @param ring   Event ring
+ *   @param cell   Storage of the ring
+ *   @param cnt    Number of cells, a power of 2
+ */
+ErrCode vc_ring_init( VC_RING *ring, VC_RING_CELL *cell, U32 cnt ) {
+
+	if(( NULL == ring ) || ( NULL == cell ) || ( cnt < 2u ) || (( cnt & ( cnt - 1u )) != 0u )) {
+		return kErrInvalidArg;
+	}
+
+	ring->cell = cell;
+	ring->mask = cnt - 1u;
+	for( U32 i = 0; i < cnt; i++ ) {
+		SEQ_STORE( &cell[i].seq, i, relaxed );
+	}
+	SEQ_STORE( &ring->head, 0u, relaxed );
+	SEQ_STORE( &ring->tail, 0u, relaxed );
+	SEQ_STORE( &ring->lost, 0u, release );
+
+	return kErrNone;
+}
+
+/*** vc_ring_pop ************************************************************/
+/**
+ *   Take the oldest event from a ring.
+ *
+ *   @param ring   Event ring
+ *   @param ev     Event
+ *
+ *   @return kErrEmpty, when there is no event.
+ */
+ErrCode vc_ring_pop( VC_RING *ring, VC_EVENT *ev ) {
+	VC_RING_CELL *cell;
+	U32 pos;
+
+	if(( NULL == ring ) || ( NULL == ev )) {
+		return kErrInvalidArg;
+	}
+
+	pos = SEQ_LOAD( &ring->tail, relaxed );
+	for( ;; ) {
+		S32 diff;
+
+		cell = &ring->cell[pos & ring->mask];
+		diff = (S32)( SEQ_LOAD( &cell->seq, acquire ) - ( pos + 1u ));
+		if( diff == 0 ) {
+			if( SEQ_CAS( &ring->tail, &pos, pos + 1u )) {
+				break;
+			}
+		}
+		else if( diff < 0 ) {
+			return kErrEmpty;
+		}
+		else {
+			pos = SEQ_LOAD( &ring->tail, relaxed );
+		}
+	}
+
+	*ev = cell->ev;
+	SEQ_STORE( &cell->seq, pos + ring->mask + 1u, release );
+
+	return kErrNone;
+}
+
+/*** vc_ring_lost ***********************************************************/
+/**
+ *   Number of events that were dropped, because the ring was full.
+ *
+ *   @param ring   Event ring
+ */
+U32 vc_ring_lost( VC_RING *ring ) {
+	return (NULL == ring) ? 0u : SEQ_LOAD( &ring->lost, relaxed );
+}
+
+/*** vc_ctx_subscribe *******************************************************/
+/**
+ *   Subscribe to the changes of a variable.
+ *
+ *   Each write that changes the value pushes an event into ring and
+ *   calls cb. Both run in the context of the writer, the callback
+ *   must be short. ring or cb may be NULL.
+ *
+ *   Subscriptions are removed by vc_init(). The ring has to stay
+ *   valid until the writers are done after vc_ctx_unsubscribe().
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param chan   Channel or VC_ALL_CHAN
+ *   @param ring   Event ring, see vc_ring_init()
+ *   @param cb     Callback
+ *   @param arg    Argument of the callback
+ *   @param id     Returns the id for vc_ctx_unsubscribe(), may be NULL
+ *
+ *   @return kErrFull, when there are already VC_MAX_SUB subscriptions.
+ */
+ErrCode vc_ctx_subscribe( VC_CTX *ctx, HND hnd, U16 chan, VC_RING *ring, VC_NOTIFY cb, void *arg, int *id ) {
+	VAR_DESC const *var;
+	U16 type;
+
+	assert( ctx->data );
+
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
+
+	if(( NULL == ring ) && ( NULL == cb )) {
+		return kErrInvalidArg;
+	}
+
+	var  = get_var( ctx, hnd );
+	type = var->type & TYPE_MASK;
+	if(( type != TYPE_INT8 ) && ( type != TYPE_INT16 ) && ( type != TYPE_ENUM ) &&
+	   ( type != TYPE_INT32 ) && ( type != TYPE_INT64 ) && ( type != TYPE_FLOAT ) &&
+	   ( type != TYPE_DOUBLE ) && ( type != TYPE_STRING )) {
+		return kErrInvalidType;
+	}
+
+	if(( chan != VC_ALL_CHAN ) && ( chan > 0u )) {
+		ErrCode ret = vc_chk_vector( var, chan );
+		if( ret != kErrNone ) {
+			return ret;
+		}
+	}
+
+	for( int i = 0; i < VC_MAX_SUB; i++ ) {
+		VC_SUB *sub = &ctx->sub[i];
+		U32 expected = 0u;
+
+		/* claim the slot, it is active after the members are set */
+		if( SEQ_CAS( &sub->active, &expected, 2u )) {
+			sub->hnd  = hnd;
+			sub->chan = chan;
+			sub->ring = ring;
+			sub->cb   = cb;
+			sub->arg  = arg;
+			SEQ_STORE( &sub->active, 1u, release );
+			(void) SEQ_ADD( &ctx->sub_cnt, 1u );
+
+			if( id != NULL ) {
+				*id = i;
+			}
+			return kErrNone;
+		}
+	}
+
+	return kErrFull;
+}
+
+/*** vc_ctx_unsubscribe *****************************************************/
+/**
+ *   Remove a subscription.
+ *
+ *   @param ctx    Context
+ *   @param id     Id from vc_ctx_subscribe()
+ */
+ErrCode vc_ctx_unsubscribe( VC_CTX *ctx, int id ) {
+
+	if(( id < 0 ) || ( id >= VC_MAX_SUB )) {
+		return kErrInvalidArg;
+	}
+
+	if( SEQ_LOAD( &ctx->sub[id].active, acquire ) != 1u ) {
+		return kErrInvalidArg;
+	}
+
+	SEQ_STORE( &ctx->sub[id].active, 0u, release );
+	(void) SEQ_ADD( &ctx->sub_cnt, (U32) -1 );
+
+	return kErrNone;
+}
+
+/*** vc_ctx_notify **********************************************************/
+/**
+ *   Report a write that didn't use the vc_ctx_as_*() functions, eg.
+ *   by the accessors varpp writes with #pragma accessors on.
+ *   The value is added to the history of the variable like a write
+ *   with vc_ctx_as_*(). When it changed, the variable is marked dirty
+ *   and the subscribers get an event.
+ *
+ *   @param ctx     Context
+ *   @param hnd     Variable handle
+ *   @param chan    Channel
+ *   @param val     New value, NULL for TYPE_STRING
+ *   @param changed 1, when the value differs from the old one
+ */
+ErrCode vc_ctx_notify( VC_CTX *ctx, HND hnd, U16 chan, VC_VALUE const *val, int changed ) {
+
+	assert( ctx->data );
+
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
+
+	var_written( ctx, hnd, chan, val, changed );
+
+	return kErrNone;
+}
+
+/*** vc_ctx_bind ************************************************************/
+/**
+ *   Bind a handler to a variable of TYPE_ACTION, see vc_ctx_invoke().
+ *
+ *   The handler is kept in the dispatch table of the context, so
+ *   triggering the action doesn't look at the SCPI name. Bindings
+ *   are removed by vc_init(), bind the handlers before the context
+ *   is shared with other threads.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param fn     Handler, NULL removes the binding
+ *   @param arg    Argument of the handler
+ */
+ErrCode vc_ctx_bind( VC_CTX *ctx, HND hnd, VC_ACTION fn, void *arg ) {
+	VAR_DESC const *var;
+	VC_ACTION_SLOT *slot;
+
+	assert( ctx->data );
+
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
+
+	var = get_var( ctx, hnd );
+	if((( var->type & TYPE_MASK ) != TYPE_ACTION ) ||
+	   ( var->data_idx >= ctx->data->action_cnt )) {
+		return kErrInvalidType;
+	}
+
+	slot = &ctx->data->action[var->data_idx];
+	slot->fn  = fn;
+	slot->arg = ( fn != NULL ) ? arg : NULL;
+
+	return kErrNone;
+}
+
+/*** vc_ctx_invoke **********************************************************/
+/**
+ *   Trigger a variable of TYPE_ACTION, ie. call the handler bound
+ *   with vc_ctx_bind() after the access rights are checked like
+ *   for a write. A write with vc_ctx_as_string() does the same.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param chan   Channel
+ *   @param req    Request source
+ *
+ *   @return kErrEmpty, when no handler is bound,
+ *           else the return value of the handler.
+ */
+ErrCode vc_ctx_invoke( VC_CTX *ctx, HND hnd, U16 chan, U16 req ) {
+	VAR_DESC const *var;
+	VC_ACTION_SLOT const *slot;
+	ErrCode ret;
+
+	assert( ctx->data );
+
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
+
+	var = get_var( ctx, hnd );
+	if((( var->type & TYPE_MASK ) != TYPE_ACTION ) ||
+	   ( var->data_idx >= ctx->data->action_cnt )) {
+		return kErrInvalidType;
+	}
+
+	ret = acc_allowed( var, VarWrite, req );
+	if( ret != kErrNone ) {
+		return ret;
+	}
+
+	if( chan > 0u ) {
+		ret = vc_chk_vector( var, chan );
+		if( ret != kErrNone ) {
+			return ret;
+		}
+	}
+
+	slot = &ctx->data->action[var->data_idx];
+	if( NULL == slot->fn ) {
+		return kErrEmpty;
+	}
+
+	return slot->fn( hnd, chan, slot->arg );
+}
+
+/*** vc_ctx_set_clock *******************************************************/
+/**
+ *   Set the clock of the histories, see vc_ctx_history().
+ *
+ *   The unit of the clock is up to the application, eg. ms, the
+ *   periods of the tiers in the CSV are in the same unit. Without
+ *   a clock the time of a sample is its number.
+ *
+ *   @param ctx    Context
+ *   @param clock  Clock, NULL for the number of the sample
+ *   @param arg    Argument of the clock
+ */
+void vc_ctx_set_clock( VC_CTX *ctx, VC_CLOCK clock, void *arg ) {
+	ctx->clock     = clock;
+	ctx->clock_arg = arg;
+}
+
+/*** vc_ctx_history *********************************************************/
+/**
+ *   Read the last cells of a history, oldest first.
+ *
+ *   A variable with #pragma history in the CSV records a sample
+ *   for every accepted write, also when the value doesn't change.
+ *   Tier 0 holds the samples, the other tiers min, max and mean of
+ *   one period per cell. A period that elapsed by the clock is closed
+ *   here, the open period isn't returned. The cells are copied with
+ *   at most two memcpy. The values are F32, INT64 and DOUBLE
+ *   variables lose precision.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param chan   Channel
+ *   @param tier   Tier, 0 for the samples
+ *   @param cell   Returns the cells
+ *   @param n      Size of cell
+ *   @param got    Returns the number of cells, may be NULL
+ *   @param req    Request source
+ *
+ *   @return kErrInvalidType, when the variable has no history.
+ */
+ErrCode vc_ctx_history( VC_CTX *ctx, HND hnd, U16 chan, U16 tier, VC_HIST_CELL *cell, U32 n, U32 *got, U16 req ) {
+	VAR_DESC const *var;
+	VC_HIST const *hist;
+	VC_HIST_TIER const *t;
+	VC_HIST_RING *ring;
+	VC_HIST_CELL const *src;
+	ErrCode ret;
+	U32 k;
+	U32 start;
+	U32 first;
+	U32 now;
+
+	assert( ctx->data );
+
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
+
+	if(( NULL == cell ) && ( n > 0u )) {
+		return kErrInvalidArg;
+	}
+
+	var = get_var( ctx, hnd );
+	ret = acc_allowed( var, VarRead, req );
+	if( ret != kErrNone ) {
+		return ret;
+	}
+
+	if( chan > 0u ) {
+		ret = vc_chk_vector( var, chan );
+		if( ret != kErrNone ) {
+			return ret;
+		}
+	}
+
+	hist = hist_find( ctx, hnd );
+	if( NULL == hist ) {
+		return kErrInvalidType;
+	}
+	if( tier >= hist->tier_cnt ) {
+		return kErrInvalidArg;
+	}
+
+	t    = &ctx->data->hist_tier[hist->tier + tier];
+	ring = &ctx->data->hist_ring[t->ring + chan];
+	src  = &ctx->data->hist_cell[t->cell + (U32) chan * t->cnt];
+	now  = ( t->period > 0u ) ? hist_now( ctx, hist, chan ) : 0u;
+
+	hist_lock( ring );
+	if( t->period > 0u ) {
+		hist_close( ring, t, &ctx->data->hist_cell[t->cell + (U32) chan * t->cnt], now );
+	}
+	k = ( n < ring->fill ) ? n : ring->fill;
+	if( k > 0u ) {
+		start = ( ring->pos + t->cnt - k ) % t->cnt;
+		first = ( k < t->cnt - start ) ? k : ( t->cnt - start );
+		(void) memcpy( cell, &src[start], sizeof(VC_HIST_CELL) * first );
+		(void) memcpy( &cell[first], src, sizeof(VC_HIST_CELL) * ( k - first ));
+	}
+	hist_unlock( ring );
+
+	if( got != NULL ) {
+		*got = k;
+	}
+	return kErrNone;
+}
+
+/*** vc_ctx_stats_var *******************************************************/
+/**
+ *   Read the access counters of a variable.
+ *
+ *   With VC_STATISTICS the accessors count reads, writes and failed
+ *   calls per variable, each thread in its own shard of the
+ *   counters, and add their latency to the histograms of
+ *   vc_stats_latency() and vc_stats_type(). The counters are part
+ *   of the generated table, contexts of vc_ctx_init_storage() share
+ *   them.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param st     Returns the counters
+ *
+ *   @return kErrEmpty, when varcore is built without VC_STATISTICS.
+ */
+ErrCode vc_ctx_stats_var( VC_CTX *ctx, HND hnd, VC_STATS *st ) {
+	assert( ctx->data );
+
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
+	if( NULL == st ) {
+		return kErrInvalidArg;
+	}
+
+	st->reads  = 0u;
+	st->writes = 0u;
+	st->errors = 0u;
+
+#ifdef VC_STATISTICS
+	if( NULL == ctx->data->stats ) {
+		return kErrEmpty;
+	}
+	for( U32 s = 0; s < VC_STATS_SHARDS; s++ ) {
+		VC_STATS_VAR *v = &ctx->data->stats[s * ctx->data->var_cnt + hnd];
+
+		st->reads  += SEQ_LOAD( &v->reads, relaxed );
+		st->writes += SEQ_LOAD( &v->writes, relaxed );
+		st->errors += SEQ_LOAD( &v->errors, relaxed );
+	}
+	return kErrNone;
+#else
+	return kErrEmpty;
+#endif
+}
+
+/*** vc_ctx_stats_reset *****************************************************/
+/**
+ *   Clear the access counters of the table of the context and the
+ *   latency histograms. Calls running meanwhile may be counted or not.
+ *
+ *   @param ctx    Context
+ */
+void vc_ctx_stats_reset( VC_CTX *ctx ) {
+#ifdef VC_STATISTICS
+	size_t n;
+
+	assert( ctx->data );
+
+	if( ctx->data->stats != NULL ) {
+		n = (size_t) VC_STATS_SHARDS * ctx->data->var_cnt;
+		for( size_t i = 0; i < n; i++ ) {
+			SEQ_STORE( &ctx->data->stats[i].reads, 0u, relaxed );
+			SEQ_STORE( &ctx->data->stats[i].writes, 0u, relaxed );
+			SEQ_STORE( &ctx->data->stats[i].errors, 0u, relaxed );
+		}
+	}
+	for( U32 s = 0; s < VC_STATS_SHARDS; s++ ) {
+		for( int b = 0; b < VC_STATS_BUCKETS; b++ ) {
+			for( int f = 0; f < VC_STAT_LAST; f++ ) {
+				SEQ_STORE( &s_stats_lat[s][f][b], 0u, relaxed );
+			}
+			for( int t = 0; t < TYPE_LAST; t++ ) {
+				SEQ_STORE( &s_stats_type[s][t][b], 0u, relaxed );
+			}
+		}
+	}
+#else
+	UNUSED_PARAM( ctx );
+#endif
+}
+
+/*** vc_ctx_stats_dump ******************************************************/
+/**
+ *   Write the latency per function and per type and the counters of
+ *   the variables that were accessed, as text or JSON. The
+ *   percentiles are the upper bounds of their buckets.
+ *
+ *   VC_DUMP_TEXT:
+ *
+ *     functions
+ *       vc_as_int16: calls 12, p50 < 64 ns, p99 < 256 ns
+ *     types
+ *       TYPE_INT16: calls 12, p50 < 64 ns, p99 < 256 ns
+ *     variables
+ *       LEM:VOLT (0x3): reads 10, writes 2, errors 0
+ *
+ *   VC_DUMP_JSON is an object with the arrays "functions", "types"
+ *   and "variables".
+ *
+ *   @param ctx    Context
+ *   @param wr     Writer
+ *   @param arg    Argument of wr
+ *   @param format VC_DUMP_TEXT or VC_DUMP_JSON
+ *
+ *   @return kErrEmpty, when varcore is built without VC_STATISTICS.
+ *           Otherwise the first error of wr.
+ */
+ErrCode vc_ctx_stats_dump( VC_CTX *ctx, VC_WRITER wr, void *arg, int format ) {
+#ifdef VC_STATISTICS
+	DUMP_OUT out;
+	U64 bucket[VC_STATS_BUCKETS];
+	VC_STATS st;
+	char num[24];
+	int json;
+	int first;
+
+	assert( ctx->data );
+
+	if(( NULL == wr ) || (( format != VC_DUMP_TEXT ) && ( format != VC_DUMP_JSON ))) {
+		return kErrInvalidArg;
+	}
+
+	json    = ( format == VC_DUMP_JSON ) ? 1 : 0;
+	out.wr  = wr;
+	out.arg = arg;
+	out.err = kErrNone;
+	out.len = 0;
+
+	out_str( &out, ( json != 0 ) ? "{\"functions\":[" : "functions\n" );
+	for( int f = 0; f < VC_STAT_LAST; f++ ) {
+		stats_sum( &s_stats_lat[0][f][0], (size_t) VC_STAT_LAST * VC_STATS_BUCKETS, bucket );
+		if(( json != 0 ) && ( f > 0 )) {
+			out_str( &out, "," );
+		}
+		stats_dump_hist( &out, s_stat_str[f], bucket, json );
+	}
+
+	out_str( &out, ( json != 0 ) ? "],\n\"types\":[" : "types\n" );
+	for( int t = 0; t < TYPE_LAST; t++ ) {
+		stats_sum( &s_stats_type[0][t][0], (size_t) TYPE_LAST * VC_STATS_BUCKETS, bucket );
+		if(( json != 0 ) && ( t > 0 )) {
+			out_str( &out, "," );
+		}
+		stats_dump_hist( &out, type2str( (U16) t ), bucket, json );
+	}
+
+	out_str( &out, ( json != 0 ) ? "],\n\"variables\":[" : "variables\n" );
+	first = 1;
+	for( HND h = 0; ( h < ctx->data->var_cnt ) && ( out.err == kErrNone ); h++ ) {
+		if(( vc_ctx_stats_var( ctx, h, &st ) != kErrNone )
+		|| ( 0u == ( st.reads | st.writes ))) {
+			continue;
+		}
+		if( json != 0 ) {
+			out_str( &out, ( first != 0 ) ? "{\"hnd\":" : ",\n{\"hnd\":" );
+			(void) vc_fmt_s64( num, (S64) h );
+			out_str( &out, num );
+			out_str( &out, ",\"scpi\":" );
+			out_json_str( &out, get_scpi( ctx, h ));
+			out_str( &out, ",\"reads\":" );
+		}
+		else {
+			out_str( &out, "  " );
+			out_str( &out, get_scpi( ctx, h ));
+			out_str( &out, " (" );
+			(void) vc_fmt_hex( num, h );
+			out_str( &out, num );
+			out_str( &out, "): reads " );
+		}
+		first = 0;
+		(void) vc_fmt_s64( num, (S64) st.reads );
+		out_str( &out, num );
+		out_str( &out, ( json != 0 ) ? ",\"writes\":" : ", writes " );
+		(void) vc_fmt_s64( num, (S64) st.writes );
+		out_str( &out, num );
+		out_str( &out, ( json != 0 ) ? ",\"errors\":" : ", errors " );
+		(void) vc_fmt_s64( num, (S64) st.errors );
+		out_str( &out, num );
+		out_str( &out, ( json != 0 ) ? "}" : "\n" );
+	}
+
+	if( json != 0 ) {
+		out_str( &out, "]}\n" );
+	}
+	out_flush( &out );
+
+	return out.err;
+#else
+	UNUSED_PARAM( ctx );
+	UNUSED_PARAM( wr );
+	UNUSED_PARAM( arg );
+	UNUSED_PARAM( format );
+	return kErrEmpty;
+#endif
+}
+
+/*** vc_stats_latency *******************************************************/
+/**
+ *   Read the latency histogram of an API function, summed over all
+ *   contexts and threads. Bucket i counts the calls that took less
+ *   than 2^(i+1) ns, the last one all longer calls.
+ *
+ *   @param fn     VC_STAT_AS_INT16 ... VC_STAT_RESET
+ *   @param bucket Returns VC_STATS_BUCKETS counters
+ *
+ *   @return kErrEmpty, when varcore is built without VC_STATISTICS.
+ */
+ErrCode vc_stats_latency( int fn, U64 *bucket ) {
+	if(( fn < 0 ) || ( fn >= VC_STAT_LAST ) || ( NULL == bucket )) {
+		return kErrInvalidArg;
+	}
+#ifdef VC_STATISTICS
+	stats_sum( &s_stats_lat[0][fn][0], (size_t) VC_STAT_LAST * VC_STATS_BUCKETS, bucket );
+	return kErrNone;
+#else
+	return kErrEmpty;
+#endif
+}
+
+/*** vc_stats_type **********************************************************/
+/**
+ *   Read the latency histogram of the accessors of a type, see
+ *   vc_stats_latency().
+ *
+ *   @param type   TYPE_INT8 ... TYPE_LAST - 1
+ *   @param bucket Returns VC_STATS_BUCKETS counters
+ *
+ *   @return kErrEmpty, when varcore is built without VC_STATISTICS.
+ */
+ErrCode vc_stats_type( int type, U64 *bucket ) {
+	if(( type < 0 ) || ( type >= TYPE_LAST ) || ( NULL == bucket )) {
+		return kErrInvalidArg;
+	}
+#ifdef VC_STATISTICS
+	stats_sum( &s_stats_type[0][type][0], (size_t) TYPE_LAST * VC_STATS_BUCKETS, bucket );
+	return kErrNone;
+#else
+	return kErrEmpty;
+#endif
+}
+
+/*** vc_ctx_get_min *******************************************************/
+/**
+ *   Read minimum value of a variable of types:
+ *      TYPE_INT8, TYPE_INT16, TYPE_INT32, TYPE_INT64, TYPE_F32, TYPE_DOUBLE.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param val    Pointer to value
+ *   @param chan   Channel
+ */
+ErrCode vc_ctx_get_min( VC_CTX *ctx, HND hnd, U8* val, U16 chan ) {
+	return rw_min_max( ctx, hnd, val, chan, 0 );
+}
+
+/*** vc_ctx_get_max *******************************************************/
+/**
+ *   Read maximum value of a variable of types:
+ *      TYPE_INT8, TYPE_INT16, TYPE_INT32, TYPE_INT64, TYPE_F32, TYPE_DOUBLE.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param val    Pointer to value
+ *   @param chan   Channel
+ */
+ErrCode vc_ctx_get_max( VC_CTX *ctx, HND hnd, U8* val, U16 chan ) {
+	return rw_min_max( ctx, hnd, val, chan, 1 );
+}
+
+/*** vc_get_min ***********************************************************/
+/**
+ *   Read minimum value of a variable of types:
+ *      TYPE_INT8, TYPE_INT16, TYPE_INT32, TYPE_INT64, TYPE_F32, TYPE_DOUBLE.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param val    Pointer to value
+ *   @param chan   Channel
+ *
+ *   The limits are kept apart from the values; they are part of
+ *   a snapshot, but not of vc_ctx_flush().
+ */
+ErrCode vc_ctx_set_min( VC_CTX *ctx, HND hnd, U8* val, U16 chan ) {
+	return rw_min_max( ctx, hnd, val, chan, 2 );
+}
+
+/*** vc_ctx_set_max *******************************************************/
+/**
+ *   Write maximum value of a variable of types:
+ *      TYPE_INT8, TYPE_INT16, TYPE_INT32, TYPE_INT64, TYPE_F32, TYPE_DOUBLE.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param val    Pointer to value
+ *   @param chan   Channel
+ *
+ *   The limits are kept apart from the values; they are part of
+ *   a snapshot, but not of vc_ctx_flush().
+ */
+ErrCode vc_ctx_set_max( VC_CTX *ctx, HND hnd, U8* val, U16 chan ) {
+	return rw_min_max( ctx, hnd, val, chan, 3 );
+}
+
+/*** vc_ctx_get_format ***********************************************/
+/**
+ *   Get format of the variable
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param fmt    Pointer to format
+ */
+ErrCode vc_ctx_get_format( VC_CTX *ctx, HND hnd, U16 *fmt ) {
+	VAR_DESC const *var;
+
+	assert( hnd < ctx->data->var_cnt );
+
+	var = get_var( ctx, hnd );
+	*(U16*)fmt = var->fmt;
+
+	return kErrNone;
+}
+
+/*** vc_ctx_get_storage *****************************************************/
+/**
+ *   Get the storage modifier of the variable.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param store  Storage
+ */
+ErrCode vc_ctx_get_storage( VC_CTX *ctx, HND hnd, U16 *store ) {
+	VAR_DESC const *var;
+
+	assert( ctx->data );
+	
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
+
+	if( NULL == store ) {
+		return kErrInvalidArg;
+	}
+
+	var = get_var( ctx, hnd );
+	*store = var->type & MSK_STORAGE;
+
+	return kErrNone;
+}
+
+/*** vc_ctx_enum_symbol **********************************************************/
+/**
+ *   Get the symbol of an enum member.
+ *
+ *   The symbol points into the table generated by varpp, nothing is
+ *   copied.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param val    value of the member
+ *   @param sym    symbol
+ *
+ *   @return kErrInvalidEnum if val is not a member or the member
+ *           has no symbol.
+ */
+ErrCode vc_ctx_enum_symbol( VC_CTX *ctx, HND hnd, S16 val, char const **sym ) {
+	VAR_DESC const *var;
+	ENUM_MBR const *mbr;
+
+	assert( ctx->data );
+
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
+
+	if( NULL == sym ) {
+		return kErrInvalidArg;
+	}
+
+	var = get_var( ctx, hnd );
+	if(( var->type & TYPE_MASK ) != TYPE_ENUM ) {
+		return kErrInvalidType;
+	}
+
+	mbr = enum_by_value( get_enum_dscr( ctx, hnd ), val );
+	if(( mbr == NULL ) || ( mbr->symbol < 0 ) || ( ctx->data->enum_sym == NULL )) {
+		return kErrInvalidEnum;
+	}
+
+	*sym = &ctx->data->enum_sym[mbr->symbol];
+	return kErrNone;
+}
+
+/*** vc_ctx_enum_value ***********************************************************/
+/**
+ *   Get the value of an enum member from its symbol.
+ *
+ *   The symbol is looked up in the hashed symbol index of the enum
+ *   descriptor, see DESCR_ENUM.
+ *
+ *   @param ctx    Context
+ *   @param hnd    Variable handle
+ *   @param sym    symbol
+ *   @param val    value of the member
+ *
+ *   @return kErrInvalidEnum if no member has this symbol.
+ */
+ErrCode vc_ctx_enum_value( VC_CTX *ctx, HND hnd, char const *sym, S16 *val ) {
+	VAR_DESC const *var;
+	ENUM_MBR const *mbr;
+
+	assert( ctx->data );
+
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
+
+	if(( NULL == sym ) || ( NULL == val )) {
+		return kErrInvalidArg;
+	}
+
+	var = get_var( ctx, hnd );
+	if(( var->type & TYPE_MASK ) != TYPE_ENUM ) {
+		return kErrInvalidType;
+	}
+
+	mbr = enum_by_symbol( ctx, get_enum_dscr( ctx, hnd ), sym );
+	if( mbr == NULL ) {
+		return kErrInvalidEnum;
+	}
+
+	*val = mbr->value;
+	return kErrNone;
+}
+
+/*** vc_ctx_get_hnd *********************************************************/
+/**
+ *   Get the handle of a variable from its SCPI string.
+ *
+ *   The handle is read from the perfect hash table generated by varpp.
+ *   Only one string compare is necessary. If the table is missing,
+ *   all variables are searched.
+ *
+ *   @param ctx    Context
+ *   @param scpi   SCPI string
+ *
+ *   @return HNON, when scpi was not found.
+ */
+HND vc_ctx_get_hnd( VC_CTX *ctx, char const *scpi ) {
+	HND hnd;
+
+	STATS_TIME( VC_STAT_GET_HND, hnd = get_hnd( ctx, scpi ));
+	return hnd;
+}
+
+/*** get_hnd ****************************************************************/
+/**
+ *   See vc_ctx_get_hnd().
+ */
+static HND get_hnd( VC_CTX *ctx, char const *scpi ) {
+
+	assert( ctx->data );
+
+	if( NULL == scpi ) {
+		return HNON;
+	}
+
+	if(( ctx->data->scpi_hash_cnt > 0u ) && ( ctx->data->scpi_disp_cnt > 0u )) {
+		U32 slot = vc_hash_slot( scpi, ctx->data->scpi_seed,
+		                         ctx->data->scpi_disp, ctx->data->scpi_disp_cnt,
+		                         ctx->data->scpi_hash_cnt );
+		HND hnd = ctx->data->scpi_hash[slot];
+
+		if(( hnd < ctx->data->var_cnt ) && ( 0 == strcmp( scpi, get_scpi( ctx, hnd )))) {
+			return hnd;
+		}
+		return HNON;
+	}
+
+	/* without a hash table, hidden variables have no SCPI string either */
+	for( HND i = 0; i < ctx->data->var_cnt; i++ ) {
+		VAR_DESC const *var = get_var( ctx, i );
+
+		if(( var->scpi_idx != HNON ) &&
+		   ( 0 == strcmp( scpi, &ctx->data->data_const_str[var->scpi_idx] ))) {
+			return i;
+		}
+	}
+
+	return HNON;
+}
+
+/*** vc_ctx_snapshot_size ***************************************************/
+/**
+ *   Size of a snapshot, see vc_ctx_snapshot().
+ *
+ *   @param ctx    Context
+ */
+size_t vc_ctx_snapshot_size( VC_CTX *ctx ) {
+	size_t size = sizeof(SNAP_HDR);
+
+	assert( ctx->data );
+
+	/* only the values, the sequence counters are no state */
+	for( int i = 0; i < kStoreSeq; i++ ) {
+		size += store_size( ctx->data, i );
+	}
+	return size;
+}
+
+/*** vc_ctx_snapshot ********************************************************/
+/**
+ *   Copy the values of all variables into a buffer.
+ *
+ *   The snapshot is a header with a hash of the table layout followed
+ *   by a copy of each value array. Like vc_ctx_restore() it holds the
+ *   write lock of every variable meanwhile, so it has each write and
+ *   each transaction completely or not at all.
+ *
+ *   @param ctx    Context
+ *   @param buf    Buffer, vc_ctx_snapshot_size() bytes
+ */
+ErrCode vc_ctx_snapshot( VC_CTX *ctx, void *buf ) {
+	U8 *p = (U8*) buf;
+	SNAP_HDR hdr;
+
+	assert( ctx->data );
+
+	if( NULL == buf ) {
+		return kErrInvalidArg;
+	}
+
+	hdr.magic    = SNAP_MAGIC;
+	hdr.layout   = ctx->layout;
+	hdr.size     = (U32) vc_ctx_snapshot_size( ctx );
+	hdr.stored   = (U32) EEPROM | (U32) FLASH;
+	(void) memcpy( p, &hdr, sizeof(hdr));
+	p += sizeof(hdr);
+
+	for( HND hnd = 0; hnd < ctx->data->var_cnt; hnd++ ) {
+		seq_write_begin( ctx, hnd );
+	}
+
+	for( int i = 0; i < kStoreSeq; i++ ) {
+		size_t size = store_size( ctx->data, i );
+		if( size > 0u ) {
+			(void) memcpy( p, store_get( ctx->data, i ), size );
+			p += size;
+		}
+	}
+
+	for( HND hnd = 0; hnd < ctx->data->var_cnt; hnd++ ) {
+		seq_write_end( ctx, hnd );
+	}
+
+	return kErrNone;
+}
+
+/*** vc_ctx_restore *********************************************************/
+/**
+ *   Restore the values of all variables from a snapshot.
+ *
+ *   The snapshot has to be taken from a table with the same layout.
+ *   Subscribers are not notified, the non-volatile variables are
+ *   marked dirty. Derived variables are recomputed when read.
+ *
+ *   @param ctx    Context
+ *   @param buf    Snapshot from vc_ctx_snapshot()
+ *
+ *   @return kErrLayout, when the snapshot doesn't fit the table.
+ */
+ErrCode vc_ctx_restore( VC_CTX *ctx, void const *buf ) {
+	U8 const *p = (U8 const *) buf;
+	SNAP_HDR hdr;
+
+	assert( ctx->data );
+
+	if( NULL == buf ) {
+		return kErrInvalidArg;
+	}
+
+	(void) memcpy( &hdr, p, sizeof(hdr));
+	if( hdr.magic != SNAP_MAGIC ) {
+		return kErrInvalidValue;
+	}
+	if(( hdr.layout != ctx->layout ) || ( hdr.size != vc_ctx_snapshot_size( ctx ))) {
+		return kErrLayout;
+	}
+	p += sizeof(hdr);
+
+	for( HND hnd = 0; hnd < ctx->data->var_cnt; hnd++ ) {
+		seq_write_begin( ctx, hnd );
+	}
+
+	for( int i = 0; i < kStoreSeq; i++ ) {
+		size_t size = store_size( ctx->data, i );
+		if( size > 0u ) {
+			(void) memcpy( store_get( ctx->data, i ), p, size );
+			p += size;
+		}
+	}
+
+	for( HND hnd = 0; hnd < ctx->data->var_cnt; hnd++ ) {
+		seq_write_end( ctx, hnd );
+		mark_dirty( ctx, hnd );
+	}
+	derive_stale_all( ctx );
+
+	return kErrNone;
+}
+
+/*** vc_ctx_is_dirty *******************************************************/
+/**
+ *   Check for changed variables of a storage class.
+ *
+ *   @param ctx      Context
+ *   @param storage  EEPROM or FLASH
+ *
+ *   @return 1, when vc_ctx_flush() has something to write.
+ */
+int vc_ctx_is_dirty( VC_CTX *ctx, U16 storage ) {
+	U32       cnt;
+	VC_DIRTY *dirty;
+
+	assert( ctx->data );
+
+	dirty = dirty_words( ctx, storage, &cnt );
+	if( NULL == dirty ) {
+		return 0;
+	}
+
+	for( U32 i = 0; i < cnt; i++ ) {
+		if( SEQ_LOAD( &dirty[i], relaxed ) != 0u ) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*** vc_ctx_flush ***********************************************************/
+/**
+ *   Write the changed variables of a storage class to a backend.
+ *
+ *   Every write of an EEPROM or FLASH variable marks it in the dirty
+ *   bitmap of its storage class, vc_ctx_init() and vc_ctx_reset()
+ *   mark all of them. The flush writes only the marked
+ *   variables, each once, however often it was written since the last
+ *   flush. Variables with adjacent handles and values are written with
+ *   one call of be->write. Call it from a periodic task to coalesce
+ *   bursts of writes, vc_ctx_is_dirty() tells if there is something
+ *   to do.
+ *
+ *   After the variables the snapshot header is written and be->sync
+ *   is called. The header records the flushed storage classes, with
+ *   be->read the classes of the old header are kept. Variables, that
+ *   failed to write, stay dirty.
+ *
+ *   With VC_THREAD_SAFE the variables are locked during be->write,
+ *   only one flush of a storage class should run at a time.
+ *
+ *   @param ctx      Context
+ *   @param storage  EEPROM or FLASH
+ *   @param be       Backend
+ *
+ *   @return first error of the backend.
+ */
+ErrCode vc_ctx_flush( VC_CTX *ctx, U16 storage, VC_BACKEND const *be ) {
+	U32        cnt;
+	VC_DIRTY  *dirty;
+	ErrCode    E = kErrNone;
+	int        written = 0;
+
+	/* pending run of adjacent variables */
+	HND        first = HNON;
+	HND        last  = HNON;
+	U8 const  *data  = NULL;
+	U32        offs  = 0;
+	size_t     size  = 0;
+
+	assert( ctx->data );
+
+	if(( NULL == be ) || ( NULL == be->write )) {
+		return kErrInvalidArg;
+	}
+	if(( storage != EEPROM ) && ( storage != FLASH )) {
+		return kErrInvalidArg;
+	}
+
+	dirty = dirty_words( ctx, storage, &cnt );
+	if( NULL == dirty ) {
+		return kErrNone;
+	}
+
+	for( U32 w = 0; w < cnt; w++ ) {
+		U32 bits = dirty_take( &dirty[w] );
+
+		for( U32 b = 0; bits != 0u; b++ ) {
+			HND     hnd = (HND)( w * 32u + b );
+			U32     o;
+			size_t  n;
+			U8     *p;
+
+			if(( bits & ( 1u << b )) == 0u ) {
+				continue;
+			}
+			bits &= ~( 1u << b );
+
+			p = var_image( ctx, get_var( ctx, hnd ), &o, &n );
+			if( NULL == p ) {
+				continue;
+			}
+
+			seq_write_begin( ctx, hnd );
+			if(( first != HNON ) && ( hnd == last + 1u ) && ( o == offs + size )) {
+				last = hnd;
+				size += n;
+				continue;
+			}
+
+			if( first != HNON ) {
+				ErrCode ret = flush_run( ctx, be, first, last, data, offs, size );
+				E = ( kErrNone == E ) ? ret : E;
+				written = 1;
+			}
+			first = hnd;
+			last  = hnd;
+			data  = p;
+			offs  = o;
+			size  = n;
+		}
+	}
+
+	if( first != HNON ) {
+		ErrCode ret = flush_run( ctx, be, first, last, data, offs, size );
+		E = ( kErrNone == E ) ? ret : E;
+		written = 1;
+	}
+
+	if(( written != 0 ) && ( kErrNone == E )) {
+		SNAP_HDR hdr;
+		SNAP_HDR old;
+
+		hdr.magic    = SNAP_MAGIC;
+		hdr.layout   = ctx->layout;
+		hdr.size     = (U32) vc_ctx_snapshot_size( ctx );
+		hdr.stored   = storage;
+
+		/* keep the other storage class, when it was flushed before */
+		if(( be->read != NULL ) && ( kErrNone == be->read( be->arg, HNON, 0u, &old, sizeof(old))) &&
+		   ( SNAP_MAGIC == old.magic ) && ( old.layout == hdr.layout ) && ( old.size == hdr.size )) {
+			hdr.stored |= old.stored;
+		}
+		E = be->write( be->arg, HNON, 0u, &hdr, sizeof(hdr));
+		if(( kErrNone == E ) && ( be->sync != NULL )) {
+			E = be->sync( be->arg );
+		}
+	}
+
+	return E;
+}
+
+/*** vc_ctx_load ************************************************************/
+/**
+ *   Read the variables of a storage class from a backend, eg.
+ *   after vc_ctx_init() and before other threads use the table.
+ *
+ *   When all variables are read, they are no longer dirty.
+ *   Subscribers are not notified.
+ *
+ *   @param ctx      Context
+ *   @param storage  EEPROM or FLASH
+ *   @param be       Backend
+ *
+ *   @return kErrLayout, when the backend holds the data of another table,
+ *           kErrEmpty, when the storage class was never flushed.
+ */
+ErrCode vc_ctx_load( VC_CTX *ctx, U16 storage, VC_BACKEND const *be ) {
+	SNAP_HDR hdr;
+	ErrCode  E;
+
+	assert( ctx->data );
+
+	if(( NULL == be ) || ( NULL == be->read )) {
+		return kErrInvalidArg;
+	}
+	if(( storage != EEPROM ) && ( storage != FLASH )) {
+		return kErrInvalidArg;
+	}
+
+	E = be->read( be->arg, HNON, 0u, &hdr, sizeof(hdr));
+	if( E != kErrNone ) {
+		return E;
+	}
+	if( hdr.magic != SNAP_MAGIC ) {
+		return kErrInvalidValue;
+	}
+	if(( hdr.layout != ctx->layout ) || ( hdr.size != vc_ctx_snapshot_size( ctx ))) {
+		return kErrLayout;
+	}
+	/* the values of a class, that was never flushed, are no values */
+	if(( hdr.stored & storage ) == 0u ) {
+		return kErrEmpty;
+	}
+
+	for( HND hnd = 0; ( kErrNone == E ) && ( hnd < ctx->data->var_cnt ); hnd++ ) {
+		VAR_DESC const *var = get_var( ctx, hnd );
+		U32     offs;
+		size_t  size;
+		U8     *p;
+
+		if(( var->type & MSK_STORAGE ) != storage ) {
+			continue;
+		}
+
+		p = var_image( ctx, var, &offs, &size );
+		if( NULL == p ) {
+			continue;
+		}
+
+		seq_write_begin( ctx, hnd );
+		E = be->read( be->arg, hnd, offs, p, size );
+		seq_write_end( ctx, hnd );
+	}
+	derive_stale_all( ctx );
+
+	if( kErrNone == E ) {
+		U32       cnt;
+		VC_DIRTY *dirty = dirty_words( ctx, storage, &cnt );
+
+		for( U32 i = 0; ( dirty != NULL ) && ( i < cnt ); i++ ) {
+			SEQ_STORE( &dirty[i], 0u, relaxed );
+		}
+	}
+
+	return E;
+}
+
+static int add_sep( char *buf, int bufsz, char c, int len ) {
+	int n;
+
+	assert( buf );
+	assert( len > 0 );
+
+	n = (len > bufsz) ? bufsz : len;
+	(void) memset( buf, c, n );
+
+	if(( n+2 ) < bufsz ) {
+		buf[n] = '\n'; n++;
+		buf[n] = '\0';
+	}
+	return n;
+
+}
+
+
+/*** vc_ctx_dump_var ********************************************************/
+/**
+ *   Write the contents of the variable to a string buffer.
+ * 
+ *   This function is for introspection and debugging purposes.
+ *
+ *   @param ctx    Context
+ *   @param buf    Pointer to atring buffer
+ *   @param bufsz  Buffer size
+ *   @param hnd    Variable handle
+ *   @param chan   Channel
+ */
+int vc_ctx_dump_var( VC_CTX *ctx, char *buf, int bufsz, HND hnd, U16 chan ) {
+	#define CHECK_LEN( b, n, l, s ) do { \
+     if( ((n) < 0) || ((l)+(n)) >= (s) ) {  \
+			 (b)[(l)] = '\0'; \
+			 return (l); \
+		 } \
+	} while(0)
+
+
+	VAR_DESC const *var;
+	STRBUF spaces;
+	U16 type;
+	U16 storage;
+	int n;
+	int len = 0;
+	char const *scpi;
+
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
+
+	(void) memset( spaces, ' ', sizeof(STRBUF));
+
+	var     = get_var( ctx, hnd );
+	type    = var->type & TYPE_MASK;
+	storage = (var->type & (U16)MSK_STORAGE) >> 8u;
+	scpi    = get_scpi( ctx, hnd );
+
+	derive_fresh( ctx, var, hnd, 0u, var->vec_items );
+
+	n = add_sep( &buf[len], bufsz - len, '=', 50 );
+	CHECK_LEN( buf, n, len, bufsz );
+	len += n;
+
+	n = snprintf( &buf[len], bufsz - len,
+		"SCPI:               %s\n"
+		"Hnd:                %#04X\n"
+		"Data type:          %s (%#04hX)\n"
+		"Items:              %d\n"
+		"Access:             %#04hX\n"
+		"Storage:            %s (%#04hX)\n"
+		"Format:             %s (%#04hX)\n"
+		"Descriptor Idx:     %d\n"
+		"Data Idx:           %d\n"
+		"Data\n"
+		,
+		scpi,
+		hnd,
+		type2str(type), var->type,
+		var->vec_items,
+		var->acc_rights,
+		storage2str(var->type), storage,
+		format2str(var->fmt), var->fmt,
+		var->descr_idx,
+		var->data_idx
+	);
+
+	CHECK_LEN( buf, n, len, bufsz );
+	len += n;
+
+	n = add_sep( &buf[len], bufsz - len, '-', 50 );
+	CHECK_LEN( buf, n, len, bufsz );
+	len += n;
+
+	switch( type ) {
+		case TYPE_INT16:
+
+		  n = snprintf( &buf[len], bufsz - len, "          val    min    max\n");
+			CHECK_LEN( buf, n, len, bufsz );
+			len += n;
+
+			if( var->vec_items == 1u ) {
+				n = snprintf( &buf[len], bufsz - len, "     ");
+				CHECK_LEN( buf, n, len, bufsz );
+				len += n;
+			}
+
+			for( U16 i = 0; i < var->vec_items; i++ ) {
+				S16 const *d = &ctx->data->data_s16[var->data_idx + i];
+				LIM_S16 const *l = &ctx->data->lim_s16[var->data_idx + i];
+
+				if( var->vec_items > 1u ) {
+					n = snprintf( &buf[len], bufsz - len, " %3d:", i );
+					CHECK_LEN( buf, n, len, bufsz );
+					len += n;	
+				}
+				n = snprintf( &buf[len], bufsz - len, "  %6hd %6hd %6hd\n", *d, l->min, l->max );
+				CHECK_LEN( buf, n, len, bufsz );
+				len += n;
+			}
+			break;
+
+		case TYPE_INT32:
+
+		  n = snprintf( &buf[len], bufsz - len, "          val    min    max\n");
+			CHECK_LEN( buf, n, len, bufsz );
+			len += n;
+
+			if( var->vec_items == 1u ) {
+				n = snprintf( &buf[len], bufsz - len, "     ");
+				CHECK_LEN( buf, n, len, bufsz );
+				len += n;
+			}
+
+			for( U16 i = 0; i < var->vec_items; i++ ) {
+				S32 const *d = &ctx->data->data_s32[var->data_idx + i];
+				LIM_S32 const *l = &ctx->data->lim_s32[var->data_idx + i];
+
+				if( var->vec_items > 1u ) {
+					n = snprintf( &buf[len], bufsz - len, " %3d:", i );
+					CHECK_LEN( buf, n, len, bufsz );
+					len += n;	
+				}
+				n = snprintf( &buf[len], bufsz - len, " %6d %6d %6d\n", *d, l->min, l->max );
+				CHECK_LEN( buf, n, len, bufsz );
+				len += n;
+			}
+			break;
+
+		case TYPE_FLOAT:
+			n = snprintf( &buf[len], bufsz - len, "                val           min           max\n");
+			CHECK_LEN( buf, n, len, bufsz );
+			len += n;
+
+			if( var->vec_items == 1u ) {
+				n = snprintf( &buf[len], bufsz - len, "     ");
+				CHECK_LEN( buf, n, len, bufsz );
+				len += n;
+			}
+
+			for( U16 i = 0; i < var->vec_items; i++ ) {
+				F32 const *d = &ctx->data->data_f32[var->data_idx + i];
+				LIM_F32 const *l = &ctx->data->lim_f32[var->data_idx + i];
+
+				if( var->vec_items > 1u ) {
+					n = snprintf( &buf[len], bufsz - len, " %3d:", i );
+					CHECK_LEN( buf, n, len, bufsz );
+					len += n;	
+				}
+
+				n = snprintf( &buf[len], bufsz - len, " %13.*f %13.*f %13.*f\n", 
+											var->fmt, *d, var->fmt, l->min, var->fmt, l->max );
+				CHECK_LEN( buf, n, len, bufsz );
+				len += n;
+			}
+			break;
+
+		case TYPE_INT8:
+
+		  n = snprintf( &buf[len], bufsz - len, "          val    min    max\n");
+			CHECK_LEN( buf, n, len, bufsz );
+			len += n;
+
+			if( var->vec_items == 1u ) {
+				n = snprintf( &buf[len], bufsz - len, "     ");
+				CHECK_LEN( buf, n, len, bufsz );
+				len += n;
+			}
+
+			for( U16 i = 0; i < var->vec_items; i++ ) {
+				S8 const *d = &ctx->data->data_s8[var->data_idx + i];
+				LIM_S8 const *l = &ctx->data->lim_s8[var->data_idx + i];
+
+				if( var->vec_items > 1u ) {
+					n = snprintf( &buf[len], bufsz - len, " %3d:", i );
+					CHECK_LEN( buf, n, len, bufsz );
+					len += n;	
+				}
+				n = snprintf( &buf[len], bufsz - len, "  %6d %6d %6d\n", *d, l->min, l->max );
+				CHECK_LEN( buf, n, len, bufsz );
+				len += n;
+			}
+			break;
+
+		case TYPE_INT64:
+
+		  n = snprintf( &buf[len], bufsz - len, "          val    min    max\n");
+			CHECK_LEN( buf, n, len, bufsz );
+			len += n;
+
+			if( var->vec_items == 1u ) {
+				n = snprintf( &buf[len], bufsz - len, "     ");
+				CHECK_LEN( buf, n, len, bufsz );
+				len += n;
+			}
+
+			for( U16 i = 0; i < var->vec_items; i++ ) {
+				S64 const *d = &ctx->data->data_s64[var->data_idx + i];
+				LIM_S64 const *l = &ctx->data->lim_s64[var->data_idx + i];
+
+				if( var->vec_items > 1u ) {
+					n = snprintf( &buf[len], bufsz - len, " %3d:", i );
+					CHECK_LEN( buf, n, len, bufsz );
+					len += n;	
+				}
+				n = snprintf( &buf[len], bufsz - len, " %6lld %6lld %6lld\n", *d, l->min, l->max );
+				CHECK_LEN( buf, n, len, bufsz );
+				len += n;
+			}
+			break;
+
+		case TYPE_DOUBLE:
+			n = snprintf( &buf[len], bufsz - len, "                val           min           max\n");
+			CHECK_LEN( buf, n, len, bufsz );
+			len += n;
+
+			if( var->vec_items == 1u ) {
+				n = snprintf( &buf[len], bufsz - len, "     ");
+				CHECK_LEN( buf, n, len, bufsz );
+				len += n;
+			}
+
+			for( U16 i = 0; i < var->vec_items; i++ ) {
+				F64 const *d = &ctx->data->data_f64[var->data_idx + i];
+				LIM_F64 const *l = &ctx->data->lim_f64[var->data_idx + i];
+
+				if( var->vec_items > 1u ) {
+					n = snprintf( &buf[len], bufsz - len, " %3d:", i );
+					CHECK_LEN( buf, n, len, bufsz );
+					len += n;	
+				}
+
+				n = snprintf( &buf[len], bufsz - len, " %13.*f %13.*f %13.*f\n", 
+											var->fmt, *d, var->fmt, l->min, var->fmt, l->max );
+				CHECK_LEN( buf, n, len, bufsz );
+				len += n;
+			}
+			break;
+
+		case TYPE_ENUM:
+			{
+				DESCR_ENUM const *dscr = get_enum_dscr( ctx, hnd );
+				for( U16 i = 0; i < dscr->cnt; i++ ) {
+					ENUM_MBR const *mbr = (ENUM_MBR const *)&dscr->mbr[i];
+					STRBUF S;
+
+					ErrCode E = as_string( ctx, mbr->hnd, VarRead, S, chan, REQ_PRG );
+					if( kErrNone == E ) {
+						int flag = 0;
+						size_t x;
+
+						x = strlen( S );
+						spaces[11-x] = '\0';
+						n = snprintf( &buf[len], bufsz - len, "%2d:  %s%s %4d", i, S, spaces, mbr->value );
+						spaces[11-x] = ' ';
+						CHECK_LEN( buf, n, len, bufsz );
+						len += n;
+							
+						for( U16 c = 0; c < var->vec_items; c++ ) {
+							U16 idx = var->data_idx + c;
+							/* cppcheck-suppress misra-c2012-11.8 */
+							DATA_ENUM *d = (DATA_ENUM *)&ctx->data->data_enum[idx];
+
+							if( *d == mbr->value ) {
+								if( !flag ) {
+									n = snprintf( &buf[len], bufsz - len, " <= [" );
+									flag = 1;
+								}
 								else {
 									n = snprintf( &buf[len], bufsz - len, ", " );
 								}
 								CHECK_LEN( buf, n, len, bufsz );
 								len += n;
 
-								n = snprintf( &buf[len], bufsz - len, "%u", c+1u );
-								CHECK_LEN( buf, n, len, bufsz );
-								len += n;
-							}
-						}
+								n = snprintf( &buf[len], bufsz - len, "%u", c+1u );
+								CHECK_LEN( buf, n, len, bufsz );
+								len += n;
+							}
+						}
+
+						if( flag != 0 ) {
+							n = snprintf( &buf[len], bufsz - len, "]\n" );
+						}
+						else {
+							n = snprintf( &buf[len], bufsz - len, "\n" );
+						}
+						CHECK_LEN( buf, n, len, bufsz );
+						len += n;
+					}
+				}
+			}
+			break;
+
+			default:
+				LOG_UNH_CASE( type );
+				break;
+	}
+
+	n = add_sep( &buf[len], bufsz - len, '=', 50 );
+	CHECK_LEN( buf, n, len, bufsz );
+	len += n;
+
+	return len;
+}
+
+/*** vc_ctx_dump_all ********************************************************/
+/**
+ *   Write all variables, or the variables in hnd, as text or JSON.
+ *
+ *   The output is collected in one buffer of VC_DUMP_CHUNK characters
+ *   and passed to wr whenever it is full, so a table of any size is
+ *   written in one pass without allocations.
+ *
+ *   VC_DUMP_TEXT has a line per variable and a line per channel,
+ *   the values look like vc_ctx_as_string():
+ *
+ *     LEM:VOLT (0x3) TYPE_INT16 EEPROM
+ *       0: 12 [0, 100]
+ *
+ *   VC_DUMP_JSON is an array with an object per variable, vectors
+ *   have arrays for value, min and max. Floats are written in their
+ *   shortest form, nan and inf as null:
+ *
+ *     [{"hnd":3,"scpi":"LEM:VOLT","type":"TYPE_INT16",
+ *       "storage":"EEPROM","value":12,"min":0,"max":100}]
+ *
+ *   @param ctx    Context
+ *   @param wr     Writer
+ *   @param arg    Argument of wr
+ *   @param format VC_DUMP_TEXT or VC_DUMP_JSON
+ *   @param hnd    Variable handles, NULL for all variables
+ *   @param n      Number of handles
+ *
+ *   @return kErrNone, kErrInvalidArg or kErrUnknownCmd, nothing is
+ *           written then. Otherwise the first error of wr.
+ */
+ErrCode vc_ctx_dump_all( VC_CTX *ctx, VC_WRITER wr, void *arg, int format, HND const *hnd, size_t n ) {
+	DUMP_OUT out;
+	size_t cnt;
+	size_t i;
+	int json;
+
+	assert( ctx->data );
+
+	if(( NULL == wr ) || (( format != VC_DUMP_TEXT ) && ( format != VC_DUMP_JSON ))) {
+		return kErrInvalidArg;
+	}
+
+	if( NULL == hnd ) {
+		cnt = ctx->data->var_cnt;
+	}
+	else {
+		for( i = 0; i < n; i++ ) {
+			if( hnd[i] >= ctx->data->var_cnt ) {
+				return kErrUnknownCmd;
+			}
+		}
+		cnt = n;
+	}
+
+	json    = ( format == VC_DUMP_JSON ) ? 1 : 0;
+	out.wr  = wr;
+	out.arg = arg;
+	out.err = kErrNone;
+	out.len = 0;
+
+	if( json != 0 ) {
+		out_str( &out, "[" );
+	}
+
+	for( i = 0; ( i < cnt ) && ( out.err == kErrNone ); i++ ) {
+		if(( json != 0 ) && ( i > 0u )) {
+			out_str( &out, ",\n" );
+		}
+		dump_one( ctx, &out, ( NULL == hnd ) ? (HND) i : hnd[i], json );
+	}
+
+	if( json != 0 ) {
+		out_str( &out, "]\n" );
+	}
+	out_flush( &out );
+
+	return out.err;
+}
+
+/*** vc_chk_vector **********************************************************/
+/**
+ *
+ *
+ */
+static ErrCode vc_chk_vector( VAR_DESC const *var, U16 chan )
+{
+	int ret;
+
+	ret = kErrNoVector;
+	if ( is_vector( var ) != 0 ) {
+		ret = kErrNone;
+		if(chan >= var->vec_items) {
+			ret = kErrInvalidChan;
+		}
+	}
+	return ret;
+}
+
+/*** init_var *************************************************************/
+/**
+ *	 Copy the default values and the limits from the descriptor of
+ *	 \b var, see init_s16() ...
+ *
+ *   @param var   Variable
+ *
+ *   @return kErrNone, when done.
+ */
+static ErrCode init_var( VC_CTX *ctx, VAR_DESC const *var ) {
+	ErrCode E    = kErrNone;
+	U16     type = var->type & TYPE_MASK;
+
+	switch( type ) {
+		case TYPE_INT16:
+			E = init_s16( ctx, var );
+			break;
+
+		case TYPE_INT32:
+			E = init_s32( ctx, var );
+			break;
+
+		case TYPE_ENUM:
+			E = init_enum( ctx, var );
+			break;
+
+		case TYPE_FLOAT:
+			E = init_f32( ctx, var );
+			break;
+
+		case TYPE_DOUBLE:
+			E = init_f64( ctx, var );
+			break;
+
+		case TYPE_INT8:
+			E = init_s8( ctx, var );
+			break;
+
+		case TYPE_INT64:
+			E = init_s64( ctx, var );
+			break;
+
+		case TYPE_STRING:
+			E = init_string( ctx, var );
+			break;
+
+		case TYPE_ACTION:
+			break;
+
+		default:
+			LOG_UNH_CASE( type );
+			break;
+	}
+	return E;
+}
+
+/*** reset_var ************************************************************/
+/**
+ *	 Copy the values and limits of \b var from the defaults image,
+ *	 or from the descriptor when the table has no image.
+ *
+ *   @param var   Variable
+ *
+ *   @return kErrNone, when done.
+ */
+static ErrCode reset_var( VC_CTX *ctx, VAR_DESC const *var ) {
+	VC_DATA const *vc = ctx->data;
+	size_t         item;
+	size_t         pos;
+	int            st = var_store( var, &item );
+
+	if( NULL == vc->dflt_s16 ) {
+		return init_var( ctx, var );
+	}
+	if( kStoreLast == st ) {
+		return kErrNone;
+	}
+
+	/* data_idx of strings is an index of the characters */
+	pos = ( kStoreStr == st ) ? var->data_idx : ( var->data_idx * item );
+	(void) memcpy( (U8*) store_get( vc, st ) + pos, (U8 const *) store_dflt( vc, st ) + pos,
+	               var->vec_items * item );
+
+	if( st <= kStoreS64 ) {
+		/* limits are min and max of the same type */
+		st += kStoreLimS16 - kStoreS16;
+		(void) memcpy( (U8*) store_get( vc, st ) + 2u * pos, (U8 const *) store_dflt( vc, st ) + 2u * pos,
+		               2u * var->vec_items * item );
+	}
+	else {
+		; /* misra-c2012-15.7 */
+	}
+	return kErrNone;
+}
+
+/*** vc_init_s16 ************************************************************/
+/**
+ *	 Copy the default values and the limits from the descriptor into
+ *	 the value and limit arrays of \b var
+ *
+ *   @param var   Variable handle
+ *
+ *   @return kErrNone, when done.
+ */
+static ErrCode init_s16( VC_CTX *ctx, VAR_DESC const *var ) {
+	DATA_S16 const *descr = &ctx->data->descr_s16[var->descr_idx];
+	S16            *data  = &ctx->data->data_s16[var->data_idx];
+	LIM_S16        *lim   = &ctx->data->lim_s16[var->data_idx];
+
+	for( U16 i = 0; i < var->vec_items; i++ ) {
+		data[i]    = descr[i].def_value;
+		lim[i].min = descr[i].min;
+		lim[i].max = descr[i].max;
+	}
+	return kErrNone;
+}
+
+/*** vc_init_s32 **********************************************************/
+/**
+ *	 Copy the default values and the limits from the descriptor into
+ *	 the value and limit arrays of \b var
+ *
+ *   @param var   Variable handle
+ *
+ *   @return kErrNone, when done.
+ */
+static ErrCode init_s32( VC_CTX *ctx, VAR_DESC const *var ) {
+	DATA_S32 const *descr = &ctx->data->descr_s32[var->descr_idx];
+	S32            *data  = &ctx->data->data_s32[var->data_idx];
+	LIM_S32        *lim   = &ctx->data->lim_s32[var->data_idx];
+
+	for( U16 i = 0; i < var->vec_items; i++ ) {
+		data[i]    = descr[i].def_value;
+		lim[i].min = descr[i].min;
+		lim[i].max = descr[i].max;
+	}
+	return kErrNone;
+}
+
+/*** vc_init_f32 **********************************************************/
+/**
+ *	 Copy the default values and the limits from the descriptor into
+ *	 the value and limit arrays of \b var
+ *
+ *   @param var   Variable handle
+ *
+ *   @return kErrNone, when done.
+ */
+static ErrCode init_f32( VC_CTX *ctx, VAR_DESC const *var ) {
+	DATA_F32 const *descr = &ctx->data->descr_f32[var->descr_idx];
+	F32            *data  = &ctx->data->data_f32[var->data_idx];
+	LIM_F32        *lim   = &ctx->data->lim_f32[var->data_idx];
+
+	for( U16 i = 0; i < var->vec_items; i++ ) {
+		data[i]    = descr[i].def_value;
+		lim[i].min = descr[i].min;
+		lim[i].max = descr[i].max;
+	}
+	return kErrNone;
+}
+
+/*** vc_init_f64 **********************************************************/
+/**
+ *	 Copy the default values and the limits from the descriptor into
+ *	 the value and limit arrays of \b var
+ *
+ *   @param var   Variable handle
+ *
+ *   @return kErrNone, when done.
+ */
+static ErrCode init_f64( VC_CTX *ctx, VAR_DESC const *var ) {
+	DATA_F64 const *descr = &ctx->data->descr_f64[var->descr_idx];
+	F64            *data  = &ctx->data->data_f64[var->data_idx];
+	LIM_F64        *lim   = &ctx->data->lim_f64[var->data_idx];
+
+	for( U16 i = 0; i < var->vec_items; i++ ) {
+		data[i]    = descr[i].def_value;
+		lim[i].min = descr[i].min;
+		lim[i].max = descr[i].max;
+	}
+	return kErrNone;
+}
+
+/*** vc_init_s8 ***********************************************************/
+/**
+ *	 Copy the default values and the limits from the descriptor into
+ *	 the value and limit arrays of \b var
+ *
+ *   @param var   Variable handle
+ *
+ *   @return kErrNone, when done.
+ */
+static ErrCode init_s8( VC_CTX *ctx, VAR_DESC const *var ) {
+	DATA_S8 const *descr = &ctx->data->descr_s8[var->descr_idx];
+	S8            *data  = &ctx->data->data_s8[var->data_idx];
+	LIM_S8        *lim   = &ctx->data->lim_s8[var->data_idx];
+
+	for( U16 i = 0; i < var->vec_items; i++ ) {
+		data[i]    = descr[i].def_value;
+		lim[i].min = descr[i].min;
+		lim[i].max = descr[i].max;
+	}
+	return kErrNone;
+}
+
+/*** vc_init_s64 **********************************************************/
+/**
+ *	 Copy the default values and the limits from the descriptor into
+ *	 the value and limit arrays of \b var
+ *
+ *   @param var   Variable handle
+ *
+ *   @return kErrNone, when done.
+ */
+static ErrCode init_s64( VC_CTX *ctx, VAR_DESC const *var ) {
+	DATA_S64 const *descr = &ctx->data->descr_s64[var->descr_idx];
+	S64            *data  = &ctx->data->data_s64[var->data_idx];
+	LIM_S64        *lim   = &ctx->data->lim_s64[var->data_idx];
+
+	for( U16 i = 0; i < var->vec_items; i++ ) {
+		data[i]    = descr[i].def_value;
+		lim[i].min = descr[i].min;
+		lim[i].max = descr[i].max;
+	}
+	return kErrNone;
+}
+
+/*** vc_init_enum **********************************************************/
+/**
+ *	 Copy data from the descriptor into the data location of \b var
+ *
+ *   @param var   Variable handle
+ *
+ *   @return kErrNone, when done.
+ */
+static ErrCode init_enum( VC_CTX *ctx, VAR_DESC const *var ) {
+	/* cppcheck-suppress [misra-c2012-11.3, misra-c2012-11.8] */
+	DESCR_ENUM const *descr = (DESCR_ENUM*)&ctx->data->data_mbr[var->descr_idx];
+	S16              *data  = &ctx->data->data_enum[var->data_idx];
+    
+	for( U16 i = 0; i < var->vec_items; i++ ) {
+		*data = descr->def_value;
+		data++;
+	}
+	return kErrNone;
+}
+
+/*** vc_init_string **********************************************************/
+/**
+ *	 Copy data from the descriptor into the data location of \b var
+ *
+ *   @param var   Variable handle
+ *
+ *   @return kErrNone, when done.
+ */
+static int  init_string( VC_CTX *ctx, VAR_DESC const *var ) {
+	DATA_STRING const *descr = &ctx->data->data_const_str[var->descr_idx];
+	DATA_STRING       *data  = &ctx->data->data_str[var->data_idx];
+	U16 flags = var->type & TYPE_FLAG;
+
+	if(( flags & TYPE_CONST ) != 0u ) {
+		return kErrNone;
+	}
+    
+	size_t len = strlen( descr );
+	U16 idx = 0;
+	for( U16 i = 0; i < var->vec_items; i++ ) {
+		(void) memset( &data[idx], 0, sizeof(STRBUF));
+		(void) memcpy( &data[idx], descr, len );
+		idx += sizeof(STRBUF);
+	}
+	return kErrNone;
+}
+
+/*** vc_valid_enum ***************************************************/
+/**
+ *	 Check if \b val is a valid enum member.
+ *
+ *   Tests the membership bitmap behind the descriptor, the members
+ *   are only scanned if varpp did not emit one.
+ *
+ *   @param dscr   pointer to ENUM descriptor
+ *   @param val    value
+ *
+ *   @return kErrNone when val is a member of the enum.
+ */
+static ErrCode valid_enum( DESCR_ENUM const *dscr, S16 val ) {
+	ErrCode E = kErrInvalidEnum;
+	S16 const *set = (S16 const *) &dscr->mbr[dscr->cnt];
+	U32 span = (U16) set[1];
+
+	if( span != 0u ) {
+		U32 bit = (U32)( (S32) val - (S32) set[0] );
+		if( bit < span ) {
+			U16 word = (U16) set[2u + ( bit / 16u )];
+			if((( word >> ( bit % 16u )) & 1u ) != 0u ) {
+				E = kErrNone;
+			}
+		}
+		else {
+			; /* misra-c2012-15.7 */
+		}
+		return E;
+	}
+
+	for( U16 i = 0; i < dscr->cnt; i++ ) {
+		ENUM_MBR const *mbr = (ENUM_MBR const *)&dscr->mbr[i];
+		if( val == mbr->value ) {
+			return kErrNone;
+		}
+	}
+
+	return E;
+}
+
+/*** enum_by_value ***************************************************************/
+/**
+ *   Find the enum member with value \b val.
+ *
+ *   @param dscr   pointer to ENUM descriptor
+ *   @param val    value
+ *
+ *   @return member or NULL.
+ */
+static ENUM_MBR const *enum_by_value( DESCR_ENUM const *dscr, S16 val ) {
+	for( U16 i = 0; i < dscr->cnt; i++ ) {
+		if( val == dscr->mbr[i].value ) {
+			return &dscr->mbr[i];
+		}
+	}
+	return NULL;
+}
+
+/*** enum_by_symbol **************************************************************/
+/**
+ *   Find the enum member with symbol \b sym in the symbol index
+ *   behind the membership set, see DESCR_ENUM.
+ *
+ *   Only the members in the probed slots are compared.
+ *
+ *   @param ctx    Context
+ *   @param dscr   pointer to ENUM descriptor
+ *   @param sym    symbol
+ *
+ *   @return member or NULL.
+ */
+static ENUM_MBR const *enum_by_symbol( VC_CTX *ctx, DESCR_ENUM const *dscr, char const *sym ) {
+	S16 const *set = (S16 const *) &dscr->mbr[dscr->cnt];
+	S16 const *idx = &set[2u + (((U32)(U16) set[1] + 15u ) / 16u )];
+	U32 slots = (U16) idx[0];
+	U32 slot;
+
+	if(( slots == 0u ) || ( ctx->data->enum_sym == NULL )) {
+		return NULL;
+	}
+
+	slot = vc_hash_str( sym, 0 ) & ( slots - 1u );
+	for( U32 n = 0; n < slots; n++ ) {
+		S16 i = idx[1u + slot];
+		if( i < 0 ) {
+			break;
+		}
+		ENUM_MBR const *mbr = &dscr->mbr[i];
+		if( strcmp( &ctx->data->enum_sym[mbr->symbol], sym ) == 0 ) {
+			return mbr;
+		}
+		slot = ( slot + 1u ) & ( slots - 1u );
+	}
+	return NULL;
+}
+
+/*** vec_check *******************************************************************/
+/**
+ *   Check the arguments of vc_ctx_read_vector() and
+ *   vc_ctx_write_vector().
+ *
+ *   @param var    variable descriptor
+ */
+static ErrCode vec_check( VC_CTX *ctx, HND hnd, int rdwr, U16 chan, U16 cnt, void const *val, U16 req, VAR_DESC const **var ) {
+	ErrCode ret;
+	U16 type;
+
+	assert( ctx->data );
+
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
+
+	if(( NULL == val ) || ( 0u == cnt )) {
+		return kErrInvalidArg;
+	}
+
+	*var = get_var( ctx, hnd );
+	type = (*var)->type & TYPE_MASK;
+	if(( type != TYPE_INT16 ) && ( type != TYPE_ENUM ) &&
+	   ( type != TYPE_INT32 ) && ( type != TYPE_FLOAT )) {
+		return kErrInvalidType;
+	}
+
+	ret = acc_allowed( *var, rdwr, req );
+	if( ret != kErrNone ) {
+		return ret;
+	}
+
+	if(( chan > 0u ) || ( cnt > 1u )) {
+		ret = vc_chk_vector( *var, chan );
+		if( ret != kErrNone ) {
+			return ret;
+		}
+		if(( (U32) chan + cnt ) > (*var)->vec_items ) {
+			return kErrInvalidChan;
+		}
+	}
+	return kErrNone;
+}
+
+#ifdef VC_SSE2
+/*** sse_lim_s16 ************************************************************/
+/**
+ *   Load the limits of 8 channels. The low half of each 32 bit lane
+ *   is min, the high half max, they are sign extended and packed.
+ */
+static inline void sse_lim_s16( LIM_S16 const *lim, __m128i *mn, __m128i *mx ) {
+	__m128i lo = _mm_loadu_si128( (__m128i const *) &lim[0] );
+	__m128i hi = _mm_loadu_si128( (__m128i const *) &lim[4] );
+
+	*mn = _mm_packs_epi32( _mm_srai_epi32( _mm_slli_epi32( lo, 16 ), 16 ),
+	                       _mm_srai_epi32( _mm_slli_epi32( hi, 16 ), 16 ));
+	*mx = _mm_packs_epi32( _mm_srai_epi32( lo, 16 ), _mm_srai_epi32( hi, 16 ));
+}
+
+/*** sse_lim_s32 ************************************************************/
+/**
+ *   Load the limits of 4 channels, see sse_lim_f32().
+ */
+static inline void sse_lim_s32( LIM_S32 const *lim, __m128i *mn, __m128i *mx ) {
+	__m128 lo = _mm_castsi128_ps( _mm_loadu_si128( (__m128i const *) &lim[0] ));
+	__m128 hi = _mm_castsi128_ps( _mm_loadu_si128( (__m128i const *) &lim[2] ));
+
+	*mn = _mm_castps_si128( _mm_shuffle_ps( lo, hi, _MM_SHUFFLE( 2, 0, 2, 0 )));
+	*mx = _mm_castps_si128( _mm_shuffle_ps( lo, hi, _MM_SHUFFLE( 3, 1, 3, 1 )));
+}
+
+/*** sse_lim_f32 ************************************************************/
+/**
+ *   Load the limits of 4 channels, the even elements are min, the odd
+ *   ones max.
+ */
+static inline void sse_lim_f32( LIM_F32 const *lim, __m128 *mn, __m128 *mx ) {
+	__m128 lo = _mm_loadu_ps( (F32 const *) &lim[0] );
+	__m128 hi = _mm_loadu_ps( (F32 const *) &lim[2] );
+
+	*mn = _mm_shuffle_ps( lo, hi, _MM_SHUFFLE( 2, 0, 2, 0 ));
+	*mx = _mm_shuffle_ps( lo, hi, _MM_SHUFFLE( 3, 1, 3, 1 ));
+}
+#endif
+
+#ifdef VC_AVX2
+/*** avx_lim_f32 ************************************************************/
+/**
+ *   Load the limits of 8 channels. The shuffle works in 128 bit lanes,
+ *   it leaves the minima in the order 0 1 4 5 2 3 6 7, the permute
+ *   puts them in order.
+ */
+static inline void avx_lim_f32( LIM_F32 const *lim, __m256 *mn, __m256 *mx ) {
+	__m256 lo = _mm256_loadu_ps( (F32 const *) &lim[0] );
+	__m256 hi = _mm256_loadu_ps( (F32 const *) &lim[4] );
+	__m256 a  = _mm256_shuffle_ps( lo, hi, _MM_SHUFFLE( 2, 0, 2, 0 ));
+	__m256 b  = _mm256_shuffle_ps( lo, hi, _MM_SHUFFLE( 3, 1, 3, 1 ));
+
+	*mn = _mm256_castpd_ps( _mm256_permute4x64_pd( _mm256_castps_pd( a ), _MM_SHUFFLE( 3, 1, 2, 0 )));
+	*mx = _mm256_castpd_ps( _mm256_permute4x64_pd( _mm256_castps_pd( b ), _MM_SHUFFLE( 3, 1, 2, 0 )));
+}
+
+/*** avx_lim_s32 ************************************************************/
+/**
+ *   Load the limits of 8 channels, see avx_lim_f32().
+ */
+static inline void avx_lim_s32( LIM_S32 const *lim, __m256i *mn, __m256i *mx ) {
+	__m256 fmn;
+	__m256 fmx;
+
+	avx_lim_f32( (LIM_F32 const *) lim, &fmn, &fmx );
+	*mn = _mm256_castps_si256( fmn );
+	*mx = _mm256_castps_si256( fmx );
+}
+#endif
+
+/*** simd_limit_s16 *********************************************************/
+/**
+ *   SIMD part of the FLAG_LIMIT check of vec_write_s16(), 8 channels
+ *   at a time with SSE2. LIM_S16 is {min, max}, the limits are split
+ *   into a vector of the minima and one of the maxima.
+ *
+ *   @param lim      limits of the first channel
+ *   @param val      values
+ *   @param cnt      number of channels
+ *   @param above    set to 1 if a value is above its maximum
+ *   @param below    set to 1 if a value is below its minimum
+ *
+ *   @return number of channels checked, the caller checks the rest.
+ */
+static inline U16 simd_limit_s16( LIM_S16 const *lim, S16 const *val, U16 cnt, int *above, int *below ) {
+	U16 i = 0;
+#ifdef VC_SSE2
+	__m128i a = _mm_setzero_si128();
+	__m128i b = _mm_setzero_si128();
+
+	for( ; ( i + 8u ) <= cnt; i += 8u ) {
+		__m128i mn;
+		__m128i mx;
+		__m128i v = _mm_loadu_si128( (__m128i const *) &val[i] );
+
+		sse_lim_s16( &lim[i], &mn, &mx );
+		a = _mm_or_si128( a, _mm_cmpgt_epi16( v, mx ));
+		b = _mm_or_si128( b, _mm_cmplt_epi16( v, mn ));
+	}
+	*above |= ( _mm_movemask_epi8( a ) != 0 ) ? 1 : 0;
+	*below |= ( _mm_movemask_epi8( b ) != 0 ) ? 1 : 0;
+#else
+	UNUSED_PARAM( lim );
+	UNUSED_PARAM( val );
+	UNUSED_PARAM( cnt );
+	UNUSED_PARAM( above );
+	UNUSED_PARAM( below );
+#endif
+	return i;
+}
+
+/*** simd_clip_s16 **********************************************************/
+/**
+ *   SIMD part of FLAG_CLIP of vec_write_s16(), see simd_limit_s16().
+ *
+ *   @return number of channels clipped, the caller clips the rest.
+ */
+static inline U16 simd_clip_s16( LIM_S16 const *lim, S16 *val, U16 cnt ) {
+	U16 i = 0;
+#ifdef VC_SSE2
+	for( ; ( i + 8u ) <= cnt; i += 8u ) {
+		__m128i mn;
+		__m128i mx;
+		__m128i v = _mm_loadu_si128( (__m128i const *) &val[i] );
+
+		sse_lim_s16( &lim[i], &mn, &mx );
+		v = _mm_max_epi16( _mm_min_epi16( v, mx ), mn );
+		_mm_storeu_si128( (__m128i *) &val[i], v );
+	}
+#else
+	UNUSED_PARAM( lim );
+	UNUSED_PARAM( val );
+	UNUSED_PARAM( cnt );
+#endif
+	return i;
+}
+
+/*** simd_store_s16 *********************************************************/
+/**
+ *   SIMD part of the store of vec_write_s16(): store the values of up
+ *   to 32 channels and set bit i of *changed when channel i changed.
+ *
+ *   @return number of channels stored, the caller stores the rest.
+ */
+static inline U16 simd_store_s16( S16 *data, S16 const *val, U16 cnt, U32 *changed ) {
+	U16 i = 0;
+#ifdef VC_SSE2
+	for( ; ( i + 8u ) <= cnt; i += 8u ) {
+		__m128i d  = _mm_loadu_si128( (__m128i const *) &data[i] );
+		__m128i v  = _mm_loadu_si128( (__m128i const *) &val[i] );
+		__m128i eq = _mm_cmpeq_epi16( d, v );
+		U32 bits   = (U32) _mm_movemask_epi8( _mm_packs_epi16( eq, eq )) & 0xffu;
+
+		*changed |= ( ~bits & 0xffu ) << i;
+		_mm_storeu_si128( (__m128i *) &data[i], v );
+	}
+#else
+	UNUSED_PARAM( data );
+	UNUSED_PARAM( val );
+	UNUSED_PARAM( cnt );
+	UNUSED_PARAM( changed );
+#endif
+	return i;
+}
+
+/*** simd_limit_s32 *********************************************************/
+/**
+ *   See simd_limit_s16(), 8 channels at a time with AVX2, 4 with SSE2.
+ */
+static inline U16 simd_limit_s32( LIM_S32 const *lim, S32 const *val, U16 cnt, int *above, int *below ) {
+	U16 i = 0;
+#ifdef VC_AVX2
+	__m256i a8 = _mm256_setzero_si256();
+	__m256i b8 = _mm256_setzero_si256();
+
+	for( ; ( i + 8u ) <= cnt; i += 8u ) {
+		__m256i mn;
+		__m256i mx;
+		__m256i v = _mm256_loadu_si256( (__m256i const *) &val[i] );
+
+		avx_lim_s32( &lim[i], &mn, &mx );
+		a8 = _mm256_or_si256( a8, _mm256_cmpgt_epi32( v, mx ));
+		b8 = _mm256_or_si256( b8, _mm256_cmpgt_epi32( mn, v ));
+	}
+	*above |= ( _mm256_movemask_epi8( a8 ) != 0 ) ? 1 : 0;
+	*below |= ( _mm256_movemask_epi8( b8 ) != 0 ) ? 1 : 0;
+#endif
+#ifdef VC_SSE2
+	__m128i a = _mm_setzero_si128();
+	__m128i b = _mm_setzero_si128();
+
+	for( ; ( i + 4u ) <= cnt; i += 4u ) {
+		__m128i mn;
+		__m128i mx;
+		__m128i v = _mm_loadu_si128( (__m128i const *) &val[i] );
+
+		sse_lim_s32( &lim[i], &mn, &mx );
+		a = _mm_or_si128( a, _mm_cmpgt_epi32( v, mx ));
+		b = _mm_or_si128( b, _mm_cmplt_epi32( v, mn ));
+	}
+	*above |= ( _mm_movemask_epi8( a ) != 0 ) ? 1 : 0;
+	*below |= ( _mm_movemask_epi8( b ) != 0 ) ? 1 : 0;
+#else
+	UNUSED_PARAM( lim );
+	UNUSED_PARAM( val );
+	UNUSED_PARAM( cnt );
+	UNUSED_PARAM( above );
+	UNUSED_PARAM( below );
+#endif
+	return i;
+}
+
+/*** simd_clip_s32 **********************************************************/
+/**
+ *   See simd_clip_s16(). SSE2 has no min/max of S32, the limits are
+ *   selected with the compare masks.
+ */
+static inline U16 simd_clip_s32( LIM_S32 const *lim, S32 *val, U16 cnt ) {
+	U16 i = 0;
+#ifdef VC_AVX2
+	for( ; ( i + 8u ) <= cnt; i += 8u ) {
+		__m256i mn;
+		__m256i mx;
+		__m256i v = _mm256_loadu_si256( (__m256i const *) &val[i] );
+
+		avx_lim_s32( &lim[i], &mn, &mx );
+		v = _mm256_max_epi32( _mm256_min_epi32( v, mx ), mn );
+		_mm256_storeu_si256( (__m256i *) &val[i], v );
+	}
+#endif
+#ifdef VC_SSE2
+	for( ; ( i + 4u ) <= cnt; i += 4u ) {
+		__m128i mn;
+		__m128i mx;
+		__m128i m;
+		__m128i v = _mm_loadu_si128( (__m128i const *) &val[i] );
+
+		sse_lim_s32( &lim[i], &mn, &mx );
+		m = _mm_cmpgt_epi32( v, mx );
+		v = _mm_or_si128( _mm_and_si128( m, mx ), _mm_andnot_si128( m, v ));
+		m = _mm_cmplt_epi32( v, mn );
+		v = _mm_or_si128( _mm_and_si128( m, mn ), _mm_andnot_si128( m, v ));
+		_mm_storeu_si128( (__m128i *) &val[i], v );
+	}
+#else
+	UNUSED_PARAM( lim );
+	UNUSED_PARAM( val );
+	UNUSED_PARAM( cnt );
+#endif
+	return i;
+}
+
+/*** simd_store_s32 *********************************************************/
+/**
+ *   See simd_store_s16().
+ */
+static inline U16 simd_store_s32( S32 *data, S32 const *val, U16 cnt, U32 *changed ) {
+	U16 i = 0;
+#ifdef VC_AVX2
+	for( ; ( i + 8u ) <= cnt; i += 8u ) {
+		__m256i d = _mm256_loadu_si256( (__m256i const *) &data[i] );
+		__m256i v = _mm256_loadu_si256( (__m256i const *) &val[i] );
+		U32 bits  = (U32) _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( d, v )));
+
+		*changed |= ( ~bits & 0xffu ) << i;
+		_mm256_storeu_si256( (__m256i *) &data[i], v );
+	}
+#endif
+#ifdef VC_SSE2
+	for( ; ( i + 4u ) <= cnt; i += 4u ) {
+		__m128i d = _mm_loadu_si128( (__m128i const *) &data[i] );
+		__m128i v = _mm_loadu_si128( (__m128i const *) &val[i] );
+		U32 bits  = (U32) _mm_movemask_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( d, v )));
+
+		*changed |= ( ~bits & 0xfu ) << i;
+		_mm_storeu_si128( (__m128i *) &data[i], v );
+	}
+#else
+	UNUSED_PARAM( data );
+	UNUSED_PARAM( val );
+	UNUSED_PARAM( cnt );
+	UNUSED_PARAM( changed );
+#endif
+	return i;
+}
+
+/*** simd_limit_f32 *********************************************************/
+/**
+ *   See simd_limit_s16(), 8 channels at a time with AVX2, 4 with SSE2.
+ *   The compares are ordered like the scalar ones, NaN passes.
+ */
+static inline U16 simd_limit_f32( LIM_F32 const *lim, F32 const *val, U16 cnt, int *above, int *below ) {
+	U16 i = 0;
+#ifdef VC_AVX2
+	__m256 a8 = _mm256_setzero_ps();
+	__m256 b8 = _mm256_setzero_ps();
+
+	for( ; ( i + 8u ) <= cnt; i += 8u ) {
+		__m256 mn;
+		__m256 mx;
+		__m256 v = _mm256_loadu_ps( &val[i] );
+
+		avx_lim_f32( &lim[i], &mn, &mx );
+		a8 = _mm256_or_ps( a8, _mm256_cmp_ps( v, mx, _CMP_GT_OQ ));
+		b8 = _mm256_or_ps( b8, _mm256_cmp_ps( v, mn, _CMP_LT_OQ ));
+	}
+	*above |= ( _mm256_movemask_ps( a8 ) != 0 ) ? 1 : 0;
+	*below |= ( _mm256_movemask_ps( b8 ) != 0 ) ? 1 : 0;
+#endif
+#ifdef VC_SSE2
+	__m128 a = _mm_setzero_ps();
+	__m128 b = _mm_setzero_ps();
+
+	for( ; ( i + 4u ) <= cnt; i += 4u ) {
+		__m128 mn;
+		__m128 mx;
+		__m128 v = _mm_loadu_ps( &val[i] );
+
+		sse_lim_f32( &lim[i], &mn, &mx );
+		a = _mm_or_ps( a, _mm_cmpgt_ps( v, mx ));
+		b = _mm_or_ps( b, _mm_cmplt_ps( v, mn ));
+	}
+	*above |= ( _mm_movemask_ps( a ) != 0 ) ? 1 : 0;
+	*below |= ( _mm_movemask_ps( b ) != 0 ) ? 1 : 0;
+#else
+	UNUSED_PARAM( lim );
+	UNUSED_PARAM( val );
+	UNUSED_PARAM( cnt );
+	UNUSED_PARAM( above );
+	UNUSED_PARAM( below );
+#endif
+	return i;
+}
+
+/*** simd_clip_f32 **********************************************************/
+/**
+ *   See simd_clip_s16(). The limits are selected with the compare
+ *   masks instead of min/max, so NaN stays NaN like in the scalar loop.
+ */
+static inline U16 simd_clip_f32( LIM_F32 const *lim, F32 *val, U16 cnt ) {
+	U16 i = 0;
+#ifdef VC_AVX2
+	for( ; ( i + 8u ) <= cnt; i += 8u ) {
+		__m256 mn;
+		__m256 mx;
+		__m256 v = _mm256_loadu_ps( &val[i] );
+
+		avx_lim_f32( &lim[i], &mn, &mx );
+		v = _mm256_blendv_ps( v, mx, _mm256_cmp_ps( v, mx, _CMP_GT_OQ ));
+		v = _mm256_blendv_ps( v, mn, _mm256_cmp_ps( v, mn, _CMP_LT_OQ ));
+		_mm256_storeu_ps( &val[i], v );
+	}
+#endif
+#ifdef VC_SSE2
+	for( ; ( i + 4u ) <= cnt; i += 4u ) {
+		__m128 mn;
+		__m128 mx;
+		__m128 m;
+		__m128 v = _mm_loadu_ps( &val[i] );
+
+		sse_lim_f32( &lim[i], &mn, &mx );
+		m = _mm_cmpgt_ps( v, mx );
+		v = _mm_or_ps( _mm_and_ps( m, mx ), _mm_andnot_ps( m, v ));
+		m = _mm_cmplt_ps( v, mn );
+		v = _mm_or_ps( _mm_and_ps( m, mn ), _mm_andnot_ps( m, v ));
+		_mm_storeu_ps( &val[i], v );
+	}
+#else
+	UNUSED_PARAM( lim );
+	UNUSED_PARAM( val );
+	UNUSED_PARAM( cnt );
+#endif
+	return i;
+}
+
+/*** simd_store_f32 *********************************************************/
+/**
+ *   See simd_store_s16(). A channel changed when the values compare
+ *   unequal, like data[i] != val[i].
+ */
+static inline U16 simd_store_f32( F32 *data, F32 const *val, U16 cnt, U32 *changed ) {
+	U16 i = 0;
+#ifdef VC_AVX2
+	for( ; ( i + 8u ) <= cnt; i += 8u ) {
+		__m256 d = _mm256_loadu_ps( &data[i] );
+		__m256 v = _mm256_loadu_ps( &val[i] );
+
+		*changed |= (U32) _mm256_movemask_ps( _mm256_cmp_ps( d, v, _CMP_NEQ_UQ )) << i;
+		_mm256_storeu_ps( &data[i], v );
+	}
+#endif
+#ifdef VC_SSE2
+	for( ; ( i + 4u ) <= cnt; i += 4u ) {
+		__m128 d = _mm_loadu_ps( &data[i] );
+		__m128 v = _mm_loadu_ps( &val[i] );
+
+		*changed |= (U32) _mm_movemask_ps( _mm_cmpneq_ps( d, v )) << i;
+		_mm_storeu_ps( &data[i], v );
+	}
+#else
+	UNUSED_PARAM( data );
+	UNUSED_PARAM( val );
+	UNUSED_PARAM( cnt );
+	UNUSED_PARAM( changed );
+#endif
+	return i;
+}
+
+/*** vec_write_s16 ***************************************************************/
+/**
+ *   Apply FLAG_LIMIT or FLAG_CLIP to \b cnt values and store them,
+ *   see limit_s16().
+ *
+ *   The limit check runs over all values before anything is stored.
+ *   With SSE2 or AVX2 the simd_* functions handle whole vectors of
+ *   channels, the loops here the rest, see bench/bench_vector.
+ *
+ *   @param flags    acc_rights of the variable
+ *   @param data     value of the first channel
+ *   @param lim      limits of the first channel
+ *   @param val      values, clipped on return
+ *   @param cnt      number of channels
+ *   @param changed  bit i is set if channel i changed
+ */
+static ErrCode vec_write_s16( U16 flags, S16 *data, LIM_S16 const *lim, S16 *val, U16 cnt, U32 *changed ) {
+	flags &= REQ_FLAG;
+	if(( flags & FLAG_LIMIT ) != 0u ) {
+		int above = 0;
+		int below = 0;
+		for( U16 i = simd_limit_s16( lim, val, cnt, &above, &below ); i < cnt; i++ ) {
+			above |= ( val[i] > lim[i].max ) ? 1 : 0;
+			below |= ( val[i] < lim[i].min ) ? 1 : 0;
+		}
+		if( above != 0 ) {
+			return kErrUpperLimit;
+		}
+		if( below != 0 ) {
+			return kErrLowerLimit;
+		}
+	}
+	else if (( flags & FLAG_CLIP ) != 0u ) {
+		for( U16 i = simd_clip_s16( lim, val, cnt ); i < cnt; i++ ) {
+			S16 v = val[i];
+			v = ( v > lim[i].max ) ? lim[i].max : v;
+			v = ( v < lim[i].min ) ? lim[i].min : v;
+			val[i] = v;
+		}
+	}
+	else {
+		; /* misra-c2012-15.7 */
+	}
+
+	for( U16 b = 0; b < cnt; b += 32u ) {
+		U16 m = cnt - b;
+		U32 w = 0;
+
+		if( m > 32u ) {
+			m = 32u;
+		}
+		for( U16 i = simd_store_s16( &data[b], &val[b], m, &w ); i < m; i++ ) {
+			w |= (U32)(( data[b + i] != val[b + i] ) ? 1u : 0u ) << i;
+			data[b + i] = val[b + i];
+		}
+		changed[b / 32u] = w;
+	}
+	return kErrNone;
+}
+
+/*** vec_write_s32 ***************************************************************/
+/**
+ *   See vec_write_s16().
+ */
+static ErrCode vec_write_s32( U16 flags, S32 *data, LIM_S32 const *lim, S32 *val, U16 cnt, U32 *changed ) {
+	flags &= REQ_FLAG;
+	if(( flags & FLAG_LIMIT ) != 0u ) {
+		int above = 0;
+		int below = 0;
+		for( U16 i = simd_limit_s32( lim, val, cnt, &above, &below ); i < cnt; i++ ) {
+			above |= ( val[i] > lim[i].max ) ? 1 : 0;
+			below |= ( val[i] < lim[i].min ) ? 1 : 0;
+		}
+		if( above != 0 ) {
+			return kErrUpperLimit;
+		}
+		if( below != 0 ) {
+			return kErrLowerLimit;
+		}
+	}
+	else if (( flags & FLAG_CLIP ) != 0u ) {
+		for( U16 i = simd_clip_s32( lim, val, cnt ); i < cnt; i++ ) {
+			S32 v = val[i];
+			v = ( v > lim[i].max ) ? lim[i].max : v;
+			v = ( v < lim[i].min ) ? lim[i].min : v;
+			val[i] = v;
+		}
+	}
+	else {
+		; /* misra-c2012-15.7 */
+	}
+
+	for( U16 b = 0; b < cnt; b += 32u ) {
+		U16 m = cnt - b;
+		U32 w = 0;
+
+		if( m > 32u ) {
+			m = 32u;
+		}
+		for( U16 i = simd_store_s32( &data[b], &val[b], m, &w ); i < m; i++ ) {
+			w |= (U32)(( data[b + i] != val[b + i] ) ? 1u : 0u ) << i;
+			data[b + i] = val[b + i];
+		}
+		changed[b / 32u] = w;
+	}
+	return kErrNone;
+}
+
+/*** vec_write_f32 ***************************************************************/
+/**
+ *   See vec_write_s16().
+ */
+static ErrCode vec_write_f32( U16 flags, F32 *data, LIM_F32 const *lim, F32 *val, U16 cnt, U32 *changed ) {
+	flags &= REQ_FLAG;
+	if(( flags & FLAG_LIMIT ) != 0u ) {
+		int above = 0;
+		int below = 0;
+		for( U16 i = simd_limit_f32( lim, val, cnt, &above, &below ); i < cnt; i++ ) {
+			above |= ( val[i] > lim[i].max ) ? 1 : 0;
+			below |= ( val[i] < lim[i].min ) ? 1 : 0;
+		}
+		if( above != 0 ) {
+			return kErrUpperLimit;
+		}
+		if( below != 0 ) {
+			return kErrLowerLimit;
+		}
+	}
+	else if (( flags & FLAG_CLIP ) != 0u ) {
+		for( U16 i = simd_clip_f32( lim, val, cnt ); i < cnt; i++ ) {
+			F32 v = val[i];
+			v = ( v > lim[i].max ) ? lim[i].max : v;
+			v = ( v < lim[i].min ) ? lim[i].min : v;
+			val[i] = v;
+		}
+	}
+	else {
+		; /* misra-c2012-15.7 */
+	}
+
+	for( U16 b = 0; b < cnt; b += 32u ) {
+		U16 m = cnt - b;
+		U32 w = 0;
+
+		if( m > 32u ) {
+			m = 32u;
+		}
+		for( U16 i = simd_store_f32( &data[b], &val[b], m, &w ); i < m; i++ ) {
+			w |= (U32)(( data[b + i] != val[b + i] ) ? 1u : 0u ) << i;
+			data[b + i] = val[b + i];
+		}
+		changed[b / 32u] = w;
+	}
+	return kErrNone;
+}
+
+/*** vec_write_enum **************************************************************/
+/**
+ *   Check \b cnt enum values and store them, see vec_write_s16().
+ *
+ *   @param dscr     ENUM descriptor
+ */
+static ErrCode vec_write_enum( DESCR_ENUM const *dscr, DATA_ENUM *data, S16 *val, U16 cnt, U32 *changed ) {
+	for( U16 i = 0; i < cnt; i++ ) {
+		if( valid_enum( dscr, val[i] ) != kErrNone ) {
+			return kErrInvalidEnum;
+		}
+	}
+
+	for( U16 b = 0; b < cnt; b += 32u ) {
+		U16 m = cnt - b;
+		U32 w = 0;
+
+		if( m > 32u ) {
+			m = 32u;
+		}
+		for( U16 i = 0; i < m; i++ ) {
+			w |= (U32)(( data[b + i] != val[b + i] ) ? 1u : 0u ) << i;
+			data[b + i] = val[b + i];
+		}
+		changed[b / 32u] = w;
+	}
+	return kErrNone;
+}
+
+/*** txn_limit ************************************************************/
+/**
+ *   Check or clip a staged value of a transaction, see limit_s16().
+ *   The variable is locked.
+ *
+ *   @param item   Staged write
+ */
+static ErrCode txn_limit( VC_CTX *ctx, VC_TXN_ITEM *item ) {
+	VC_DATA const  *vc  = ctx->data;
+	VAR_DESC const *var = get_var( ctx, item->hnd );
+	HND             idx = var->data_idx + item->chan;
+	U16             acc = var->acc_rights;
+	ErrCode         E   = kErrInvalidType;
+
+	switch( var->type & TYPE_MASK ) {
+		case TYPE_INT8:   E = limit_s8( acc, &vc->lim_s8[idx], &item->val.s8 ); break;
+		case TYPE_INT16:  E = limit_s16( acc, &vc->lim_s16[idx], &item->val.s16 ); break;
+		case TYPE_INT32:  E = limit_s32( acc, &vc->lim_s32[idx], &item->val.s32 ); break;
+		case TYPE_INT64:  E = limit_s64( acc, &vc->lim_s64[idx], &item->val.s64 ); break;
+		case TYPE_FLOAT:  E = limit_f32( acc, &vc->lim_f32[idx], &item->val.f32 ); break;
+		case TYPE_DOUBLE: E = limit_f64( acc, &vc->lim_f64[idx], &item->val.f64 ); break;
+		case TYPE_ENUM:   E = valid_enum( get_enum_dscr( ctx, item->hnd ), item->val.s16 ); break;
+		default:
+			break;
+	}
+	return E;
+}
+
+/*** txn_store ************************************************************/
+/**
+ *   Store a checked value of a transaction. The variable is locked.
+ *
+ *   @param item   Staged write
+ *
+ *   @return 1, when the value has changed.
+ */
+static int txn_store( VC_CTX *ctx, VC_TXN_ITEM const *item ) {
+	VC_DATA const  *vc      = ctx->data;
+	VAR_DESC const *var     = get_var( ctx, item->hnd );
+	HND             idx     = var->data_idx + item->chan;
+	int             changed = 0;
+
+	switch( var->type & TYPE_MASK ) {
+		case TYPE_INT8:
+			changed = ( vc->data_s8[idx] != item->val.s8 ) ? 1 : 0;
+			vc->data_s8[idx] = item->val.s8;
+			break;
+		case TYPE_INT16:
+			changed = ( vc->data_s16[idx] != item->val.s16 ) ? 1 : 0;
+			vc->data_s16[idx] = item->val.s16;
+			break;
+		case TYPE_INT32:
+			changed = ( vc->data_s32[idx] != item->val.s32 ) ? 1 : 0;
+			vc->data_s32[idx] = item->val.s32;
+			break;
+		case TYPE_INT64:
+			changed = ( vc->data_s64[idx] != item->val.s64 ) ? 1 : 0;
+			vc->data_s64[idx] = item->val.s64;
+			break;
+		case TYPE_FLOAT:
+			changed = ( vc->data_f32[idx] != item->val.f32 ) ? 1 : 0;
+			vc->data_f32[idx] = item->val.f32;
+			break;
+		case TYPE_DOUBLE:
+			changed = ( vc->data_f64[idx] != item->val.f64 ) ? 1 : 0;
+			vc->data_f64[idx] = item->val.f64;
+			break;
+		case TYPE_ENUM:
+			changed = ( vc->data_enum[idx] != item->val.s16 ) ? 1 : 0;
+			vc->data_enum[idx] = item->val.s16;
+			break;
+		default:
+			break;
+	}
+	return changed;
+}
+
+/*** rw_many **************************************************************/
+/**
+ *   Read or write many variables, see vc_ctx_read_many().
+ *
+ *   The first pass checks handle, type, access rights and channel
+ *   of each item. Then there is one pass per data table that only
+ *   touches the items of this table.
+ */
+static ErrCode rw_many( VC_CTX *ctx, HND const *hnd, U16 const *chan, VC_VALUE *val, ErrCode *err, size_t n, int rdwr, U16 req ) {
+	ErrCode ret = kErrNone;
+	size_t i;
+
+	assert( ctx->data );
+
+	if(( NULL == hnd ) || ( NULL == val ) || ( NULL == err )) {
+		return kErrInvalidArg;
+	}
+
+	for( i = 0; i < n; i++ ) {
+		VAR_DESC const *var;
+		U16 ch = (NULL == chan) ? 0u : chan[i];
+		U16 type;
+
+		if( hnd[i] >= ctx->data->var_cnt ) {
+			err[i] = kErrUnknownCmd;
+			continue;
+		}
+
+		var  = get_var( ctx, hnd[i] );
+		type = var->type & TYPE_MASK;
+		if(( type != TYPE_INT16 ) && ( type != TYPE_ENUM ) &&
+		   ( type != TYPE_INT32 ) && ( type != TYPE_FLOAT )) {
+			err[i] = kErrInvalidType;
+			continue;
+		}
+
+		err[i] = acc_allowed( var, rdwr, req );
+		if(( err[i] == kErrNone ) && ( ch > 0u )) {
+			err[i] = vc_chk_vector( var, ch );
+		}
+		if(( err[i] == kErrNone ) && ( rdwr == VarRead )) {
+			derive_fresh( ctx, var, hnd[i], ch, 1u );
+		}
+	}
+
+	/* TYPE_INT16 */
+	for( i = 0; i < n; i++ ) {
+		VAR_DESC const *var;
+		S16 *data;
+		LIM_S16 const *lim;
+		HND idx;
+
+		if( err[i] != kErrNone ) {
+			continue;
+		}
+		var = get_var( ctx, hnd[i] );
+		if(( var->type & TYPE_MASK ) != TYPE_INT16 ) {
+			continue;
+		}
+
+		idx = var->data_idx + ((NULL == chan) ? 0u : chan[i]);
+		data = &ctx->data->data_s16[idx];
+		lim = &ctx->data->lim_s16[idx];
+		if( rdwr == VarRead ) {
+			U32 seq;
+			do {
+				seq = seq_read_begin( ctx, hnd[i] );
+				val[i].s16 = *data;
+			} while( seq_read_retry( ctx, hnd[i], seq ) != 0 );
+		}
+		else {
+			int changed = 0;
+
+			seq_write_begin( ctx, hnd[i] );
+			err[i] = limit_s16( var->acc_rights, lim, &val[i].s16 );
+			if( err[i] == kErrNone ) {
+				changed = ( *data != val[i].s16 ) ? 1 : 0;
+				*data = val[i].s16;
+			}
+			seq_write_end( ctx, hnd[i] );
+
+			if( err[i] == kErrNone ) {
+				var_written( ctx, hnd[i], (NULL == chan) ? 0u : chan[i], &val[i], changed );
+			}
+		}
+	}
+
+	/* TYPE_ENUM */
+	for( i = 0; i < n; i++ ) {
+		VAR_DESC const *var;
+		DATA_ENUM *data;
+
+		if( err[i] != kErrNone ) {
+			continue;
+		}
+		var = get_var( ctx, hnd[i] );
+		if(( var->type & TYPE_MASK ) != TYPE_ENUM ) {
+			continue;
+		}
+
+		data = &ctx->data->data_enum[var->data_idx + ((NULL == chan) ? 0u : chan[i])];
+		if( rdwr == VarRead ) {
+			U32 seq;
+			do {
+				seq = seq_read_begin( ctx, hnd[i] );
+				val[i].s16 = *data;
+			} while( seq_read_retry( ctx, hnd[i], seq ) != 0 );
+		}
+		else {
+			err[i] = valid_enum( get_enum_dscr( ctx, hnd[i] ), val[i].s16 );
+			if( err[i] == kErrNone ) {
+				int changed;
+
+				seq_write_begin( ctx, hnd[i] );
+				changed = ( *data != val[i].s16 ) ? 1 : 0;
+				*data = val[i].s16;
+				seq_write_end( ctx, hnd[i] );
+
+				var_written( ctx, hnd[i], (NULL == chan) ? 0u : chan[i], &val[i], changed );
+			}
+		}
+	}
+
+	/* TYPE_INT32 */
+	for( i = 0; i < n; i++ ) {
+		VAR_DESC const *var;
+		S32 *data;
+		LIM_S32 const *lim;
+		HND idx;
+
+		if( err[i] != kErrNone ) {
+			continue;
+		}
+		var = get_var( ctx, hnd[i] );
+		if(( var->type & TYPE_MASK ) != TYPE_INT32 ) {
+			continue;
+		}
+
+		idx = var->data_idx + ((NULL == chan) ? 0u : chan[i]);
+		data = &ctx->data->data_s32[idx];
+		lim = &ctx->data->lim_s32[idx];
+		if( rdwr == VarRead ) {
+			U32 seq;
+			do {
+				seq = seq_read_begin( ctx, hnd[i] );
+				val[i].s32 = *data;
+			} while( seq_read_retry( ctx, hnd[i], seq ) != 0 );
+		}
+		else {
+			int changed = 0;
+
+			seq_write_begin( ctx, hnd[i] );
+			err[i] = limit_s32( var->acc_rights, lim, &val[i].s32 );
+			if( err[i] == kErrNone ) {
+				changed = ( *data != val[i].s32 ) ? 1 : 0;
+				*data = val[i].s32;
+			}
+			seq_write_end( ctx, hnd[i] );
+
+			if( err[i] == kErrNone ) {
+				var_written( ctx, hnd[i], (NULL == chan) ? 0u : chan[i], &val[i], changed );
+			}
+		}
+	}
+
+	/* TYPE_FLOAT */
+	for( i = 0; i < n; i++ ) {
+		VAR_DESC const *var;
+		F32 *data;
+		LIM_F32 const *lim;
+		HND idx;
+
+		if( err[i] != kErrNone ) {
+			continue;
+		}
+		var = get_var( ctx, hnd[i] );
+		if(( var->type & TYPE_MASK ) != TYPE_FLOAT ) {
+			continue;
+		}
+
+		idx = var->data_idx + ((NULL == chan) ? 0u : chan[i]);
+		data = &ctx->data->data_f32[idx];
+		lim = &ctx->data->lim_f32[idx];
+		if( rdwr == VarRead ) {
+			U32 seq;
+			do {
+				seq = seq_read_begin( ctx, hnd[i] );
+				val[i].f32 = *data;
+			} while( seq_read_retry( ctx, hnd[i], seq ) != 0 );
+		}
+		else {
+			int changed = 0;
+
+			seq_write_begin( ctx, hnd[i] );
+			err[i] = limit_f32( var->acc_rights, lim, &val[i].f32 );
+			if( err[i] == kErrNone ) {
+				changed = ( *data != val[i].f32 ) ? 1 : 0;
+				*data = val[i].f32;
+			}
+			seq_write_end( ctx, hnd[i] );
+
+			if( err[i] == kErrNone ) {
+				var_written( ctx, hnd[i], (NULL == chan) ? 0u : chan[i], &val[i], changed );
+			}
+		}
+	}
+
+	for( i = 0; i < n; i++ ) {
+		if( err[i] != kErrNone ) {
+			ret = err[i];
+			break;
+		}
+	}
+
+	return ret;
+}
+
+#ifdef VC_HAS_ATOMIC
+/*** atomic_var *************************************************************/
+/**
+ *   Check handle, type, access rights and channel for the
+ *   vc_atomic_* functions.
+ *
+ *   @param hnd    Variable handle
+ *   @param chan   Channel
+ *   @param type   Expected type
+ *   @param rdwr   Read/Write access
+ *   @param req    Request source
+ *   @param var    Returns the variable
+ */
+static ErrCode atomic_var( VC_CTX *ctx, HND hnd, U16 chan, U16 type, int rdwr, U16 req, VAR_DESC const **var ) {
+	ErrCode ret;
+
+	assert( ctx->data );
+
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
+
+	*var = get_var( ctx, hnd );
+	if(( (*var)->type & TYPE_MASK ) != type ) {
+		return kErrInvalidType;
+	}
+
+	ret = acc_allowed( *var, rdwr, req );
+	if(( ret == kErrNone ) && ( chan > 0u )) {
+		ret = vc_chk_vector( *var, chan );
+	}
+	if(( ret == kErrNone ) && ( rdwr == VarRead )) {
+		derive_fresh( ctx, *var, hnd, chan, 1u );
+	}
+	return ret;
+}
+#endif
+
+/*** ring_push **************************************************************/
+/**
+ *   Append an event to a ring.
+ *
+ *   Each cell has a sequence number. A cell is free for the push at
+ *   position pos, when its sequence number is pos. After the event
+ *   is written, the sequence number becomes pos + 1 and the cell
+ *   can be popped.
+ *
+ *   @return kErrFull, when the ring is full. The event is lost.
+ */
+static ErrCode ring_push( VC_RING *ring, VC_EVENT const *ev ) {
+	VC_RING_CELL *cell;
+	U32 pos;
+
+	pos = SEQ_LOAD( &ring->head, relaxed );
+	for( ;; ) {
+		S32 diff;
+
+		cell = &ring->cell[pos & ring->mask];
+		diff = (S32)( SEQ_LOAD( &cell->seq, acquire ) - pos );
+		if( diff == 0 ) {
+			if( SEQ_CAS( &ring->head, &pos, pos + 1u )) {
+				break;
+			}
+		}
+		else if( diff < 0 ) {
+			(void) SEQ_ADD( &ring->lost, 1u );
+			return kErrFull;
+		}
+		else {
+			pos = SEQ_LOAD( &ring->head, relaxed );
+		}
+	}
+
+	cell->ev = *ev;
+	SEQ_STORE( &cell->seq, pos + 1u, release );
+
+	return kErrNone;
+}
+/*** var_written ************************************************************/
+/**
+ *   A write of a variable was accepted: add the value to its history,
+ *   see vc_ctx_history(), and report a change with var_changed().
+ *
+ *   @param hnd    Variable handle
+ *   @param chan   Channel
+ *   @param val    New value, NULL for strings
+ *   @param changed 1, when the value differs from the old one
+ */
+static void var_written( VC_CTX *ctx, HND hnd, U16 chan, VC_VALUE const *val, int changed ) {
+
+	if(( ctx->data->hist_cnt > 0u ) && ( val != NULL )) {
+		VC_HIST const *hist = hist_find( ctx, hnd );
+		VAR_DESC const *var = get_var( ctx, hnd );
+
+		if(( hist != NULL ) && ( chan < var->vec_items )) {
+			hist_add( ctx, hist, chan, hist_value( var->type & TYPE_MASK, val ));
+		}
+	}
+
+	if( changed != 0 ) {
+		var_changed( ctx, hnd, chan, val );
+	}
+}
+
+/*** var_changed ************************************************************/
+/**
+ *   A variable was changed: mark it dirty and send a change event
+ *   to its subscribers.
+ *
+ *   @param hnd    Variable handle
+ *   @param chan   Channel
+ *   @param val    New value, NULL for strings
+ */
+static void var_changed( VC_CTX *ctx, HND hnd, U16 chan, VC_VALUE const *val ) {
+	VC_EVENT ev;
+
+	mark_dirty( ctx, hnd );
+	derive_stale( ctx, hnd, chan );
+
+	if( 0u == SEQ_LOAD( &ctx->sub_cnt, relaxed )) {
+		return;
+	}
+
+	ev.hnd  = hnd;
+	ev.chan = chan;
+	if( NULL == val ) {
+		(void) memset( &ev.val, 0, sizeof(ev.val));
+	}
+	else {
+		ev.val = *val;
+	}
+
+	for( int i = 0; i < VC_MAX_SUB; i++ ) {
+		VC_SUB const *sub = &ctx->sub[i];
+
+		if(( SEQ_LOAD( &sub->active, acquire ) != 1u ) || ( sub->hnd != hnd ) ||
+		   (( sub->chan != VC_ALL_CHAN ) && ( sub->chan != chan ))) {
+			continue;
+		}
+
+		if( sub->ring != NULL ) {
+			(void) ring_push( sub->ring, &ev );
+		}
+		if( sub->cb != NULL ) {
+			sub->cb( &ev, sub->arg );
+		}
+	}
+}
+
+/*** derive_find ************************************************************/
+/**
+ *   Find the derived variable of a handle, VC_DATA.derive is sorted
+ *   by handle.
+ *
+ *   @return NULL, when hnd isn't a derived variable.
+ */
+static VC_DERIVE const *derive_find( VC_CTX *ctx, HND hnd ) {
+	VC_DERIVE const *drv = ctx->data->derive;
+	U32 lo = 0u;
+	U32 hi = ctx->data->derive_cnt;
+
+	while( lo < hi ) {
+		U32 mid = ( lo + hi ) / 2u;
+
+		if( drv[mid].hnd < hnd ) {
+			lo = mid + 1u;
+		}
+		else {
+			hi = mid;
+		}
+	}
+
+	return (( lo < ctx->data->derive_cnt ) && ( drv[lo].hnd == hnd )) ? &drv[lo] : NULL;
+}
+
+/*** derive_input ***********************************************************/
+/**
+ *   Read an input of a derived variable as double.
+ *
+ *   @param hnd    Handle of the input
+ *   @param chan   Channel of the derived variable, a scalar input
+ *                 is read from channel 0
+ */
+static F64 derive_input( VC_CTX *ctx, HND hnd, U16 chan ) {
+	VC_DATA const *vc = ctx->data;
+	VAR_DESC const *var = get_var( ctx, hnd );
+	F64 val = 0.0;
+	HND idx;
+	U32 seq;
+
+	if( !is_vector( var )) {
+		chan = 0u;
+	}
+	idx = var->data_idx + chan;
+
+	derive_fresh( ctx, var, hnd, chan, 1u );
+	do {
+		seq = seq_read_begin( ctx, hnd );
+		switch( var->type & TYPE_MASK ) {
+			case TYPE_INT8:   val = (F64) vc->data_s8[idx]; break;
+			case TYPE_INT16:  val = (F64) vc->data_s16[idx]; break;
+			case TYPE_INT32:  val = (F64) vc->data_s32[idx]; break;
+			case TYPE_INT64:  val = (F64) vc->data_s64[idx]; break;
+			case TYPE_FLOAT:  val = (F64) vc->data_f32[idx]; break;
+			case TYPE_DOUBLE: val = vc->data_f64[idx]; break;
+			case TYPE_ENUM:   val = (F64) vc->data_enum[idx]; break;
+			default:
+				break;
+		}
+	} while( seq_read_retry( ctx, hnd, seq ) != 0 );
+
+	return val;
+}
+
+/*** derive_eval ************************************************************/
+/**
+ *   Run the program of a derived variable for one channel.
+ *   varpp checks the programs, the stack has at most VC_DRV_STACK
+ *   entries.
+ */
+static F64 derive_eval( VC_CTX *ctx, VC_DERIVE const *drv, U16 chan ) {
+	U16 const *code = &ctx->data->derive_code[drv->code];
+	F64 stack[VC_DRV_STACK];
+	int sp = 0;
+	int done = 0;
+
+	while( done == 0 ) {
+		U16 op = *code++;
+
+		assert( sp < VC_DRV_STACK );
+		switch( op ) {
+			case VC_DRV_VAR:   stack[sp++] = derive_input( ctx, *code++, chan ); break;
+			case VC_DRV_CONST: stack[sp++] = ctx->data->derive_const[*code++]; break;
+			case VC_DRV_ADD:   sp--; stack[sp - 1] += stack[sp]; break;
+			case VC_DRV_SUB:   sp--; stack[sp - 1] -= stack[sp]; break;
+			case VC_DRV_MUL:   sp--; stack[sp - 1] *= stack[sp]; break;
+			case VC_DRV_DIV:   sp--; stack[sp - 1] /= stack[sp]; break;
+			case VC_DRV_NEG:   stack[sp - 1] = -stack[sp - 1]; break;
+			default:
+				done = 1;
+				break;
+		}
+	}
+
+	return ( sp > 0 ) ? stack[sp - 1] : 0.0;
+}
+
+/*** derive_int *************************************************************/
+/**
+ *   Round the result of a derived variable of an integer type and
+ *   clip it to [lo, hi]. NaN becomes 0.
+ */
+static S64 derive_int( F64 val, S64 lo, S64 hi ) {
+	S64 n;
+
+	if( val != val ) {
+		n = 0;
+	}
+	else if( val >= (F64) hi ) {
+		n = hi;
+	}
+	else if( val <= (F64) lo ) {
+		n = lo;
+	}
+	else {
+		n = (S64)(( val < 0.0 ) ? ( val - 0.5 ) : ( val + 0.5 ));
+	}
+	return n;
+}
+
+/*** derive_store ***********************************************************/
+/**
+ *   Store the result of a derived variable. Integer types are rounded,
+ *   FLAG_CLIP clips the result to the limits of the variable.
+ *   The caller holds the write lock of the variable.
+ */
+static void derive_store( VC_CTX *ctx, VAR_DESC const *var, U16 chan, F64 val ) {
+	VC_DATA const *vc = ctx->data;
+	HND idx = var->data_idx + chan;
+	U16 flags = var->acc_rights & FLAG_CLIP;
+
+	switch( var->type & TYPE_MASK ) {
+		case TYPE_INT8: {
+			S8 v = (S8) derive_int( val, SCHAR_MIN, SCHAR_MAX );
+			(void) limit_s8( flags, &vc->lim_s8[idx], &v );
+			vc->data_s8[idx] = v;
+			break;
+		}
+
+		case TYPE_INT16: {
+			S16 v = (S16) derive_int( val, SHRT_MIN, SHRT_MAX );
+			(void) limit_s16( flags, &vc->lim_s16[idx], &v );
+			vc->data_s16[idx] = v;
+			break;
+		}
+
+		case TYPE_INT32: {
+			S32 v = (S32) derive_int( val, INT_MIN, INT_MAX );
+			(void) limit_s32( flags, &vc->lim_s32[idx], &v );
+			vc->data_s32[idx] = v;
+			break;
+		}
+
+		case TYPE_INT64: {
+			S64 v = derive_int( val, LLONG_MIN, LLONG_MAX );
+			(void) limit_s64( flags, &vc->lim_s64[idx], &v );
+			vc->data_s64[idx] = v;
+			break;
+		}
+
+		case TYPE_FLOAT: {
+			F32 v = (F32) val;
+			(void) limit_f32( flags, &vc->lim_f32[idx], &v );
+			vc->data_f32[idx] = v;
+			break;
+		}
+
+		case TYPE_DOUBLE: {
+			F64 v = val;
+			(void) limit_f64( flags, &vc->lim_f64[idx], &v );
+			vc->data_f64[idx] = v;
+			break;
+		}
+
+		default:
+			break;
+	}
+}
+
+/*** derive_update **********************************************************/
+/**
+ *   Recompute the stale channels chan ... chan+cnt-1 of a derived
+ *   variable.
+ *
+ *   The expression is evaluated without a lock, the inputs are read
+ *   like any other variable. The write lock of the variable is only
+ *   taken to store the result, so no other lock is held at the same
+ *   time. The result is dropped and the channel computed again, when
+ *   an input was written during the computation, see derive_mark().
+ *
+ *   Changes of derived variables are not notified.
+ */
+static void derive_update( VC_CTX *ctx, VAR_DESC const *var, HND hnd, U16 chan, U16 cnt ) {
+	VC_DERIVE const *drv = derive_find( ctx, hnd );
+
+	if(( NULL == drv ) || ( NULL == ctx->data->stale )) {
+		return;
+	}
+
+	for( U16 k = 0; k < cnt; k++ ) {
+		VC_SEQ *stale = &ctx->data->stale[drv->stale + chan + k];
+		U32 s = SEQ_LOAD( stale, acquire );
+
+		while( s != 0u ) {
+			F64 val = derive_eval( ctx, drv, chan + k );
+
+			seq_write_begin( ctx, hnd );
+			if( SEQ_CAS( stale, &s, 0u )) {
+				derive_store( ctx, var, chan + k, val );
+				s = 0u;
+			}
+			seq_write_end( ctx, hnd );
+		}
+	}
+}
+
+/*** derive_mark ************************************************************/
+/**
+ *   Mark a channel of a derived variable stale. The flag counts the
+ *   marks and skips 0, so derive_update() sees a mark set during the
+ *   computation even when the flag was already set before.
+ */
+static inline void derive_mark( VC_SEQ *stale ) {
+	U32 s = SEQ_LOAD( stale, relaxed );
+
+	for( ;; ) {
+		U32 n = (( s + 1u ) != 0u ) ? ( s + 1u ) : 1u;
+
+		if( SEQ_CAS( stale, &s, n )) {
+			break;
+		}
+	}
+}
+
+/*** derive_stale ***********************************************************/
+/**
+ *   A variable was changed: mark the derived variables depending on
+ *   it stale. A vector marks the same channel, a scalar all channels.
+ *   varpp lists the derived variables depending on another derived
+ *   variable as well.
+ *
+ *   @param hnd    Variable handle
+ *   @param chan   Channel
+ */
+static void derive_stale( VC_CTX *ctx, HND hnd, U16 chan ) {
+	VC_DATA const *vc = ctx->data;
+	int all;
+
+	if(( NULL == vc->derive_first ) || ( NULL == vc->stale )) {
+		return;
+	}
+
+	all = !is_vector( get_var( ctx, hnd ));
+	for( U16 i = vc->derive_first[hnd]; i < vc->derive_first[hnd + 1u]; i++ ) {
+		VC_DERIVE const *drv = &vc->derive[vc->derive_list[i]];
+
+		if( all != 0 ) {
+			U16 cnt = get_var( ctx, drv->hnd )->vec_items;
+
+			for( U16 k = 0; k < cnt; k++ ) {
+				derive_mark( &vc->stale[drv->stale + k] );
+			}
+		}
+		else {
+			derive_mark( &vc->stale[drv->stale + chan] );
+		}
+	}
+}
+
+/*** derive_stale_all *******************************************************/
+/**
+ *   Mark all derived variables stale, eg. after vc_ctx_restore().
+ */
+static void derive_stale_all( VC_CTX *ctx ) {
+	VC_DATA const *vc = ctx->data;
+
+	for( U32 i = 0; ( vc->stale != NULL ) && ( i < vc->stale_cnt ); i++ ) {
+		derive_mark( &vc->stale[i] );
+	}
+}
+
+/*** hist_find **************************************************************/
+/**
+ *   Find the history of a handle, VC_DATA.hist is sorted by handle.
+ *
+ *   @return NULL, when hnd has no history.
+ */
+static VC_HIST const *hist_find( VC_CTX *ctx, HND hnd ) {
+	VC_HIST const *hist = ctx->data->hist;
+	U32 lo = 0u;
+	U32 hi = ctx->data->hist_cnt;
+
+	while( lo < hi ) {
+		U32 mid = ( lo + hi ) / 2u;
+
+		if( hist[mid].hnd < hnd ) {
+			lo = mid + 1u;
+		}
+		else {
+			hi = mid;
+		}
+	}
+
+	return (( lo < ctx->data->hist_cnt ) && ( hist[lo].hnd == hnd )) ? &hist[lo] : NULL;
+}
+
+/*** hist_value *************************************************************/
+/**
+ *   Value of a write as sample of a history, INT64 and DOUBLE
+ *   lose precision as F32.
+ *
+ *   @param type   TYPE_INT8 ... TYPE_ENUM
+ *   @param val    New value
+ */
+static F32 hist_value( U16 type, VC_VALUE const *val ) {
+	F32 v = 0.0f;
+
+	switch( type ) {
+		case TYPE_INT16:
+		case TYPE_ENUM:   v = (F32) val->s16; break;
+		case TYPE_INT32:  v = (F32) val->s32; break;
+		case TYPE_FLOAT:  v = val->f32; break;
+		case TYPE_INT8:   v = (F32) val->s8; break;
+		case TYPE_INT64:  v = (F32) val->s64; break;
+		case TYPE_DOUBLE: v = (F32) val->f64; break;
+		default:
+			break;
+	}
+	return v;
+}
+
+/*** hist_push **************************************************************/
+/**
+ *   Append a cell to a ring, the oldest cell is overwritten when
+ *   the ring is full. The ring is locked.
+ *
+ *   @param ring   Ring
+ *   @param cnt    Cells of the ring
+ *   @param cell   The cells
+ */
+static void hist_push( VC_HIST_RING *ring, U32 cnt, VC_HIST_CELL *cell, U32 ts, F32 min, F32 max, F32 mean ) {
+	VC_HIST_CELL *c = &cell[ring->pos];
+
+	c->ts   = ts;
+	c->min  = min;
+	c->max  = max;
+	c->mean = mean;
+
+	ring->pos = ( ring->pos + 1u < cnt ) ? ( ring->pos + 1u ) : 0u;
+	if( ring->fill < cnt ) {
+		ring->fill++;
+	}
+}
+
+/*** hist_close *************************************************************/
+/**
+ *   Close the open period of a ring, when now is in a later period.
+ *   The ring is locked.
+ *
+ *   @param ring   Ring
+ *   @param tier   Tier of the ring, period > 0
+ *   @param cell   The cells
+ *   @param now    Current time
+ */
+static void hist_close( VC_HIST_RING *ring, VC_HIST_TIER const *tier, VC_HIST_CELL *cell, U32 now ) {
+
+	if(( ring->n > 0u ) && (( now - ( now % tier->period )) != ring->ts )) {
+		hist_push( ring, tier->cnt, cell, ring->ts, ring->min, ring->max,
+		           (F32)( ring->sum / (F64) ring->n ));
+		ring->n = 0u;
+	}
+}
+
+/*** hist_now ***************************************************************/
+/**
+ *   Current time of a history: the clock, without a clock the
+ *   number of the next sample of the channel.
+ *
+ *   @param hist   History
+ *   @param chan   Channel
+ */
+static U32 hist_now( VC_CTX *ctx, VC_HIST const *hist, U16 chan ) {
+	VC_HIST_RING *ring;
+	U32 now;
+
+	if( ctx->clock != NULL ) {
+		return ctx->clock( ctx->clock_arg );
+	}
+
+	ring = &ctx->data->hist_ring[ctx->data->hist_tier[hist->tier].ring + chan];
+	hist_lock( ring );
+	now = ring->ts;
+	hist_unlock( ring );
+	return now;
+}
+
+/*** hist_add ***************************************************************/
+/**
+ *   Add a sample to the history of a channel, see vc_ctx_history().
+ *
+ *   Tier 0 gets the sample. The other tiers collect min, max and
+ *   sum of their open period, which is closed by the first sample
+ *   of a later period or by vc_ctx_history() after it elapsed.
+ *
+ *   @param hist   History
+ *   @param chan   Channel
+ *   @param v      Sample
+ */
+static void hist_add( VC_CTX *ctx, VC_HIST const *hist, U16 chan, F32 v ) {
+	VC_DATA const *vc = ctx->data;
+	U32 ts = 0u;
+
+	if( ctx->clock != NULL ) {
+		ts = ctx->clock( ctx->clock_arg );
+	}
+
+	for( U16 t = 0; t < hist->tier_cnt; t++ ) {
+		VC_HIST_TIER const *tier = &vc->hist_tier[hist->tier + t];
+		VC_HIST_RING *ring = &vc->hist_ring[tier->ring + chan];
+		VC_HIST_CELL *cell = &vc->hist_cell[tier->cell + (U32) chan * tier->cnt];
+
+		hist_lock( ring );
+		if( 0u == tier->period ) {
+			/* without a clock the time is the number of the sample */
+			if( NULL == ctx->clock ) {
+				ts = ring->ts++;
+			}
+			hist_push( ring, tier->cnt, cell, ts, v, v, v );
+		}
+		else {
+			hist_close( ring, tier, cell, ts );
+			if( 0u == ring->n ) {
+				ring->ts  = ts - ( ts % tier->period );
+				ring->min = v;
+				ring->max = v;
+				ring->sum = 0.0;
+			}
+			ring->n++;
+			ring->sum += (F64) v;
+			ring->min = ( v < ring->min ) ? v : ring->min;
+			ring->max = ( v > ring->max ) ? v : ring->max;
+		}
+		hist_unlock( ring );
+	}
+}
+
+#ifdef VC_STATISTICS
+# ifdef STATS_CLOCK
+/*** stats_now **************************************************************/
+/**
+ *   Default clock of the latency histograms, define VC_STATS_NOW()
+ *   for another one.
+ *
+ *   @return Monotonic time in ns.
+ */
+static U64 stats_now( void ) {
+	struct timespec ts;
+
+#  ifdef _WIN32
+	(void) timespec_get( &ts, TIME_UTC );
+#  else
+	(void) clock_gettime( CLOCK_MONOTONIC, &ts );
+#  endif
+	return (U64) ts.tv_sec * 1000000000u + (U64) ts.tv_nsec;
+}
+# endif
+
+/*** stats_shard ************************************************************/
+/**
+ *   Shard of the calling thread. The threads get the shards round
+ *   robin, so concurrent callers rarely share a cache line.
+ */
+static U32 stats_shard( void ) {
+# ifdef VC_THREAD_SAFE
+	if( 0u == s_stats_shard ) {
+		s_stats_shard = SEQ_ADD( &s_stats_next, 1u ) % VC_STATS_SHARDS + 1u;
+	}
+	return s_stats_shard - 1u;
+# else
+	return 0u;
+# endif
+}
+
+/*** stats_latency **********************************************************/
+/**
+ *   Add the time since t0 to the histogram of fn and, unless
+ *   TYPE_LAST, to the histogram of type.
+ *
+ *   @param fn     VC_STAT_AS_INT16 ... VC_STAT_RESET
+ *   @param type   Type of the variable or TYPE_LAST
+ *   @param t0     Time of the call
+ */
+static void stats_latency( int fn, U16 type, U64 t0 ) {
+	U64 ns = VC_STATS_NOW() - t0;
+	U32 shard = stats_shard();
+	int b = 0;
+
+	while(( ns > 1u ) && ( b < VC_STATS_BUCKETS - 1 )) {
+		ns >>= 1;
+		b++;
+	}
+
+	(void) SEQ_ADD( &s_stats_lat[shard][fn][b], 1u );
+	if( type < TYPE_LAST ) {
+		(void) SEQ_ADD( &s_stats_type[shard][type][b], 1u );
+	}
+}
+
+/*** stats_var **************************************************************/
+/**
+ *   Record a call of an accessor, see STATS_VAR.
+ *
+ *   @param fn     VC_STAT_AS_INT16 ... VC_STAT_RESET
+ *   @param hnd    Variable handle
+ *   @param rdwr   VarRead or VarWrite
+ *   @param ret    Result of the call
+ *   @param t0     Time of the call
+ */
+static void stats_var( VC_CTX *ctx, int fn, HND hnd, int rdwr, ErrCode ret, U64 t0 ) {
+	U16 type = TYPE_LAST;
+
+	if(( ctx->data != NULL ) && ( hnd < ctx->data->var_cnt )) {
+		type = get_var( ctx, hnd )->type & TYPE_MASK;
+	}
+	stats_latency( fn, type, t0 );
+	stats_items( ctx, &hnd, &ret, 1u, rdwr );
+}
+
+/*** stats_items ************************************************************/
+/**
+ *   Count reads or writes and failures of the variables in hnd.
+ *
+ *   @param hnd    Variable handles
+ *   @param err    Results, NULL counts every item as done
+ *   @param n      Number of items
+ *   @param rdwr   VarRead or VarWrite
+ */
+static void stats_items( VC_CTX *ctx, HND const *hnd, ErrCode const *err, size_t n, int rdwr ) {
+	VC_STATS_VAR *st;
+
+	if(( NULL == ctx->data ) || ( NULL == ctx->data->stats ) || ( NULL == hnd )) {
+		return;
+	}
+
+	st = &ctx->data->stats[stats_shard() * ctx->data->var_cnt];
+	for( size_t i = 0; i < n; i++ ) {
+		if( hnd[i] >= ctx->data->var_cnt ) {
+			continue;
+		}
+		if( rdwr == VarWrite ) {
+			(void) SEQ_ADD( &st[hnd[i]].writes, 1u );
+		}
+		else {
+			(void) SEQ_ADD( &st[hnd[i]].reads, 1u );
+		}
+		if(( err != NULL ) && ( err[i] != kErrNone )) {
+			(void) SEQ_ADD( &st[hnd[i]].errors, 1u );
+		}
+	}
+}
+
+/*** stats_sum **************************************************************/
+/**
+ *   Sum the histograms of all shards.
+ *
+ *   @param cnt    Histogram of shard 0
+ *   @param stride Distance of the shards in counters
+ *   @param bucket Returns the VC_STATS_BUCKETS sums
+ */
+static void stats_sum( VC_COUNT const *cnt, size_t stride, U64 *bucket ) {
+	for( int b = 0; b < VC_STATS_BUCKETS; b++ ) {
+		bucket[b] = 0u;
+		for( U32 s = 0; s < VC_STATS_SHARDS; s++ ) {
+			bucket[b] += SEQ_LOAD( (VC_COUNT *) &cnt[s * stride + (size_t) b], relaxed );
+		}
+	}
+}
+
+/*** stats_dump_hist ********************************************************/
+/**
+ *   Write the number of calls and the upper bounds of the buckets
+ *   of the 50th and 99th percentile. The text omits unused
+ *   histograms.
+ *
+ *   @param name   Function or type
+ *   @param bucket Histogram
+ *   @param json   0 for VC_DUMP_TEXT
+ */
+static void stats_dump_hist( DUMP_OUT *out, char const *name, U64 const *bucket, int json ) {
+	char num[24];
+	U64 calls = 0u;
+	U64 sum = 0u;
+	int p50 = -1;
+	int p99 = -1;
+
+	for( int b = 0; b < VC_STATS_BUCKETS; b++ ) {
+		calls += bucket[b];
+	}
+	if(( 0u == calls ) && ( 0 == json )) {
+		return;
+	}
+	for( int b = 0; ( calls > 0u ) && ( b < VC_STATS_BUCKETS ) && ( p99 < 0 ); b++ ) {
+		sum += bucket[b];
+		if(( p50 < 0 ) && ( sum * 2u >= calls )) {
+			p50 = b;
+		}
+		if( sum * 100u >= calls * 99u ) {
+			p99 = b;
+		}
+	}
+
+	if( json != 0 ) {
+		out_str( out, "{\"name\":\"" );
+		out_str( out, name );
+		out_str( out, "\",\"calls\":" );
+	}
+	else {
+		out_str( out, "  " );
+		out_str( out, name );
+		out_str( out, ": calls " );
+	}
+	(void) vc_fmt_s64( num, (S64) calls );
+	out_str( out, num );
+
+	out_str( out, ( json != 0 ) ? ",\"p50_ns\":" : ", p50 < " );
+	(void) vc_fmt_s64( num, ( p50 < 0 ) ? 0 : ( (S64) 1 << ( p50 + 1 )));
+	out_str( out, num );
+	out_str( out, ( json != 0 ) ? ",\"p99_ns\":" : " ns, p99 < " );
+	(void) vc_fmt_s64( num, ( p99 < 0 ) ? 0 : ( (S64) 1 << ( p99 + 1 )));
+	out_str( out, num );
+	out_str( out, ( json != 0 ) ? "}" : " ns\n" );
+}
+#endif
+
+/*** dirty_words ************************************************************/
+/**
+ *   Dirty bitmap of a storage class.
+ *
+ *   @param storage  EEPROM or FLASH
+ *   @param cnt      Number of words of the bitmap
+ *
+ *   @return NULL, when the table has no bitmaps or the variables
+ *           of storage are volatile.
+ */
+static VC_DIRTY *dirty_words( VC_CTX *ctx, U16 storage, U32 *cnt ) {
+	U32 words = VC_DIRTY_WORDS( ctx->data->var_cnt ) / 2u;
+
+	*cnt = words;
+	if( NULL == ctx->data->dirty ) {
+		return NULL;
+	}
+
+	switch( storage & MSK_STORAGE ) {
+		case EEPROM: return &ctx->data->dirty[0];
+		case FLASH:  return &ctx->data->dirty[words];
+		default:
+			break;
+	}
+	return NULL;
+}
+
+/*** mark_dirty *************************************************************/
+/**
+ *   Mark a non-volatile variable for the next vc_ctx_flush().
+ *
+ *   @param hnd    Variable handle
+ */
+static void mark_dirty( VC_CTX *ctx, HND hnd ) {
+	U32       cnt;
+	VC_DIRTY *dirty = dirty_words( ctx, get_var( ctx, hnd )->type, &cnt );
+	U32       bit   = 1u << ( hnd % 32u );
+
+	if( NULL == dirty ) {
+		return;
+	}
+
+	dirty = &dirty[hnd / 32u];
+	if(( SEQ_LOAD( dirty, relaxed ) & bit ) == 0u ) {
+		(void) SEQ_OR( dirty, bit );
+	}
+}
+
+/*** dirty_take *************************************************************/
+/**
+ *   Read and clear a word of a dirty bitmap.
+ */
+static U32 dirty_take( VC_DIRTY *dirty ) {
+#ifdef VC_THREAD_SAFE
+	return atomic_exchange_explicit( dirty, 0u, memory_order_acquire );
+#else
+	U32 bits = *dirty;
+
+	*dirty = 0u;
+	return bits;
+#endif
+}
+
+/*** var_store ************************************************************/
+/**
+ *   Array with the values of a variable.
+ *
+ *   @param var    Variable
+ *   @param item   Size of one value
+ *
+ *   @return kStoreS16 ... kStoreStr, kStoreLast when the variable has
+ *           no values (constant strings, actions).
+ */
+static int var_store( VAR_DESC const *var, size_t *item ) {
+	int st = kStoreLast;
+
+	*item = 0;
+	switch( var->type & TYPE_MASK ) {
+		case TYPE_INT16:  st = kStoreS16;  *item = sizeof(S16); break;
+		case TYPE_INT32:  st = kStoreS32;  *item = sizeof(S32); break;
+		case TYPE_FLOAT:  st = kStoreF32;  *item = sizeof(F32); break;
+		case TYPE_DOUBLE: st = kStoreF64;  *item = sizeof(F64); break;
+		case TYPE_INT8:   st = kStoreS8;   *item = sizeof(S8); break;
+		case TYPE_INT64:  st = kStoreS64;  *item = sizeof(S64); break;
+		case TYPE_ENUM:   st = kStoreEnum; *item = sizeof(S16); break;
+		case TYPE_STRING:
+			if(( var->type & TYPE_CONST ) == 0u ) {
+				st = kStoreStr;
+				*item = sizeof(STRBUF);
+			}
+			break;
+		default:
+			break;
+	}
+	return st;
+}
+
+/*** var_image **************************************************************/
+/**
+ *   Location of the values of a variable and its position in a snapshot.
+ *
+ *   @param var    Variable
+ *   @param offs   Position in the snapshot
+ *   @param size   Size of the values
+ *
+ *   @return NULL, when the variable has no values (constant
+ *           strings, actions).
+ */
+static U8 *var_image( VC_CTX *ctx, VAR_DESC const *var, U32 *offs, size_t *size ) {
+	VC_DATA const *vc   = ctx->data;
+	size_t         item;
+	int            st   = var_store( var, &item );
+	size_t         pos;
+
+	*size = var->vec_items * item;
+	if( 0u == *size ) {
+		return NULL;
+	}
+
+	/* data_idx of strings is an index of the characters */
+	pos = ( kStoreStr == st ) ? var->data_idx : ( var->data_idx * item );
+	*offs = (U32)( sizeof(SNAP_HDR) + pos );
+	for( int i = 0; i < st; i++ ) {
+		*offs += (U32) store_size( vc, i );
+	}
+
+	return (U8*) store_get( vc, st ) + pos;
+}
+
+/*** flush_run **************************************************************/
+/**
+ *   Write the values of the variables first ... last, which are
+ *   adjacent in the snapshot, and unlock them.
+ */
+static ErrCode flush_run( VC_CTX *ctx, VC_BACKEND const *be, HND first, HND last,
+                          U8 const *data, U32 offs, size_t size ) {
+	ErrCode E = be->write( be->arg, first, offs, data, size );
+
+	for( U32 hnd = first; hnd <= last; hnd++ ) {
+		seq_write_end( ctx, (HND) hnd );
+		if( E != kErrNone ) {
+			mark_dirty( ctx, (HND) hnd );
+		}
+	}
+	return E;
+}
+
+/*** vc_get_min_max **************************************************/
+/**
+ *   Read minimum or maximum value of a variable of types:
+ *      TYPE_INT8, TYPE_INT16, TYPE_INT32, TYPE_INT64, TYPE_F32, TYPE_DOUBLE.
+ *
+ *   The 8 and 64 bit limits are copied, val need not be aligned.
+ *
+ *   @param hnd    Variable handle
+ *   @param val    Pointer to value
+ *   @param chan   Channel
+ *   @param flag   Flag, {Bit 0: 0 -> minimum, 1 -> maximum,
+ *                        Bit 1: 0 -> read, 1 -> write }
+ */
+static ErrCode rw_min_max( VC_CTX *ctx, HND hnd, U8* val, U16 chan, U16 flag ) {
+	U16 type;
+
+  /* cppcheck-suppress misra-c2012-19.2 */
+	union {
+		/*U8   bytes[4];*/
+		S32  val_s32;
+    F32  val_f32;
+		/* cppcheck-suppress misra-c2012-19.2 */
+	} conv;
+
+	LIM_S16 *lim_s16;
+	LIM_S32 *lim_s32;
+	LIM_F32 *lim_f32;
+	LIM_S8  *lim_s8;
+	LIM_S64 *lim_s64;
+	LIM_F64 *lim_f64;
+
+	VAR_DESC const *var;
+	U32 seq;
+
+	int minmax = flag & 1u;
+	int wr     = (flag & 2u) >> 1u;
+	
+	assert( ctx->data );
+	
+	if( hnd >= ctx->data->var_cnt ) {
+		return kErrUnknownCmd;
+	}
+
+	if( NULL == val ) {
+		return kErrInvalidArg;
+	}
+
+	var = get_var( ctx, hnd );
+	type = var->type & TYPE_MASK;
+
+	if(( type != TYPE_INT16 ) && ( type != TYPE_INT32 ) && ( type != TYPE_FLOAT ) &&
+	   ( type != TYPE_INT8 ) && ( type != TYPE_INT64 ) && ( type != TYPE_DOUBLE )) {
+		return kErrInvalidType;
+	}
+
+	if( chan > 0u ) {
+		ErrCode ret = vc_chk_vector( var, chan );
+		if( ret != kErrNone ) {
+			return ret;
+		}
+	}
+
+	if( wr != 0 ) {
+		seq_write_begin( ctx, hnd );
+	}
+
+	do {
+		seq = (wr != 0) ? 0u : seq_read_begin( ctx, hnd );
+
+		switch( type ) {
+			case TYPE_INT16:
+				lim_s16 = &ctx->data->lim_s16[ var->data_idx + chan ];
+				if( wr != 0 ) {
+					S16 *p = (0 == minmax) ? &lim_s16->min : &lim_s16->max;
+					/* cppcheck-suppress misra-c2012-11.3 */
+					*p = *(S16*)val;
+				}
+				else {
+					/* cppcheck-suppress misra-c2012-11.3 */
+					*(S16*) val = (0 == minmax) ? lim_s16->min : lim_s16->max;
+				}
+				break;
+
+			case TYPE_INT32:
+				lim_s32 = &ctx->data->lim_s32[ var->data_idx + chan ];
+				if( wr != 0 ) {
+					S32 *p = (0 == minmax) ? &lim_s32->min : &lim_s32->max;
+					/* cppcheck-suppress misra-c2012-11.3 */
+					*p = *(S32*)val;
+				}
+				else {
+					/* cppcheck-suppress misra-c2012-11.3 */
+					*(S32*) val = (0 == minmax) ? lim_s32->min : lim_s32->max;
+				}
+				break;
+
+			case TYPE_FLOAT:
+				lim_f32 = &ctx->data->lim_f32[ var->data_idx + chan ];
+				if( wr != 0 ) {
+					F32 *p = (0 == minmax) ? &lim_f32->min : &lim_f32->max;
+					/* cppcheck-suppress misra-c2012-11.3 */
+					conv.val_s32 = *(S32 *)val;
+					*p = conv.val_f32;
+				}
+				else {
+					conv.val_f32 = (0 == minmax) ? lim_f32->min : lim_f32->max;
+					/* cppcheck-suppress misra-c2012-11.3 */
+					*(S32*) val = conv.val_s32;
+				}
+				break;
+
+			case TYPE_INT8:
+				lim_s8 = &ctx->data->lim_s8[ var->data_idx + chan ];
+				if( wr != 0 ) {
+					(void) memcpy( (0 == minmax) ? &lim_s8->min : &lim_s8->max, val, sizeof(S8));
+				}
+				else {
+					(void) memcpy( val, (0 == minmax) ? &lim_s8->min : &lim_s8->max, sizeof(S8));
+				}
+				break;
+
+			case TYPE_INT64:
+				lim_s64 = &ctx->data->lim_s64[ var->data_idx + chan ];
+				if( wr != 0 ) {
+					(void) memcpy( (0 == minmax) ? &lim_s64->min : &lim_s64->max, val, sizeof(S64));
+				}
+				else {
+					(void) memcpy( val, (0 == minmax) ? &lim_s64->min : &lim_s64->max, sizeof(S64));
+				}
+				break;
+
+			case TYPE_DOUBLE:
+				lim_f64 = &ctx->data->lim_f64[ var->data_idx + chan ];
+				if( wr != 0 ) {
+					(void) memcpy( (0 == minmax) ? &lim_f64->min : &lim_f64->max, val, sizeof(F64));
+				}
+				else {
+					(void) memcpy( val, (0 == minmax) ? &lim_f64->min : &lim_f64->max, sizeof(F64));
+				}
+				break;
+
+			default:
+				LOG_UNH_CASE( type );
+				break;
+		}
+	} while(( wr == 0 ) && ( seq_read_retry( ctx, hnd, seq ) != 0 ));
+
+	if( wr != 0 ) {
+		seq_write_end( ctx, hnd );
+	}
+
+	return kErrNone;
+}
+
+/*** out_flush **************************************************************/
+/**
+ *   Pass the buffer of vc_ctx_dump_all() to the writer.
+ */
+static void out_flush( DUMP_OUT *out ) {
+	if(( out->len > 0u ) && ( out->err == kErrNone )) {
+		out->err = out->wr( out->arg, out->buf, out->len );
+	}
+	out->len = 0;
+}
+
+/*** out_mem ****************************************************************/
+/**
+ *   Append n characters to the buffer, flush it when it is full.
+ */
+static void out_mem( DUMP_OUT *out, char const *s, size_t n ) {
+	while(( n > 0u ) && ( out->err == kErrNone )) {
+		size_t k = sizeof(out->buf) - out->len;
+
+		k = ( k > n ) ? n : k;
+		(void) memcpy( &out->buf[out->len], s, k );
+		out->len += k;
+		s += k;
+		n -= k;
+
+		if( out->len == sizeof(out->buf) ) {
+			out_flush( out );
+		}
+	}
+}
+
+/*** out_str **************************************************************/
+/**
+ *   Append a string without its '\0'.
+ */
+static void out_str( DUMP_OUT *out, char const *s ) {
+	out_mem( out, s, strlen( s ));
+}
+
+/*** out_json_str ***********************************************************/
+/**
+ *   Append a string in quotes, '"', '\' and control characters
+ *   are escaped.
+ */
+static void out_json_str( DUMP_OUT *out, char const *s ) {
+	static char const hex[] = "0123456789abcdef";
+	size_t i = 0;
+
+	out_mem( out, "\"", 1u );
+	while( s[i] != '\0' ) {
+		U8 c = (U8) s[i];
+
+		if(( c == (U8) '"' ) || ( c == (U8) '\\' ) || ( c < 0x20u )) {
+			char esc[6] = { '\\', (char) c, '0', '0', '0', '0' };
+			size_t len = 2u;
+
+			out_mem( out, s, i );
+			if( c < 0x20u ) {
+				esc[1] = 'u';
+				esc[4] = hex[c >> 4];
+				esc[5] = hex[c & 0xfu];
+				len = 6u;
+			}
+			else {
+				; /* misra-c2012-15.7 */
+			}
+			out_mem( out, esc, len );
+			s = &s[i + 1u];
+			i = 0;
+		}
+		else {
+			i++;
+		}
+	}
+	out_mem( out, s, i );
+	out_mem( out, "\"", 1u );
+}
+
+/*** dump_read **************************************************************/
+/**
+ *   Read the value and the limits of a channel with one seqlock read.
+ *
+ *   @param val    Value, min and max
+ *   @param str    Value of a TYPE_STRING, sizeof(STRBUF) characters
+ */
+static void dump_read( VC_CTX *ctx, VAR_DESC const *var, HND hnd, U16 chan, VC_VALUE *val, char *str ) {
+	VC_DATA const *vc = ctx->data;
+	HND idx = var->data_idx + chan;
+	U32 seq;
+
+	derive_fresh( ctx, var, hnd, chan, 1u );
+	do {
+		seq = seq_read_begin( ctx, hnd );
+		switch( var->type & TYPE_MASK ) {
+			case TYPE_INT8:
+				val[0].s8 = vc->data_s8[idx];
+				val[1].s8 = vc->lim_s8[idx].min;
+				val[2].s8 = vc->lim_s8[idx].max;
+				break;
+
+			case TYPE_INT16:
+				val[0].s16 = vc->data_s16[idx];
+				val[1].s16 = vc->lim_s16[idx].min;
+				val[2].s16 = vc->lim_s16[idx].max;
+				break;
+
+			case TYPE_INT32:
+				val[0].s32 = vc->data_s32[idx];
+				val[1].s32 = vc->lim_s32[idx].min;
+				val[2].s32 = vc->lim_s32[idx].max;
+				break;
+
+			case TYPE_INT64:
+				val[0].s64 = vc->data_s64[idx];
+				val[1].s64 = vc->lim_s64[idx].min;
+				val[2].s64 = vc->lim_s64[idx].max;
+				break;
+
+			case TYPE_FLOAT:
+				val[0].f32 = vc->data_f32[idx];
+				val[1].f32 = vc->lim_f32[idx].min;
+				val[2].f32 = vc->lim_f32[idx].max;
+				break;
+
+			case TYPE_DOUBLE:
+				val[0].f64 = vc->data_f64[idx];
+				val[1].f64 = vc->lim_f64[idx].min;
+				val[2].f64 = vc->lim_f64[idx].max;
+				break;
+
+			case TYPE_ENUM:
+				val[0].s16 = vc->data_enum[idx];
+				break;
+
+			case TYPE_STRING:
+				if(( var->type & TYPE_CONST ) != 0u ) {
+					(void) strncpy( str, &vc->data_const_str[var->descr_idx], sizeof(STRBUF));
+				}
+				else {
+					(void) memcpy( str, &vc->data_str[var->data_idx + (chan * sizeof(STRBUF))], sizeof(STRBUF));
+				}
+				break;
+
+			default:
+				break;
+		}
+	} while( seq_read_retry( ctx, hnd, seq ) != 0 );
+
+	str[sizeof(STRBUF) - 1u] = '\0';
+}
+
+/*** dump_num ***************************************************************/
+/**
+ *   Append a number. The text has the format of the variable like
+ *   vc_ctx_as_string(), JSON has decimal integers and the shortest
+ *   floats, nan and inf are null.
+ */
+static void dump_num( DUMP_OUT *out, U16 type, U16 fmt, VC_VALUE const *val, int json ) {
+	char num[32];
+	char const *p;
+	int  hex = (( json == 0 ) &&
+	            (( fmt == FMT_HEX2 ) || ( fmt == FMT_HEX4 ) || ( fmt == FMT_HEX8 ))) ? 1 : 0;
+
+	switch( type ) {
+		case TYPE_INT8:
+			if(( hex != 0 ) && ( fmt == FMT_HEX2 )) {
+				(void) vc_fmt_hex( num, (U8) val->s8 );
+			}
+			else {
+				(void) vc_fmt_s32( num, val->s8 );
+			}
+			break;
+
+		case TYPE_INT16:
+			if(( hex != 0 ) && ( fmt != FMT_HEX8 )) {
+				(void) vc_fmt_hex( num, (U16) val->s16 );
+			}
+			else {
+				(void) vc_fmt_s32( num, val->s16 );
+			}
+			break;
+
+		case TYPE_INT32:
+			if(( hex != 0 ) && (( fmt == FMT_HEX8 ) || ( val->s32 > 0xffff ))) {
+				(void) vc_fmt_hex( num, (U32) val->s32 );
+			}
+			else if( hex != 0 ) {
+				(void) vc_fmt_hex( num, (U16) val->s32 );
+			}
+			else {
+				(void) vc_fmt_s32( num, val->s32 );
+			}
+			break;
+
+		case TYPE_INT64:
+			if(( hex != 0 ) && ( val->s64 >= 0 ) && ( val->s64 <= (S64) 0xffffffffu )) {
+				(void) vc_fmt_hex( num, (U32) val->s64 );
+			}
+			else {
+				(void) vc_fmt_s64( num, val->s64 );
+			}
+			break;
+
+		case TYPE_FLOAT:
+			(void) vc_fmt_f32( num, val->f32, ( json != 0 ) ? (U16) FMT_DEFAULT : fmt );
+			break;
+
+		case TYPE_DOUBLE:
+			(void) vc_fmt_f64( num, val->f64, ( json != 0 ) ? (U16) FMT_DEFAULT : fmt );
+			break;
+
+		default:
+			LOG_UNH_CASE( type );
+			num[0] = '\0';
+			break;
+	}
+
+	/* "nan", "inf" with an optional sign */
+	p = ( num[0] == '-' ) ? &num[1] : num;
+	if(( json != 0 ) && (( *p == 'n' ) || ( *p == 'i' ))) {
+		out_str( out, "null" );
+	}
+	else {
+		out_str( out, num );
+	}
+}
+
+/*** dump_value *************************************************************/
+/**
+ *   Append the value of a channel, read by dump_read().
+ */
+static void dump_value( VC_CTX *ctx, DUMP_OUT *out, HND hnd, VC_VALUE const *val, char const *str, int json ) {
+	VAR_DESC const *var = get_var( ctx, hnd );
+	U16 type = var->type & TYPE_MASK;
+
+	if( type == TYPE_STRING ) {
+		if( json != 0 ) {
+			out_json_str( out, str );
+		}
+		else {
+			out_str( out, str );
+		}
+	}
+	else if( type == TYPE_ENUM ) {
+		char const *sym;
+
+		if( vc_ctx_enum_symbol( ctx, hnd, val->s16, &sym ) != kErrNone ) {
+			VC_VALUE v;
+
+			v.s16 = val->s16;
+			dump_num( out, TYPE_INT16, FMT_DEFAULT, &v, json );
+		}
+		else if( json != 0 ) {
+			out_json_str( out, sym );
+		}
+		else {
+			out_str( out, sym );
+		}
+	}
+	else {
+		dump_num( out, type, var->fmt, val, json );
+	}
+}
+
+/*** dump_one ***************************************************************/
+/**
+ *   Append a variable for vc_ctx_dump_all().
+ */
+static void dump_one( VC_CTX *ctx, DUMP_OUT *out, HND hnd, int json ) {
+	VAR_DESC const *var = get_var( ctx, hnd );
+	U16 type  = var->type & TYPE_MASK;
+	U16 items = ( type == TYPE_ACTION ) ? 0u : var->vec_items;
+	int lim   = ( type <= TYPE_DOUBLE ) ? 1 : 0;
+	int vec   = is_vector( var );
+	VC_VALUE val[3];
+	STRBUF str;
+	char num[16];
+
+	if( json == 0 ) {
+		(void) vc_fmt_hex( num, hnd );
+		out_str( out, get_scpi( ctx, hnd ));
+		out_str( out, " (" );
+		out_str( out, num );
+		out_str( out, ") " );
+		out_str( out, type2str( type ));
+		out_str( out, " " );
+		out_str( out, storage2str( var->type ));
+		out_str( out, "\n" );
+
+		for( U16 c = 0; c < items; c++ ) {
+			dump_read( ctx, var, hnd, c, val, str );
+			(void) vc_fmt_s32( num, c );
+			out_str( out, "  " );
+			out_str( out, num );
+			out_str( out, ": " );
+			dump_value( ctx, out, hnd, &val[0], str, json );
+			if( lim != 0 ) {
+				out_str( out, " [" );
+				dump_num( out, type, var->fmt, &val[1], json );
+				out_str( out, ", " );
+				dump_num( out, type, var->fmt, &val[2], json );
+				out_str( out, "]" );
+			}
+			out_str( out, "\n" );
+		}
+		return;
+	}
+
+	(void) vc_fmt_s32( num, hnd );
+	out_str( out, "{\"hnd\":" );
+	out_str( out, num );
+	out_str( out, ",\"scpi\":" );
+	out_json_str( out, get_scpi( ctx, hnd ));
+	out_str( out, ",\"type\":\"" );
+	out_str( out, type2str( type ));
+	out_str( out, "\",\"storage\":\"" );
+	out_str( out, storage2str( var->type ));
+	out_str( out, "\"" );
+
+	/* value, min and max, each channel is read again for min and max */
+	for( int k = 0; ( items > 0u ) && ( k < (( lim != 0 ) ? 3 : 1 )); k++ ) {
+		static char const *const key[] = { ",\"value\":", ",\"min\":", ",\"max\":" };
+
+		out_str( out, key[k] );
+		if( vec != 0 ) {
+			out_str( out, "[" );
+		}
+		for( U16 c = 0; c < items; c++ ) {
+			dump_read( ctx, var, hnd, c, val, str );
+			if( c > 0u ) {
+				out_str( out, "," );
+			}
+			if( k == 0 ) {
+				dump_value( ctx, out, hnd, &val[0], str, json );
+			}
+			else {
+				dump_num( out, type, var->fmt, &val[k], json );
+			}
+		}
+		if( vec != 0 ) {
+			out_str( out, "]" );
+		}
+	}
+	out_str( out, "}" );
+}
+
+/*** vc_init ****************************************************************/
+/**
+ *   Initialize the default context, see vc_ctx_init().
+ *
+ *   The functions without a context parameter use the default context.
+ */
+ErrCode vc_init( VC_DATA const *vc ) {
+	return vc_ctx_init( &s_vc_ctx, vc );
+}
+
+/*** vc_reset ***************************************************************/
+/**
+ *   See vc_ctx_reset().
+ */
+ErrCode vc_reset( void ) {
+	return vc_ctx_reset( &s_vc_ctx );
+}
+
+/*** vc_reset_storage *******************************************************/
+/**
+ *   See vc_ctx_reset_storage().
+ */
+ErrCode vc_reset_storage( U16 storage ) {
+	return vc_ctx_reset_storage( &s_vc_ctx, storage );
+}
+
+/*** vc_get_access **********************************************************/
+/**
+ *   See vc_ctx_get_access().
+ */
+int vc_get_access( HND hnd, int chan ) {
+	return vc_ctx_get_access( &s_vc_ctx, hnd, chan );
+}
+
+/*** vc_get_datatype ********************************************************/
+/**
+ *   See vc_ctx_get_datatype().
+ */
+int vc_get_datatype( HND hnd ) {
+	return vc_ctx_get_datatype( &s_vc_ctx, hnd );
+}
+
+/*** vc_as_int16 ************************************************************/
+/**
+ *   See vc_ctx_as_int16().
+ */
+ErrCode vc_as_int16( HND hnd, int rdwr, S16 *val, U16 chan, U16 req ) {
+	return vc_ctx_as_int16( &s_vc_ctx, hnd, rdwr, val, chan, req );
+}
+
+/*** vc_as_int32 ************************************************************/
+/**
+ *   See vc_ctx_as_int32().
+ */
+ErrCode vc_as_int32( HND hnd, int rdwr, S32 *val, U16 chan, U16 req ) {
+	return vc_ctx_as_int32( &s_vc_ctx, hnd, rdwr, val, chan, req );
+}
+
+/*** vc_as_float ************************************************************/
+/**
+ *   See vc_ctx_as_float().
+ */
+ErrCode vc_as_float( HND hnd, int rdwr, F32 *val, U16 chan, U16 req ) {
+	return vc_ctx_as_float( &s_vc_ctx, hnd, rdwr, val, chan, req );
+}
+
+/*** vc_as_int8 *************************************************************/
+/**
+ *   See vc_ctx_as_int8().
+ */
+ErrCode vc_as_int8( HND hnd, int rdwr, S8 *val, U16 chan, U16 req ) {
+	return vc_ctx_as_int8( &s_vc_ctx, hnd, rdwr, val, chan, req );
+}
+
+/*** vc_as_int64 ************************************************************/
+/**
+ *   See vc_ctx_as_int64().
+ */
+ErrCode vc_as_int64( HND hnd, int rdwr, S64 *val, U16 chan, U16 req ) {
+	return vc_ctx_as_int64( &s_vc_ctx, hnd, rdwr, val, chan, req );
+}
+
+/*** vc_as_double ***********************************************************/
+/**
+ *   See vc_ctx_as_double().
+ */
+ErrCode vc_as_double( HND hnd, int rdwr, F64 *val, U16 chan, U16 req ) {
+	return vc_ctx_as_double( &s_vc_ctx, hnd, rdwr, val, chan, req );
+}
+
+/*** vc_read_vector **************************************************************/
+/**
+ *   See vc_ctx_read_vector().
+ */
+ErrCode vc_read_vector( HND hnd, U16 chan, U16 cnt, void *val, U16 req ) {
+	return vc_ctx_read_vector( &s_vc_ctx, hnd, chan, cnt, val, req );
+}
+
+/*** vc_write_vector *************************************************************/
+/**
+ *   See vc_ctx_write_vector().
+ */
+ErrCode vc_write_vector( HND hnd, U16 chan, U16 cnt, void *val, U16 req ) {
+	return vc_ctx_write_vector( &s_vc_ctx, hnd, chan, cnt, val, req );
+}
+
+/*** vc_as_string ***********************************************************/
+/**
+ *   See vc_ctx_as_string().
+ */
+ErrCode vc_as_string( HND hnd, int rdwr, char *val, U16 chan, U16 req ) {
+	return vc_ctx_as_string( &s_vc_ctx, hnd, rdwr, val, chan, req );
+}
+
+/*** vc_read_many ***********************************************************/
+/**
+ *   See vc_ctx_read_many().
+ */
+ErrCode vc_read_many( HND const *hnd, U16 const *chan, VC_VALUE *val, ErrCode *err, size_t n, U16 req ) {
+	return vc_ctx_read_many( &s_vc_ctx, hnd, chan, val, err, n, req );
+}
+
+/*** vc_write_many **********************************************************/
+/**
+ *   See vc_ctx_write_many().
+ */
+ErrCode vc_write_many( HND const *hnd, U16 const *chan, VC_VALUE *val, ErrCode *err, size_t n, U16 req ) {
+	return vc_ctx_write_many( &s_vc_ctx, hnd, chan, val, err, n, req );
+}
+
+/*** vc_txn_begin ***********************************************************/
+/**
+ *   See vc_ctx_txn_begin().
+ */
+ErrCode vc_txn_begin( VC_TXN *txn, U16 req ) {
+	return vc_ctx_txn_begin( &s_vc_ctx, txn, req );
+}
+
+#ifdef VC_HAS_ATOMIC
+/*** vc_atomic_load_s16 *****************************************************/
+/**
+ *   See vc_ctx_atomic_load_s16().
+ */
+ErrCode vc_atomic_load_s16( HND hnd, U16 chan, S16 *val, U16 req ) {
+	return vc_ctx_atomic_load_s16( &s_vc_ctx, hnd, chan, val, req );
+}
+
+/*** vc_atomic_load_s32 *****************************************************/
+/**
+ *   See vc_ctx_atomic_load_s32().
+ */
+ErrCode vc_atomic_load_s32( HND hnd, U16 chan, S32 *val, U16 req ) {
+	return vc_ctx_atomic_load_s32( &s_vc_ctx, hnd, chan, val, req );
+}
+
+/*** vc_atomic_load_f32 *****************************************************/
+/**
+ *   See vc_ctx_atomic_load_f32().
+ */
+ErrCode vc_atomic_load_f32( HND hnd, U16 chan, F32 *val, U16 req ) {
+	return vc_ctx_atomic_load_f32( &s_vc_ctx, hnd, chan, val, req );
+}
+
+/*** vc_atomic_store_s16 ****************************************************/
+/**
+ *   See vc_ctx_atomic_store_s16().
+ */
+ErrCode vc_atomic_store_s16( HND hnd, U16 chan, S16 *val, U16 req ) {
+	return vc_ctx_atomic_store_s16( &s_vc_ctx, hnd, chan, val, req );
+}
+
+/*** vc_atomic_store_s32 ****************************************************/
+/**
+ *   See vc_ctx_atomic_store_s32().
+ */
+ErrCode vc_atomic_store_s32( HND hnd, U16 chan, S32 *val, U16 req ) {
+	return vc_ctx_atomic_store_s32( &s_vc_ctx, hnd, chan, val, req );
+}
+
+/*** vc_atomic_store_f32 ****************************************************/
+/**
+ *   See vc_ctx_atomic_store_f32().
+ */
+ErrCode vc_atomic_store_f32( HND hnd, U16 chan, F32 *val, U16 req ) {
+	return vc_ctx_atomic_store_f32( &s_vc_ctx, hnd, chan, val, req );
+}
 
-						if( flag != 0 ) {
-							n = snprintf( &buf[len], bufsz - len, "]\n" );
-						}
-						else {
-							n = snprintf( &buf[len], bufsz - len, "\n" );
-						}
-						CHECK_LEN( buf, n, len, bufsz );
-						len += n;
-					}
-				}
-			}
-			break;
+/*** vc_atomic_fetch_add_s16 ************************************************/
+/**
+ *   See vc_ctx_atomic_fetch_add_s16().
+ */
+ErrCode vc_atomic_fetch_add_s16( HND hnd, U16 chan, S16 add, S16 *old, U16 req ) {
+	return vc_ctx_atomic_fetch_add_s16( &s_vc_ctx, hnd, chan, add, old, req );
+}
 
-			default:
-				LOG_UNH_CASE( type );
-				break;
-	}
+/*** vc_atomic_fetch_add_s32 ************************************************/
+/**
+ *   See vc_ctx_atomic_fetch_add_s32().
+ */
+ErrCode vc_atomic_fetch_add_s32( HND hnd, U16 chan, S32 add, S32 *old, U16 req ) {
+	return vc_ctx_atomic_fetch_add_s32( &s_vc_ctx, hnd, chan, add, old, req );
+}
 
-	n = add_sep( &buf[len], bufsz - len, '=', 50 );
-	CHECK_LEN( buf, n, len, bufsz );
-	len += n;
+/*** vc_atomic_fetch_add_f32 ************************************************/
+/**
+ *   See vc_ctx_atomic_fetch_add_f32().
+ */
+ErrCode vc_atomic_fetch_add_f32( HND hnd, U16 chan, F32 add, F32 *old, U16 req ) {
+	return vc_ctx_atomic_fetch_add_f32( &s_vc_ctx, hnd, chan, add, old, req );
+}
 
-	return len;
+/*** vc_atomic_cas_s16 ******************************************************/
+/**
+ *   See vc_ctx_atomic_cas_s16().
+ */
+ErrCode vc_atomic_cas_s16( HND hnd, U16 chan, S16 *expected, S16 desired, U16 req ) {
+	return vc_ctx_atomic_cas_s16( &s_vc_ctx, hnd, chan, expected, desired, req );
 }
 
-/*** vc_chk_vector **********************************************************/
+/*** vc_atomic_cas_s32 ******************************************************/
 /**
- *
- *
+ *   See vc_ctx_atomic_cas_s32().
  */
-static ErrCode vc_chk_vector( VAR_DESC const *var, U16 chan )
-{
-	int ret;
+ErrCode vc_atomic_cas_s32( HND hnd, U16 chan, S32 *expected, S32 desired, U16 req ) {
+	return vc_ctx_atomic_cas_s32( &s_vc_ctx, hnd, chan, expected, desired, req );
+}
 
-	ret = kErrNoVector;
-	if ( is_vector( var ) != 0 ) {
-		ret = kErrNone;
-		if(chan >= var->vec_items) {
-			ret = kErrInvalidChan;
-		}
-	}
-	return ret;
+/*** vc_atomic_cas_f32 ******************************************************/
+/**
+ *   See vc_ctx_atomic_cas_f32().
+ */
+ErrCode vc_atomic_cas_f32( HND hnd, U16 chan, F32 *expected, F32 desired, U16 req ) {
+	return vc_ctx_atomic_cas_f32( &s_vc_ctx, hnd, chan, expected, desired, req );
 }
+#endif
 
-/*** vc_init_s16 ************************************************************/
+/*** vc_subscribe ***********************************************************/
 /**
- *	 Copy data from the descriptor into the data location of \b var
- *
- *   @param var   Variable handle
- *
- *   @return kErrNone, when done.
+ *   See vc_ctx_subscribe().
  */
-static ErrCode init_s16( VAR_DESC const *var ) {
-	DATA_S16 const *descr = &s_vc_data->descr_s16[var->descr_idx];
-	DATA_S16       *data  = &s_vc_data->data_s16[var->data_idx];
+ErrCode vc_subscribe( HND hnd, U16 chan, VC_RING *ring, VC_NOTIFY cb, void *arg, int *id ) {
+	return vc_ctx_subscribe( &s_vc_ctx, hnd, chan, ring, cb, arg, id );
+}
 
-	(void) memcpy( data, descr, sizeof(DATA_S16) * var->vec_items );
-	return kErrNone;
+/*** vc_unsubscribe *********************************************************/
+/**
+ *   See vc_ctx_unsubscribe().
+ */
+ErrCode vc_unsubscribe( int id ) {
+	return vc_ctx_unsubscribe( &s_vc_ctx, id );
 }
 
-/*** vc_init_s32 **********************************************************/
+/*** vc_notify **************************************************************/
 /**
- *	 Copy data from the descriptor into the data location of \b var
- *
- *   @param var   Variable handle
- *
- *   @return kErrNone, when done.
+ *   See vc_ctx_notify().
  */
-static ErrCode init_s32( VAR_DESC const *var ) {
-	DATA_S32 const *descr = &s_vc_data->descr_s32[var->descr_idx];
-	DATA_S32       *data  = &s_vc_data->data_s32[var->data_idx];
+ErrCode vc_notify( HND hnd, U16 chan, VC_VALUE const *val, int changed ) {
+	return vc_ctx_notify( &s_vc_ctx, hnd, chan, val, changed );
+}
 
-	(void) memcpy( data, descr, sizeof(DATA_S32) * var->vec_items );
-	return kErrNone;
+/*** vc_bind **************************************************************/
+/**
+ *   See vc_ctx_bind().
+ */
+ErrCode vc_bind( HND hnd, VC_ACTION fn, void *arg ) {
+	return vc_ctx_bind( &s_vc_ctx, hnd, fn, arg );
 }
 
-/*** vc_init_f32 **********************************************************/
+/*** vc_invoke ************************************************************/
 /**
- *	 Copy data from the descriptor into the data location of \b var
- *
- *   @param var   Variable handle
- *
- *   @return kErrNone, when done.
+ *   See vc_ctx_invoke().
  */
-static ErrCode init_f32( VAR_DESC const *var ) {
-	DATA_F32 const *descr = &s_vc_data->descr_f32[var->descr_idx];
-	DATA_F32       *data  = &s_vc_data->data_f32[var->data_idx];
+ErrCode vc_invoke( HND hnd, U16 chan, U16 req ) {
+	return vc_ctx_invoke( &s_vc_ctx, hnd, chan, req );
+}
 
-	(void) memcpy( data, descr, sizeof(DATA_F32) * var->vec_items );
-	return kErrNone;
+/*** vc_set_clock *********************************************************/
+/**
+ *   See vc_ctx_set_clock().
+ */
+void vc_set_clock( VC_CLOCK clock, void *arg ) {
+	vc_ctx_set_clock( &s_vc_ctx, clock, arg );
 }
 
-/*** vc_init_f64 **********************************************************/
+/*** vc_history ***********************************************************/
 /**
- *	 Copy data from the descriptor into the data location of \b var
- *
- *   @param var   Variable handle
- *
- *   @return kErrNone, when done.
+ *   See vc_ctx_history().
  */
-static ErrCode init_f64( VAR_DESC const *var ) {
-	DATA_F64 const *descr = &s_vc_data->descr_f64[var->descr_idx];
-	DATA_F64       *data  = &s_vc_data->data_f64[var->data_idx];
+ErrCode vc_history( HND hnd, U16 chan, U16 tier, VC_HIST_CELL *cell, U32 n, U32 *got, U16 req ) {
+	return vc_ctx_history( &s_vc_ctx, hnd, chan, tier, cell, n, got, req );
+}
 
-	(void) memcpy( data, descr, sizeof(DATA_F64) * var->vec_items );
-	return kErrNone;
+/*** vc_stats_var *********************************************************/
+/**
+ *   See vc_ctx_stats_var().
+ */
+ErrCode vc_stats_var( HND hnd, VC_STATS *st ) {
+	return vc_ctx_stats_var( &s_vc_ctx, hnd, st );
 }
 
-/*** vc_init_enum **********************************************************/
+/*** vc_stats_reset *******************************************************/
 /**
- *	 Copy data from the descriptor into the data location of \b var
- *
- *   @param var   Variable handle
- *
- *   @return kErrNone, when done.
+ *   See vc_ctx_stats_reset().
  */
-static ErrCode init_enum( VAR_DESC const *var ) {
-	/* cppcheck-suppress [misra-c2012-11.3, misra-c2012-11.8] */
-	DESCR_ENUM const *descr = (DESCR_ENUM*)&s_vc_data->data_mbr[var->descr_idx];
-	S16              *data  = &s_vc_data->data_enum[var->data_idx];
-    
-	for( U16 i = 0; i < var->vec_items; i++ ) {
-		*data = descr->def_value;
-		data++;
-	}
-	return kErrNone;
+void vc_stats_reset( void ) {
+	vc_ctx_stats_reset( &s_vc_ctx );
 }
 
-/*** vc_init_string **********************************************************/
+/*** vc_stats_dump ********************************************************/
 /**
- *	 Copy data from the descriptor into the data location of \b var
- *
- *   @param var   Variable handle
- *
- *   @return kErrNone, when done.
+ *   See vc_ctx_stats_dump().
  */
-static int  init_string( VAR_DESC const *var ) {
-	DATA_STRING const *descr = &s_vc_data->data_const_str[var->descr_idx];
-	DATA_STRING       *data  = &s_vc_data->data_str[var->data_idx];
-	U16 flags = var->type & TYPE_FLAG;
+ErrCode vc_stats_dump( VC_WRITER wr, void *arg, int format ) {
+	return vc_ctx_stats_dump( &s_vc_ctx, wr, arg, format );
+}
 
-	if(( flags & TYPE_CONST ) != 0u ) {
-		return kErrNone;
-	}
-    
-	size_t len = strlen( descr );
-	U16 idx = 0;
-	for( U16 i = 0; i < var->vec_items; i++ ) {
-		(void) memcpy( &data[idx], descr, len );
-		idx += sizeof(STRBUF);
-	}
-	return kErrNone;
+/*** vc_get_min *************************************************************/
+/**
+ *   See vc_ctx_get_min().
+ */
+ErrCode vc_get_min( HND hnd, U8* val, U16 chan ) {
+	return vc_ctx_get_min( &s_vc_ctx, hnd, val, chan );
 }
 
-/*** vc_valid_enum ***************************************************/
+/*** vc_get_max *************************************************************/
 /**
- *	 Check if \b val is a valid enum member.
- *
- *   @param dscr   pointer to ENUM descriptor
- *   @param val    value
- *
- *   @return kErrNone when val is a member of the enum.
+ *   See vc_ctx_get_max().
  */
-static ErrCode valid_enum( DESCR_ENUM const *dscr, S16 val ) {
-	ErrCode E = kErrInvalidEnum;
+ErrCode vc_get_max( HND hnd, U8* val, U16 chan ) {
+	return vc_ctx_get_max( &s_vc_ctx, hnd, val, chan );
+}
 
-	for( U16 i = 0; i < dscr->cnt; i++ ) {
-		ENUM_MBR const *mbr = (ENUM_MBR const *)&dscr->mbr[i];
-		if( val == mbr->value ) {
-			return kErrNone;
-		}
-	}
+/*** vc_set_min *************************************************************/
+/**
+ *   See vc_ctx_set_min().
+ */
+ErrCode vc_set_min( HND hnd, U8* val, U16 chan ) {
+	return vc_ctx_set_min( &s_vc_ctx, hnd, val, chan );
+}
 
-	return E;
+/*** vc_set_max *************************************************************/
+/**
+ *   See vc_ctx_set_max().
+ */
+ErrCode vc_set_max( HND hnd, U8* val, U16 chan ) {
+	return vc_ctx_set_max( &s_vc_ctx, hnd, val, chan );
 }
 
-/*** vc_get_min_max **************************************************/
+/*** vc_get_format **********************************************************/
 /**
- *   Read minimum or maximum value of a variable of types:
- *      TYPE_INT16, TYPE_INT32, TYPE_F32.
- *
- *   @param hnd    Variable handle
- *   @param val    Pointer to value
- *   @param chan   Channel
- *   @param flag   Flag, {Bit 0: 0 -> minimum, 1 -> maximum,
- *                        Bit 1: 0 -> read, 1 -> write }
+ *   See vc_ctx_get_format().
  */
-static ErrCode rw_min_max( HND hnd, U8* val, U16 chan, U16 flag ) {
-	U16 type;
+ErrCode vc_get_format( HND hnd, U16 *fmt ) {
+	return vc_ctx_get_format( &s_vc_ctx, hnd, fmt );
+}
 
-  /* cppcheck-suppress misra-c2012-19.2 */
-	union {
-		/*U8   bytes[4];*/
-		S32  val_s32;
-    F32  val_f32;
-		/* cppcheck-suppress misra-c2012-19.2 */
-	} conv;
+/*** vc_get_storage *********************************************************/
+/**
+ *   See vc_ctx_get_storage().
+ */
+ErrCode vc_get_storage( HND hnd, U16 *store ) {
+	return vc_ctx_get_storage( &s_vc_ctx, hnd, store );
+}
 
-	DATA_S16 *data_s16;
-	DATA_S32 *data_s32;
-	DATA_F32 *data_f32;
+/*** vc_enum_symbol **************************************************************/
+/**
+ *   See vc_ctx_enum_symbol().
+ */
+ErrCode vc_enum_symbol( HND hnd, S16 val, char const **sym ) {
+	return vc_ctx_enum_symbol( &s_vc_ctx, hnd, val, sym );
+}
 
-	VAR_DESC const *var;
+/*** vc_enum_value ***************************************************************/
+/**
+ *   See vc_ctx_enum_value().
+ */
+ErrCode vc_enum_value( HND hnd, char const *sym, S16 *val ) {
+	return vc_ctx_enum_value( &s_vc_ctx, hnd, sym, val );
+}
 
-	int minmax = flag & 1u;
-	int wr     = (flag & 2u) >> 1u;
-	
-	assert( s_vc_data );
-	
-	if( hnd >= s_vc_data->var_cnt ) {
-		return kErrUnknownCmd;
-	}
+/*** vc_get_hnd *************************************************************/
+/**
+ *   See vc_ctx_get_hnd().
+ */
+HND vc_get_hnd( char const *scpi ) {
+	return vc_ctx_get_hnd( &s_vc_ctx, scpi );
+}
 
-	if( NULL == val ) {
-		return kErrInvalidArg;
-	}
+/*** vc_dump_var ************************************************************/
+/**
+ *   See vc_ctx_dump_var().
+ */
+int vc_dump_var( char *buf, int bufsz, HND hnd, U16 chan ) {
+	return vc_ctx_dump_var( &s_vc_ctx, buf, bufsz, hnd, chan );
+}
 
-	var = get_var( hnd );
-	type = var->type & TYPE_MASK;
+/*** vc_dump_all ************************************************************/
+/**
+ *   See vc_ctx_dump_all().
+ */
+ErrCode vc_dump_all( VC_WRITER wr, void *arg, int format, HND const *hnd, size_t n ) {
+	return vc_ctx_dump_all( &s_vc_ctx, wr, arg, format, hnd, n );
+}
 
-	if( chan > 0u ) {
-		ErrCode ret = vc_chk_vector( var, chan );
-		if( ret != kErrNone ) {
-			return ret;
-		}
-	}
-	
-	switch( type ) {
-		case TYPE_INT16:
-			data_s16 = &s_vc_data->data_s16[ var->data_idx + chan ];
-			if( wr != 0 ) {
-				S16 *p = (0 == minmax) ? &data_s16->min : &data_s16->max;
-				/* cppcheck-suppress misra-c2012-11.3 */
-				*p = *(S16*)val;
-			}
-			else {
-				/* cppcheck-suppress misra-c2012-11.3 */
-				*(S16*) val = (0 == minmax) ? data_s16->min : data_s16->max;
-			}
-			break;
+/*** vc_snapshot_size *******************************************************/
+/**
+ *   See vc_ctx_snapshot_size().
+ */
+size_t vc_snapshot_size( void ) {
+	return vc_ctx_snapshot_size( &s_vc_ctx );
+}
 
-		case TYPE_INT32:
-			data_s32 = &s_vc_data->data_s32[ var->data_idx + chan ];
-			if( wr != 0 ) {
-				S32 *p = (0 == minmax) ? &data_s32->min : &data_s32->max;
-				/* cppcheck-suppress misra-c2012-11.3 */
-				*p = *(S32*)val;
-			}
-			else {
-				/* cppcheck-suppress misra-c2012-11.3 */
-				*(S32*) val = (0 == minmax) ? data_s32->min : data_s32->max;
-			}
-			break;
+/*** vc_snapshot ************************************************************/
+/**
+ *   See vc_ctx_snapshot().
+ */
+ErrCode vc_snapshot( void *buf ) {
+	return vc_ctx_snapshot( &s_vc_ctx, buf );
+}
 
-		case TYPE_FLOAT:
-			data_f32 = &s_vc_data->data_f32[ var->data_idx + chan ];
-			if( wr != 0 ) {
-				F32 *p = (0 == minmax) ? &data_f32->min : &data_f32->max;
-				/* cppcheck-suppress misra-c2012-11.3 */
-				conv.val_s32 = *(S32 *)val;
-				*p = conv.val_f32;
-			}
-			else {
-				conv.val_f32 = (0 == minmax) ? data_f32->min : data_f32->max;
-				/* cppcheck-suppress misra-c2012-11.3 */
-				*(S32*) val = conv.val_s32;
-			}
-			break;
+/*** vc_restore *************************************************************/
+/**
+ *   See vc_ctx_restore().
+ */
+ErrCode vc_restore( void const *buf ) {
+	return vc_ctx_restore( &s_vc_ctx, buf );
+}
 
-		default:
-			return kErrInvalidType;
-	}
+/*** vc_is_dirty ************************************************************/
+/**
+ *   See vc_ctx_is_dirty().
+ */
+int vc_is_dirty( U16 storage ) {
+	return vc_ctx_is_dirty( &s_vc_ctx, storage );
+}
 
-	return kErrNone;
+/*** vc_flush ***************************************************************/
+/**
+ *   See vc_ctx_flush().
+ */
+ErrCode vc_flush( U16 storage, VC_BACKEND const *be ) {
+	return vc_ctx_flush( &s_vc_ctx, storage, be );
+}
+
+/*** vc_load ****************************************************************/
+/**
+ *   See vc_ctx_load().
+ */
+ErrCode vc_load( U16 storage, VC_BACKEND const *be ) {
+	return vc_ctx_load( &s_vc_ctx, storage, be );
 }
 
 /*______________________________________________________________________EOF_*/
@@ -39,8 +39,29 @@
 
 #include "errcode.h"
 
+#include <stddef.h>
 #include <stdint.h>
 
+#if ( defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)) || \
+    ( defined(__cplusplus) && (__cplusplus >= 201103L))
+# define VC_HAS_ATOMIC 1
+#endif
+
+#ifdef VC_THREAD_SAFE
+# ifndef VC_HAS_ATOMIC
+#  error "VC_THREAD_SAFE requires C11 atomics"
+# endif
+# ifdef __cplusplus
+#  include <atomic>
+# else
+#  include <stdatomic.h>
+# endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* constant definitions
 ----------------------------------------------------------------------------*/
 enum {
@@ -63,6 +84,7 @@ enum {
 
 	TYPE_VECTOR  = 0x1000u,
 	TYPE_CONST   = 0x2000u,
+	TYPE_DERIVED = 0x4000u,   /* computed from other variables, see VC_DERIVE */
 
 	RAM_VOLATILE = 0x0000u,
 	EEPROM       = 0x0100u,
@@ -115,12 +137,14 @@ enum {
 
 /* global defined data types
 ----------------------------------------------------------------------------*/
-typedef char            S8;
+typedef signed char     S8;
 typedef unsigned char   U8;
 typedef short           S16;
 typedef unsigned short  U16;
 typedef int             S32;
 typedef unsigned int    U32;
+typedef long long       S64;
+typedef unsigned long long U64;
 typedef float           F32;
 typedef double          F64;
 
@@ -130,6 +154,80 @@ typedef double          F64;
 
 #define HNON (U16)-1
 
+/* vc_subscribe(): all channels of a vector */
+#define VC_ALL_CHAN (U16)-1
+
+/* Number of subscriptions, see vc_subscribe() */
+#ifndef VC_MAX_SUB
+# define VC_MAX_SUB 8
+#endif
+
+/* Number of writes of a transaction, see vc_txn_begin() */
+#ifndef VC_TXN_MAX
+# define VC_TXN_MAX 32
+#endif
+
+/* Size of the output buffer of vc_dump_all() */
+#ifndef VC_DUMP_CHUNK
+# define VC_DUMP_CHUNK 256
+#endif
+
+/* Stack depth of the program of a derived variable, see VC_DRV_* */
+#ifndef VC_DRV_STACK
+# define VC_DRV_STACK 16
+#endif
+
+/* Channels of one vc_write_vector(), its bitmap of changed channels is on the stack */
+#ifndef VC_VEC_MAX
+# define VC_VEC_MAX 4096
+#endif
+
+/* Shards of the counters of VC_STATISTICS, a thread uses one of them */
+#ifndef VC_STATS_SHARDS
+# ifdef VC_THREAD_SAFE
+#  define VC_STATS_SHARDS 8
+# else
+#  define VC_STATS_SHARDS 1
+# endif
+#endif
+
+/* Buckets of a latency histogram, bucket i counts calls of less than 2^(i+1) ns */
+#define VC_STATS_BUCKETS 32
+
+/**
+ * Sequence counter of a variable.
+ *
+ * Only used when varcore is built with VC_THREAD_SAFE. A writer makes
+ * the counter odd while it changes the variable, readers retry
+ * when the counter was odd or has changed during the read.
+ */
+#if defined(VC_THREAD_SAFE) && defined(__cplusplus)
+typedef std::atomic_uint VC_SEQ;  /* layout of atomic_uint, see varcore.hpp */
+#elif defined(VC_THREAD_SAFE)
+typedef atomic_uint     VC_SEQ;
+#else
+typedef U32             VC_SEQ;
+#endif
+
+/**
+ * Word of the dirty bitmaps, see vc_flush().
+ *
+ * The table has one bitmap for EEPROM and one for FLASH variables,
+ * each with one bit per variable.
+ */
+typedef VC_SEQ          VC_DIRTY;
+
+#define VC_DIRTY_WORDS(var_cnt)  (2u * (((var_cnt) + 31u) / 32u))
+
+/* Counter of VC_STATISTICS, see vc_stats_var() */
+#if defined(VC_THREAD_SAFE) && defined(__cplusplus)
+typedef std::atomic_ullong VC_COUNT;
+#elif defined(VC_THREAD_SAFE)
+typedef atomic_ullong   VC_COUNT;
+#else
+typedef U64             VC_COUNT;
+#endif
+
 // HND needs to be unsigned!
 typedef U16             HND;
 typedef char            STRBUF[32];
@@ -139,6 +237,12 @@ typedef struct {
 	int        str_idx;   /* Index in string-Liste */
 } ENUM_DESC;
 
+typedef struct _DATA_S8 {
+	S8  def_value;
+	S8  min;
+	S8  max;
+} DATA_S8;
+
 typedef struct _DATA_S16 {
 	S16 def_value;
 	S16 min;
@@ -151,6 +255,12 @@ typedef struct _DATA_S32 {
 	S32 max;
 } DATA_S32;
 
+typedef struct _DATA_S64 {
+	S64 def_value;
+	S64 min;
+	S64 max;
+} DATA_S64;
+
 typedef struct _DATA_F32 {
 	F32 def_value;
 	F32 min;
@@ -163,7 +273,39 @@ typedef struct _DATA_F64 {
 	F64 max;
 } DATA_F64;
 
-typedef S8 DATA_STRING;
+/* current limits of a channel, the values are kept in a separate
+ * array, see VC_DATA */
+typedef struct _LIM_S8 {
+	S8  min;
+	S8  max;
+} LIM_S8;
+
+typedef struct _LIM_S16 {
+	S16 min;
+	S16 max;
+} LIM_S16;
+
+typedef struct _LIM_S32 {
+	S32 min;
+	S32 max;
+} LIM_S32;
+
+typedef struct _LIM_S64 {
+	S64 min;
+	S64 max;
+} LIM_S64;
+
+typedef struct _LIM_F32 {
+	F32 min;
+	F32 max;
+} LIM_F32;
+
+typedef struct _LIM_F64 {
+	F64 min;
+	F64 max;
+} LIM_F64;
+
+typedef char DATA_STRING;
 
 typedef struct _ENUM_MBR {
 	S16 hnd;
@@ -171,6 +313,21 @@ typedef struct _ENUM_MBR {
 	S16 symbol;
 } ENUM_MBR;
 
+/* An enum descriptor in g_enum_mbr is followed by its membership set:
+ *   S16 min, S16 span, (span+15)/16 words of a bitmap,
+ *   bit (value - min) is set for every member.
+ * varpp omits the bitmap (span 0) when the values span more than
+ * VC_ENUM_SET_MAX, the members are scanned then.
+ *
+ * The set is followed by the symbol index:
+ *   S16 slots, slots member indices (-1: empty).
+ * slots is a power of 2, a symbol starts at slot
+ * vc_hash_str( symbol, 0 ) & (slots-1), collisions use the next slot.
+ * ENUM_MBR.symbol is the index of the symbol in VC_DATA.enum_sym, -1
+ * if the member has no symbol.
+ */
+#define VC_ENUM_SET_MAX  4096
+
 typedef struct _DESCR_ENUM {
 	S16 def_value;
 	U16 cnt;
@@ -184,6 +341,129 @@ typedef struct _DESCR_ENUM {
 typedef S16 DATA_ENUM;
 typedef S16 DATA_ENUM_MBR;
 
+/* Operations of the program of a derived variable. The program
+ * works on a stack of doubles and ends with VC_DRV_END.
+ * VC_DRV_VAR is followed by a handle, the value of the same channel
+ * is pushed (channel 0 of a scalar). VC_DRV_CONST is followed by an
+ * index in VC_DATA.derive_const. */
+enum {
+	VC_DRV_END   = 0,
+	VC_DRV_VAR   = 1,
+	VC_DRV_CONST = 2,
+	VC_DRV_ADD   = 3,
+	VC_DRV_SUB   = 4,
+	VC_DRV_MUL   = 5,
+	VC_DRV_DIV   = 6,
+	VC_DRV_NEG   = 7
+};
+
+/**
+ * Derived variable, varpp creates one for each variable with an
+ * expression instead of a default value.
+ *
+ * code is the start of its program in VC_DATA.derive_code, stale the
+ * index of the flag of channel 0 in VC_DATA.stale. A write to an
+ * input sets the flags, a read recomputes the stale channels.
+ */
+typedef struct _VC_DERIVE {
+	HND         hnd;
+	U16         code;
+	U16         stale;
+} VC_DERIVE;
+
+/**
+ * Handler of a variable of TYPE_ACTION, see vc_bind() and vc_invoke().
+ * chan is 0 for a scalar action.
+ */
+typedef ErrCode (*VC_ACTION)( HND hnd, U16 chan, void *arg );
+
+/* Slot of the dispatch table, indexed by VAR_DESC.data_idx of the action */
+typedef struct _VC_ACTION_SLOT {
+	VC_ACTION   fn;
+	void       *arg;
+} VC_ACTION_SLOT;
+
+/**
+ * Cell of a history, see vc_history().
+ *
+ * In tier 0 a cell is one sample, min, max and mean are its value.
+ * In the other tiers a cell is one period, ts is its start.
+ * The values are F32, samples of INT64 and DOUBLE variables lose precision.
+ */
+typedef struct _VC_HIST_CELL {
+	U32         ts;
+	F32         min;
+	F32         max;
+	F32         mean;
+} VC_HIST_CELL;
+
+/* History of a variable, its tiers are hist_tier[tier ... tier+tier_cnt-1] */
+typedef struct _VC_HIST {
+	HND         hnd;
+	U16         tier;
+	U16         tier_cnt;
+} VC_HIST;
+
+/* Tier of a history: one ring of cnt cells per channel, period 0 for the samples */
+typedef struct _VC_HIST_TIER {
+	U32         period;
+	U32         cnt;
+	U32         cell;         /* cells of channel 0 in VC_DATA.hist_cell */
+	U32         ring;         /* ring of channel 0 in VC_DATA.hist_ring */
+} VC_HIST_TIER;
+
+/* State of the ring of one tier and channel */
+typedef struct _VC_HIST_RING {
+	VC_SEQ      lock;
+	U32         pos;          /* next cell */
+	U32         fill;         /* cells used */
+	U32         ts;           /* start of the open period, tier 0: samples */
+	U32         n;            /* samples in the open period */
+	F32         min;
+	F32         max;
+	F64         sum;
+} VC_HIST_RING;
+
+/* Access counters of a variable in one shard, see vc_stats_var() */
+typedef struct _VC_STATS_VAR {
+	VC_COUNT    reads;
+	VC_COUNT    writes;
+	VC_COUNT    errors;
+} VC_STATS_VAR;
+
+/**
+ * Access counters of a variable, the sum of all shards.
+ * A read or write is one call or one item of vc_read_many()
+ * and vc_write_many(), errors are the failed ones.
+ */
+typedef struct _VC_STATS {
+	U64         reads;
+	U64         writes;
+	U64         errors;
+} VC_STATS;
+
+/* API functions with a latency histogram, see vc_stats_latency() */
+enum {
+	VC_STAT_AS_INT16 = 0,
+	VC_STAT_AS_INT32,
+	VC_STAT_AS_FLOAT,
+	VC_STAT_AS_INT8,
+	VC_STAT_AS_INT64,
+	VC_STAT_AS_DOUBLE,
+	VC_STAT_AS_STRING,
+	VC_STAT_READ_VECTOR,
+	VC_STAT_WRITE_VECTOR,
+	VC_STAT_READ_MANY,
+	VC_STAT_WRITE_MANY,
+	VC_STAT_GET_HND,
+	VC_STAT_RESET,
+
+	VC_STAT_LAST
+};
+
+/* Clock of the histories, see vc_set_clock() */
+typedef U32 (*VC_CLOCK)( void *arg );
+
 
 
 typedef struct _VAR_DESC {
@@ -197,20 +477,80 @@ typedef struct _VAR_DESC {
 	U16         data_idx;
 } VAR_DESC;
 
+/**
+ * Value of one item in vc_read_many(), vc_write_many() and vc_txn_write().
+ * The member is selected by the type of the variable:
+ * s16 for TYPE_INT16 and TYPE_ENUM, s32 for TYPE_INT32, f32 for TYPE_FLOAT.
+ * s8, s64 and f64 are used by transactions and change events of
+ * TYPE_INT8, TYPE_INT64 and TYPE_DOUBLE only.
+ */
+typedef union _VC_VALUE {
+	S8  s8;
+	S16 s16;
+	S32 s32;
+	S64 s64;
+	F32 f32;
+	F64 f64;
+} VC_VALUE;
+
+/**
+ * Change event of a variable, see vc_subscribe().
+ *
+ * val holds the new value, it is 0 for TYPE_STRING.
+ */
+typedef struct _VC_EVENT {
+	HND      hnd;
+	U16      chan;
+	VC_VALUE val;
+} VC_EVENT;
+
+typedef struct _VC_RING_CELL {
+	VC_SEQ   seq;
+	VC_EVENT ev;
+} VC_RING_CELL;
+
+/**
+ * Bounded event ring of a subscriber.
+ *
+ * With VC_THREAD_SAFE the ring is lock-free, several writers may
+ * push and several readers may pop. Events are dropped and
+ * counted in lost when the ring is full.
+ */
+typedef struct _VC_RING {
+	VC_RING_CELL *cell;
+	U32           mask;
+	VC_SEQ        head;   /* next push */
+	VC_SEQ        tail;   /* next pop */
+	VC_SEQ        lost;
+} VC_RING;
+
+typedef void (*VC_NOTIFY)( VC_EVENT const *ev, void *arg );
+
+typedef struct _VC_SUB {
+	VC_SEQ     active;
+	HND        hnd;
+	U16        chan;
+	VC_RING   *ring;
+	VC_NOTIFY  cb;
+	void      *arg;
+} VC_SUB;
+
 typedef struct _VC_DATA {
 	VAR_DESC const   *vars;
-	HND const         var_cnt;
+	HND               var_cnt;
 
 	DATA_S16 const  *descr_s16;
 	HND              descr_s16_cnt;
 
-	DATA_S16        *data_s16;
+	S16             *data_s16;
+	LIM_S16         *lim_s16;
 	HND              data_s16_cnt;
 
 	DATA_S32 const  *descr_s32;
 	HND              descr_s32_cnt;
 
-	DATA_S32        *data_s32;
+	S32             *data_s32;
+	LIM_S32         *lim_s32;
 	HND              data_s32_cnt;
 
 	DATA_STRING    *data_str;
@@ -228,14 +568,83 @@ typedef struct _VC_DATA {
 	DATA_F32 const  *descr_f32;
 	HND              descr_f32_cnt;
 
-	DATA_F32        *data_f32;
+	F32             *data_f32;
+	LIM_F32         *lim_f32;
 	HND              data_f32_cnt;
 
 	DATA_F64 const  *descr_f64;
 	HND              descr_f64_cnt;
 
-	DATA_F64        *data_f64;
+	F64             *data_f64;
+	LIM_F64         *lim_f64;
 	HND              data_f64_cnt;
+
+	DATA_S8 const   *descr_s8;
+	HND              descr_s8_cnt;
+
+	S8              *data_s8;
+	LIM_S8          *lim_s8;
+	HND              data_s8_cnt;
+
+	DATA_S64 const  *descr_s64;
+	HND              descr_s64_cnt;
+
+	S64             *data_s64;
+	LIM_S64         *lim_s64;
+	HND              data_s64_cnt;
+
+	U16 const       *scpi_disp;       /* perfect hash of SCPI strings: displacements */
+	HND              scpi_disp_cnt;
+
+	HND const       *scpi_hash;       /* perfect hash of SCPI strings: handles */
+	HND              scpi_hash_cnt;
+
+	U32              scpi_seed;
+
+	VC_SEQ          *seq;             /* one per variable, VC_THREAD_SAFE only */
+
+	VC_DIRTY        *dirty;           /* VC_DIRTY_WORDS(var_cnt), see vc_flush() */
+
+	char const      *enum_sym;        /* zero terminated symbols of the enum members */
+	HND              enum_sym_cnt;
+
+	S16 const       *dflt_s16;        /* values after vc_init(), see vc_reset() */
+	S32 const       *dflt_s32;
+	F32 const       *dflt_f32;
+	F64 const       *dflt_f64;
+	S8 const        *dflt_s8;
+	S64 const       *dflt_s64;
+	S16 const       *dflt_enum;
+	DATA_STRING const *dflt_str;
+
+	LIM_S16 const   *dflt_lim_s16;    /* limits after vc_init() */
+	LIM_S32 const   *dflt_lim_s32;
+	LIM_F32 const   *dflt_lim_f32;
+	LIM_F64 const   *dflt_lim_f64;
+	LIM_S8 const    *dflt_lim_s8;
+	LIM_S64 const   *dflt_lim_s64;
+
+	VC_DERIVE const *derive;          /* derived variables, sorted by handle */
+	HND              derive_cnt;
+	U16 const       *derive_code;     /* programs of the derived variables */
+	F64 const       *derive_const;
+	U16 const       *derive_first;    /* var_cnt+1 entries, the derived variables depending */
+	U16 const       *derive_list;     /* on hnd are derive_list[derive_first[hnd] ... derive_first[hnd+1]-1] */
+	VC_SEQ          *stale;           /* one flag per channel of a derived variable */
+	HND              stale_cnt;
+
+	VC_ACTION_SLOT  *action;          /* handlers of the TYPE_ACTION variables, see vc_bind() */
+	HND              action_cnt;
+
+	VC_HIST const      *hist;         /* variables with a history, sorted by handle */
+	HND                 hist_cnt;
+	VC_HIST_TIER const *hist_tier;
+	VC_HIST_RING       *hist_ring;    /* one per tier and channel */
+	U32                 hist_ring_cnt;
+	VC_HIST_CELL       *hist_cell;
+	U32                 hist_cell_cnt;
+
+	VC_STATS_VAR    *stats;           /* VC_STATS_SHARDS * var_cnt, shared by all contexts, VC_STATISTICS only */
 #if 0
 	DATA_STRING *descr_str;
 	HND          descr_str_cnt;
@@ -246,15 +655,224 @@ typedef struct _VC_DATA {
 #endif
 } VC_DATA;
 
+/**
+ * Backend of the non-volatile storage, see vc_flush() and vc_load().
+ *
+ * The data of a variable is its part of a snapshot (see vc_snapshot()),
+ * offs is the position in the snapshot. A backend may use offs as
+ * address, the snapshot header is written with hnd HNON at offs 0.
+ * write and read return kErrNone when done, sync may be NULL.
+ */
+typedef struct _VC_BACKEND {
+	ErrCode (*write)( void *arg, HND hnd, U32 offs, void const *data, size_t size );
+	ErrCode (*read)( void *arg, HND hnd, U32 offs, void *data, size_t size );
+	ErrCode (*sync)( void *arg );
+	void     *arg;
+} VC_BACKEND;
+
+/* Output formats of vc_dump_all() */
+enum {
+	VC_DUMP_TEXT = 0,
+	VC_DUMP_JSON = 1
+};
+
+/**
+ * Writer of vc_dump_all(), gets the output in chunks of up to
+ * VC_DUMP_CHUNK characters. data isn't terminated with '\0'.
+ * A return value other than kErrNone stops the dump.
+ */
+typedef ErrCode (*VC_WRITER)( void *arg, char const *data, size_t len );
+
+/**
+ * Instance of a variable table.
+ *
+ * Several contexts can run in different threads, they don't share
+ * any state. The members are private, see vc_ctx_init().
+ * vc_init() and all functions without ctx use a default context.
+ */
+typedef struct _VC_CTX {
+	VC_DATA const *data;
+	VC_DATA        own;           /* data with own storage, see vc_ctx_init_storage() */
+	U32            layout;        /* hash of the table layout, see vc_ctx_snapshot() */
+
+	VC_SUB         sub[VC_MAX_SUB];
+	VC_SEQ         sub_cnt;
+
+	VC_CLOCK       clock;         /* timestamps of the histories */
+	void          *clock_arg;
+} VC_CTX;
+
+/**
+ * Staged write of a transaction.
+ */
+typedef struct _VC_TXN_ITEM {
+	HND         hnd;
+	U16         chan;
+	U16         changed;
+	VC_VALUE    val;
+} VC_TXN_ITEM;
+
+/**
+ * Transaction, see vc_txn_begin().
+ *
+ * The writes are staged in the transaction, sorted by handle and
+ * channel, and published by vc_txn_commit(). The members are private.
+ */
+typedef struct _VC_TXN {
+	VC_CTX        *ctx;
+	U16            req;
+	U16            cnt;
+	ErrCode        err;           /* first failed write */
+	HND            err_hnd;       /* its handle */
+	VC_TXN_ITEM    item[VC_TXN_MAX];
+} VC_TXN;
+
 /* list of global defined functions
 ----------------------------------------------------------------------------*/
+ErrCode vc_ctx_init( VC_CTX *ctx, VC_DATA const *vc );
+size_t  vc_ctx_storage_size( VC_DATA const *vc );
+ErrCode vc_ctx_init_storage( VC_CTX *ctx, VC_DATA const *vc, void *storage, size_t size );
+
+ErrCode vc_ctx_reset( VC_CTX *ctx );
+ErrCode vc_ctx_reset_storage( VC_CTX *ctx, U16 storage );
+
+int vc_ctx_get_access( VC_CTX *ctx, HND hnd, int chan );
+int vc_ctx_get_datatype( VC_CTX *ctx, HND hnd );
+
+ErrCode vc_ctx_as_int16( VC_CTX *ctx, HND hnd, int rdwr, S16 *val, U16 chan, U16 req );
+ErrCode vc_ctx_as_int32( VC_CTX *ctx, HND hnd, int rdwr, S32 *val, U16 chan, U16 req );
+ErrCode vc_ctx_as_float( VC_CTX *ctx, HND hnd, int rdwr, F32 *val, U16 chan, U16 req );
+ErrCode vc_ctx_as_int8( VC_CTX *ctx, HND hnd, int rdwr, S8 *val, U16 chan, U16 req );
+ErrCode vc_ctx_as_int64( VC_CTX *ctx, HND hnd, int rdwr, S64 *val, U16 chan, U16 req );
+ErrCode vc_ctx_as_double( VC_CTX *ctx, HND hnd, int rdwr, F64 *val, U16 chan, U16 req );
+ErrCode vc_ctx_as_string( VC_CTX *ctx, HND hnd, int rdwr, char *val, U16 chan, U16 req );
+
+ErrCode vc_ctx_read_vector( VC_CTX *ctx, HND hnd, U16 chan, U16 cnt, void *val, U16 req );
+ErrCode vc_ctx_write_vector( VC_CTX *ctx, HND hnd, U16 chan, U16 cnt, void *val, U16 req );
+
+ErrCode vc_ctx_read_many( VC_CTX *ctx, HND const *hnd, U16 const *chan, VC_VALUE *val, ErrCode *err, size_t n, U16 req );
+ErrCode vc_ctx_write_many( VC_CTX *ctx, HND const *hnd, U16 const *chan, VC_VALUE *val, ErrCode *err, size_t n, U16 req );
+
+ErrCode vc_ctx_txn_begin( VC_CTX *ctx, VC_TXN *txn, U16 req );
+ErrCode vc_txn_write( VC_TXN *txn, HND hnd, U16 chan, VC_VALUE const *val );
+ErrCode vc_txn_commit( VC_TXN *txn, HND *err_hnd );
+void    vc_txn_abort( VC_TXN *txn );
+
+/* Without VC_THREAD_SAFE don't mix the vc_atomic_* functions with the
+ * other accessors on one variable, with VC_THREAD_SAFE they lock: they use
+ * its seqlock and wait for or block its writers */
+#ifdef VC_HAS_ATOMIC
+ErrCode vc_ctx_atomic_load_s16( VC_CTX *ctx, HND hnd, U16 chan, S16 *val, U16 req );
+ErrCode vc_ctx_atomic_load_s32( VC_CTX *ctx, HND hnd, U16 chan, S32 *val, U16 req );
+ErrCode vc_ctx_atomic_load_f32( VC_CTX *ctx, HND hnd, U16 chan, F32 *val, U16 req );
+ErrCode vc_ctx_atomic_store_s16( VC_CTX *ctx, HND hnd, U16 chan, S16 *val, U16 req );
+ErrCode vc_ctx_atomic_store_s32( VC_CTX *ctx, HND hnd, U16 chan, S32 *val, U16 req );
+ErrCode vc_ctx_atomic_store_f32( VC_CTX *ctx, HND hnd, U16 chan, F32 *val, U16 req );
+ErrCode vc_ctx_atomic_fetch_add_s16( VC_CTX *ctx, HND hnd, U16 chan, S16 add, S16 *old, U16 req );
+ErrCode vc_ctx_atomic_fetch_add_s32( VC_CTX *ctx, HND hnd, U16 chan, S32 add, S32 *old, U16 req );
+ErrCode vc_ctx_atomic_fetch_add_f32( VC_CTX *ctx, HND hnd, U16 chan, F32 add, F32 *old, U16 req );
+ErrCode vc_ctx_atomic_cas_s16( VC_CTX *ctx, HND hnd, U16 chan, S16 *expected, S16 desired, U16 req );
+ErrCode vc_ctx_atomic_cas_s32( VC_CTX *ctx, HND hnd, U16 chan, S32 *expected, S32 desired, U16 req );
+ErrCode vc_ctx_atomic_cas_f32( VC_CTX *ctx, HND hnd, U16 chan, F32 *expected, F32 desired, U16 req );
+#endif
+
+ErrCode vc_ctx_subscribe( VC_CTX *ctx, HND hnd, U16 chan, VC_RING *ring, VC_NOTIFY cb, void *arg, int *id );
+ErrCode vc_ctx_unsubscribe( VC_CTX *ctx, int id );
+ErrCode vc_ctx_notify( VC_CTX *ctx, HND hnd, U16 chan, VC_VALUE const *val, int changed );
+
+ErrCode vc_ctx_bind( VC_CTX *ctx, HND hnd, VC_ACTION fn, void *arg );
+ErrCode vc_ctx_invoke( VC_CTX *ctx, HND hnd, U16 chan, U16 req );
+
+void    vc_ctx_set_clock( VC_CTX *ctx, VC_CLOCK clock, void *arg );
+ErrCode vc_ctx_history( VC_CTX *ctx, HND hnd, U16 chan, U16 tier, VC_HIST_CELL *cell, U32 n, U32 *got, U16 req );
+
+ErrCode vc_ctx_stats_var( VC_CTX *ctx, HND hnd, VC_STATS *st );
+void    vc_ctx_stats_reset( VC_CTX *ctx );
+ErrCode vc_ctx_stats_dump( VC_CTX *ctx, VC_WRITER wr, void *arg, int format );
+ErrCode vc_stats_latency( int fn, U64 *bucket );
+ErrCode vc_stats_type( int type, U64 *bucket );
+
+ErrCode vc_ctx_get_min( VC_CTX *ctx, HND hnd, U8* val, U16 chan );
+ErrCode vc_ctx_get_max( VC_CTX *ctx, HND hnd, U8* val, U16 chan );
+/* limits set at run time are in a snapshot, but vc_flush() doesn't persist them */
+ErrCode vc_ctx_set_min( VC_CTX *ctx, HND hnd, U8* val, U16 chan );
+ErrCode vc_ctx_set_max( VC_CTX *ctx, HND hnd, U8* val, U16 chan );
+
+ErrCode vc_ctx_get_format( VC_CTX *ctx, HND hnd, U16 *fmt );
+ErrCode vc_ctx_get_storage( VC_CTX *ctx, HND hnd, U16 *store );
+
+ErrCode vc_ctx_enum_symbol( VC_CTX *ctx, HND hnd, S16 val, char const **sym );
+ErrCode vc_ctx_enum_value( VC_CTX *ctx, HND hnd, char const *sym, S16 *val );
+
+HND vc_ctx_get_hnd( VC_CTX *ctx, char const *scpi );
+
+int vc_ctx_dump_var( VC_CTX *ctx, char *buf, int bufsz, HND hnd, U16 chan );
+ErrCode vc_ctx_dump_all( VC_CTX *ctx, VC_WRITER wr, void *arg, int format, HND const *hnd, size_t n );
+
+size_t  vc_ctx_snapshot_size( VC_CTX *ctx );
+ErrCode vc_ctx_snapshot( VC_CTX *ctx, void *buf );
+ErrCode vc_ctx_restore( VC_CTX *ctx, void const *buf );
+
+int     vc_ctx_is_dirty( VC_CTX *ctx, U16 storage );
+ErrCode vc_ctx_flush( VC_CTX *ctx, U16 storage, VC_BACKEND const *be );
+ErrCode vc_ctx_load( VC_CTX *ctx, U16 storage, VC_BACKEND const *be );
+
+/* default context */
 ErrCode vc_init( VC_DATA const* );
-ErrCode vc_reset();
+ErrCode vc_reset( void );
+ErrCode vc_reset_storage( U16 );
+int vc_get_access( HND hnd, int chan );
+int vc_get_datatype( HND hnd );
+
 ErrCode vc_as_int16( HND hnd, int rdwr, S16 *val, U16 chan, U16 req );
 ErrCode vc_as_int32( HND hnd, int rdwr, S32 *val, U16 chan, U16 req );
 ErrCode vc_as_float( HND hnd, int rdwr, F32 *val, U16 chan, U16 req );
+ErrCode vc_as_int8( HND hnd, int rdwr, S8 *val, U16 chan, U16 req );
+ErrCode vc_as_int64( HND hnd, int rdwr, S64 *val, U16 chan, U16 req );
+ErrCode vc_as_double( HND hnd, int rdwr, F64 *val, U16 chan, U16 req );
 ErrCode vc_as_string( HND hnd, int rdwr, char *val, U16 chan, U16 req );
 
+ErrCode vc_read_vector( HND hnd, U16 chan, U16 cnt, void *val, U16 req );
+ErrCode vc_write_vector( HND hnd, U16 chan, U16 cnt, void *val, U16 req );
+
+ErrCode vc_read_many( HND const *hnd, U16 const *chan, VC_VALUE *val, ErrCode *err, size_t n, U16 req );
+ErrCode vc_write_many( HND const *hnd, U16 const *chan, VC_VALUE *val, ErrCode *err, size_t n, U16 req );
+
+ErrCode vc_txn_begin( VC_TXN *txn, U16 req );
+
+#ifdef VC_HAS_ATOMIC
+ErrCode vc_atomic_load_s16( HND hnd, U16 chan, S16 *val, U16 req );
+ErrCode vc_atomic_load_s32( HND hnd, U16 chan, S32 *val, U16 req );
+ErrCode vc_atomic_load_f32( HND hnd, U16 chan, F32 *val, U16 req );
+ErrCode vc_atomic_store_s16( HND hnd, U16 chan, S16 *val, U16 req );
+ErrCode vc_atomic_store_s32( HND hnd, U16 chan, S32 *val, U16 req );
+ErrCode vc_atomic_store_f32( HND hnd, U16 chan, F32 *val, U16 req );
+ErrCode vc_atomic_fetch_add_s16( HND hnd, U16 chan, S16 add, S16 *old, U16 req );
+ErrCode vc_atomic_fetch_add_s32( HND hnd, U16 chan, S32 add, S32 *old, U16 req );
+ErrCode vc_atomic_fetch_add_f32( HND hnd, U16 chan, F32 add, F32 *old, U16 req );
+ErrCode vc_atomic_cas_s16( HND hnd, U16 chan, S16 *expected, S16 desired, U16 req );
+ErrCode vc_atomic_cas_s32( HND hnd, U16 chan, S32 *expected, S32 desired, U16 req );
+ErrCode vc_atomic_cas_f32( HND hnd, U16 chan, F32 *expected, F32 desired, U16 req );
+#endif
+
+ErrCode vc_ring_init( VC_RING *ring, VC_RING_CELL *cell, U32 cnt );
+ErrCode vc_ring_pop( VC_RING *ring, VC_EVENT *ev );
+U32     vc_ring_lost( VC_RING *ring );
+
+ErrCode vc_subscribe( HND hnd, U16 chan, VC_RING *ring, VC_NOTIFY cb, void *arg, int *id );
+ErrCode vc_unsubscribe( int id );
+ErrCode vc_notify( HND hnd, U16 chan, VC_VALUE const *val, int changed );
+
+ErrCode vc_bind( HND hnd, VC_ACTION fn, void *arg );
+ErrCode vc_invoke( HND hnd, U16 chan, U16 req );
+
+void    vc_set_clock( VC_CLOCK clock, void *arg );
+ErrCode vc_history( HND hnd, U16 chan, U16 tier, VC_HIST_CELL *cell, U32 n, U32 *got, U16 req );
+
+ErrCode vc_stats_var( HND hnd, VC_STATS *st );
+void    vc_stats_reset( void );
+ErrCode vc_stats_dump( VC_WRITER wr, void *arg, int format );
+
 ErrCode vc_get_min( HND, U8*, U16 );
 ErrCode vc_get_max( HND, U8*, U16 );
 ErrCode vc_set_min( HND, U8*, U16 );
@@ -263,6 +881,22 @@ ErrCode vc_set_max( HND, U8*, U16 );
 ErrCode vc_get_format( HND, U16* );
 ErrCode vc_get_storage( HND, U16* );
 
+ErrCode vc_enum_symbol( HND, S16, char const ** );
+ErrCode vc_enum_value( HND, char const *, S16* );
+
 HND vc_get_hnd( char const * );
 
 int vc_dump_var( char *, int, HND, U16 );
+ErrCode vc_dump_all( VC_WRITER wr, void *arg, int format, HND const *hnd, size_t n );
+
+size_t  vc_snapshot_size( void );
+ErrCode vc_snapshot( void *buf );
+ErrCode vc_restore( void const *buf );
+
+int     vc_is_dirty( U16 storage );
+ErrCode vc_flush( U16 storage, VC_BACKEND const *be );
+ErrCode vc_load( U16 storage, VC_BACKEND const *be );
+
+#ifdef __cplusplus
+}
+#endif
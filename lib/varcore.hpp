@@ -0,0 +1,273 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file   varcore.hpp
+ * \author rhae
+ *
+ * Header-only C++17 layer over the C functions of varcore.h.
+ *
+ * A variable is a constexpr object that knows its handle, value type,
+ * varcore type and number of channels, eg. vc::Var<F32, 8> for a float
+ * vector with 8 channels. varpp writes these objects to vardefs.hpp
+ * with #pragma cpp on. The object selects the matching vc_as_*()
+ * function at compile time, calls for the wrong type and vector calls
+ * for a type without vc_read_vector() don't compile. The methods are
+ * inline and only call the C function.
+ */
+
+#pragma once
+
+#include "varcore.h"
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if __cplusplus > 201703L && defined(__has_include)
+# if __has_include(<span>)
+#  include <span>
+# endif
+#endif
+
+namespace vc {
+
+#if defined(__cpp_lib_span)
+template<typename T> using span = std::span<T>;
+#else
+/**
+ * Contiguous values, the part of std::span (C++20) used by Var.
+ */
+template<typename T>
+class span {
+public:
+	constexpr span() noexcept : m_data( nullptr ), m_size( 0 ) {}
+	constexpr span( T *data, std::size_t size ) noexcept : m_data( data ), m_size( size ) {}
+
+	template<std::size_t M>
+	constexpr span( T (&arr)[M] ) noexcept : m_data( arr ), m_size( M ) {}
+
+	/* std::array, std::vector */
+	template<typename C, typename = std::enable_if_t<
+		std::is_convertible<decltype( std::declval<C&>().data() ), T*>::value>>
+	constexpr span( C &c ) noexcept : m_data( c.data() ), m_size( c.size() ) {}
+
+	constexpr T *data() const noexcept { return m_data; }
+	constexpr std::size_t size() const noexcept { return m_size; }
+	constexpr T *begin() const noexcept { return m_data; }
+	constexpr T *end() const noexcept { return m_data + m_size; }
+	constexpr T &operator[]( std::size_t i ) const noexcept { return m_data[i]; }
+
+private:
+	T           *m_data;
+	std::size_t  m_size;
+};
+#endif
+
+/**
+ * vc_as_*() of a value type and a varcore type. Other combinations
+ * have no traits and don't compile.
+ */
+template<typename T, U16 Type> struct traits;
+
+#define VC_TRAITS( T, TYPE, FN, VEC ) \
+	template<> struct traits<T, TYPE> { \
+		static constexpr bool vector = VEC; \
+		static ErrCode as( HND hnd, int rdwr, T *val, U16 chan, U16 req ) { \
+			return vc_as_##FN( hnd, rdwr, val, chan, req ); \
+		} \
+		static ErrCode as( VC_CTX *ctx, HND hnd, int rdwr, T *val, U16 chan, U16 req ) { \
+			return vc_ctx_as_##FN( ctx, hnd, rdwr, val, chan, req ); \
+		} \
+	}
+
+VC_TRAITS( S8,  TYPE_INT8,   int8,   false );
+VC_TRAITS( S16, TYPE_INT16,  int16,  true  );
+VC_TRAITS( S32, TYPE_INT32,  int32,  true  );
+VC_TRAITS( S64, TYPE_INT64,  int64,  false );
+VC_TRAITS( F32, TYPE_FLOAT,  float,  true  );
+VC_TRAITS( F64, TYPE_DOUBLE, double, false );
+VC_TRAITS( S16, TYPE_ENUM,   int16,  true  );
+
+#undef VC_TRAITS
+
+/* varcore type of a number type */
+template<typename T> struct type_of;
+template<> struct type_of<S8>  { static constexpr U16 value = TYPE_INT8; };
+template<> struct type_of<S16> { static constexpr U16 value = TYPE_INT16; };
+template<> struct type_of<S32> { static constexpr U16 value = TYPE_INT32; };
+template<> struct type_of<S64> { static constexpr U16 value = TYPE_INT64; };
+template<> struct type_of<F32> { static constexpr U16 value = TYPE_FLOAT; };
+template<> struct type_of<F64> { static constexpr U16 value = TYPE_DOUBLE; };
+
+/**
+ * Variable of a number type or TYPE_ENUM with N channels.
+ *
+ * read() and write() of a channel use vc_as_*(), the span overloads
+ * use vc_read_vector() and vc_write_vector(). Written values are
+ * clipped in place like with the C functions. A span with more than
+ * N values is rejected with kErrInvalidArg.
+ */
+template<typename T, U16 N = 1, U16 Type = type_of<T>::value>
+class Var {
+	static_assert( N > 0, "a variable has at least one channel" );
+	using Traits = traits<T, Type>;
+
+public:
+	using value_type = T;
+	static constexpr U16 type  = Type;
+	static constexpr U16 items = N;
+
+	constexpr explicit Var( HND hnd ) noexcept : m_hnd( hnd ) {}
+
+	constexpr HND hnd() const noexcept { return m_hnd; }
+	static constexpr U16 size() noexcept { return N; }
+
+	ErrCode read( T &val, U16 chan = 0, U16 req = REQ_PRG ) const {
+		return Traits::as( m_hnd, VarRead, &val, chan, req );
+	}
+
+	ErrCode write( T val, U16 chan = 0, U16 req = REQ_PRG ) const {
+		return Traits::as( m_hnd, VarWrite, &val, chan, req );
+	}
+
+	ErrCode read( VC_CTX &ctx, T &val, U16 chan = 0, U16 req = REQ_PRG ) const {
+		return Traits::as( &ctx, m_hnd, VarRead, &val, chan, req );
+	}
+
+	ErrCode write( VC_CTX &ctx, T val, U16 chan = 0, U16 req = REQ_PRG ) const {
+		return Traits::as( &ctx, m_hnd, VarWrite, &val, chan, req );
+	}
+
+	/* channel chan, 0 when the read fails */
+	T get( U16 chan = 0, U16 req = REQ_PRG ) const {
+		T val = T();
+		(void) read( val, chan, req );
+		return val;
+	}
+
+	ErrCode read( span<T> val, U16 chan = 0, U16 req = REQ_PRG ) const {
+		static_assert( Traits::vector, "vc_read_vector() supports int16, int32, float and enum" );
+		if( val.size() > N ) {
+			return kErrInvalidArg;
+		}
+		return vc_read_vector( m_hnd, chan, static_cast<U16>( val.size() ), val.data(), req );
+	}
+
+	ErrCode write( span<T> val, U16 chan = 0, U16 req = REQ_PRG ) const {
+		static_assert( Traits::vector, "vc_write_vector() supports int16, int32, float and enum" );
+		if( val.size() > N ) {
+			return kErrInvalidArg;
+		}
+		return vc_write_vector( m_hnd, chan, static_cast<U16>( val.size() ), val.data(), req );
+	}
+
+	ErrCode read( VC_CTX &ctx, span<T> val, U16 chan = 0, U16 req = REQ_PRG ) const {
+		static_assert( Traits::vector, "vc_read_vector() supports int16, int32, float and enum" );
+		if( val.size() > N ) {
+			return kErrInvalidArg;
+		}
+		return vc_ctx_read_vector( &ctx, m_hnd, chan, static_cast<U16>( val.size() ), val.data(), req );
+	}
+
+	ErrCode write( VC_CTX &ctx, span<T> val, U16 chan = 0, U16 req = REQ_PRG ) const {
+		static_assert( Traits::vector, "vc_write_vector() supports int16, int32, float and enum" );
+		if( val.size() > N ) {
+			return kErrInvalidArg;
+		}
+		return vc_ctx_write_vector( &ctx, m_hnd, chan, static_cast<U16>( val.size() ), val.data(), req );
+	}
+
+	ErrCode get_min( T &val, U16 chan = 0 ) const {
+		static_assert( Type != TYPE_ENUM, "enums have no limits" );
+		return vc_get_min( m_hnd, reinterpret_cast<U8*>( &val ), chan );
+	}
+
+	ErrCode get_max( T &val, U16 chan = 0 ) const {
+		static_assert( Type != TYPE_ENUM, "enums have no limits" );
+		return vc_get_max( m_hnd, reinterpret_cast<U8*>( &val ), chan );
+	}
+
+	ErrCode set_min( T val, U16 chan = 0 ) const {
+		static_assert( Type != TYPE_ENUM, "enums have no limits" );
+		return vc_set_min( m_hnd, reinterpret_cast<U8*>( &val ), chan );
+	}
+
+	ErrCode set_max( T val, U16 chan = 0 ) const {
+		static_assert( Type != TYPE_ENUM, "enums have no limits" );
+		return vc_set_max( m_hnd, reinterpret_cast<U8*>( &val ), chan );
+	}
+
+private:
+	HND m_hnd;
+};
+
+template<U16 N = 1>
+using Enum = Var<S16, N, TYPE_ENUM>;
+
+/**
+ * Variable of TYPE_STRING with N channels, Const for TYPE_CONST.
+ */
+template<U16 N = 1, bool Const = false>
+class Str {
+	static_assert( N > 0, "a variable has at least one channel" );
+
+public:
+	static constexpr U16 type  = TYPE_STRING;
+	static constexpr U16 items = N;
+
+	constexpr explicit Str( HND hnd ) noexcept : m_hnd( hnd ) {}
+
+	constexpr HND hnd() const noexcept { return m_hnd; }
+	static constexpr U16 size() noexcept { return N; }
+
+	ErrCode read( STRBUF &val, U16 chan = 0, U16 req = REQ_PRG ) const {
+		return vc_as_string( m_hnd, VarRead, val, chan, req );
+	}
+
+	ErrCode write( char const *val, U16 chan = 0, U16 req = REQ_PRG ) const {
+		static_assert( !Const, "the string is constant" );
+		STRBUF buf = {};
+		std::size_t len = std::strlen( val );
+
+		if( len >= sizeof(STRBUF) ) {
+			return kErrSizeTooBig;
+		}
+		std::memcpy( buf, val, len );
+		return vc_as_string( m_hnd, VarWrite, buf, chan, req );
+	}
+
+private:
+	HND m_hnd;
+};
+
+} /* namespace vc */
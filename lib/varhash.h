@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file   varhash.h
+ * \author rhae
+ *
+ * Hash functions shared by the variable preprocessor, which builds
+ * the perfect hash tables for the SCPI strings, and the varcore, which
+ * uses these tables to look up a handle.
+ *
+ * The perfect hash is a two level "hash and displace" scheme:
+ *   - The string is hashed once (FNV-1a, seeded).
+ *   - The hash selects a bucket, the bucket holds a displacement.
+ *   - The hash mixed with the displacement selects the slot.
+ *
+ * Both sides must use exactly these functions. Changing them
+ * requires to regenerate all vardef.inc files.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/* constant definitions
+----------------------------------------------------------------------------*/
+#define VC_HASH_FNV_BASIS  2166136261u
+#define VC_HASH_FNV_PRIME  16777619u
+
+/*** vc_hash_str ************************************************************/
+/**
+ *   Hash a zero terminated string (FNV-1a).
+ *
+ *   @param s      string
+ *   @param seed   seed, selected by varpp for a collision free hash
+ */
+static inline uint32_t vc_hash_str( char const *s, uint32_t seed ) {
+	uint32_t h = VC_HASH_FNV_BASIS ^ seed;
+
+	while( *s != '\0' ) {
+		h ^= (uint8_t) *s;
+		h *= VC_HASH_FNV_PRIME;
+		s++;
+	}
+	return h;
+}
+
+/*** vc_hash_u32 ************************************************************/
+/**
+ *   Add a 32 bit value to a hash (FNV-1a, little endian byte order).
+ *
+ *   @param h      hash, start with VC_HASH_FNV_BASIS
+ *   @param v      value
+ */
+static inline uint32_t vc_hash_u32( uint32_t h, uint32_t v ) {
+	for( int i = 0; i < 4; i++ ) {
+		h ^= (uint8_t)( v >> ( 8 * i ));
+		h *= VC_HASH_FNV_PRIME;
+	}
+	return h;
+}
+
+/*** vc_hash_mix ************************************************************/
+/**
+ *   Mix the string hash with a displacement (murmur3 finalizer).
+ *
+ *   @param h      string hash
+ *   @param disp   displacement of the bucket
+ */
+static inline uint32_t vc_hash_mix( uint32_t h, uint32_t disp ) {
+	h ^= disp * 0x9e3779b9u;
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+
+/*** vc_hash_slot ***********************************************************/
+/**
+ *   Compute the slot of a string in a perfect hash table.
+ *
+ *   The slot is only valid if the string is one of the keys the table
+ *   was built from. The caller has to compare the key stored in
+ *   the slot.
+ *
+ *   @param s          string
+ *   @param seed       seed of the table
+ *   @param disp       displacements
+ *   @param disp_cnt   number of displacements (buckets)
+ *   @param slot_cnt   number of slots
+ */
+static inline uint32_t vc_hash_slot( char const *s, uint32_t seed,
+                                     uint16_t const *disp, uint32_t disp_cnt,
+                                     uint32_t slot_cnt ) {
+	uint32_t h = vc_hash_str( s, seed );
+	uint32_t d = disp[ vc_hash_mix( h, 0 ) % disp_cnt ];
+
+	return vc_hash_mix( h, d + 1u ) % slot_cnt;
+}
+
+/*______________________________________________________________________EOF_*/
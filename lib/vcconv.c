@@ -0,0 +1,1043 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file   vcconv.c
+ * \author rhae
+ *
+ * Conversion of numbers to and from strings.
+ *
+ * The integers are converted two digits at a time. Floats with
+ * FMT_PREC_1 ... FMT_PREC_4 are scaled into an integer, which is exact
+ * in double precision. All other floats are written with the fewest
+ * digits that read back to the same float.
+ *
+ * The parsers accept the whole string only, a '.' is the decimal point
+ * in every locale. Floats are rounded correctly: the digits are scaled
+ * in double precision, only when the result is too close to the middle
+ * of two floats strtof() decides.
+ *
+ * Doubles use the same digit loop. A double is exact when the digits fit
+ * into 53 bits and the power of ten is exact, ie. up to 10^22; all other
+ * doubles are converted by strtod(), from a string without a decimal
+ * point. Written doubles are checked this way, so they read back to the
+ * same double.
+ *
+ * So the libc is still used on the slow paths: strtof() near a rounding
+ * tie and strtod() for inexact doubles. The string has no decimal point,
+ * so the locale doesn't matter, and errno is saved and restored around
+ * the call, so the parsers never change errno.
+ */
+
+/* local header */
+#include "vcconv.h"
+
+/* header of standard C - libraries */
+#include <errno.h>
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* constant definitions
+----------------------------------------------------------------------------*/
+/* fixed precision up to this value, beyond the number is written like FMT_SCI */
+#define FIXED_MAX    1e15
+
+/* significant digits of a float, that are kept exactly */
+#define PARSE_DIGITS 19
+
+/* digits of the string for strtof() */
+#define SLOW_DIGITS  40
+
+/* strtof() decides, when the double is this close to the middle of two floats */
+#define MID_ULPS     16u
+
+/* integers up to this value are exact in a double */
+#define EXACT_F64    ( (uint64_t) 1u << 53 )
+
+/* largest exact power of ten in a double */
+#define EXACT_POW10  22
+
+/* local defined data types
+----------------------------------------------------------------------------*/
+/* decimal number of vc_parse_f32() and vc_parse_f64(): digits * 10^exp */
+typedef struct _DEC_NUM {
+	char     digits[SLOW_DIGITS + 1];
+	int      cnt;        /* digits kept */
+	int      sticky;     /* dropped digits were not 0 */
+	int      exp;
+	int      neg;
+	uint64_t m;          /* the first PARSE_DIGITS digits */
+	int      m_cnt;      /* digits in m */
+} DEC_NUM;
+
+/* local defined variables
+----------------------------------------------------------------------------*/
+static char const s_digits2[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static char const s_hex[] = "0123456789abcdef";
+
+/* exact powers of ten */
+static double const s_pow10[] = {
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+	1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+	1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static U32 const s_pow10_u32[] = {
+	1u, 10u, 100u, 1000u, 10000u, 100000u,
+	1000000u, 10000000u, 100000000u, 1000000000u
+};
+
+static uint64_t const s_pow10_u64[] = {
+	1u, 10u, 100u, 1000u, 10000u, 100000u,
+	1000000u, 10000000u, 100000000u, 1000000000u,
+	10000000000u, 100000000000u, 1000000000000u, 10000000000000u,
+	100000000000000u, 1000000000000000u, 10000000000000000u,
+	100000000000000000u
+};
+
+/*** put_u64 ****************************************************************/
+/**
+ *   Write the decimal digits of n, without terminating zero.
+ *
+ *   @return number of characters.
+ */
+static int put_u64( char *buf, uint64_t n ) {
+	char tmp[20];
+	int  i = (int) sizeof(tmp);
+	int  len;
+
+	while( n >= 100u ) {
+		U32 r = (U32)( n % 100u );
+		n /= 100u;
+		i -= 2;
+		tmp[i]      = s_digits2[2u * r];
+		tmp[i + 1]  = s_digits2[2u * r + 1u];
+	}
+	if( n >= 10u ) {
+		i -= 2;
+		tmp[i]     = s_digits2[2u * n];
+		tmp[i + 1] = s_digits2[2u * n + 1u];
+	}
+	else {
+		i--;
+		tmp[i] = (char)( '0' + n );
+	}
+
+	len = (int) sizeof(tmp) - i;
+	(void) memcpy( buf, &tmp[i], (size_t) len );
+	return len;
+}
+
+/*** put_u64_width **********************************************************/
+/**
+ *   Write exactly width decimal digits of n, with leading zeros.
+ */
+static void put_u64_width( char *buf, uint64_t n, int width ) {
+	for( int i = width - 1; i >= 0; i-- ) {
+		buf[i] = (char)( '0' + ( n % 10u ));
+		n /= 10u;
+	}
+}
+
+/*** mul_pow10 **************************************************************/
+/**
+ *   x * 10^k
+ */
+static double mul_pow10( double x, int k ) {
+	int const max = (int)( sizeof(s_pow10) / sizeof(s_pow10[0]) ) - 1;
+
+	while( k > max ) {
+		x *= s_pow10[max];
+		k -= max;
+	}
+	while( k < -max ) {
+		x /= s_pow10[max];
+		k += max;
+	}
+	return ( k >= 0 ) ? ( x * s_pow10[k] ) : ( x / s_pow10[-k] );
+}
+
+/*** round_even *************************************************************/
+/**
+ *   Round a positive number to an integer, ties to even.
+ */
+static uint64_t round_even( double x ) {
+	uint64_t i = (uint64_t) x;
+	double   r = x - (double) i;
+
+	if(( r > 0.5 ) || (( r == 0.5 ) && (( i & 1u ) != 0u ))) {
+		i++;
+	}
+	return i;
+}
+
+/*** round_scaled *********************************************************/
+/**
+ *   x * s rounded half to even, like printf("%.*f"). The product is
+ *   split into n + err without error (Dekker), err decides the rounding.
+ *
+ *   @param x      Number, >= 0 and x * s < 2^52
+ *   @param s      Scale, a small power of ten
+ */
+static uint64_t round_scaled( double x, double s ) {
+	double   n  = x * s;
+	double   c  = 134217729.0 * x;
+	double   xh = c - ( c - x );
+	double   xl = x - xh;
+	double   err = (( xh * s - n ) + xl * s );
+	uint64_t i  = (uint64_t) n;
+	double   t  = (( n - (double) i ) - 0.5 ) + err;
+
+	if(( t > 0.0 ) || (( t == 0.0 ) && (( i & 1u ) != 0u ))) {
+		i++;
+	}
+	return i;
+}
+
+/*** shortest ***************************************************************/
+/**
+ *   Fewest decimal digits, that read back to the same float.
+ *
+ *   @param f      Number, finite and > 0
+ *   @param exp    Decimal exponent of the first digit
+ *   @param cnt    Number of digits
+ *
+ *   @return digits, the number is d.ddd * 10^exp
+ */
+static U32 shortest( F32 f, int *exp, int *cnt ) {
+	double x = f;
+	int    e = 0;
+	U32    d = 0;
+	U32    bits;
+
+	/* estimate of the exponent by the binary exponent, log10(2) ~ 77/256 */
+	(void) memcpy( &bits, &f, sizeof(bits));
+	e = ((int)(( bits >> 23 ) & 0xffu ) - 127 ) * 77 / 256;
+	while( x >= mul_pow10( 1.0, e + 1 )) {
+		e++;
+	}
+	while( x < mul_pow10( 1.0, e )) {
+		e--;
+	}
+
+	for( int p = 1; p <= 9; p++ ) {
+		int ed = e;
+
+		d = (U32) round_even( mul_pow10( x, p - 1 - e ));
+		if( d >= s_pow10_u32[p] ) {
+			/* 9.96 -> 10.0 */
+			d /= 10u;
+			ed++;
+		}
+		*exp = ed;
+		*cnt = p;
+		if(( F32 ) mul_pow10( (double) d, ed - ( p - 1 )) == f ) {
+			break;
+		}
+	}
+
+	while(( *cnt > 1 ) && (( d % 10u ) == 0u )) {
+		d /= 10u;
+		(*cnt)--;
+	}
+	return d;
+}
+
+/*** slow_str *************************************************************/
+/**
+ *   Write cnt digits and the exponent exp for strtof() or strtod():
+ *   "125e-3". The string has no decimal point, so the locale doesn't
+ *   matter.
+ *
+ *   @param buf    Buffer, at least cnt + 8 characters
+ */
+static void slow_str( char *buf, char const *digits, int cnt, int exp ) {
+	int len = cnt;
+
+	(void) memcpy( buf, digits, (size_t) cnt );
+	buf[len++] = 'e';
+	if( exp < 0 ) {
+		buf[len++] = '-';
+		exp = -exp;
+	}
+	len += put_u64( &buf[len], (uint64_t) exp );
+	buf[len] = '\0';
+}
+
+/*** parse_slow64 ***********************************************************/
+/**
+ *   Convert the digits with strtod(), errno is preserved.
+ */
+static F64 parse_slow64( char const *digits, int cnt, int exp ) {
+	char buf[SLOW_DIGITS + 16];
+	int  err = errno;
+	F64  d;
+
+	slow_str( buf, digits, cnt, exp );
+	d = strtod( buf, NULL );
+	errno = err;
+	return d;
+}
+
+/*** dec_to_f64 *************************************************************/
+/**
+ *   d * 10^k, correctly rounded.
+ */
+static F64 dec_to_f64( uint64_t d, int k ) {
+	char digits[20];
+	int  cnt = 1;
+
+	if(( d < EXACT_F64 ) && ( k >= -EXACT_POW10 ) && ( k <= EXACT_POW10 )) {
+		/* one rounding of exact operands */
+		return ( k >= 0 ) ? ( (double) d * s_pow10[k] ) : ( (double) d / s_pow10[-k] );
+	}
+
+	while(( cnt < (int)( sizeof(s_pow10_u64) / sizeof(s_pow10_u64[0]) )) && ( d >= s_pow10_u64[cnt] )) {
+		cnt++;
+	}
+	put_u64_width( digits, d, cnt );
+	return parse_slow64( digits, cnt, k );
+}
+
+/*** shortest64 *************************************************************/
+/**
+ *   Fewest decimal digits, that read back to the same double.
+ *   See shortest().
+ *
+ *   The scaling in double precision is not exact, so the 17 digits
+ *   are moved until they read back to x. Shorter candidates are
+ *   rounded from these digits. All candidates are checked with
+ *   dec_to_f64(), which is exact.
+ */
+static uint64_t shortest64( F64 x, int *exp, int *cnt ) {
+	int      e = 0;
+	uint64_t d;
+	uint64_t bits;
+
+	(void) memcpy( &bits, &x, sizeof(bits));
+	e = ((int)(( bits >> 52 ) & 0x7ffu ) - 1023 ) * 77 / 256;
+	while( x >= mul_pow10( 1.0, e + 1 )) {
+		e++;
+	}
+	while( x < mul_pow10( 1.0, e )) {
+		e--;
+	}
+
+	/* 17 digits identify every double */
+	d = round_even( mul_pow10( x, 16 - e ));
+	if( d >= s_pow10_u64[17] ) {
+		d /= 10u;
+		e++;
+	}
+	for( int i = 0; i < 64; i++ ) {
+		F64 y = dec_to_f64( d, e - 16 );
+
+		if( y == x ) {
+			break;
+		}
+		d = ( y < x ) ? ( d + 1u ) : ( d - 1u );
+	}
+	*exp = e;
+	*cnt = 17;
+
+	for( int p = 1; ( p < 17 ) && ( 17 == *cnt ); p++ ) {
+		uint64_t q = s_pow10_u64[17 - p];
+		uint64_t c = d / q + ((( d % q ) * 2u >= q ) ? 1u : 0u );
+
+		for( int k = 0; ( k < 3 ) && ( 17 == *cnt ); k++ ) {
+			uint64_t t = ( 0 == k ) ? c : (( 1 == k ) ? ( c - 1u ) : ( c + 1u ));
+
+			if(( t > 0u ) && ( dec_to_f64( t, e - ( p - 1 )) == x )) {
+				if( t >= s_pow10_u64[p] ) {
+					/* 9.96 -> 10.0 */
+					t /= 10u;
+					e++;
+				}
+				*exp = e;
+				*cnt = p;
+				d = t;
+			}
+		}
+	}
+
+	while(( *cnt > 1 ) && (( d % 10u ) == 0u )) {
+		d /= 10u;
+		(*cnt)--;
+	}
+	return d;
+}
+
+/*** put_sci ****************************************************************/
+/**
+ *   Write cnt digits d with exponent exp: "1.25e+03"
+ */
+static int put_sci( char *buf, uint64_t d, int cnt, int exp ) {
+	char digits[20] = { 0 };
+	int  len = 0;
+
+	put_u64_width( digits, d, cnt );
+	buf[len++] = digits[0];
+	if( cnt > 1 ) {
+		buf[len++] = '.';
+		(void) memcpy( &buf[len], &digits[1], (size_t)( cnt - 1 ));
+		len += cnt - 1;
+	}
+	buf[len++] = 'e';
+	buf[len++] = ( exp < 0 ) ? '-' : '+';
+	exp = ( exp < 0 ) ? -exp : exp;
+	if( exp < 10 ) {
+		buf[len++] = '0';
+	}
+	len += put_u64( &buf[len], (uint64_t) exp );
+	return len;
+}
+
+/*** put_plain **************************************************************/
+/**
+ *   Write cnt digits d with exponent exp without exponent: "1250", "0.0125"
+ */
+static int put_plain( char *buf, uint64_t d, int cnt, int exp ) {
+	char digits[20];
+	int  len = 0;
+
+	put_u64_width( digits, d, cnt );
+	if( exp < 0 ) {
+		buf[len++] = '0';
+		buf[len++] = '.';
+		for( int i = -1; i > exp; i-- ) {
+			buf[len++] = '0';
+		}
+		(void) memcpy( &buf[len], digits, (size_t) cnt );
+		len += cnt;
+	}
+	else if( cnt <= exp + 1 ) {
+		(void) memcpy( &buf[len], digits, (size_t) cnt );
+		len += cnt;
+		for( int i = cnt; i <= exp; i++ ) {
+			buf[len++] = '0';
+		}
+	}
+	else {
+		(void) memcpy( &buf[len], digits, (size_t)( exp + 1 ));
+		len += exp + 1;
+		buf[len++] = '.';
+		(void) memcpy( &buf[len], &digits[exp + 1], (size_t)( cnt - exp - 1 ));
+		len += cnt - exp - 1;
+	}
+	return len;
+}
+
+/*** vc_fmt_s32 *************************************************************/
+/**
+ *   Convert an integer to decimal, like "%d".
+ *
+ *   @param buf    Buffer, at least 12 characters
+ *   @param n      Number
+ *
+ *   @return length of the string.
+ */
+int vc_fmt_s32( char *buf, S32 n ) {
+	int len = 0;
+	U32 u   = (U32) n;
+
+	if( n < 0 ) {
+		buf[len++] = '-';
+		u = 0u - u;
+	}
+	len += put_u64( &buf[len], u );
+	buf[len] = '\0';
+	return len;
+}
+
+/*** vc_fmt_s64 *************************************************************/
+/**
+ *   Convert an integer to decimal, like "%lld".
+ *
+ *   @param buf    Buffer, at least 21 characters
+ *   @param n      Number
+ *
+ *   @return length of the string.
+ */
+int vc_fmt_s64( char *buf, S64 n ) {
+	int      len = 0;
+	uint64_t u   = (uint64_t) n;
+
+	if( n < 0 ) {
+		buf[len++] = '-';
+		u = 0u - u;
+	}
+	len += put_u64( &buf[len], u );
+	buf[len] = '\0';
+	return len;
+}
+
+/*** vc_fmt_hex *************************************************************/
+/**
+ *   Convert an integer to hex, like "%#x": "0", "0x1f".
+ *
+ *   @param buf    Buffer, at least 11 characters
+ *   @param n      Number
+ *
+ *   @return length of the string.
+ */
+int vc_fmt_hex( char *buf, U32 n ) {
+	int len = 0;
+	int shift = 28;
+
+	if( 0u == n ) {
+		buf[len++] = '0';
+	}
+	else {
+		buf[len++] = '0';
+		buf[len++] = 'x';
+		while(( n >> shift ) == 0u ) {
+			shift -= 4;
+		}
+		for( ; shift >= 0; shift -= 4 ) {
+			buf[len++] = s_hex[( n >> shift ) & 0xfu];
+		}
+	}
+	buf[len] = '\0';
+	return len;
+}
+
+/*** vc_fmt_f32 *************************************************************/
+/**
+ *   Convert a float to a string.
+ *
+ *   - FMT_PREC_1 ... FMT_PREC_4: fixed number of decimals, like "%.*f".
+ *     Numbers above 1e15 are written like FMT_SCI.
+ *   - FMT_SCI: exponent, eg. "1.5e+03".
+ *   - otherwise: without exponent for 1e-5 <= |f| < 1e9, eg. "0.1".
+ *
+ *   Without a fixed precision the number has the fewest digits that
+ *   read back to the same float.
+ *
+ *   @param buf    Buffer, at least sizeof(STRBUF)
+ *   @param f      Number
+ *   @param fmt    Format of the variable
+ *
+ *   @return length of the string.
+ */
+int vc_fmt_f32( char *buf, F32 f, U16 fmt ) {
+	U32    bits;
+	int    len = 0;
+	double x;
+
+	(void) memcpy( &bits, &f, sizeof(bits));
+	if(( bits & 0x80000000u ) != 0u ) {
+		buf[len++] = '-';
+		bits &= 0x7fffffffu;
+		(void) memcpy( &f, &bits, sizeof(f));
+	}
+	x = f;
+
+	if( bits >= 0x7f800000u ) {
+		(void) memcpy( &buf[len], ( bits > 0x7f800000u ) ? "nan" : "inf", 4u );
+		return len + 3;
+	}
+
+	if(( fmt >= FMT_PREC_1 ) && ( fmt <= FMT_PREC_4 ) && ( x < FIXED_MAX )) {
+		/* exact: 24 bit mantissa * 10^4 fits into a double */
+		uint64_t n = round_even( x * s_pow10[fmt] );
+
+		len += put_u64( &buf[len], n / s_pow10_u32[fmt] );
+		buf[len++] = '.';
+		put_u64_width( &buf[len], (U32)( n % s_pow10_u32[fmt] ), fmt );
+		len += fmt;
+	}
+	else if( 0u == bits ) {
+		buf[len++] = '0';
+	}
+	else {
+		int exp;
+		int cnt;
+		U32 d = shortest( f, &exp, &cnt );
+
+		if(( fmt != FMT_SCI ) && ( exp >= -5 ) && ( exp < 9 )) {
+			len += put_plain( &buf[len], d, cnt, exp );
+		}
+		else {
+			len += put_sci( &buf[len], d, cnt, exp );
+		}
+	}
+
+	buf[len] = '\0';
+	return len;
+}
+
+/*** vc_fmt_f64 *************************************************************/
+/**
+ *   Convert a double to a string, see vc_fmt_f32().
+ *
+ *   A fixed precision is used up to 1e11, where the scaled number
+ *   still fits the mantissa.
+ *
+ *   @param buf    Buffer, at least sizeof(STRBUF)
+ *   @param f      Number
+ *   @param fmt    Format of the variable
+ *
+ *   @return length of the string.
+ */
+int vc_fmt_f64( char *buf, F64 f, U16 fmt ) {
+	uint64_t bits;
+	int      len = 0;
+
+	(void) memcpy( &bits, &f, sizeof(bits));
+	if(( bits >> 63 ) != 0u ) {
+		buf[len++] = '-';
+		bits &= ~( (uint64_t) 1u << 63 );
+		(void) memcpy( &f, &bits, sizeof(f));
+	}
+
+	if( bits >= ( (uint64_t) 0x7ffu << 52 )) {
+		(void) memcpy( &buf[len], ( bits > ( (uint64_t) 0x7ffu << 52 )) ? "nan" : "inf", 4u );
+		return len + 3;
+	}
+
+	if(( fmt >= FMT_PREC_1 ) && ( fmt <= FMT_PREC_4 ) && ( f < 1e11 )) {
+		uint64_t n = round_scaled( f, s_pow10[fmt] );
+
+		len += put_u64( &buf[len], n / s_pow10_u32[fmt] );
+		buf[len++] = '.';
+		put_u64_width( &buf[len], n % s_pow10_u32[fmt], fmt );
+		len += fmt;
+	}
+	else if( 0u == bits ) {
+		buf[len++] = '0';
+	}
+	else {
+		int      exp;
+		int      cnt;
+		uint64_t d = shortest64( f, &exp, &cnt );
+
+		if(( fmt != FMT_SCI ) && ( exp >= -5 ) && ( exp < 9 )) {
+			len += put_plain( &buf[len], d, cnt, exp );
+		}
+		else {
+			len += put_sci( &buf[len], d, cnt, exp );
+		}
+	}
+
+	buf[len] = '\0';
+	return len;
+}
+
+/*** is_space ***************************************************************/
+/**
+ *   White space like isspace() in the "C" locale.
+ */
+static inline int is_space( char c ) {
+	return ( ' ' == c ) || (( c >= '\t' ) && ( c <= '\r' ));
+}
+
+/*** digit_val **************************************************************/
+/**
+ *   Value of a digit in base 8, 10 or 16.
+ *
+ *   @return base or more, when c is no digit.
+ */
+static inline U32 digit_val( char c ) {
+	U32 d = 99u;
+
+	if(( c >= '0' ) && ( c <= '9' )) {
+		d = (U32)( c - '0' );
+	}
+	else if(( c >= 'a' ) && ( c <= 'f' )) {
+		d = (U32)( c - 'a' ) + 10u;
+	}
+	else if(( c >= 'A' ) && ( c <= 'F' )) {
+		d = (U32)( c - 'A' ) + 10u;
+	}
+	else {
+		; /* misra-c2012-15.7 */
+	}
+	return d;
+}
+
+/*** vc_parse_s32 ***********************************************************/
+/**
+ *   Convert a string to an integer, like strtol( s, &end, 0 ).
+ *
+ *   Leading white space, a sign and the prefixes "0x" (hex) and "0"
+ *   (octal) are accepted. Hex and octal numbers may use all 32 bits,
+ *   eg. "0xffffffff" is -1.
+ *
+ *   @param s      String
+ *   @param n      Number
+ *
+ *   @return kErrInvalidValue, when the string isn't a number or the
+ *           number doesn't fit.
+ */
+ErrCode vc_parse_s32( char const *s, S32 *n ) {
+	int      neg  = 0;
+	U32      base = 10u;
+	uint64_t u    = 0;
+	uint64_t max;
+	char const *p;
+
+	while( is_space( *s ) != 0 ) {
+		s++;
+	}
+	if(( '-' == *s ) || ( '+' == *s )) {
+		neg = ( '-' == *s ) ? 1 : 0;
+		s++;
+	}
+	if( '0' == s[0] ) {
+		if((( 'x' == s[1] ) || ( 'X' == s[1] )) && ( digit_val( s[2] ) < 16u )) {
+			base = 16u;
+			s += 2;
+		}
+		else {
+			base = 8u;
+		}
+	}
+
+	p = s;
+	while( digit_val( *p ) < base ) {
+		u = u * base + digit_val( *p );
+		if( u > 0xffffffffu ) {
+			return kErrInvalidValue;
+		}
+		p++;
+	}
+	if(( p == s ) || ( *p != '\0' )) {
+		return kErrInvalidValue;
+	}
+
+	if( 10u == base ) {
+		max = ( neg != 0 ) ? 0x80000000u : 0x7fffffffu;
+	}
+	else {
+		max = 0xffffffffu;
+	}
+	if( u > max ) {
+		return kErrInvalidValue;
+	}
+
+	*n = (S32)( U32 ) u;
+	if( neg != 0 ) {
+		*n = (S32)( 0u - ( U32 ) u );
+	}
+	return kErrNone;
+}
+
+/*** vc_parse_s64 ***********************************************************/
+/**
+ *   Convert a string to an integer, like strtoll( s, &end, 0 ).
+ *   See vc_parse_s32(), hex and octal numbers may use all 64 bits.
+ *
+ *   @param s      String
+ *   @param n      Number
+ *
+ *   @return kErrInvalidValue, when the string isn't a number or the
+ *           number doesn't fit.
+ */
+ErrCode vc_parse_s64( char const *s, S64 *n ) {
+	int      neg  = 0;
+	U32      base = 10u;
+	uint64_t u    = 0;
+	uint64_t max;
+	char const *p;
+
+	while( is_space( *s ) != 0 ) {
+		s++;
+	}
+	if(( '-' == *s ) || ( '+' == *s )) {
+		neg = ( '-' == *s ) ? 1 : 0;
+		s++;
+	}
+	if( '0' == s[0] ) {
+		if((( 'x' == s[1] ) || ( 'X' == s[1] )) && ( digit_val( s[2] ) < 16u )) {
+			base = 16u;
+			s += 2;
+		}
+		else {
+			base = 8u;
+		}
+	}
+
+	p = s;
+	while( digit_val( *p ) < base ) {
+		U32 d = digit_val( *p );
+
+		if( u > ( UINT64_MAX - d ) / base ) {
+			return kErrInvalidValue;
+		}
+		u = u * base + d;
+		p++;
+	}
+	if(( p == s ) || ( *p != '\0' )) {
+		return kErrInvalidValue;
+	}
+
+	if( 10u == base ) {
+		max = ( neg != 0 ) ? ( (uint64_t) 1u << 63 ) : ((( (uint64_t) 1u << 63 )) - 1u );
+	}
+	else {
+		max = UINT64_MAX;
+	}
+	if( u > max ) {
+		return kErrInvalidValue;
+	}
+
+	if( neg != 0 ) {
+		u = 0u - u;
+	}
+	*n = (S64) u;
+	return kErrNone;
+}
+
+/*** parse_slow *************************************************************/
+/**
+ *   Convert the digits with strtof(), errno is preserved.
+ */
+static F32 parse_slow( char const *digits, int cnt, int exp ) {
+	char buf[SLOW_DIGITS + 16];
+	int  err = errno;
+	F32  f;
+
+	slow_str( buf, digits, cnt, exp );
+	f = strtof( buf, NULL );
+	errno = err;
+	return f;
+}
+
+/*** scan_dec ***************************************************************/
+/**
+ *   Read the decimal number of vc_parse_f32() and vc_parse_f64().
+ *
+ *   @param s      String
+ *   @param n      Number
+ *
+ *   @return kErrInvalidValue, when the string isn't a number.
+ */
+static ErrCode scan_dec( char const *s, DEC_NUM *n ) {
+	int any = 0;      /* seen a digit */
+
+	(void) memset( n, 0, sizeof(*n));
+
+	while( is_space( *s ) != 0 ) {
+		s++;
+	}
+	if(( '-' == *s ) || ( '+' == *s )) {
+		n->neg = ( '-' == *s ) ? 1 : 0;
+		s++;
+	}
+
+	for( int dot = 0; ; s++ ) {
+		if(( '.' == *s ) && ( 0 == dot )) {
+			dot = 1;
+			continue;
+		}
+		if(( *s < '0' ) || ( *s > '9' )) {
+			break;
+		}
+
+		any = 1;
+		if(( 0 == n->cnt ) && ( '0' == *s )) {
+			/* leading zero */
+			n->exp -= dot;
+			continue;
+		}
+		if( n->cnt < SLOW_DIGITS ) {
+			n->digits[n->cnt++] = *s;
+			n->exp -= dot;
+		}
+		else {
+			n->sticky |= ( *s != '0' ) ? 1 : 0;
+			n->exp += 1 - dot;
+		}
+		if( n->m_cnt < PARSE_DIGITS ) {
+			n->m = n->m * 10u + (uint64_t)( *s - '0' );
+			n->m_cnt++;
+		}
+	}
+	if( 0 == any ) {
+		return kErrInvalidValue;
+	}
+
+	if(( 'e' == *s ) || ( 'E' == *s )) {
+		int eneg = 0;
+		int e    = 0;
+
+		s++;
+		if(( '-' == *s ) || ( '+' == *s )) {
+			eneg = ( '-' == *s ) ? 1 : 0;
+			s++;
+		}
+		if(( *s < '0' ) || ( *s > '9' )) {
+			return kErrInvalidValue;
+		}
+		while(( *s >= '0' ) && ( *s <= '9' )) {
+			e = ( e < 10000 ) ? ( e * 10 + ( *s - '0' )) : e;
+			s++;
+		}
+		n->exp += ( eneg != 0 ) ? -e : e;
+	}
+	if( *s != '\0' ) {
+		return kErrInvalidValue;
+	}
+	return kErrNone;
+}
+
+/*** vc_parse_f32 ***********************************************************/
+/**
+ *   Convert a string to a float, like strtof() in the "C" locale.
+ *
+ *   Accepted are leading white space, a sign, digits with an optional
+ *   '.' and an optional exponent, eg. "-1.5e3". inf, nan and hex
+ *   floats are not accepted.
+ *
+ *   @param s      String
+ *   @param f      Number
+ *
+ *   @return kErrInvalidValue, when the string isn't a number or the
+ *           number is out of the range of a float.
+ */
+ErrCode vc_parse_f32( char const *s, F32 *f ) {
+	DEC_NUM  n;
+	double   d;
+	uint64_t bits;
+	U32      low;
+	F32      r;
+
+	if( scan_dec( s, &n ) != kErrNone ) {
+		return kErrInvalidValue;
+	}
+
+	if( 0u == n.m ) {
+		r = 0.0f;
+	}
+	else {
+		/* number = m * 10^(exp + cnt - m_cnt) */
+		int e10 = n.exp + n.cnt - n.m_cnt;
+
+		if(( e10 + n.m_cnt ) > ( FLT_MAX_10_EXP + 1 )) {
+			return kErrInvalidValue;
+		}
+		if(( e10 + n.m_cnt ) < ( FLT_MIN_10_EXP - 1 )) {
+			return kErrInvalidValue;
+		}
+
+		d = mul_pow10( (double) n.m, e10 );
+		r = (F32) d;
+
+		/* The lower 29 bits of the double are rounded away. Close to
+		   the middle of two floats the error of d may select the
+		   wrong one. */
+		(void) memcpy( &bits, &d, sizeof(bits));
+		low = (U32)( bits & 0x1fffffffu );
+		if(( low >= ( 0x10000000u - MID_ULPS )) && ( low <= ( 0x10000000u + MID_ULPS ))) {
+			if( n.sticky != 0 ) {
+				/* the dropped digits decide a tie */
+				n.digits[n.cnt++] = '1';
+				n.exp--;
+			}
+			r = parse_slow( n.digits, n.cnt, n.exp );
+		}
+
+		if(( r > FLT_MAX ) || ( r < FLT_MIN )) {
+			return kErrInvalidValue;
+		}
+	}
+
+	*f = ( n.neg != 0 ) ? -r : r;
+	return kErrNone;
+}
+
+/*** vc_parse_f64 ***********************************************************/
+/**
+ *   Convert a string to a double, like strtod() in the "C" locale.
+ *   See vc_parse_f32().
+ *
+ *   @param s      String
+ *   @param f      Number
+ *
+ *   @return kErrInvalidValue, when the string isn't a number or the
+ *           number is out of the range of a double.
+ */
+ErrCode vc_parse_f64( char const *s, F64 *f ) {
+	DEC_NUM n;
+	F64     r;
+
+	if( scan_dec( s, &n ) != kErrNone ) {
+		return kErrInvalidValue;
+	}
+
+	if( 0u == n.m ) {
+		r = 0.0;
+	}
+	else {
+		int e10 = n.exp + n.cnt - n.m_cnt;
+
+		if(( e10 + n.m_cnt ) > ( DBL_MAX_10_EXP + 1 )) {
+			return kErrInvalidValue;
+		}
+		if(( e10 + n.m_cnt ) < ( DBL_MIN_10_EXP - 1 )) {
+			return kErrInvalidValue;
+		}
+
+		if(( n.m_cnt == n.cnt ) && ( n.m < EXACT_F64 ) &&
+		   ( e10 >= -EXACT_POW10 ) && ( e10 <= EXACT_POW10 )) {
+			r = dec_to_f64( n.m, e10 );
+		}
+		else {
+			if( n.sticky != 0 ) {
+				n.digits[n.cnt++] = '1';
+				n.exp--;
+			}
+			r = parse_slow64( n.digits, n.cnt, n.exp );
+		}
+
+		if(( r > DBL_MAX ) || ( r < DBL_MIN )) {
+			return kErrInvalidValue;
+		}
+	}
+
+	*f = ( n.neg != 0 ) ? -r : r;
+	return kErrNone;
+}
+
+/*______________________________________________________________________EOF_*/
@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file   vcconv.h
+ * \author rhae
+ *
+ * Conversion of numbers to and from strings for vc_as_string(),
+ * without printf and strtol and without the locale. strtof() and
+ * strtod() are left only for values near a rounding tie, errno is
+ * preserved.
+ */
+
+#pragma once
+
+#include "varcore.h"
+
+/* list of global defined functions
+----------------------------------------------------------------------------*/
+int vc_fmt_s32( char *buf, S32 n );
+int vc_fmt_s64( char *buf, S64 n );
+int vc_fmt_hex( char *buf, U32 n );
+int vc_fmt_f32( char *buf, F32 f, U16 fmt );
+int vc_fmt_f64( char *buf, F64 f, U16 fmt );
+
+ErrCode vc_parse_s32( char const *s, S32 *n );
+ErrCode vc_parse_s64( char const *s, S64 *n );
+ErrCode vc_parse_f32( char const *s, F32 *f );
+ErrCode vc_parse_f64( char const *s, F64 *f );
@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file   vcfile.c
+ * \author rhae
+ *
+ * File backend of vc_flush() and vc_load().
+ */
+
+/* local header */
+#include "vcfile.h"
+
+/* header of standard C - libraries */
+#include <assert.h>
+#include <string.h>
+
+/* list of local defined functions
+----------------------------------------------------------------------------*/
+static ErrCode file_write( void *arg, HND hnd, U32 offs, void const *data, size_t size );
+static ErrCode file_read( void *arg, HND hnd, U32 offs, void *data, size_t size );
+static ErrCode file_sync( void *arg );
+
+/*** vc_file_open ***********************************************************/
+/**
+ *   Open or create a file and set up a backend for it.
+ *
+ *   @param f      File
+ *   @param be     Backend, for vc_flush() and vc_load()
+ *   @param path   Path of the file
+ *
+ *   @return kErrIO, when the file can't be opened.
+ */
+ErrCode vc_file_open( VC_FILE *f, VC_BACKEND *be, char const *path ) {
+	assert( f );
+	assert( be );
+
+	if( NULL == path ) {
+		return kErrInvalidArg;
+	}
+
+	f->fp = fopen( path, "r+b" );
+	if( NULL == f->fp ) {
+		f->fp = fopen( path, "w+b" );
+	}
+	if( NULL == f->fp ) {
+		return kErrIO;
+	}
+
+	be->write = file_write;
+	be->read  = file_read;
+	be->sync  = file_sync;
+	be->arg   = f;
+
+	return kErrNone;
+}
+
+/*** vc_file_close **********************************************************/
+/**
+ *   Close the file.
+ *
+ *   @param f      File
+ */
+ErrCode vc_file_close( VC_FILE *f ) {
+	int ret;
+
+	assert( f );
+
+	if( NULL == f->fp ) {
+		return kErrNone;
+	}
+
+	ret = fclose( f->fp );
+	f->fp = NULL;
+	return ( 0 == ret ) ? kErrNone : kErrIO;
+}
+
+/*** file_write *************************************************************/
+/**
+ *   Write the data of a variable at its offset, see VC_BACKEND.write.
+ *
+ *   @param arg    File
+ *   @param hnd    Variable handle, not used
+ *   @param offs   Offset of the data in the file
+ *   @param data   Data of the variable
+ *   @param size   Size of the data
+ *
+ *   @return kErrIO, when the data can't be written.
+ */
+static ErrCode file_write( void *arg, HND hnd, U32 offs, void const *data, size_t size ) {
+	VC_FILE *f = (VC_FILE *) arg;
+	(void) hnd;
+
+	if( fseek( f->fp, (long) offs, SEEK_SET ) != 0 ) {
+		return kErrIO;
+	}
+	if( fwrite( data, 1u, size, f->fp ) != size ) {
+		return kErrIO;
+	}
+	return kErrNone;
+}
+
+/*** file_read **************************************************************/
+/**
+ *   Read the data of a variable from its offset, see VC_BACKEND.read.
+ *
+ *   @param arg    File
+ *   @param hnd    Variable handle, not used
+ *   @param offs   Offset of the data in the file
+ *   @param data   Buffer of the data
+ *   @param size   Size of the data
+ *
+ *   @return kErrEmpty, when the file ends before the data, eg. nothing
+ *           was flushed yet.
+ */
+static ErrCode file_read( void *arg, HND hnd, U32 offs, void *data, size_t size ) {
+	VC_FILE *f = (VC_FILE *) arg;
+	(void) hnd;
+
+	if( fseek( f->fp, (long) offs, SEEK_SET ) != 0 ) {
+		return kErrIO;
+	}
+	if( fread( data, 1u, size, f->fp ) != size ) {
+		/* nothing flushed yet */
+		return kErrEmpty;
+	}
+	return kErrNone;
+}
+
+/*** file_sync **************************************************************/
+/**
+ *   Write the buffered data to the file, see VC_BACKEND.sync.
+ *
+ *   @param arg    File
+ *
+ *   @return kErrIO, when the data can't be written.
+ */
+static ErrCode file_sync( void *arg ) {
+	VC_FILE *f = (VC_FILE *) arg;
+
+	return ( 0 == fflush( f->fp )) ? kErrNone : kErrIO;
+}
+
+/*______________________________________________________________________EOF_*/
@@ -0,0 +1,241 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <varcore.h>
+
+#include "vardefs.h"
+#include "varacc.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** accessor tests *********************************************************/
+
+static void acc_get(void) {
+  S8  n8  = -7;
+  S16 n16 = 42;
+  S32 n32 = -12345;
+  S64 n64 = 1234567890123LL;
+  F32 f32 = 1.5f;
+  F64 f64 = 60.25;
+  S16 e16 = -1;
+
+  vc_as_int8( VAR_FLG, VarWrite, &n8, 5, REQ_PRG );
+  vc_as_int16( VAR_TP1, VarWrite, &n16, 2, REQ_PRG );
+  vc_as_int32( VAR_PAB, VarWrite, &n32, 7, REQ_PRG );
+  vc_as_int64( VAR_CNT, VarWrite, &n64, 0, REQ_PRG );
+  vc_as_float( VAR_VOL, VarWrite, &f32, 3, REQ_PRG );
+  vc_as_double( VAR_FRQ, VarWrite, &f64, 1, REQ_PRG );
+  vc_as_int16( VAR_YNU, VarWrite, &e16, 6, REQ_PRG );
+
+  CU_ASSERT_EQUAL( vc_get_FLG( 5 ), -7 );
+  CU_ASSERT_EQUAL( vc_get_TP1( 2 ), 42 );
+  CU_ASSERT_EQUAL( vc_get_TP1( 1 ), 0 );
+  CU_ASSERT_EQUAL( vc_get_PAB( 7 ), -12345 );
+  CU_ASSERT_EQUAL( vc_get_CNT(), 1234567890123LL );
+  CU_ASSERT_EQUAL( vc_get_VOL( 3 ), 1.5f );
+  CU_ASSERT_EQUAL( vc_get_FRQ( 1 ), 60.25 );
+  CU_ASSERT_EQUAL( vc_get_FRQ( 0 ), 50.0 );
+  CU_ASSERT_EQUAL( vc_get_YNU( 6 ), -1 );
+  CU_ASSERT_EQUAL( vc_get_CO_NODEID(), 1 );
+  CU_ASSERT_EQUAL( vc_get_CAN_BAUD(), 500 );
+
+  /* every channel of the vectors after CUR */
+  for( U16 c = 0; c < VEC_LEM; c++ ) {
+    F32 f = 100.0f + c;
+    S16 n = (S16)( 10 * c );
+
+    vc_as_float( VAR_CUR_PMAX, VarWrite, &f, c, REQ_PRG );
+    vc_as_int16( VAR_UAB, VarWrite, &n, c, REQ_PRG );
+    CU_ASSERT_EQUAL( vc_get_CUR_PMAX( c ), f );
+    CU_ASSERT_EQUAL( vc_get_UAB( c ), n );
+    CU_ASSERT_EQUAL( vc_get_CUR_NMAX( c ), -500.0f );
+  }
+
+  vc_reset();
+}
+
+static void acc_set(void) {
+  S16 n16;
+  F32 f32;
+  S64 n64;
+  ErrCode ret;
+
+  /* FLAG_CLIP */
+  ret = vc_set_TP1( 4, 200 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  vc_as_int16( VAR_TP1, VarRead, &n16, 4, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 105 );
+  ret = vc_set_TP1( 4, -200 );
+  CU_ASSERT_EQUAL( vc_get_TP1( 4 ), -80 );
+
+  /* FLAG_LIMIT, the limits are read at run time */
+  ret = vc_set_CUR( 2, 2000.0f );
+  CU_ASSERT_EQUAL( ret, kErrUpperLimit );
+  ret = vc_set_CUR( 2, -2000.0f );
+  CU_ASSERT_EQUAL( ret, kErrLowerLimit );
+  ret = vc_set_CUR( 2, 12.5f );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  vc_as_float( VAR_CUR, VarRead, &f32, 2, REQ_PRG );
+  CU_ASSERT_EQUAL( f32, 12.5f );
+
+  f32 = 10.0f;
+  vc_set_max( VAR_CUR, (U8*)&f32, 2 );
+  ret = vc_set_CUR( 2, 11.0f );
+  CU_ASSERT_EQUAL( ret, kErrUpperLimit );
+  CU_ASSERT_EQUAL( vc_get_CUR( 2 ), 12.5f );
+
+  n64 = 9007199254740994LL;
+  ret = vc_set_CNT( n64 );
+  CU_ASSERT_EQUAL( ret, kErrUpperLimit );
+
+  /* no limit flag */
+  ret = vc_set_UAB( 0, 5000 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( vc_get_UAB( 0 ), 5000 );
+
+  /* enums */
+  ret = vc_set_LOD( 1 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  vc_as_int16( VAR_LOD, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 1 );
+  ret = vc_set_LOD( 2 );
+  CU_ASSERT_EQUAL( ret, kErrInvalidEnum );
+  CU_ASSERT_EQUAL( vc_get_LOD(), 1 );
+  ret = vc_set_YNU( 7, -2 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( vc_get_YNU( 7 ), -2 );
+
+  vc_reset();
+}
+
+/* varacc.h has no setter of the read-only VAR_RDO and of the admin
+ * variable VAR_SER, a function of the same name would conflict with
+ * these objects at compile time */
+static int const vc_set_RDO = 0;
+static int const vc_set_SER = 0;
+
+static void acc_rights(void) {
+  S32 n32 = 4711;
+
+  CU_ASSERT_EQUAL( vc_set_RDO, 0 );
+  CU_ASSERT_EQUAL( vc_set_SER, 0 );
+
+  /* read-only variable, the getter exists */
+  CU_ASSERT_EQUAL( vc_get_RDO(), 1234 );
+  CU_ASSERT_EQUAL( vc_as_int32( VAR_RDO, VarWrite, &n32, 0, REQ_PRG ), kErrAccessDenied );
+
+  /* admin variable, written with an explicit REQ_ADMIN */
+  CU_ASSERT_EQUAL( vc_as_int32( VAR_SER, VarWrite, &n32, 0, REQ_PRG ), kErrAccessDenied );
+  CU_ASSERT_EQUAL( vc_as_int32( VAR_SER, VarWrite, &n32, 0, REQ_PRG | REQ_ADMIN ), kErrNone );
+  CU_ASSERT_EQUAL( vc_get_SER(), 4711 );
+
+  vc_reset();
+}
+
+static void acc_notify(void) {
+  VC_RING_CELL cell[4];
+  VC_RING      r;
+  VC_EVENT     ev;
+  ErrCode      ret;
+  int          id;
+
+  vc_ring_init( &r, cell, countof(cell) );
+  ret = vc_subscribe( VAR_PAB, VC_ALL_CHAN, &r, NULL, NULL, &id );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  vc_set_PAB( 6, 777 );
+  ret = vc_ring_pop( &r, &ev );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( ev.hnd, VAR_PAB );
+  CU_ASSERT_EQUAL( ev.chan, 6 );
+  CU_ASSERT_EQUAL( ev.val.s32, 777 );
+
+  /* unchanged value */
+  vc_set_PAB( 6, 777 );
+  ret = vc_ring_pop( &r, &ev );
+  CU_ASSERT_EQUAL( ret, kErrEmpty );
+
+  CU_ASSERT_EQUAL( vc_notify( 0x7fff, 0, NULL, 1 ), kErrUnknownCmd );
+
+  vc_unsubscribe( id );
+  vc_reset();
+}
+
+static CU_TestInfo tests_acc[] = {
+  { "Get",     acc_get },
+  { "Set",     acc_set },
+  { "Rights",  acc_rights },
+  { "Notify",  acc_notify },
+	CU_TEST_INFO_NULL,
+};
+
+
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "accessors",  suite_init, suite_clean, NULL, NULL, tests_acc },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_acc(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
@@ -0,0 +1,221 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <varcore.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+
+
+/*** action tests ***********************************************************/
+
+typedef struct {
+  int hits;
+  HND hnd;
+  U16 chan;
+} ACT_LOG;
+
+static ErrCode act_log( HND hnd, U16 chan, void *arg ) {
+  ACT_LOG *log = (ACT_LOG*) arg;
+
+  log->hits++;
+  log->hnd  = hnd;
+  log->chan = chan;
+  return kErrNone;
+}
+
+static ErrCode act_fail( HND hnd, U16 chan, void *arg ) {
+  (void) hnd;
+  (void) chan;
+  (void) arg;
+  return kErrIO;
+}
+
+static void action_invoke(void) {
+  ACT_LOG log = { 0, 0, 0 };
+
+  CU_ASSERT_EQUAL( vc_invoke( VAR_RST, 0, REQ_PRG ), kErrEmpty );
+
+  CU_ASSERT_EQUAL( vc_bind( VAR_RST, act_log, &log ), kErrNone );
+  CU_ASSERT_EQUAL( vc_invoke( VAR_RST, 0, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( log.hits, 1 );
+  CU_ASSERT_EQUAL( log.hnd, VAR_RST );
+
+  /* the return value of the handler is passed through */
+  CU_ASSERT_EQUAL( vc_bind( VAR_RST, act_fail, NULL ), kErrNone );
+  CU_ASSERT_EQUAL( vc_invoke( VAR_RST, 0, REQ_PRG ), kErrIO );
+
+  /* unbind */
+  CU_ASSERT_EQUAL( vc_bind( VAR_RST, NULL, NULL ), kErrNone );
+  CU_ASSERT_EQUAL( vc_invoke( VAR_RST, 0, REQ_PRG ), kErrEmpty );
+  CU_ASSERT_EQUAL( log.hits, 1 );
+}
+
+static void action_vector(void) {
+  ACT_LOG log = { 0, 0, 0 };
+
+  CU_ASSERT_EQUAL( vc_bind( VAR_CAL, act_log, &log ), kErrNone );
+  CU_ASSERT_EQUAL( vc_invoke( VAR_CAL, 5, REQ_PRG | REQ_ADMIN ), kErrNone );
+  CU_ASSERT_EQUAL( log.hits, 1 );
+  CU_ASSERT_EQUAL( log.hnd, VAR_CAL );
+  CU_ASSERT_EQUAL( log.chan, 5 );
+
+  CU_ASSERT_EQUAL( vc_invoke( VAR_CAL, VEC_LEM, REQ_PRG | REQ_ADMIN ), kErrInvalidChan );
+  CU_ASSERT_EQUAL( vc_invoke( VAR_RST, 1, REQ_PRG ), kErrNoVector );
+  CU_ASSERT_EQUAL( log.hits, 1 );
+
+  /* each action has its own slot */
+  CU_ASSERT_EQUAL( vc_invoke( VAR_RST, 0, REQ_PRG ), kErrEmpty );
+  vc_bind( VAR_CAL, NULL, NULL );
+}
+
+static void action_access(void) {
+  ACT_LOG log = { 0, 0, 0 };
+
+  vc_bind( VAR_RST, act_log, &log );
+  vc_bind( VAR_CAL, act_log, &log );
+
+  CU_ASSERT_EQUAL( vc_invoke( VAR_RST, 0, REQ_EX1 ), kErrAccessDenied );
+  CU_ASSERT_EQUAL( vc_invoke( VAR_RST, 0, REQ_PRG | REQ_ADMIN ), kErrAccessDenied );
+  CU_ASSERT_EQUAL( vc_invoke( VAR_CAL, 0, REQ_PRG ), kErrAccessDenied );
+  CU_ASSERT_EQUAL( log.hits, 0 );
+
+  CU_ASSERT_EQUAL( vc_invoke( VAR_RST, 0, REQ_CMD ), kErrNone );
+  CU_ASSERT_EQUAL( log.hits, 1 );
+
+  vc_bind( VAR_RST, NULL, NULL );
+  vc_bind( VAR_CAL, NULL, NULL );
+}
+
+static void action_errors(void) {
+  ACT_LOG log = { 0, 0, 0 };
+
+  CU_ASSERT_EQUAL( vc_bind( VAR_CUR, act_log, &log ), kErrInvalidType );
+  CU_ASSERT_EQUAL( vc_invoke( VAR_CUR, 0, REQ_PRG ), kErrInvalidType );
+  CU_ASSERT_EQUAL( vc_bind( 0x7fff, act_log, &log ), kErrUnknownCmd );
+  CU_ASSERT_EQUAL( vc_invoke( 0x7fff, 0, REQ_PRG ), kErrUnknownCmd );
+  CU_ASSERT_EQUAL( log.hits, 0 );
+}
+
+static void action_string(void) {
+  ACT_LOG log = { 0, 0, 0 };
+  char buf[32] = "1";
+
+  /* a write through the SCPI path triggers the action */
+  vc_bind( VAR_RST, act_log, &log );
+  CU_ASSERT_EQUAL( vc_as_string( vc_get_hnd( "RST" ), VarWrite, buf, 0, REQ_CMD ), kErrNone );
+  CU_ASSERT_EQUAL( log.hits, 1 );
+  CU_ASSERT_EQUAL( vc_as_string( VAR_RST, VarRead, buf, 0, REQ_CMD ), kErrInvalidType );
+  CU_ASSERT_EQUAL( log.hits, 1 );
+
+  /* vc_reset() keeps the bindings, vc_init() removes them */
+  vc_reset();
+  CU_ASSERT_EQUAL( vc_invoke( VAR_RST, 0, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( log.hits, 2 );
+  vc_init( &g_var_data );
+  CU_ASSERT_EQUAL( vc_invoke( VAR_RST, 0, REQ_PRG ), kErrEmpty );
+}
+
+static void action_ctx(void) {
+  static F64 storage[4096];
+  VC_CTX ctx;
+  ACT_LOG log = { 0, 0, 0 };
+  ACT_LOG own = { 0, 0, 0 };
+
+  CU_ASSERT( vc_ctx_storage_size( &g_var_data ) <= sizeof(storage));
+  CU_ASSERT_EQUAL( vc_ctx_init_storage( &ctx, &g_var_data, storage, sizeof(storage)), kErrNone );
+
+  /* the context has its own dispatch table */
+  vc_bind( VAR_RST, act_log, &log );
+  CU_ASSERT_EQUAL( vc_ctx_invoke( &ctx, VAR_RST, 0, REQ_PRG ), kErrEmpty );
+  CU_ASSERT_EQUAL( vc_ctx_bind( &ctx, VAR_RST, act_log, &own ), kErrNone );
+  CU_ASSERT_EQUAL( vc_ctx_invoke( &ctx, VAR_RST, 0, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( own.hits, 1 );
+  CU_ASSERT_EQUAL( log.hits, 0 );
+
+  vc_bind( VAR_RST, NULL, NULL );
+}
+
+
+static CU_TestInfo tests_action[] = {
+  { "Invoke",               action_invoke },
+  { "Vector",               action_vector },
+  { "Access rights",        action_access },
+  { "Errors",               action_errors },
+  { "SCPI write",           action_string },
+  { "Context",              action_ctx },
+	CU_TEST_INFO_NULL,
+};
+
+
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "action",  suite_init, suite_clean, NULL, NULL, tests_action },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_action(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
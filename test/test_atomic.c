@@ -0,0 +1,263 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#ifdef VC_THREAD_SAFE
+#include <pthread.h>
+#include <stdatomic.h>
+#endif
+
+#include <varcore.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+#ifdef VC_HAS_ATOMIC
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** atomic tests ***********************************************************/
+
+static void ld_st(void) {
+  ErrCode ret;
+  S16     n16;
+  S32     n32;
+  F32     f;
+
+  n16 = 200;
+  ret = vc_atomic_store_s16( VAR_TP1, 3, &n16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( n16, 105 );
+  ret = vc_atomic_load_s16( VAR_TP1, 3, &n16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( n16, 105 );
+
+  n32 = 100001;
+  ret = vc_atomic_store_s32( VAR_POW, 1, &n32, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrUpperLimit );
+  n32 = -42;
+  ret = vc_atomic_store_s32( VAR_POW, 1, &n32, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_int32( VAR_POW, VarRead, &n32, 1, REQ_PRG );
+  CU_ASSERT_EQUAL( n32, -42 );
+
+  f = 12.5f;
+  ret = vc_atomic_store_f32( VAR_VOL, 0, &f, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  f = 0.0f;
+  ret = vc_atomic_load_f32( VAR_VOL, 0, &f, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( f, 12.5, 0.001 );
+
+  ret = vc_atomic_load_s32( VAR_VOL, 0, &n32, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidType );
+  ret = vc_atomic_load_s16( VAR_CO_NODEID, 1, &n16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNoVector );
+  n32 = 1;
+  ret = vc_atomic_store_s32( VAR_SER, 0, &n32, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrAccessDenied );
+}
+
+static void fetch_add(void) {
+  ErrCode ret;
+  S16     n16;
+  S32     n32;
+  F32     f;
+
+  // FLAG_LIMIT, the sum isn't written
+  n32 = 99990;
+  ret = vc_atomic_store_s32( VAR_POW, 2, &n32, REQ_PRG );
+  ret = vc_atomic_fetch_add_s32( VAR_POW, 2, 5, &n32, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( n32, 99990 );
+  ret = vc_atomic_fetch_add_s32( VAR_POW, 2, 10, &n32, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrUpperLimit );
+  CU_ASSERT_EQUAL( n32, 99995 );
+
+  // FLAG_CLIP
+  n16 = 100;
+  ret = vc_atomic_store_s16( VAR_TP1, 4, &n16, REQ_PRG );
+  ret = vc_atomic_fetch_add_s16( VAR_TP1, 4, 10, NULL, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_atomic_load_s16( VAR_TP1, 4, &n16, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 105 );
+
+  // no flags, saturates
+  n32 = 0x7ffffff0;
+  ret = vc_atomic_store_s32( VAR_ERR, 0, &n32, REQ_PRG );
+  ret = vc_atomic_fetch_add_s32( VAR_ERR, 0, 0x100, NULL, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_atomic_load_s32( VAR_ERR, 0, &n32, REQ_PRG );
+  CU_ASSERT_EQUAL( n32, 0x7fffffff );
+
+  ret = vc_atomic_fetch_add_f32( VAR_CUR_NMAX, 5, -600.0f, &f, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_DOUBLE_EQUAL( f, -500.0, 0.001 );
+  ret = vc_atomic_load_f32( VAR_CUR_NMAX, 5, &f, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( f, -1000.0, 0.001 );
+}
+
+static void cas(void) {
+  ErrCode ret;
+  S16     n16;
+  S32     n32;
+  F32     f;
+
+  n32 = 10;
+  ret = vc_atomic_store_s32( VAR_PAB, 0, &n32, REQ_PRG );
+  n32 = 11;
+  ret = vc_atomic_cas_s32( VAR_PAB, 0, &n32, 20, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrValueChanged );
+  CU_ASSERT_EQUAL( n32, 10 );
+  ret = vc_atomic_cas_s32( VAR_PAB, 0, &n32, 200000, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_atomic_load_s32( VAR_PAB, 0, &n32, REQ_PRG );
+  CU_ASSERT_EQUAL( n32, 100000 );
+
+  n16 = 0;
+  ret = vc_atomic_cas_s16( VAR_IAB, 1, &n16, 1001, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrUpperLimit );
+  ret = vc_atomic_cas_s16( VAR_IAB, 1, &n16, 7, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_int16( VAR_IAB, VarRead, &n16, 1, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 7 );
+
+  f = 0.0f;
+  ret = vc_atomic_cas_f32( VAR_CUR, 6, &f, 1.5f, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_atomic_cas_f32( VAR_CUR, 6, NULL, 1.5f, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidArg );
+}
+
+#ifdef VC_THREAD_SAFE
+static atomic_int store_done;
+
+/* stores 50, which is only in range while the upper limit is 100 */
+static void *limit_store_thread( void *arg ) {
+  S32 n32;
+
+  (void) arg;
+  while( atomic_load( &store_done ) == 0 ) {
+    n32 = 50;
+    (void) vc_atomic_store_s32( VAR_POW, 3, &n32, REQ_PRG );
+    n32 = 0;
+    (void) vc_atomic_cas_s32( VAR_POW, 3, &n32, 50, REQ_PRG );
+  }
+  return NULL;
+}
+
+/* lowers the upper limit while the other thread stores, a store that
+ * read the old limit before the lock wrote 50 after the limit was 10 */
+static void limit_thread(void) {
+  pthread_t tid;
+  S32 n32;
+  S32 max;
+  int bad = 0;
+
+  atomic_store( &store_done, 0 );
+  CU_ASSERT_EQUAL_FATAL( pthread_create( &tid, NULL, limit_store_thread, NULL ), 0 );
+
+  for( int i = 0; i < 200000; i++ ) {
+    max = 100;
+    vc_set_max( VAR_POW, (U8*)&max, 3 );
+    max = 10;
+    vc_set_max( VAR_POW, (U8*)&max, 3 );
+    n32 = 0;
+    vc_atomic_store_s32( VAR_POW, 3, &n32, REQ_PRG );
+    vc_atomic_load_s32( VAR_POW, 3, &n32, REQ_PRG );
+    if( n32 > 10 ) {
+      bad++;
+    }
+  }
+
+  atomic_store( &store_done, 1 );
+  pthread_join( tid, NULL );
+  CU_ASSERT_EQUAL( bad, 0 );
+
+  max = 100000;
+  vc_set_max( VAR_POW, (U8*)&max, 3 );
+}
+#endif
+
+static CU_TestInfo tests_atomic[] = {
+  { "Load/Store",        ld_st },
+  { "Fetch add",         fetch_add },
+  { "Compare and swap",  cas },
+#ifdef VC_THREAD_SAFE
+  { "Limits in threads", limit_thread },
+#endif
+	CU_TEST_INFO_NULL,
+};
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "atomic functions",  suite_init, suite_clean, NULL, NULL, tests_atomic },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_atomic(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
+
+#else
+
+void test_add_atomic(void)
+{
+}
+
+#endif
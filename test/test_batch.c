@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* WARNING - MAINTENANCE NIGHTMARE AHEAD
+ *
+ * If you change any of the tests & suites below, you also need
+ * to keep track of changes in the result statistics and reflect
+ * any changes in the result report counts in print_example_results().
+ *
+ * Yes, this could have been designed better using a more
+ * automated mechanism.  No, it was not done that way.
+ */
+
+#include <varcore.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** batch tests ************************************************************/
+
+static void rd_many(void) {
+  HND      hnd[]  = { VAR_CO_NODEID, VAR_SER, VAR_CUR_NMAX, VAR_XON, 0x7fff, VAR_IDN, VAR_CO_NODEID };
+  U16      chan[] = { 0,             0,       3,            0,       0,      0,       2             };
+  VC_VALUE val[countof(hnd)];
+  ErrCode  err[countof(hnd)];
+  ErrCode  ret;
+
+  memset( val, 0, sizeof(val));
+  ret = vc_read_many( hnd, chan, val, err, countof(hnd), REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrUnknownCmd );
+
+  CU_ASSERT_EQUAL( err[0], kErrNone );
+  CU_ASSERT_EQUAL( val[0].s16, 1 );
+  CU_ASSERT_EQUAL( err[1], kErrNone );
+  CU_ASSERT_EQUAL( val[1].s32, 10000 );
+  CU_ASSERT_EQUAL( err[2], kErrNone );
+  CU_ASSERT_DOUBLE_EQUAL( val[2].f32, -500.0, 0.001 );
+  CU_ASSERT_EQUAL( err[3], kErrNone );
+  CU_ASSERT_EQUAL( val[3].s16, 1 );
+  CU_ASSERT_EQUAL( err[4], kErrUnknownCmd );
+  CU_ASSERT_EQUAL( err[5], kErrInvalidType );
+  CU_ASSERT_EQUAL( err[6], kErrNoVector );
+
+  // without channels
+  ret = vc_read_many( hnd, NULL, val, err, 4, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_DOUBLE_EQUAL( val[2].f32, -500.0, 0.001 );
+
+  ret = vc_read_many( hnd, chan, val, NULL, 4, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidArg );
+}
+
+static void wr_many(void) {
+  HND      hnd[]  = { VAR_TP1, VAR_IAB, VAR_POW, VAR_CUR_NMAX, VAR_YNU, VAR_SER, VAR_YNU };
+  U16      chan[] = { 1,       0,       7,       2,            1,       0,       2       };
+  VC_VALUE val[countof(hnd)];
+  ErrCode  err[countof(hnd)];
+  ErrCode  ret;
+  S16      n16;
+  S32      n32;
+  F32      f;
+
+  val[0].s16 = 200;
+  val[1].s16 = 2000;
+  val[2].s32 = 5;
+  val[3].f32 = -500.5f;
+  val[4].s16 = -3;
+  val[5].s32 = 1;
+  val[6].s16 = -1;
+
+  ret = vc_write_many( hnd, chan, val, err, countof(hnd), REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrUpperLimit );
+
+  // FLAG_CLIP
+  CU_ASSERT_EQUAL( err[0], kErrNone );
+  CU_ASSERT_EQUAL( val[0].s16, 105 );
+  ret = vc_as_int16( VAR_TP1, VarRead, &n16, 1, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 105 );
+
+  // FLAG_LIMIT
+  CU_ASSERT_EQUAL( err[1], kErrUpperLimit );
+  ret = vc_as_int16( VAR_IAB, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 0 );
+
+  CU_ASSERT_EQUAL( err[2], kErrNone );
+  ret = vc_as_int32( VAR_POW, VarRead, &n32, 7, REQ_PRG );
+  CU_ASSERT_EQUAL( n32, 5 );
+
+  CU_ASSERT_EQUAL( err[3], kErrNone );
+  ret = vc_as_float( VAR_CUR_NMAX, VarRead, &f, 2, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( f, -500.5, 0.001 );
+
+  CU_ASSERT_EQUAL( err[4], kErrInvalidEnum );
+  CU_ASSERT_EQUAL( err[5], kErrAccessDenied );
+
+  CU_ASSERT_EQUAL( err[6], kErrNone );
+  ret = vc_as_int16( VAR_YNU, VarRead, &n16, 2, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, -1 );
+}
+
+static CU_TestInfo tests_batch[] = {
+  { "Read many",   rd_many },
+  { "Write many",  wr_many },
+	CU_TEST_INFO_NULL,
+};
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "batch functions",  suite_init, suite_clean, NULL, NULL, tests_batch },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_batch(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
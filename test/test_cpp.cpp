@@ -0,0 +1,238 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+extern "C" {
+#include "CUnit/CUnit.h"
+}
+
+#include <array>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <type_traits>
+
+#include <varcore.hpp>
+
+#include "vardefs.hpp"
+
+extern "C" VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** C++ wrapper tests ******************************************************/
+
+/* handle, type and channels are known at compile time */
+static_assert( var::CUR.hnd() == VAR_CUR, "handle" );
+static_assert( var::CUR.size() == VEC_LEM, "channels" );
+static_assert( decltype(var::CUR)::type == TYPE_FLOAT, "type" );
+static_assert( std::is_same<decltype(var::TP1)::value_type, S16>::value, "value type" );
+static_assert( decltype(var::LOD)::type == TYPE_ENUM, "enum" );
+static_assert( sizeof(var::CUR) == sizeof(HND), "no overhead" );
+
+static void cpp_scalar(void) {
+  S16 n16 = 0;
+  F64 f64 = 0.0;
+  S64 n64 = 0;
+  ErrCode ret;
+
+  ret = var::TP1.write( 42, 3 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = var::TP1.read( n16, 3 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( n16, 42 );
+  CU_ASSERT_EQUAL( var::TP1.get( 3 ), 42 );
+
+  /* FLAG_CLIP of the C function */
+  var::TP1.write( 1000, 4 );
+  CU_ASSERT_EQUAL( var::TP1.get( 4 ), 105 );
+
+  ret = var::FRQ.write( 60.5, 1 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  var::FRQ.read( f64, 1 );
+  CU_ASSERT_EQUAL( f64, 60.5 );
+
+  ret = var::CNT.write( 9007199254740993LL );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  var::CNT.read( n64 );
+  CU_ASSERT_EQUAL( n64, 9007199254740993LL );
+
+  ret = var::LOD.write( 1 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = var::LOD.write( 7 );
+  CU_ASSERT_EQUAL( ret, kErrInvalidEnum );
+  CU_ASSERT_EQUAL( var::LOD.get(), 1 );
+
+  /* the channel is still checked at run time */
+  ret = var::TP1.read( n16, VEC_LEM );
+  CU_ASSERT_EQUAL( ret, kErrInvalidChan );
+
+  vc_reset();
+}
+
+static void cpp_limits(void) {
+  F32 f;
+
+  CU_ASSERT_EQUAL( var::CUR.get_max( f, 2 ), kErrNone );
+  CU_ASSERT_EQUAL( f, 1000.0f );
+  CU_ASSERT_EQUAL( var::CUR.set_max( 10.0f, 2 ), kErrNone );
+  CU_ASSERT_EQUAL( var::CUR.write( 11.0f, 2 ), kErrUpperLimit );
+  CU_ASSERT_EQUAL( var::CUR.get_min( f, 2 ), kErrNone );
+  CU_ASSERT_EQUAL( f, -1000.0f );
+
+  vc_reset();
+}
+
+static void cpp_vector(void) {
+  std::array<F32, VEC_LEM> in;
+  std::array<F32, VEC_LEM> out;
+  S16 n16[4] = { 1, 2, 3, 4 };
+  S16 r16[4] = { 0, 0, 0, 0 };
+  ErrCode ret;
+
+  for( size_t i = 0; i < in.size(); i++ ) {
+    in[i] = 1.5f * (F32) i;
+  }
+  ret = var::VOL.write( in );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = var::VOL.read( out );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT( in == out );
+
+  ret = var::UAB.write( n16, 4 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = var::UAB.read( vc::span<S16>( r16, 2 ), 5 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( r16[0], 2 );
+  CU_ASSERT_EQUAL( r16[1], 3 );
+
+  /* more channels than the vector has */
+  ret = var::UAB.read( r16, 6 );
+  CU_ASSERT_EQUAL( ret, kErrInvalidChan );
+
+  /* more values than the variable has, not truncated to U16 */
+  std::array<F32, var::VOL.size() + 1> big{};
+  ret = var::VOL.write( big );
+  CU_ASSERT_EQUAL( ret, kErrInvalidArg );
+  ret = var::VOL.read( big );
+  CU_ASSERT_EQUAL( ret, kErrInvalidArg );
+  std::vector<S16> huge( 65536 + 2, 0 );
+  ret = var::UAB.write( huge );
+  CU_ASSERT_EQUAL( ret, kErrInvalidArg );
+
+  vc_reset();
+}
+
+static void cpp_string(void) {
+  STRBUF S;
+  ErrCode ret;
+
+  ret = var::NAS.write( "10.0.0.1", 1 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = var::NAS.read( S, 1 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_STRING_EQUAL( S, "10.0.0.1" );
+
+  ret = var::NAS.write( "0123456789012345678901234567890123456789" );
+  CU_ASSERT_EQUAL( ret, kErrSizeTooBig );
+
+  var::IDN.read( S );
+  CU_ASSERT( strncmp( S, "Test application", 16 ) == 0 );
+
+  vc_reset();
+}
+
+static void cpp_ctx(void) {
+  static double storage[1024];
+  VC_CTX ctx;
+  F32 f = 0.0f;
+
+  CU_ASSERT( vc_ctx_storage_size( &g_var_data ) <= sizeof(storage) );
+  vc_ctx_init_storage( &ctx, &g_var_data, storage, sizeof(storage) );
+
+  CU_ASSERT_EQUAL( var::CUR.write( ctx, 5.0f, 1 ), kErrNone );
+  CU_ASSERT_EQUAL( var::CUR.read( ctx, f, 1 ), kErrNone );
+  CU_ASSERT_EQUAL( f, 5.0f );
+  CU_ASSERT_EQUAL( var::CUR.get( 1 ), 0.0f );
+
+  std::array<F32, 3> in = { 1.0f, 2.0f, 3.0f };
+  std::array<F32, 3> out{};
+  CU_ASSERT_EQUAL( var::VOL.write( ctx, in, 2 ), kErrNone );
+  CU_ASSERT_EQUAL( var::VOL.read( ctx, out, 2 ), kErrNone );
+  CU_ASSERT( in == out );
+  std::array<F32, var::VOL.size() + 1> big{};
+  CU_ASSERT_EQUAL( var::VOL.write( ctx, big ), kErrInvalidArg );
+  CU_ASSERT_EQUAL( var::VOL.read( ctx, big ), kErrInvalidArg );
+}
+
+static CU_TestInfo tests_cpp[] = {
+  { "Scalars",  cpp_scalar },
+  { "Limits",   cpp_limits },
+  { "Vectors",  cpp_vector },
+  { "Strings",  cpp_string },
+  { "Contexts", cpp_ctx },
+	CU_TEST_INFO_NULL,
+};
+
+
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "C++ wrapper",  suite_init, suite_clean, NULL, NULL, tests_cpp },
+	CU_SUITE_INFO_NULL,
+};
+
+extern "C" void test_add_cpp(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
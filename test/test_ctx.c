@@ -0,0 +1,189 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <varcore.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** context tests **********************************************************/
+
+static double s_storage[2][1024];
+
+static void ctx_storage(void) {
+  VC_CTX  ctx;
+  size_t  size;
+  ErrCode ret;
+
+  size = vc_ctx_storage_size( &g_var_data );
+  CU_ASSERT( size > 0 );
+  CU_ASSERT( size <= sizeof(s_storage[0]) );
+
+  ret = vc_ctx_init_storage( &ctx, &g_var_data, s_storage[0], size - 1 );
+  CU_ASSERT_EQUAL( ret, kErrInvalidArg );
+  ret = vc_ctx_init_storage( &ctx, &g_var_data, NULL, size );
+  CU_ASSERT_EQUAL( ret, kErrInvalidArg );
+  ret = vc_ctx_init_storage( &ctx, &g_var_data, s_storage[0], size );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+}
+
+static void ctx_instances(void) {
+  VC_CTX  ctx[2];
+  ErrCode ret;
+  S16     n16;
+  S32     n32;
+  F32     f;
+  STRBUF  s;
+
+  for( int i = 0; i < 2; i++ ) {
+    ret = vc_ctx_init_storage( &ctx[i], &g_var_data, s_storage[i], sizeof(s_storage[i]) );
+    CU_ASSERT_EQUAL( ret, kErrNone );
+  }
+
+  // default values
+  ret = vc_ctx_as_int16( &ctx[1], VAR_CO_NODEID, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 1 );
+  ret = vc_ctx_as_string( &ctx[1], VAR_UAS, VarRead, s, 0, REQ_PRG );
+  CU_ASSERT_STRING_EQUAL( s, "192.168.2.11" );
+
+  n16 = 11;
+  ret = vc_ctx_as_int16( &ctx[0], VAR_CO_NODEID, VarWrite, &n16, 0, REQ_PRG );
+  n16 = 22;
+  ret = vc_ctx_as_int16( &ctx[1], VAR_CO_NODEID, VarWrite, &n16, 0, REQ_PRG );
+  n32 = 7;
+  ret = vc_ctx_as_int32( &ctx[1], VAR_POW, VarWrite, &n32, 2, REQ_PRG );
+  f = 1.5f;
+  ret = vc_ctx_as_float( &ctx[0], VAR_VOL, VarWrite, &f, 4, REQ_PRG );
+  memset( s, 0, sizeof(s) );
+  strcpy( s, "ctx0" );
+  ret = vc_ctx_as_string( &ctx[0], VAR_UAS, VarWrite, s, 0, REQ_PRG );
+
+  ret = vc_ctx_as_int16( &ctx[0], VAR_CO_NODEID, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 11 );
+  ret = vc_ctx_as_int16( &ctx[1], VAR_CO_NODEID, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 22 );
+  ret = vc_as_int16( VAR_CO_NODEID, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 1 );
+
+  ret = vc_ctx_as_int32( &ctx[0], VAR_POW, VarRead, &n32, 2, REQ_PRG );
+  CU_ASSERT_EQUAL( n32, 0 );
+  ret = vc_ctx_as_float( &ctx[1], VAR_VOL, VarRead, &f, 4, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( f, 0.0, 0.001 );
+  ret = vc_ctx_as_string( &ctx[1], VAR_UAS, VarRead, s, 0, REQ_PRG );
+  CU_ASSERT_STRING_EQUAL( s, "192.168.2.11" );
+  ret = vc_ctx_as_string( &ctx[0], VAR_UAS, VarRead, s, 0, REQ_PRG );
+  CU_ASSERT_STRING_EQUAL( s, "ctx0" );
+
+  // shared descriptors
+  CU_ASSERT_EQUAL( vc_ctx_get_hnd( &ctx[1], "CUR:NMAX" ), VAR_CUR_NMAX );
+
+  ret = vc_ctx_reset( &ctx[0] );
+  ret = vc_ctx_as_int16( &ctx[0], VAR_CO_NODEID, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 1 );
+  ret = vc_ctx_as_int16( &ctx[1], VAR_CO_NODEID, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 22 );
+}
+
+static int s_notified;
+
+static void on_change( VC_EVENT const *ev, void *arg ) {
+  (void) ev;
+  (void) arg;
+  s_notified++;
+}
+
+static void ctx_subscribe(void) {
+  VC_CTX  ctx;
+  ErrCode ret;
+  S16     n16;
+
+  vc_ctx_init_storage( &ctx, &g_var_data, s_storage[0], sizeof(s_storage[0]) );
+  ret = vc_ctx_subscribe( &ctx, VAR_CO_NODEID, 0, NULL, on_change, NULL, NULL );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  s_notified = 0;
+  n16 = 33;
+  ret = vc_as_int16( VAR_CO_NODEID, VarWrite, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( s_notified, 0 );
+  ret = vc_ctx_as_int16( &ctx, VAR_CO_NODEID, VarWrite, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( s_notified, 1 );
+
+  vc_reset();
+}
+
+static CU_TestInfo tests_ctx[] = {
+  { "Context storage",    ctx_storage },
+  { "Context instances",  ctx_instances },
+  { "Context subscribe",  ctx_subscribe },
+	CU_TEST_INFO_NULL,
+};
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "contexts",  suite_init, suite_clean, NULL, NULL, tests_ctx },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_ctx(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
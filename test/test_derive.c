@@ -0,0 +1,286 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#ifdef VC_THREAD_SAFE
+#include <pthread.h>
+#include <stdatomic.h>
+#endif
+
+#include <varcore.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** derived variable tests *************************************************/
+
+/* cached value of a channel of VAR_PWR in the default context */
+static F32 *pwr_cache( U16 chan ) {
+  return &g_var_data.data_f32[g_var_data.vars[VAR_PWR].data_idx + chan];
+}
+
+static void derive_read(void) {
+  F32 val;
+  F32 pwr[VEC_LEM];
+  F64 pkw;
+  S16 id;
+
+  val = 10.0f;
+  CU_ASSERT_EQUAL( vc_as_float( VAR_VOL, VarWrite, &val, 2, REQ_PRG ), kErrNone );
+  val = 5.0f;
+  CU_ASSERT_EQUAL( vc_as_float( VAR_CUR, VarWrite, &val, 2, REQ_PRG ), kErrNone );
+
+  CU_ASSERT_EQUAL( vc_as_float( VAR_PWR, VarRead, &val, 2, REQ_PRG ), kErrNone );
+  CU_ASSERT_DOUBLE_EQUAL( val, 50.0, 1e-6 );
+  CU_ASSERT_EQUAL( vc_read_vector( VAR_PWR, 0, VEC_LEM, pwr, REQ_PRG ), kErrNone );
+  CU_ASSERT_DOUBLE_EQUAL( pwr[1], 0.0, 1e-6 );
+  CU_ASSERT_DOUBLE_EQUAL( pwr[2], 50.0, 1e-6 );
+
+  /* derived from a derived variable */
+  CU_ASSERT_EQUAL( vc_as_double( VAR_PKW, VarRead, &pkw, 2, REQ_PRG ), kErrNone );
+  CU_ASSERT_DOUBLE_EQUAL( pkw, 0.05, 1e-9 );
+  val = 20.0f;
+  vc_as_float( VAR_VOL, VarWrite, &val, 2, REQ_PRG );
+  vc_as_double( VAR_PKW, VarRead, &pkw, 2, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( pkw, 0.1, 1e-9 );
+
+  /* a scalar input changes all channels */
+  vc_as_float( VAR_IOF, VarRead, &val, 7, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( val, 1.0, 1e-6 );
+  id = 3;
+  vc_as_int16( VAR_CO_NODEID, VarWrite, &id, 0, REQ_PRG );
+  vc_as_float( VAR_IOF, VarRead, &val, 7, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( val, 3.0, 1e-6 );
+  vc_as_float( VAR_IOF, VarRead, &val, 2, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( val, 8.0, 1e-6 );
+
+  vc_reset();
+}
+
+static void derive_lazy(void) {
+  F32 val;
+
+  vc_as_float( VAR_PWR, VarRead, &val, 0, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( val, 0.0, 1e-6 );
+
+  /* not stale: the cached value is returned */
+  *pwr_cache( 0 ) = 123.0f;
+  vc_as_float( VAR_PWR, VarRead, &val, 0, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( val, 123.0, 1e-6 );
+
+  /* another channel or the same value doesn't make it stale */
+  val = 4.0f;
+  vc_as_float( VAR_VOL, VarWrite, &val, 1, REQ_PRG );
+  val = 0.0f;
+  vc_as_float( VAR_CUR, VarWrite, &val, 0, REQ_PRG );
+  vc_as_float( VAR_PWR, VarRead, &val, 0, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( val, 123.0, 1e-6 );
+
+  /* a change of an input is recomputed once, when read */
+  val = 2.0f;
+  vc_as_float( VAR_CUR, VarWrite, &val, 0, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( *pwr_cache( 0 ), 123.0, 1e-6 );
+  vc_as_float( VAR_PWR, VarRead, &val, 0, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( val, 0.0, 1e-6 );
+  *pwr_cache( 0 ) = 7.0f;
+  vc_as_float( VAR_PWR, VarRead, &val, 0, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( val, 7.0, 1e-6 );
+
+  /* vc_reset() makes everything stale */
+  vc_reset();
+  vc_as_float( VAR_PWR, VarRead, &val, 0, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( val, 0.0, 1e-6 );
+}
+
+static void derive_write(void) {
+  VC_TXN   txn;
+  VC_VALUE v;
+  F32      val = 1.0f;
+  F32      vec[2] = { 1.0f, 2.0f };
+  S32      bdk = 1;
+
+  CU_ASSERT_EQUAL( vc_as_float( VAR_PWR, VarWrite, &val, 0, REQ_PRG ), kErrAccessDenied );
+  CU_ASSERT_EQUAL( vc_write_vector( VAR_PWR, 0, 2, vec, REQ_PRG ), kErrAccessDenied );
+  CU_ASSERT_EQUAL( vc_as_int32( VAR_BDK, VarWrite, &bdk, 0, REQ_PRG ), kErrAccessDenied );
+
+  vc_txn_begin( &txn, REQ_PRG );
+  v.f32 = 1.0f;
+  CU_ASSERT_EQUAL( vc_txn_write( &txn, VAR_PWR, 0, &v ), kErrAccessDenied );
+  vc_txn_abort( &txn );
+
+  /* wrong type or channel */
+  CU_ASSERT_EQUAL( vc_as_int32( VAR_PWR, VarRead, &bdk, 0, REQ_PRG ), kErrInvalidType );
+  CU_ASSERT_EQUAL( vc_as_float( VAR_PWR, VarRead, &val, VEC_LEM, REQ_PRG ), kErrInvalidChan );
+}
+
+static void derive_int(void) {
+  HND const hnd[3] = { VAR_TPN, VAR_TPN, VAR_BDK };
+  U16 const chan[3] = { 0, 1, 0 };
+  VC_VALUE  val[3];
+  ErrCode   err[3];
+  S16       tp1;
+  S16       tpn;
+  S32       bdk;
+
+  tp1 = 30;
+  vc_as_int16( VAR_TP1, VarWrite, &tp1, 0, REQ_PRG );
+  tp1 = -80;
+  vc_as_int16( VAR_TP1, VarWrite, &tp1, 1, REQ_PRG );
+  vc_as_int16( VAR_TPN, VarRead, &tpn, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( tpn, -64 );
+
+  /* FLAG_CLIP */
+  tp1 = 60;
+  vc_as_int16( VAR_TP1, VarWrite, &tp1, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( vc_read_many( hnd, chan, val, err, 3, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( val[0].s16, -100 );
+  CU_ASSERT_EQUAL( val[1].s16, 100 );
+
+  /* 500 * 1000 / 3 is rounded */
+  CU_ASSERT_EQUAL( val[2].s32, 166667 );
+  vc_as_int32( VAR_BDK, VarRead, &bdk, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( bdk, 166667 );
+
+  vc_reset();
+}
+
+static void derive_ctx(void) {
+  static double storage[1024];
+  VC_CTX ctx;
+  F32    val;
+
+  CU_ASSERT( vc_ctx_storage_size( &g_var_data ) <= sizeof(storage));
+  CU_ASSERT_EQUAL( vc_ctx_init_storage( &ctx, &g_var_data, storage, sizeof(storage)), kErrNone );
+
+  val = 3.0f;
+  vc_ctx_as_float( &ctx, VAR_VOL, VarWrite, &val, 4, REQ_PRG );
+  vc_ctx_as_float( &ctx, VAR_CUR, VarWrite, &val, 4, REQ_PRG );
+  vc_ctx_as_float( &ctx, VAR_PWR, VarRead, &val, 4, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( val, 9.0, 1e-6 );
+
+  /* the default context is not affected */
+  vc_as_float( VAR_PWR, VarRead, &val, 4, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( val, 0.0, 1e-6 );
+}
+
+#ifdef VC_THREAD_SAFE
+static atomic_int snap_done;
+
+/* takes the write locks of all variables in handle order */
+static void *derive_snap_thread( void *arg ) {
+  void *buf = malloc( vc_snapshot_size() );
+
+  (void) arg;
+  while( atomic_load( &snap_done ) == 0 ) {
+    (void) vc_snapshot( buf );
+  }
+  free( buf );
+  return NULL;
+}
+
+/* computes VAR_PWR while the other thread takes snapshots, this
+ * deadlocked when the inputs were read under the lock of VAR_PWR */
+static void derive_thread(void) {
+  pthread_t tid;
+  F32 val;
+  F32 cur = 2.0f;
+
+  vc_as_float( VAR_CUR, VarWrite, &cur, 0, REQ_PRG );
+  atomic_store( &snap_done, 0 );
+  CU_ASSERT_EQUAL_FATAL( pthread_create( &tid, NULL, derive_snap_thread, NULL ), 0 );
+
+  for( int i = 0; i < 20000; i++ ) {
+    val = (F32)( i % 100 );
+    vc_as_float( VAR_VOL, VarWrite, &val, 0, REQ_PRG );
+    vc_as_float( VAR_PWR, VarRead, &val, 0, REQ_PRG );
+    CU_ASSERT_DOUBLE_EQUAL( val, 2.0 * ( i % 100 ), 1e-3 );
+  }
+
+  atomic_store( &snap_done, 1 );
+  pthread_join( tid, NULL );
+
+  vc_reset();
+}
+#endif
+
+static CU_TestInfo tests_derive[] = {
+  { "Read",                 derive_read },
+  { "Lazy update",          derive_lazy },
+  { "Write",                derive_write },
+  { "Integer types",        derive_int },
+  { "Context",              derive_ctx },
+#ifdef VC_THREAD_SAFE
+  { "Threads",              derive_thread },
+#endif
+	CU_TEST_INFO_NULL,
+};
+
+
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "derived",  suite_init, suite_clean, NULL, NULL, tests_derive },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_derive(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
@@ -109,8 +109,135 @@ static void dump(void) {
   free(buf);
 }
 
+/* writer of vc_dump_all(), collects the output */
+typedef struct {
+  char   buf[16384];
+  size_t len;
+  size_t max;
+  int    calls;
+  int    fail_at;
+} SINK;
+
+static ErrCode sink_write( void *arg, char const *data, size_t len ) {
+  SINK *s = arg;
+
+  s->calls++;
+  if( s->calls == s->fail_at ) {
+    return kErrIO;
+  }
+  if( s->len + len >= sizeof(s->buf) ) {
+    return kErrSizeTooBig;
+  }
+  memcpy( &s->buf[s->len], data, len );
+  s->len += len;
+  s->buf[s->len] = '\0';
+  s->max = ( len > s->max ) ? len : s->max;
+  return kErrNone;
+}
+
+static void dump_all_json(void) {
+  static SINK s;
+  HND hnd[] = { VAR_CO_NODEID, VAR_LOD, VAR_RST };
+  ErrCode ret;
+
+  memset( &s, 0, sizeof(s) );
+  ret = vc_dump_all( sink_write, &s, VC_DUMP_JSON, hnd, 3 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_STRING_EQUAL( s.buf,
+    "[{\"hnd\":14,\"scpi\":\"CO:NODEID\",\"type\":\"TYPE_INT16\",\"storage\":\"EEPROM\","
+      "\"value\":1,\"min\":0,\"max\":127},\n"
+    "{\"hnd\":23,\"scpi\":\"LOD\",\"type\":\"TYPE_ENUM\",\"storage\":\"RAM_VOLATILE\","
+      "\"value\":\"SYM_OFF\"},\n"
+    "{\"hnd\":4,\"scpi\":\"RST\",\"type\":\"TYPE_ACTION\",\"storage\":\"RAM_VOLATILE\"}]\n" );
+
+  /* vectors, strings are escaped, nan is null */
+  F64 frq = 0.0 / 0.0;
+  STRBUF S;
+
+  vc_as_double( VAR_FRQ, VarWrite, &frq, 1, REQ_PRG );
+  strcpy( S, "a\"b\\c\n" );
+  vc_as_string( VAR_NAS, VarWrite, S, 1, REQ_PRG );
+
+  memset( &s, 0, sizeof(s) );
+  hnd[0] = VAR_FRQ;
+  hnd[1] = VAR_NAS;
+  ret = vc_dump_all( sink_write, &s, VC_DUMP_JSON, hnd, 2 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_PTR_NOT_NULL( strstr( s.buf, "\"value\":[50,null],\"min\":[0,0],\"max\":[1000000,1000000]}" ));
+  CU_ASSERT_PTR_NOT_NULL( strstr( s.buf, "\"value\":[\"192.168.2.10\",\"a\\\"b\\\\c\\u000a\"]}" ));
+
+  vc_reset();
+}
+
+static void dump_all_text(void) {
+  static SINK s;
+  HND hnd[] = { VAR_CAN_ERR, VAR_CUR, VAR_IDN };
+  S32 err = 0x12345;
+  F32 cur = 1.25f;
+  ErrCode ret;
+
+  vc_as_int32( VAR_CAN_ERR, VarWrite, &err, 0, REQ_PRG );
+  vc_as_float( VAR_CUR, VarWrite, &cur, 7, REQ_PRG );
+
+  memset( &s, 0, sizeof(s) );
+  ret = vc_dump_all( sink_write, &s, VC_DUMP_TEXT, hnd, 3 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_PTR_NOT_NULL( strstr( s.buf, "CAN:ERR (0x10) TYPE_INT32 RAM_VOLATILE\n  0: 0x12345 [0, 0]\n" ));
+  CU_ASSERT_PTR_NOT_NULL( strstr( s.buf, "CUR (0x5) TYPE_FLOAT RAM_VOLATILE\n  0: 0.0 [-1000.0, 1000.0]\n" ));
+  CU_ASSERT_PTR_NOT_NULL( strstr( s.buf, "  7: 1.2 [-1000.0, 1000.0]\n" ));
+  CU_ASSERT_PTR_NOT_NULL( strstr( s.buf, "IDN (0) TYPE_STRING RAM_VOLATILE\n  0: Test application" ));
+
+  vc_reset();
+}
+
+static void dump_all_chunk(void) {
+  static SINK s;
+  static char one[16384];
+  size_t len = 0;
+  ErrCode ret;
+
+  /* all variables, the same output as one by one */
+  memset( &s, 0, sizeof(s) );
+  ret = vc_dump_all( sink_write, &s, VC_DUMP_TEXT, NULL, 0 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT( s.calls > 1 );
+  CU_ASSERT_EQUAL( s.max, VC_DUMP_CHUNK );
+
+  for( HND h = 0; h < g_var_data.var_cnt; h++ ) {
+    static SINK t;
+
+    memset( &t, 0, sizeof(t) );
+    ret = vc_dump_all( sink_write, &t, VC_DUMP_TEXT, &h, 1 );
+    CU_ASSERT_EQUAL( ret, kErrNone );
+    memcpy( &one[len], t.buf, t.len );
+    len += t.len;
+  }
+  CU_ASSERT_EQUAL( len, s.len );
+  CU_ASSERT_EQUAL( memcmp( one, s.buf, len ), 0 );
+
+  /* an error of the writer stops the dump */
+  memset( &s, 0, sizeof(s) );
+  s.fail_at = 2;
+  ret = vc_dump_all( sink_write, &s, VC_DUMP_JSON, NULL, 0 );
+  CU_ASSERT_EQUAL( ret, kErrIO );
+  CU_ASSERT_EQUAL( s.calls, 2 );
+  CU_ASSERT_EQUAL( s.len, VC_DUMP_CHUNK );
+
+  /* invalid arguments, nothing is written */
+  HND bad[] = { VAR_LOD, 0x7fff };
+
+  memset( &s, 0, sizeof(s) );
+  CU_ASSERT_EQUAL( vc_dump_all( sink_write, &s, VC_DUMP_JSON, bad, 2 ), kErrUnknownCmd );
+  CU_ASSERT_EQUAL( vc_dump_all( sink_write, &s, 2, NULL, 0 ), kErrInvalidArg );
+  CU_ASSERT_EQUAL( vc_dump_all( NULL, &s, VC_DUMP_TEXT, NULL, 0 ), kErrInvalidArg );
+  CU_ASSERT_EQUAL( s.calls, 0 );
+}
+
 static CU_TestInfo tests_dump[] = {
   { "Dump variables", dump },
+  { "Dump JSON", dump_all_json },
+  { "Dump text", dump_all_text },
+  { "Dump in chunks", dump_all_chunk },
 	CU_TEST_INFO_NULL,
 };
 
@@ -147,6 +147,130 @@ static void wr_enum_invalid(void) {
   CU_ASSERT_EQUAL( YNU, -1 );
 }
 
+static void wr_enum_gap(void) {
+  static S16 const valid[] = { -20, 3, 17 };
+  static S16 const invalid[] = { -21, -19, 0, 2, 4, 16, 18, -32768, 32767 };
+  S16 GAP;
+  ErrCode ret;
+
+  for( size_t i = 0; i < countof(valid); i++ ) {
+    GAP = valid[i];
+    ret = vc_as_int16( VAR_GAP, VarWrite, &GAP, 0, REQ_PRG );
+    CU_ASSERT_EQUAL( ret, kErrNone );
+  }
+
+  for( size_t i = 0; i < countof(invalid); i++ ) {
+    GAP = invalid[i];
+    ret = vc_as_int16( VAR_GAP, VarWrite, &GAP, 0, REQ_PRG );
+    CU_ASSERT_EQUAL( ret, kErrInvalidEnum );
+  }
+
+  GAP = 99;
+  ret = vc_as_int16( VAR_GAP, VarRead, &GAP, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( GAP, 17 );
+}
+
+static void wr_enum_wide(void) {
+  S16 WID;
+  ErrCode ret;
+
+  /* the values span more than VC_ENUM_SET_MAX, no bitmap */
+  WID = 5000;
+  ret = vc_as_int16( VAR_WID, VarWrite, &WID, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  WID = 0;
+  ret = vc_as_int16( VAR_WID, VarWrite, &WID, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidEnum );
+
+  WID = -5000;
+  ret = vc_as_int16( VAR_WID, VarWrite, &WID, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  WID = 99;
+  ret = vc_as_int16( VAR_WID, VarRead, &WID, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( WID, -5000 );
+}
+
+static void rd_enum_symbol(void) {
+  STRBUF buf;
+  char const *sym;
+  S16 LOD;
+  ErrCode ret;
+
+  LOD = 1;
+  ret = vc_as_int16( VAR_LOD, VarWrite, &LOD, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_string( VAR_LOD, VarRead, buf, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_STRING_EQUAL( buf, "SYM_ON" );
+
+  ret = vc_enum_symbol( VAR_YNU, -1, &sym );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_STRING_EQUAL( sym, "SYM_SEMI" );
+
+  ret = vc_enum_symbol( VAR_YNU, 5, &sym );
+  CU_ASSERT_EQUAL( ret, kErrInvalidEnum );
+
+  ret = vc_enum_symbol( VAR_TP1, 0, &sym );
+  CU_ASSERT_EQUAL( ret, kErrInvalidType );
+
+  /* members without a symbol read as number */
+  ret = vc_as_string( VAR_XON, VarRead, buf, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_STRING_EQUAL( buf, "1" );
+}
+
+static void wr_enum_symbol(void) {
+  STRBUF buf;
+  S16 val;
+  ErrCode ret;
+
+  ret = vc_enum_value( VAR_GAP, "SYM_SEMI", &val );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( val, 3 );
+
+  ret = vc_enum_value( VAR_GAP, "SYM_ON", &val );
+  CU_ASSERT_EQUAL( ret, kErrInvalidEnum );
+
+  strcpy( buf, "SYM_AUTO" );
+  ret = vc_as_string( VAR_YNU, VarWrite, buf, 3, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  val = 99;
+  ret = vc_as_int16( VAR_YNU, VarRead, &val, 3, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( val, -2 );
+
+  strcpy( buf, "SYM_MANU" );
+  ret = vc_as_string( VAR_YNU, VarWrite, buf, 3, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_string( VAR_YNU, VarRead, buf, 3, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_STRING_EQUAL( buf, "SYM_MANU" );
+
+  /* numbers are accepted too */
+  strcpy( buf, "-1" );
+  ret = vc_as_string( VAR_YNU, VarWrite, buf, 3, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_string( VAR_YNU, VarRead, buf, 3, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_STRING_EQUAL( buf, "SYM_SEMI" );
+
+  strcpy( buf, "SYM_ON" );
+  ret = vc_as_string( VAR_YNU, VarWrite, buf, 3, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidEnum );
+
+  strcpy( buf, "5" );
+  ret = vc_as_string( VAR_YNU, VarWrite, buf, 3, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidEnum );
+
+  ret = vc_as_string( VAR_YNU, VarRead, buf, 3, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_STRING_EQUAL( buf, "SYM_SEMI" );
+}
+
 static void get_storage_enum(void) {
   ErrCode ret;
   U16     storage;
@@ -173,6 +297,10 @@ static CU_TestInfo tests_rdwr_enum[] = {
   { "RD ENUM", rd_enum },
   { "WR ENUM", wr_enum },
   { "WR ENUM (invalid value)", wr_enum_invalid },
+  { "WR ENUM (sparse values)", wr_enum_gap },
+  { "WR ENUM (wide values)", wr_enum_wide },
+  { "RD ENUM (symbol)", rd_enum_symbol },
+  { "WR ENUM (symbol)", wr_enum_symbol },
   { "WR get_storage", get_storage_enum },
 	CU_TEST_INFO_NULL,
 };
@@ -0,0 +1,179 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+#include "test_utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* WARNING - MAINTENANCE NIGHTMARE AHEAD
+ *
+ * If you change any of the tests & suites below, you also need
+ * to keep track of changes in the result statistics and reflect
+ * any changes in the result report counts in print_example_results().
+ *
+ * Yes, this could have been designed better using a more
+ * automated mechanism.  No, it was not done that way.
+ */
+
+#include <varcore.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** double tests ***********************************************************/
+static void rdwr_f64(void)
+{
+  F64 frq = 1.0;
+  ErrCode ret;
+
+  ret = vc_as_double( VAR_FRQ, VarRead, &frq, 1, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT( frq == 50.0 );
+
+  frq = 0.1;
+  ret = vc_as_double( VAR_FRQ, VarWrite, &frq, 1, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  frq = 0;
+  ret = vc_as_double( VAR_FRQ, VarRead, &frq, 1, REQ_PRG );
+  CU_ASSERT( frq == 0.1 );
+
+  ret = vc_as_double( VAR_FRQ, VarRead, &frq, VEC_ETH, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidChan );
+}
+
+static void wr_f64_clip(void)
+{
+  F64 frq;
+  ErrCode ret;
+
+  frq = 2e6;
+  ret = vc_as_double( VAR_FRQ, VarWrite, &frq, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_double( VAR_FRQ, VarRead, &frq, 0, REQ_PRG );
+  CU_ASSERT( frq == 1e6 );
+
+  frq = -1e-300;
+  ret = vc_as_double( VAR_FRQ, VarWrite, &frq, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_double( VAR_FRQ, VarRead, &frq, 0, REQ_PRG );
+  CU_ASSERT( frq == 0.0 );
+}
+
+static void as_str_f64(void)
+{
+  ErrCode ret;
+  STRBUF S;
+  F64 frq;
+
+  strcpy( S, "50.000000000000007" );
+  ret = vc_as_string( VAR_FRQ, VarWrite, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_double( VAR_FRQ, VarRead, &frq, 0, REQ_PRG );
+  CU_ASSERT( frq == 50.000000000000007 );
+  CU_ASSERT( frq != 50.0 );
+  ret = vc_as_string( VAR_FRQ, VarRead, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_STRING_EQUAL( S, "50.00000000000001" );
+
+  strcpy( S, "1e309" );
+  ret = vc_as_string( VAR_FRQ, VarWrite, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidValue );
+}
+
+static void min_max_f64(void)
+{
+  F64 Max;
+  F64 Mx;
+  ErrCode ret;
+
+  ret = vc_get_max( VAR_FRQ, (U8*)&Max, 1 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT( Max == 1e6 );
+
+  Mx = 60.5;
+  ret = vc_set_max( VAR_FRQ, (U8*)&Mx, 1 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  Mx = 61.0;
+  ret = vc_as_double( VAR_FRQ, VarWrite, &Mx, 1, REQ_PRG );
+  ret = vc_as_double( VAR_FRQ, VarRead, &Mx, 1, REQ_PRG );
+  CU_ASSERT( Mx == 60.5 );
+
+  vc_reset();
+}
+
+static CU_TestInfo tests_rdwr_f64[] = {
+  { "F64, RD/WR",        rdwr_f64 },
+  { "F64, WR clip",      wr_f64_clip },
+  { "F64, AS string",    as_str_f64 },
+  { "F64, SET MIN/MAX",  min_max_f64 },
+	CU_TEST_INFO_NULL,
+};
+
+
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "variable F64",  suite_init, suite_clean, NULL, NULL, tests_rdwr_f64 },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_f64(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
@@ -0,0 +1,357 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <varcore.h>
+#include <vcfile.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** flush tests ************************************************************/
+
+/* backend in memory, eg. an EEPROM */
+typedef struct _MEM {
+  U8      img[8192];
+  int     writes;
+  int     syncs;
+  HND     first[16];
+  ErrCode err;
+} MEM;
+
+static ErrCode mem_write( void *arg, HND hnd, U32 offs, void const *data, size_t size ) {
+  MEM *m = (MEM*) arg;
+
+  if( m->err != kErrNone ) {
+    return m->err;
+  }
+  CU_ASSERT( offs + size <= sizeof(m->img) );
+  memcpy( &m->img[offs], data, size );
+  if( hnd != HNON ) {
+    m->first[m->writes % 16] = hnd;
+    m->writes++;
+  }
+  return kErrNone;
+}
+
+static ErrCode mem_read( void *arg, HND hnd, U32 offs, void *data, size_t size ) {
+  MEM *m = (MEM*) arg;
+  (void) hnd;
+
+  memcpy( data, &m->img[offs], size );
+  return kErrNone;
+}
+
+static ErrCode mem_sync( void *arg ) {
+  MEM *m = (MEM*) arg;
+
+  m->syncs++;
+  return kErrNone;
+}
+
+static MEM s_mem;
+static VC_BACKEND s_be = { mem_write, mem_read, mem_sync, &s_mem };
+
+/* defaults in the backend, nothing dirty */
+static void mem_clean(void) {
+  vc_reset();
+  vc_flush( EEPROM, &s_be );
+  vc_flush( FLASH, &s_be );
+  memset( &s_mem, 0, sizeof(s_mem) );
+}
+
+static void flush_dirty(void) {
+  ErrCode ret;
+  S16     n16;
+  F32     f;
+
+  // after a reset all variables are dirty
+  vc_reset();
+  CU_ASSERT_EQUAL( vc_is_dirty( EEPROM ), 1 );
+  CU_ASSERT_EQUAL( vc_is_dirty( FLASH ), 1 );
+
+  mem_clean();
+  CU_ASSERT_EQUAL( vc_is_dirty( EEPROM ), 0 );
+  CU_ASSERT_EQUAL( vc_flush( EEPROM, &s_be ), kErrNone );
+  CU_ASSERT_EQUAL( s_mem.writes, 0 );
+  CU_ASSERT_EQUAL( s_mem.syncs, 0 );
+
+  // volatile variables are not tracked
+  f = 1.0f;
+  ret = vc_as_float( VAR_VOL, VarWrite, &f, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( vc_is_dirty( EEPROM ), 0 );
+  CU_ASSERT_EQUAL( vc_is_dirty( FLASH ), 0 );
+
+  // a burst of writes is one write of the backend
+  for( n16 = 2; n16 < 20; n16++ ) {
+    ret = vc_as_int16( VAR_CO_NODEID, VarWrite, &n16, 0, REQ_PRG );
+  }
+  CU_ASSERT_EQUAL( vc_is_dirty( EEPROM ), 1 );
+  CU_ASSERT_EQUAL( vc_is_dirty( FLASH ), 0 );
+
+  CU_ASSERT_EQUAL( vc_flush( FLASH, &s_be ), kErrNone );
+  CU_ASSERT_EQUAL( s_mem.writes, 0 );
+  CU_ASSERT_EQUAL( vc_flush( EEPROM, &s_be ), kErrNone );
+  CU_ASSERT_EQUAL( s_mem.writes, 1 );
+  CU_ASSERT_EQUAL( s_mem.first[0], VAR_CO_NODEID );
+  CU_ASSERT_EQUAL( s_mem.syncs, 1 );
+  CU_ASSERT_EQUAL( vc_is_dirty( EEPROM ), 0 );
+
+  CU_ASSERT_EQUAL( vc_flush( EEPROM, &s_be ), kErrNone );
+  CU_ASSERT_EQUAL( s_mem.writes, 1 );
+
+  // unchanged values are not written
+  n16 = 19;
+  ret = vc_as_int16( VAR_CO_NODEID, VarWrite, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( vc_is_dirty( EEPROM ), 0 );
+
+  CU_ASSERT_EQUAL( vc_flush( RAM_VOLATILE, &s_be ), kErrInvalidArg );
+  CU_ASSERT_EQUAL( vc_flush( EEPROM, NULL ), kErrInvalidArg );
+}
+
+static void flush_coalesce(void) {
+  ErrCode ret;
+  S16     n16;
+  STRBUF  s;
+
+  mem_clean();
+
+  // adjacent handles and values
+  n16 = 3;
+  ret = vc_as_int16( VAR_CO_NODEID, VarWrite, &n16, 0, REQ_PRG );
+  n16 = 250;
+  ret = vc_as_int16( VAR_CAN_BAUD, VarWrite, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  CU_ASSERT_EQUAL( vc_flush( EEPROM, &s_be ), kErrNone );
+  CU_ASSERT_EQUAL( s_mem.writes, 1 );
+
+  // not adjacent
+  n16 = 4;
+  ret = vc_as_int16( VAR_CO_NODEID, VarWrite, &n16, 0, REQ_PRG );
+  memset( s, 0, sizeof(s) );
+  strcpy( s, "10.0.0.1" );
+  ret = vc_as_string( VAR_UAS, VarWrite, s, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( vc_is_dirty( FLASH ), 1 );
+  CU_ASSERT_EQUAL( vc_flush( EEPROM, &s_be ), kErrNone );
+  CU_ASSERT_EQUAL( vc_flush( FLASH, &s_be ), kErrNone );
+  CU_ASSERT_EQUAL( s_mem.writes, 3 );
+  CU_ASSERT_EQUAL( s_mem.first[2], VAR_UAS );
+
+  vc_reset();
+}
+
+static void flush_load(void) {
+  ErrCode ret;
+  S16     n16;
+  F32     f;
+  STRBUF  s;
+
+  mem_clean();
+
+  // nothing flushed
+  CU_ASSERT_EQUAL( vc_load( EEPROM, &s_be ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_load( RAM_VOLATILE, &s_be ), kErrInvalidArg );
+
+  n16 = 7;
+  ret = vc_as_int16( VAR_CO_NODEID, VarWrite, &n16, 0, REQ_PRG );
+  f = -123.5f;
+  ret = vc_as_float( VAR_CUR_NMAX, VarWrite, &f, 1, REQ_PRG );
+  f = 12.5f;
+  ret = vc_as_float( VAR_VOL, VarWrite, &f, 0, REQ_PRG );
+  memset( s, 0, sizeof(s) );
+  strcpy( s, "10.0.0.2" );
+  ret = vc_as_string( VAR_UAS, VarWrite, s, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( vc_flush( EEPROM, &s_be ), kErrNone );
+  CU_ASSERT_EQUAL( vc_flush( FLASH, &s_be ), kErrNone );
+
+  vc_reset();
+  CU_ASSERT_EQUAL( vc_is_dirty( EEPROM ), 1 );
+  ret = vc_load( EEPROM, &s_be );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( vc_is_dirty( EEPROM ), 0 );
+  CU_ASSERT_EQUAL( vc_is_dirty( FLASH ), 1 );
+
+  ret = vc_as_int16( VAR_CO_NODEID, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 7 );
+  ret = vc_as_float( VAR_CUR_NMAX, VarRead, &f, 1, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( f, -123.5, 0.001 );
+  ret = vc_as_float( VAR_VOL, VarRead, &f, 0, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( f, 0.0, 0.001 );
+  ret = vc_as_string( VAR_UAS, VarRead, s, 0, REQ_PRG );
+  CU_ASSERT_STRING_EQUAL( s, "192.168.2.11" );
+
+  ret = vc_load( FLASH, &s_be );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_string( VAR_UAS, VarRead, s, 0, REQ_PRG );
+  CU_ASSERT_STRING_EQUAL( s, "10.0.0.2" );
+
+  // other table
+  ((U32*) s_mem.img)[1] ^= 1u;
+  CU_ASSERT_EQUAL( vc_load( EEPROM, &s_be ), kErrLayout );
+
+  vc_reset();
+}
+
+static void flush_class(void) {
+  S16 n16;
+
+  vc_reset();
+  memset( &s_mem, 0, sizeof(s_mem) );
+
+  // the FLASH part of the image was never written
+  CU_ASSERT_EQUAL( vc_flush( EEPROM, &s_be ), kErrNone );
+  CU_ASSERT_EQUAL( vc_load( FLASH, &s_be ), kErrEmpty );
+  CU_ASSERT_EQUAL( vc_is_dirty( FLASH ), 1 );
+  CU_ASSERT_EQUAL( vc_load( EEPROM, &s_be ), kErrNone );
+
+  // a flush of FLASH keeps EEPROM in the header
+  CU_ASSERT_EQUAL( vc_flush( FLASH, &s_be ), kErrNone );
+  CU_ASSERT_EQUAL( vc_load( FLASH, &s_be ), kErrNone );
+  n16 = 5;
+  vc_as_int16( VAR_CO_NODEID, VarWrite, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( vc_flush( EEPROM, &s_be ), kErrNone );
+  CU_ASSERT_EQUAL( vc_load( FLASH, &s_be ), kErrNone );
+  CU_ASSERT_EQUAL( vc_load( EEPROM, &s_be ), kErrNone );
+
+  vc_reset();
+}
+
+static void flush_error(void) {
+  S16 n16;
+
+  mem_clean();
+
+  n16 = 9;
+  vc_as_int16( VAR_CO_NODEID, VarWrite, &n16, 0, REQ_PRG );
+  s_mem.err = kErrIO;
+  CU_ASSERT_EQUAL( vc_flush( EEPROM, &s_be ), kErrIO );
+  CU_ASSERT_EQUAL( s_mem.syncs, 0 );
+  CU_ASSERT_EQUAL( vc_is_dirty( EEPROM ), 1 );
+
+  s_mem.err = kErrNone;
+  CU_ASSERT_EQUAL( vc_flush( EEPROM, &s_be ), kErrNone );
+  CU_ASSERT_EQUAL( s_mem.writes, 1 );
+  CU_ASSERT_EQUAL( vc_is_dirty( EEPROM ), 0 );
+
+  vc_reset();
+}
+
+static void flush_file(void) {
+  char const *path = "test_flush.bin";
+  VC_FILE     f;
+  VC_BACKEND  be;
+  ErrCode     ret;
+  S16         n16;
+
+  remove( path );
+  vc_reset();
+
+  ret = vc_file_open( &f, &be, path );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  if( ret != kErrNone ) {
+    return;
+  }
+  CU_ASSERT_EQUAL( vc_load( EEPROM, &be ), kErrEmpty );
+
+  n16 = 99;
+  vc_as_int16( VAR_CAN_BAUD, VarWrite, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( vc_flush( EEPROM, &be ), kErrNone );
+  CU_ASSERT_EQUAL( vc_file_close( &f ), kErrNone );
+
+  vc_reset();
+  ret = vc_file_open( &f, &be, path );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  if( ret != kErrNone ) {
+    return;
+  }
+  CU_ASSERT_EQUAL( vc_load( EEPROM, &be ), kErrNone );
+  vc_as_int16( VAR_CAN_BAUD, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 99 );
+  CU_ASSERT_EQUAL( vc_load( FLASH, &be ), kErrEmpty );
+  CU_ASSERT_EQUAL( vc_file_close( &f ), kErrNone );
+
+  remove( path );
+  vc_reset();
+}
+
+static CU_TestInfo tests_flush[] = {
+  { "Flush dirty",        flush_dirty },
+  { "Flush coalesce",     flush_coalesce },
+  { "Flush load",         flush_load },
+  { "Flush class",        flush_class },
+  { "Flush error",        flush_error },
+  { "Flush file",         flush_file },
+	CU_TEST_INFO_NULL,
+};
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "flush",  suite_init, suite_clean, NULL, NULL, tests_flush },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_flush(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
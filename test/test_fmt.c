@@ -0,0 +1,268 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <varcore.h>
+#include <vcconv.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** format tests ***********************************************************/
+
+static U32 s_rnd = 1;
+
+static U32 rnd(void) {
+  s_rnd ^= s_rnd << 13;
+  s_rnd ^= s_rnd >> 17;
+  s_rnd ^= s_rnd << 5;
+  return s_rnd;
+}
+
+static void fmt_int(void) {
+  char a[16];
+  char b[16];
+  int  len;
+
+  len = vc_fmt_s32( a, 0 );
+  CU_ASSERT_EQUAL( len, 1 );
+  CU_ASSERT_STRING_EQUAL( a, "0" );
+  vc_fmt_s32( a, -2147483647 - 1 );
+  CU_ASSERT_STRING_EQUAL( a, "-2147483648" );
+
+  vc_fmt_hex( a, 0 );
+  CU_ASSERT_STRING_EQUAL( a, "0" );
+  vc_fmt_hex( a, 0x80 );
+  CU_ASSERT_STRING_EQUAL( a, "0x80" );
+  len = vc_fmt_hex( a, 0xffffffffu );
+  CU_ASSERT_EQUAL( len, 10 );
+  CU_ASSERT_STRING_EQUAL( a, "0xffffffff" );
+
+  for( int i = 0; i < 10000; i++ ) {
+    S32 n = (S32) rnd() >> ( rnd() % 32 );
+    vc_fmt_s32( a, n );
+    sprintf( b, "%d", n );
+    CU_ASSERT_STRING_EQUAL( a, b );
+    vc_fmt_hex( a, (U32) n );
+    sprintf( b, "%#x", (U32) n );
+    CU_ASSERT_STRING_EQUAL( a, b );
+  }
+}
+
+static void fmt_float(void) {
+  char a[sizeof(STRBUF)];
+  char b[64];
+
+  vc_fmt_f32( a, 0.1f, FMT_DEFAULT );
+  CU_ASSERT_STRING_EQUAL( a, "0.1" );
+  vc_fmt_f32( a, 100.0f, FMT_DEFAULT );
+  CU_ASSERT_STRING_EQUAL( a, "100" );
+  vc_fmt_f32( a, -0.00125f, FMT_DEFAULT );
+  CU_ASSERT_STRING_EQUAL( a, "-0.00125" );
+  vc_fmt_f32( a, 1e9f, FMT_DEFAULT );
+  CU_ASSERT_STRING_EQUAL( a, "1e+09" );
+  vc_fmt_f32( a, 3.4028235e38f, FMT_DEFAULT );
+  CU_ASSERT_STRING_EQUAL( a, "3.4028235e+38" );
+  vc_fmt_f32( a, 1500.0f, FMT_SCI );
+  CU_ASSERT_STRING_EQUAL( a, "1.5e+03" );
+  vc_fmt_f32( a, 0.0f, FMT_SCI );
+  CU_ASSERT_STRING_EQUAL( a, "0" );
+
+  vc_fmt_f32( a, 0.05f, FMT_PREC_1 );
+  CU_ASSERT_STRING_EQUAL( a, "0.1" );
+  vc_fmt_f32( a, -2.5f, FMT_PREC_3 );
+  CU_ASSERT_STRING_EQUAL( a, "-2.500" );
+  vc_fmt_f32( a, 1e20f, FMT_PREC_2 );
+  CU_ASSERT_STRING_EQUAL( a, "1e+20" );
+
+  for( int i = 0; i < 10000; i++ ) {
+    U32 bits = rnd();
+    F32 f;
+    U16 prec = (U16)( FMT_PREC_1 + i % 4 );
+
+    memcpy( &f, &bits, sizeof(f) );
+    if( f != f ) {
+      continue;
+    }
+
+    // shortest, reads back to the same number
+    vc_fmt_f32( a, f, FMT_DEFAULT );
+    CU_ASSERT( strtof( a, NULL ) == f );
+
+    // fixed precision, like printf
+    f = (F32)((S32)( rnd() % 2000000u ) - 1000000 ) / (F32)( 1u + rnd() % 1000u );
+    vc_fmt_f32( a, f, prec );
+    sprintf( b, "%.*f", prec, f );
+    CU_ASSERT_STRING_EQUAL( a, b );
+  }
+}
+
+static void fmt_int64(void) {
+  char a[sizeof(STRBUF)];
+  char b[sizeof(STRBUF)];
+  int  len;
+
+  len = vc_fmt_s64( a, 0 );
+  CU_ASSERT_EQUAL( len, 1 );
+  CU_ASSERT_STRING_EQUAL( a, "0" );
+  len = vc_fmt_s64( a, -9223372036854775807LL - 1 );
+  CU_ASSERT_EQUAL( len, 20 );
+  CU_ASSERT_STRING_EQUAL( a, "-9223372036854775808" );
+  vc_fmt_s64( a, 9223372036854775807LL );
+  CU_ASSERT_STRING_EQUAL( a, "9223372036854775807" );
+
+  for( int i = 0; i < 10000; i++ ) {
+    S64 n = (S64)((( (U64) rnd() << 32 ) | rnd() ) >> ( rnd() % 64 ));
+    if(( i & 1 ) != 0 ) {
+      n = -n;
+    }
+    vc_fmt_s64( a, n );
+    sprintf( b, "%lld", n );
+    CU_ASSERT_STRING_EQUAL( a, b );
+  }
+}
+
+static void fmt_double(void) {
+  char a[sizeof(STRBUF)];
+  char b[64];
+
+  vc_fmt_f64( a, 0.1, FMT_DEFAULT );
+  CU_ASSERT_STRING_EQUAL( a, "0.1" );
+  vc_fmt_f64( a, 50.0, FMT_DEFAULT );
+  CU_ASSERT_STRING_EQUAL( a, "50" );
+  vc_fmt_f64( a, 9007199254740993.0, FMT_DEFAULT );
+  CU_ASSERT_STRING_EQUAL( a, "9.007199254740992e+15" );
+  vc_fmt_f64( a, 1.7976931348623157e308, FMT_DEFAULT );
+  CU_ASSERT_EQUAL( strlen( a ), 23 );
+  CU_ASSERT( strtod( a, NULL ) == 1.7976931348623157e308 );
+  vc_fmt_f64( a, 5e-324, FMT_DEFAULT );
+  CU_ASSERT_STRING_EQUAL( a, "5e-324" );
+  vc_fmt_f64( a, -2.5, FMT_PREC_3 );
+  CU_ASSERT_STRING_EQUAL( a, "-2.500" );
+
+  for( int i = 0; i < 10000; i++ ) {
+    U64 bits = ((U64) rnd() << 32 ) | rnd();
+    F64 f;
+    U16 prec = (U16)( FMT_PREC_1 + i % 4 );
+
+    memcpy( &f, &bits, sizeof(f) );
+    if(( f != f ) || ( f - f != 0.0 )) {
+      continue;
+    }
+
+    // shortest, reads back to the same number
+    vc_fmt_f64( a, f, FMT_DEFAULT );
+    CU_ASSERT( strtod( a, NULL ) == f );
+
+    // fixed precision, like printf
+    f = (F64)((S32)( rnd() % 2000000u ) - 1000000 ) / (F64)( 1u + rnd() % 1000u );
+    vc_fmt_f64( a, f, prec );
+    sprintf( b, "%.*f", prec, f );
+    CU_ASSERT_STRING_EQUAL( a, b );
+  }
+}
+
+static void fmt_as_string(void) {
+  ErrCode ret;
+  STRBUF  S;
+  S16     n16;
+  S32     n32;
+  F32     f;
+
+  n16 = -5;
+  ret = vc_as_int16( VAR_TP1, VarWrite, &n16, 0, REQ_PRG );
+  ret = vc_as_string( VAR_TP1, VarRead, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_STRING_EQUAL( S, "-5" );
+
+  n32 = 0x12345;
+  ret = vc_as_int32( VAR_ERR, VarWrite, &n32, 0, REQ_PRG );
+  ret = vc_as_string( VAR_ERR, VarRead, S, 0, REQ_PRG );
+  CU_ASSERT_STRING_EQUAL( S, "0x12345" );
+
+  f = 12.3456f;
+  ret = vc_as_float( VAR_VOL, VarWrite, &f, 0, REQ_PRG );
+  ret = vc_as_string( VAR_VOL, VarRead, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_STRING_EQUAL( S, "12.346" );
+
+  vc_reset();
+}
+
+static CU_TestInfo tests_fmt[] = {
+  { "Format integers",    fmt_int },
+  { "Format floats",      fmt_float },
+  { "Format int64",       fmt_int64 },
+  { "Format doubles",     fmt_double },
+  { "Format as string",   fmt_as_string },
+	CU_TEST_INFO_NULL,
+};
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "format",  suite_init, suite_clean, NULL, NULL, tests_fmt },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_fmt(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
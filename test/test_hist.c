@@ -0,0 +1,292 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <varcore.h>
+
+#include "vardefs.h"
+#include "varacc.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+
+
+/*** history tests **********************************************************/
+
+static U32 s_now;
+
+static U32 test_clock( void *arg ) {
+  (void) arg;
+  return s_now;
+}
+
+static void write_cur( U16 chan, F32 val ) {
+  CU_ASSERT_EQUAL( vc_as_float( VAR_CUR, VarWrite, &val, chan, REQ_PRG ), kErrNone );
+}
+
+static void hist_samples(void) {
+  VC_HIST_CELL cell[16];
+  U32 got = 99;
+  F32 val;
+
+  vc_init( &g_var_data );
+
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 1, 0, cell, 16, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 0 );
+
+  /* the ring keeps the last 8 samples, oldest first */
+  for( int i = 1; i <= 10; i++ ) {
+    write_cur( 1, (F32) i );
+  }
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 1, 0, cell, 16, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 8 );
+  for( U32 i = 0; i < got; i++ ) {
+    CU_ASSERT_EQUAL( cell[i].ts, i + 2 );
+    CU_ASSERT_DOUBLE_EQUAL( cell[i].mean, i + 3.0, 1e-6 );
+    CU_ASSERT_DOUBLE_EQUAL( cell[i].min, i + 3.0, 1e-6 );
+    CU_ASSERT_DOUBLE_EQUAL( cell[i].max, i + 3.0, 1e-6 );
+  }
+
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 1, 0, cell, 3, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 3 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[0].mean, 8.0, 1e-6 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[2].mean, 10.0, 1e-6 );
+
+  /* an unchanged value is a sample, a rejected one isn't */
+  write_cur( 1, 10.0f );
+  val = 5000.0f;
+  CU_ASSERT_EQUAL( vc_as_float( VAR_CUR, VarWrite, &val, 1, REQ_PRG ), kErrUpperLimit );
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 1, 0, cell, 1, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( cell[0].ts, 10 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[0].mean, 10.0, 1e-6 );
+
+  /* the other channels have their own rings */
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 0, 0, cell, 16, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 0 );
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 1, 0, NULL, 0, NULL, REQ_PRG ), kErrNone );
+}
+
+static void hist_tiers(void) {
+  VC_HIST_CELL cell[8];
+  U32 got;
+
+  vc_init( &g_var_data );
+  vc_set_clock( test_clock, NULL );
+
+  s_now = 1000;
+  write_cur( 2, 1.0f );
+  s_now = 1003;
+  write_cur( 2, 4.0f );
+  s_now = 1007;
+  write_cur( 2, -2.0f );
+
+  /* the open period isn't returned */
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 2, 1, cell, 8, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 0 );
+
+  s_now = 1012;
+  write_cur( 2, 7.0f );
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 2, 0, cell, 8, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 4 );
+  CU_ASSERT_EQUAL( cell[1].ts, 1003 );
+  CU_ASSERT_EQUAL( cell[3].ts, 1012 );
+
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 2, 1, cell, 8, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 1 );
+  CU_ASSERT_EQUAL( cell[0].ts, 1000 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[0].min, -2.0, 1e-6 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[0].max, 4.0, 1e-6 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[0].mean, 1.0, 1e-6 );
+
+  /* a gap doesn't add empty periods */
+  s_now = 1105;
+  write_cur( 2, 3.0f );
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 2, 1, cell, 8, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 2 );
+  CU_ASSERT_EQUAL( cell[1].ts, 1010 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[1].mean, 7.0, 1e-6 );
+
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 2, 2, cell, 8, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 1 );
+  CU_ASSERT_EQUAL( cell[0].ts, 1000 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[0].min, -2.0, 1e-6 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[0].max, 7.0, 1e-6 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[0].mean, 2.5, 1e-6 );
+
+  /* an elapsed period is closed without another sample */
+  s_now = 1130;
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 2, 1, cell, 8, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 3 );
+  CU_ASSERT_EQUAL( cell[2].ts, 1100 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[2].mean, 3.0, 1e-6 );
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 2, 2, cell, 8, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 1 );
+
+  /* the ring of a tier wraps */
+  for( U32 i = 0; i < 6; i++ ) {
+    s_now = 1200 + i * 10;
+    write_cur( 2, (F32) i );
+  }
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 2, 1, cell, 8, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 4 );
+  CU_ASSERT_EQUAL( cell[0].ts, 1210 );
+  CU_ASSERT_EQUAL( cell[3].ts, 1240 );
+
+  vc_set_clock( NULL, NULL );
+}
+
+static void hist_writes(void) {
+  VC_HIST_CELL cell[4];
+  F32 vec[VEC_LEM];
+  S16 tp;
+  U32 got;
+  VC_TXN txn;
+  VC_VALUE v;
+
+  vc_init( &g_var_data );
+
+  /* integer variable, the clipped value is recorded */
+  tp = 200;
+  vc_as_int16( VAR_TP1, VarWrite, &tp, 3, REQ_PRG );
+  CU_ASSERT_EQUAL( vc_history( VAR_TP1, 3, 0, cell, 4, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 1 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[0].mean, 105.0, 1e-6 );
+
+  /* typed accessors, a write of the same value is recorded as well */
+  CU_ASSERT_EQUAL( vc_set_TP1( 5, 42 ), kErrNone );
+  CU_ASSERT_EQUAL( vc_set_TP1( 5, 42 ), kErrNone );
+  CU_ASSERT_EQUAL( vc_history( VAR_TP1, 5, 0, cell, 4, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 2 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[1].mean, 42.0, 1e-6 );
+
+  /* vector writes and transactions */
+  for( int i = 0; i < VEC_LEM; i++ ) {
+    vec[i] = (F32) i + 1.0f;
+  }
+  CU_ASSERT_EQUAL( vc_write_vector( VAR_CUR, 0, VEC_LEM, vec, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 7, 0, cell, 4, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 1 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[0].mean, 8.0, 1e-6 );
+  CU_ASSERT_EQUAL( vc_write_vector( VAR_CUR, 0, VEC_LEM, vec, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 7, 0, cell, 4, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 2 );
+
+  vc_txn_begin( &txn, REQ_PRG );
+  v.f32 = 9.5f;
+  vc_txn_write( &txn, VAR_CUR, 7, &v );
+  CU_ASSERT_EQUAL( vc_txn_commit( &txn, NULL ), kErrNone );
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 7, 0, cell, 4, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 3 );
+  CU_ASSERT_DOUBLE_EQUAL( cell[2].mean, 9.5, 1e-6 );
+}
+
+static void hist_errors(void) {
+  VC_HIST_CELL cell[4];
+  U32 got;
+
+  CU_ASSERT_EQUAL( vc_history( VAR_VOL, 0, 0, cell, 4, &got, REQ_PRG ), kErrInvalidType );
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 0, 3, cell, 4, &got, REQ_PRG ), kErrInvalidArg );
+  CU_ASSERT_EQUAL( vc_history( VAR_TP1, 0, 1, cell, 4, &got, REQ_PRG ), kErrInvalidArg );
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, VEC_LEM, 0, cell, 4, &got, REQ_PRG ), kErrInvalidChan );
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 0, 0, NULL, 4, &got, REQ_PRG ), kErrInvalidArg );
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 0, 0, cell, 4, &got, REQ_EX1 ), kErrAccessDenied );
+  CU_ASSERT_EQUAL( vc_history( 0x7fff, 0, 0, cell, 4, &got, REQ_PRG ), kErrUnknownCmd );
+}
+
+static void hist_ctx(void) {
+  static F64 storage[4096];
+  VC_HIST_CELL cell[4];
+  VC_CTX ctx;
+  F32 val = 3.0f;
+  U32 got;
+
+  vc_init( &g_var_data );
+  CU_ASSERT( vc_ctx_storage_size( &g_var_data ) <= sizeof(storage));
+  CU_ASSERT_EQUAL( vc_ctx_init_storage( &ctx, &g_var_data, storage, sizeof(storage)), kErrNone );
+
+  CU_ASSERT_EQUAL( vc_ctx_as_float( &ctx, VAR_CUR, VarWrite, &val, 0, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( vc_ctx_history( &ctx, VAR_CUR, 0, 0, cell, 4, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 1 );
+  CU_ASSERT_EQUAL( vc_history( VAR_CUR, 0, 0, cell, 4, &got, REQ_PRG ), kErrNone );
+  CU_ASSERT_EQUAL( got, 0 );
+}
+
+
+static CU_TestInfo tests_hist[] = {
+  { "Samples",              hist_samples },
+  { "Tiers",                hist_tiers },
+  { "Writes",               hist_writes },
+  { "Errors",               hist_errors },
+  { "Context",              hist_ctx },
+	CU_TEST_INFO_NULL,
+};
+
+
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "history",  suite_init, suite_clean, NULL, NULL, tests_hist },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_hist(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
@@ -77,8 +77,49 @@ static void get_scpi( void ) {
   CU_ASSERT_EQUAL( hnd, VAR_YON );
 }
 
+static void get_scpi_all( void ) {
+  HND hnd;
+
+  hnd = vc_get_hnd( "CUR:NMAX" );
+  CU_ASSERT_EQUAL( hnd, VAR_CUR_NMAX );
+
+  hnd = vc_get_hnd( "CO:NODEID" );
+  CU_ASSERT_EQUAL( hnd, VAR_CO_NODEID );
+
+  hnd = vc_get_hnd( "CUR:NMA" );
+  CU_ASSERT_EQUAL( hnd, HNON );
+
+  hnd = vc_get_hnd( "XYZ" );
+  CU_ASSERT_EQUAL( hnd, HNON );
+
+  hnd = vc_get_hnd( "" );
+  CU_ASSERT_EQUAL( hnd, HNON );
+
+  // hidden variables have no SCPI string
+  hnd = vc_get_hnd( "---" );
+  CU_ASSERT_EQUAL( hnd, HNON );
+}
+
+static void get_scpi_linear( void ) {
+  VC_DATA data = g_var_data;
+  VC_CTX  ctx;
+
+  // a table without hash table is searched linearly
+  data.scpi_hash_cnt = 0;
+  vc_ctx_init( &ctx, &data );
+
+  CU_ASSERT_EQUAL( vc_ctx_get_hnd( &ctx, "CUR:NMAX" ), VAR_CUR_NMAX );
+  CU_ASSERT_EQUAL( vc_ctx_get_hnd( &ctx, "CUR:NMA" ), HNON );
+  CU_ASSERT_EQUAL( vc_ctx_get_hnd( &ctx, "---" ), HNON );
+  CU_ASSERT_EQUAL( vc_ctx_get_hnd( &ctx, NULL ), HNON );
+
+  vc_init( &g_var_data );
+}
+
 static CU_TestInfo tests_misc[] = {
   { "Get SCPI handle",   get_scpi },
+  { "Get SCPI handle (hash)", get_scpi_all },
+  { "Get SCPI handle (linear)", get_scpi_linear },
 	CU_TEST_INFO_NULL,
 };
 
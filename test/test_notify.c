@@ -0,0 +1,269 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <varcore.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** notification tests *****************************************************/
+
+static int      s_cb_cnt;
+static VC_EVENT s_cb_ev;
+
+static void on_change( VC_EVENT const *ev, void *arg ) {
+  s_cb_cnt += *(int*)arg;
+  s_cb_ev = *ev;
+}
+
+static void ring(void) {
+  VC_RING_CELL cell[4];
+  VC_RING      r;
+  VC_EVENT     ev;
+  ErrCode      ret;
+
+  ret = vc_ring_init( &r, cell, 3 );
+  CU_ASSERT_EQUAL( ret, kErrInvalidArg );
+  ret = vc_ring_init( &r, cell, countof(cell) );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  ret = vc_ring_pop( &r, &ev );
+  CU_ASSERT_EQUAL( ret, kErrEmpty );
+  CU_ASSERT_EQUAL( vc_ring_lost( &r ), 0 );
+}
+
+static void subscribe(void) {
+  VC_RING_CELL cell[4];
+  VC_RING      r;
+  VC_EVENT     ev;
+  ErrCode      ret;
+  S32          n32;
+  F32          f;
+  int          id, id2;
+  int          one = 1;
+
+  vc_ring_init( &r, cell, countof(cell) );
+
+  ret = vc_subscribe( VAR_POW, VC_ALL_CHAN, &r, NULL, NULL, &id );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  n32 = 1234;
+  ret = vc_as_int32( VAR_POW, VarWrite, &n32, 3, REQ_PRG );
+  ret = vc_ring_pop( &r, &ev );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( ev.hnd, VAR_POW );
+  CU_ASSERT_EQUAL( ev.chan, 3 );
+  CU_ASSERT_EQUAL( ev.val.s32, 1234 );
+
+  // unchanged value, rejected value and other variable
+  ret = vc_as_int32( VAR_POW, VarWrite, &n32, 3, REQ_PRG );
+  n32 = 200000;
+  ret = vc_as_int32( VAR_POW, VarWrite, &n32, 3, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrUpperLimit );
+  ret = vc_as_int32( VAR_PAB, VarWrite, &n32, 3, REQ_PRG );
+  ret = vc_ring_pop( &r, &ev );
+  CU_ASSERT_EQUAL( ret, kErrEmpty );
+
+  // full ring
+  for( n32 = 1; n32 <= 6; n32++ ) {
+    ret = vc_as_int32( VAR_POW, VarWrite, &n32, 0, REQ_PRG );
+  }
+  CU_ASSERT_EQUAL( vc_ring_lost( &r ), 2 );
+  ret = vc_ring_pop( &r, &ev );
+  CU_ASSERT_EQUAL( ev.val.s32, 1 );
+
+  ret = vc_unsubscribe( id );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_unsubscribe( id );
+  CU_ASSERT_EQUAL( ret, kErrInvalidArg );
+
+  // callback for one channel
+  s_cb_cnt = 0;
+  ret = vc_subscribe( VAR_CUR, 2, NULL, on_change, &one, &id2 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  f = 5.5f;
+  ret = vc_as_float( VAR_CUR, VarWrite, &f, 1, REQ_PRG );
+  ret = vc_as_float( VAR_CUR, VarWrite, &f, 2, REQ_PRG );
+  CU_ASSERT_EQUAL( s_cb_cnt, 1 );
+  CU_ASSERT_EQUAL( s_cb_ev.chan, 2 );
+  CU_ASSERT_DOUBLE_EQUAL( s_cb_ev.val.f32, 5.5, 0.001 );
+  vc_unsubscribe( id2 );
+
+  ret = vc_subscribe( VAR_CUR, 8, NULL, on_change, &one, NULL );
+  CU_ASSERT_EQUAL( ret, kErrInvalidChan );
+  ret = vc_subscribe( VAR_CUR, 0, NULL, NULL, NULL, NULL );
+  CU_ASSERT_EQUAL( ret, kErrInvalidArg );
+  ret = vc_subscribe( VAR_RST, 0, &r, NULL, NULL, NULL );
+  CU_ASSERT_EQUAL( ret, kErrInvalidType );
+}
+
+static void sub_string(void) {
+  VC_RING_CELL cell[2];
+  VC_RING      r;
+  VC_EVENT     ev;
+  ErrCode      ret;
+  STRBUF       s;
+
+  vc_ring_init( &r, cell, countof(cell) );
+  ret = vc_subscribe( VAR_NAS, 1, &r, NULL, NULL, NULL );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  strcpy( s, "10.0.0.1" );
+  ret = vc_as_string( VAR_NAS, VarWrite, s, 1, REQ_PRG );
+  ret = vc_ring_pop( &r, &ev );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( ev.hnd, VAR_NAS );
+  CU_ASSERT_EQUAL( ev.chan, 1 );
+}
+
+static void sub_wide(void) {
+  VC_RING_CELL cell[4];
+  VC_RING      r;
+  VC_EVENT     ev;
+  ErrCode      ret;
+  S8           n8;
+  S64          n64;
+  F64          d;
+  int          id[3];
+
+  vc_ring_init( &r, cell, countof(cell) );
+  ret = vc_subscribe( VAR_FLG, 2, &r, NULL, NULL, &id[0] );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_subscribe( VAR_CNT, 0, &r, NULL, NULL, &id[1] );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_subscribe( VAR_FRQ, VC_ALL_CHAN, &r, NULL, NULL, &id[2] );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  n8 = -7;
+  ret = vc_as_int8( VAR_FLG, VarWrite, &n8, 2, REQ_PRG );
+  ret = vc_ring_pop( &r, &ev );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( ev.hnd, VAR_FLG );
+  CU_ASSERT_EQUAL( ev.chan, 2 );
+  CU_ASSERT_EQUAL( ev.val.s8, -7 );
+
+  // beyond the 53 bit of a double
+  n64 = 9007199254740993LL;
+  ret = vc_as_int64( VAR_CNT, VarWrite, &n64, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_ring_pop( &r, &ev );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( ev.hnd, VAR_CNT );
+  CU_ASSERT( ev.val.s64 == 9007199254740993LL );
+
+  // the clipped value is sent
+  d = 2e6;
+  ret = vc_as_double( VAR_FRQ, VarWrite, &d, 1, REQ_PRG );
+  ret = vc_ring_pop( &r, &ev );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( ev.hnd, VAR_FRQ );
+  CU_ASSERT_EQUAL( ev.chan, 1 );
+  CU_ASSERT_DOUBLE_EQUAL( ev.val.f64, 1e6, 1e-9 );
+
+  // unchanged value
+  ret = vc_as_double( VAR_FRQ, VarWrite, &d, 1, REQ_PRG );
+  ret = vc_ring_pop( &r, &ev );
+  CU_ASSERT_EQUAL( ret, kErrEmpty );
+
+  for( int i = 0; i < 3; i++ ) {
+    vc_unsubscribe( id[i] );
+  }
+}
+
+static void sub_full(void) {
+  ErrCode ret = kErrNone;
+  int     one = 1;
+  int     i;
+
+  vc_init(&g_var_data);
+  for( i = 0; (i < VC_MAX_SUB) && (ret == kErrNone); i++ ) {
+    ret = vc_subscribe( VAR_VOL, 0, NULL, on_change, &one, NULL );
+  }
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_subscribe( VAR_VOL, 0, NULL, on_change, &one, NULL );
+  CU_ASSERT_EQUAL( ret, kErrFull );
+
+  vc_init(&g_var_data);
+  ret = vc_subscribe( VAR_VOL, 0, NULL, on_change, &one, NULL );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  vc_init(&g_var_data);
+}
+
+static CU_TestInfo tests_notify[] = {
+  { "Event ring",         ring },
+  { "Subscribe",          subscribe },
+  { "Subscribe string",   sub_string },
+  { "Subscribe 8/64 bit", sub_wide },
+  { "Subscriptions full", sub_full },
+	CU_TEST_INFO_NULL,
+};
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "notifications",  suite_init, suite_clean, NULL, NULL, tests_notify },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_notify(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
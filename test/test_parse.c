@@ -0,0 +1,262 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <float.h>
+
+#include <varcore.h>
+#include <vcconv.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+/*** parse tests ************************************************************/
+
+static U32 s_rnd = 7;
+
+static U32 rnd(void) {
+  s_rnd ^= s_rnd << 13;
+  s_rnd ^= s_rnd >> 17;
+  s_rnd ^= s_rnd << 5;
+  return s_rnd;
+}
+
+static void parse_int(void) {
+  S32 n;
+
+  CU_ASSERT_EQUAL( vc_parse_s32( "0", &n ), kErrNone );
+  CU_ASSERT_EQUAL( n, 0 );
+  CU_ASSERT_EQUAL( vc_parse_s32( " -12", &n ), kErrNone );
+  CU_ASSERT_EQUAL( n, -12 );
+  CU_ASSERT_EQUAL( vc_parse_s32( "+7", &n ), kErrNone );
+  CU_ASSERT_EQUAL( n, 7 );
+  CU_ASSERT_EQUAL( vc_parse_s32( "-2147483648", &n ), kErrNone );
+  CU_ASSERT_EQUAL( n, -2147483647 - 1 );
+  CU_ASSERT_EQUAL( vc_parse_s32( "0x1F", &n ), kErrNone );
+  CU_ASSERT_EQUAL( n, 31 );
+  CU_ASSERT_EQUAL( vc_parse_s32( "0xffffffff", &n ), kErrNone );
+  CU_ASSERT_EQUAL( n, -1 );
+  CU_ASSERT_EQUAL( vc_parse_s32( "010", &n ), kErrNone );
+  CU_ASSERT_EQUAL( n, 8 );
+
+  CU_ASSERT_EQUAL( vc_parse_s32( "", &n ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_s32( "-", &n ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_s32( "0x", &n ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_s32( "08", &n ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_s32( "12 ", &n ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_s32( "1.5", &n ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_s32( "2147483648", &n ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_s32( "0x100000000", &n ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_s32( "99999999999999999999", &n ), kErrInvalidValue );
+}
+
+static void parse_float(void) {
+  F32 f;
+
+  CU_ASSERT_EQUAL( vc_parse_f32( "1.5", &f ), kErrNone );
+  CU_ASSERT_EQUAL( f, 1.5f );
+  CU_ASSERT_EQUAL( vc_parse_f32( "  -.5e1", &f ), kErrNone );
+  CU_ASSERT_EQUAL( f, -5.0f );
+  CU_ASSERT_EQUAL( vc_parse_f32( "1.", &f ), kErrNone );
+  CU_ASSERT_EQUAL( f, 1.0f );
+  CU_ASSERT_EQUAL( vc_parse_f32( "0.1", &f ), kErrNone );
+  CU_ASSERT_EQUAL( f, 0.1f );
+  CU_ASSERT_EQUAL( vc_parse_f32( "3.4028235e38", &f ), kErrNone );
+  CU_ASSERT_EQUAL( f, 3.4028235e38f );
+  // middle of two floats, ties to even
+  CU_ASSERT_EQUAL( vc_parse_f32( "16777217", &f ), kErrNone );
+  CU_ASSERT_EQUAL( f, 16777216.0f );
+  CU_ASSERT_EQUAL( vc_parse_f32( "16777217.000000000000000000000000000000000000000000001", &f ), kErrNone );
+  CU_ASSERT_EQUAL( f, 16777218.0f );
+
+  CU_ASSERT_EQUAL( vc_parse_f32( "", &f ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_f32( ".", &f ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_f32( "1e", &f ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_f32( "1,5", &f ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_f32( "1.5 ", &f ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_f32( "inf", &f ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_f32( "nan", &f ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_f32( "1e39", &f ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_f32( "1e-39", &f ), kErrInvalidValue );
+
+  // same as strtof
+  for( int i = 0; i < 10000; i++ ) {
+    char a[64];
+    U32  bits = rnd();
+    F32  g;
+
+    memcpy( &f, &bits, sizeof(f) );
+    if(( f != f ) || ( f > FLT_MAX ) || ( f < -FLT_MAX ) || (( f < FLT_MIN ) && ( f > -FLT_MIN ))) {
+      continue;
+    }
+    sprintf( a, "%.*e", (int)( rnd() % 12 ), f );
+    f = strtof( a, NULL );
+    if(( f > FLT_MAX ) || ( f < -FLT_MAX ) || (( f < FLT_MIN ) && ( f > -FLT_MIN ))) {
+      // rounded out of range
+      CU_ASSERT_EQUAL( vc_parse_f32( a, &g ), kErrInvalidValue );
+      continue;
+    }
+    CU_ASSERT_EQUAL( vc_parse_f32( a, &g ), kErrNone );
+    CU_ASSERT( g == f );
+  }
+}
+
+static void parse_int64(void) {
+  S64 n;
+
+  CU_ASSERT_EQUAL( vc_parse_s64( " -12", &n ), kErrNone );
+  CU_ASSERT_EQUAL( n, -12 );
+  CU_ASSERT_EQUAL( vc_parse_s64( "-9223372036854775808", &n ), kErrNone );
+  CU_ASSERT( n == -9223372036854775807LL - 1 );
+  CU_ASSERT_EQUAL( vc_parse_s64( "9007199254740993", &n ), kErrNone );
+  CU_ASSERT( n == 9007199254740993LL );
+  CU_ASSERT_EQUAL( vc_parse_s64( "0xffffffffffffffff", &n ), kErrNone );
+  CU_ASSERT( n == -1 );
+
+  CU_ASSERT_EQUAL( vc_parse_s64( "", &n ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_s64( "9223372036854775808", &n ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_s64( "0x10000000000000000", &n ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_s64( "1.5", &n ), kErrInvalidValue );
+}
+
+static void parse_double(void) {
+  F64 f;
+
+  CU_ASSERT_EQUAL( vc_parse_f64( "0.1", &f ), kErrNone );
+  CU_ASSERT( f == 0.1 );
+  CU_ASSERT_EQUAL( vc_parse_f64( "  -.5e1", &f ), kErrNone );
+  CU_ASSERT( f == -5.0 );
+  CU_ASSERT_EQUAL( vc_parse_f64( "1.7976931348623157e308", &f ), kErrNone );
+  CU_ASSERT( f == 1.7976931348623157e308 );
+  CU_ASSERT_EQUAL( vc_parse_f64( "9007199254740993", &f ), kErrNone );
+  CU_ASSERT( f == 9007199254740992.0 );
+
+  CU_ASSERT_EQUAL( vc_parse_f64( "", &f ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_f64( "1,5", &f ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_f64( "inf", &f ), kErrInvalidValue );
+  CU_ASSERT_EQUAL( vc_parse_f64( "1e309", &f ), kErrInvalidValue );
+
+  // same as strtod
+  for( int i = 0; i < 10000; i++ ) {
+    char a[64];
+    U64  bits = ((U64) rnd() << 32 ) | rnd();
+    F64  g;
+
+    memcpy( &f, &bits, sizeof(f) );
+    if(( f != f ) || ( f > DBL_MAX ) || ( f < -DBL_MAX ) || (( f < DBL_MIN ) && ( f > -DBL_MIN ))) {
+      continue;
+    }
+    sprintf( a, "%.*e", (int)( rnd() % 20 ), f );
+    f = strtod( a, NULL );
+    if(( f > DBL_MAX ) || ( f < -DBL_MAX ) || (( f < DBL_MIN ) && ( f > -DBL_MIN ))) {
+      continue;
+    }
+    CU_ASSERT_EQUAL( vc_parse_f64( a, &g ), kErrNone );
+    CU_ASSERT( g == f );
+  }
+}
+
+static void parse_as_string(void) {
+  ErrCode ret;
+  STRBUF  S;
+  S32     n32;
+  F32     f;
+
+  strcpy( S, "0xffff" );
+  ret = vc_as_string( VAR_ERR, VarWrite, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_int32( VAR_ERR, VarRead, &n32, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n32, 0xffff );
+
+  strcpy( S, "12.5" );
+  ret = vc_as_string( VAR_VOL, VarWrite, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_float( VAR_VOL, VarRead, &f, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( f, 12.5f );
+
+  strcpy( S, "12,5" );
+  ret = vc_as_string( VAR_VOL, VarWrite, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidValue );
+
+  strcpy( S, "40000" );
+  ret = vc_as_string( VAR_TP1, VarWrite, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidValue );
+
+  vc_reset();
+}
+
+static CU_TestInfo tests_parse[] = {
+  { "Parse integers",     parse_int },
+  { "Parse floats",       parse_float },
+  { "Parse int64",        parse_int64 },
+  { "Parse doubles",      parse_double },
+  { "Parse as string",    parse_as_string },
+	CU_TEST_INFO_NULL,
+};
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "parse",  suite_init, suite_clean, NULL, NULL, tests_parse },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_parse(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
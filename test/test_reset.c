@@ -0,0 +1,175 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <varcore.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** reset tests ************************************************************/
+
+static double s_storage[2][1024];
+
+static void reset_all(void) {
+  S16 tp1 = 50;
+  S16 max = 10;
+  S16 lod = 1;
+  STRBUF S;
+  ErrCode ret;
+
+  vc_as_int16( VAR_TP1, VarWrite, &tp1, 2, REQ_PRG );
+  vc_set_max( VAR_TP1, (U8*)&max, 1 );
+  vc_as_int16( VAR_LOD, VarWrite, &lod, 0, REQ_PRG );
+  strcpy( S, "a.much.longer.host.name" );
+  vc_as_string( VAR_NAS, VarWrite, S, 1, REQ_PRG );
+
+  ret = vc_reset();
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  vc_as_int16( VAR_TP1, VarRead, &tp1, 2, REQ_PRG );
+  CU_ASSERT_EQUAL( tp1, 0 );
+  vc_get_max( VAR_TP1, (U8*)&max, 1 );
+  CU_ASSERT_EQUAL( max, 105 );
+  vc_as_int16( VAR_LOD, VarRead, &lod, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( lod, 0 );
+  vc_as_string( VAR_NAS, VarRead, S, 1, REQ_PRG );
+  CU_ASSERT_STRING_EQUAL( S, "192.168.2.10" );
+}
+
+static ErrCode be_write( void *arg, HND hnd, U32 offs, void const *data, size_t size ) {
+  (void) arg; (void) hnd; (void) offs; (void) data; (void) size;
+  return kErrNone;
+}
+
+static void reset_storage(void) {
+  static VC_BACKEND const be = { be_write, NULL, NULL, NULL };
+  S16 tp1 = 50;
+  S16 node = 42;
+  ErrCode ret;
+
+  vc_as_int16( VAR_TP1, VarWrite, &tp1, 0, REQ_PRG );
+  vc_as_int16( VAR_CO_NODEID, VarWrite, &node, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( vc_flush( EEPROM, &be ), kErrNone );
+  CU_ASSERT( vc_is_dirty( EEPROM ) == 0 );
+
+  ret = vc_reset_storage( RAM_VOLATILE );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  vc_as_int16( VAR_TP1, VarRead, &tp1, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( tp1, 0 );
+  vc_as_int16( VAR_CO_NODEID, VarRead, &node, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( node, 42 );
+
+  ret = vc_reset_storage( EEPROM );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  vc_as_int16( VAR_CO_NODEID, VarRead, &node, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( node, 1 );
+  CU_ASSERT( vc_is_dirty( EEPROM ) != 0 );
+
+  ret = vc_reset_storage( 0x0300u );
+  CU_ASSERT_EQUAL( ret, kErrInvalidArg );
+
+  vc_reset();
+}
+
+/* a table without defaults image is reset from the descriptors */
+static void reset_no_image(void) {
+  static double snap[2][1024];
+  VC_DATA tab = g_var_data;
+  VC_CTX  ctx[2];
+  S32     pow = 1000;
+  size_t  size;
+
+  tab.dflt_s16 = NULL;
+  CU_ASSERT_EQUAL( vc_ctx_init_storage( &ctx[0], &g_var_data, s_storage[0], sizeof(s_storage[0]) ), kErrNone );
+  CU_ASSERT_EQUAL( vc_ctx_init_storage( &ctx[1], &tab, s_storage[1], sizeof(s_storage[1]) ), kErrNone );
+
+  for( int i = 0; i < 2; i++ ) {
+    vc_ctx_as_int32( &ctx[i], VAR_POW, VarWrite, &pow, 1, REQ_PRG );
+    CU_ASSERT_EQUAL( vc_ctx_reset_storage( &ctx[i], RAM_VOLATILE ), kErrNone );
+  }
+
+  size = vc_ctx_snapshot_size( &ctx[0] );
+  CU_ASSERT( size <= sizeof(snap[0]) );
+  CU_ASSERT_EQUAL( vc_ctx_snapshot( &ctx[0], snap[0] ), kErrNone );
+  CU_ASSERT_EQUAL( vc_ctx_snapshot( &ctx[1], snap[1] ), kErrNone );
+  CU_ASSERT( memcmp( snap[0], snap[1], size ) == 0 );
+}
+
+static CU_TestInfo tests_reset[] = {
+  { "Reset all",            reset_all },
+  { "Reset storage class",  reset_storage },
+  { "Reset without image",  reset_no_image },
+	CU_TEST_INFO_NULL,
+};
+
+
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "reset",  suite_init, suite_clean, NULL, NULL, tests_reset },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_reset(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
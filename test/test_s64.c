@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+#include "test_utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* WARNING - MAINTENANCE NIGHTMARE AHEAD
+ *
+ * If you change any of the tests & suites below, you also need
+ * to keep track of changes in the result statistics and reflect
+ * any changes in the result report counts in print_example_results().
+ *
+ * Yes, this could have been designed better using a more
+ * automated mechanism.  No, it was not done that way.
+ */
+
+#include <varcore.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** integer64 tests ********************************************************/
+static void rdwr64(void)
+{
+  S64 cnt = 0x55;
+  ErrCode ret;
+
+  ret = vc_as_int64( VAR_CNT, VarRead, &cnt, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT( cnt == 0 );
+
+  /* not exact as double */
+  cnt = 9007199254740993LL;
+  ret = vc_as_int64( VAR_CNT, VarWrite, &cnt, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  cnt = 0;
+  ret = vc_as_int64( VAR_CNT, VarRead, &cnt, 0, REQ_PRG );
+  CU_ASSERT( cnt == 9007199254740993LL );
+
+  cnt = -9223372036854775807LL - 1;
+  ret = vc_as_int64( VAR_CNT, VarWrite, &cnt, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+}
+
+static void wr64_limit(void)
+{
+  S64 cnt;
+  ErrCode ret;
+
+  cnt = 9007199254740994LL;
+  ret = vc_as_int64( VAR_CNT, VarWrite, &cnt, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrUpperLimit );
+  ret = vc_as_int64( VAR_CNT, VarRead, &cnt, 0, REQ_PRG );
+  CU_ASSERT( cnt == -9223372036854775807LL - 1 );
+
+  ret = vc_as_int64( VAR_CNT, VarWrite, &cnt, 1, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNoVector );
+}
+
+static void as_str64(void)
+{
+  ErrCode ret;
+  STRBUF S;
+  S64 cnt;
+
+  ret = vc_as_string( VAR_CNT, VarRead, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_STRING_EQUAL( S, "-9223372036854775808" );
+
+  strcpy( S, "9007199254740993" );
+  ret = vc_as_string( VAR_CNT, VarWrite, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_int64( VAR_CNT, VarRead, &cnt, 0, REQ_PRG );
+  CU_ASSERT( cnt == 9007199254740993LL );
+  ret = vc_as_string( VAR_CNT, VarRead, S, 0, REQ_PRG );
+  CU_ASSERT_STRING_EQUAL( S, "9007199254740993" );
+
+  strcpy( S, "9223372036854775808" );
+  ret = vc_as_string( VAR_CNT, VarWrite, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidValue );
+}
+
+static void min_max64(void)
+{
+  S64 Min;
+  S64 Max;
+  S64 Mn;
+  ErrCode ret;
+
+  ret = vc_get_min( VAR_CNT, (U8*)&Min, 0 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT( Min == -9223372036854775807LL - 1 );
+  ret = vc_get_max( VAR_CNT, (U8*)&Max, 0 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT( Max == 9007199254740993LL );
+
+  Mn = 1LL << 40;
+  ret = vc_set_min( VAR_CNT, (U8*)&Mn, 0 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  Mn -= 1;
+  ret = vc_as_int64( VAR_CNT, VarWrite, &Mn, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrLowerLimit );
+
+  vc_reset();
+}
+
+static CU_TestInfo tests_rdwr64[] = {
+  { "S64, RD/WR",        rdwr64 },
+  { "S64, WR limit",     wr64_limit },
+  { "S64, AS string",    as_str64 },
+  { "S64, SET MIN/MAX",  min_max64 },
+	CU_TEST_INFO_NULL,
+};
+
+
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "variable S64",  suite_init, suite_clean, NULL, NULL, tests_rdwr64 },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_s64(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
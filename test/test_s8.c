@@ -0,0 +1,217 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+#include "test_utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* WARNING - MAINTENANCE NIGHTMARE AHEAD
+ *
+ * If you change any of the tests & suites below, you also need
+ * to keep track of changes in the result statistics and reflect
+ * any changes in the result report counts in print_example_results().
+ *
+ * Yes, this could have been designed better using a more
+ * automated mechanism.  No, it was not done that way.
+ */
+
+#include <varcore.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** integer8 tests *********************************************************/
+static void rd8(void)
+{
+  S8 flg = 0x55;
+  ErrCode ret = vc_as_int8( VAR_FLG, VarRead, &flg, 0, REQ_PRG );
+
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( flg, 1 );
+
+  ret = vc_as_int8( VAR_FLG, VarRead, &flg, VEC_LEM, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidChan );
+}
+
+static void wr8_clip(void)
+{
+  S8 flg;
+  ErrCode ret;
+
+  flg = -100;
+  ret = vc_as_int8( VAR_FLG, VarWrite, &flg, 1, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_int8( VAR_FLG, VarRead, &flg, 1, REQ_PRG );
+  CU_ASSERT_EQUAL( flg, -100 );
+
+  flg = -101;
+  ret = vc_as_int8( VAR_FLG, VarWrite, &flg, 1, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_int8( VAR_FLG, VarRead, &flg, 1, REQ_PRG );
+  CU_ASSERT_EQUAL( flg, -100 );
+
+  flg = 127;
+  ret = vc_as_int8( VAR_FLG, VarWrite, &flg, VEC_LEM-1, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_int8( VAR_FLG, VarRead, &flg, VEC_LEM-1, REQ_PRG );
+  CU_ASSERT_EQUAL( flg, 100 );
+
+  /* other channels unchanged */
+  ret = vc_as_int8( VAR_FLG, VarRead, &flg, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( flg, 1 );
+}
+
+static void as_str8(void)
+{
+  ErrCode ret;
+  STRBUF S;
+  S8 msk;
+
+  msk = -1;
+  ret = vc_as_int8( VAR_MSK, VarWrite, &msk, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_string( VAR_MSK, VarRead, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_STRING_EQUAL( S, "0xff" );
+
+  strcpy( S, "0x80" );
+  ret = vc_as_string( VAR_MSK, VarWrite, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_int8( VAR_MSK, VarRead, &msk, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( msk, -128 );
+
+  strcpy( S, "0x100" );
+  ret = vc_as_string( VAR_MSK, VarWrite, S, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidValue );
+
+  strcpy( S, "-42" );
+  ret = vc_as_string( VAR_FLG, VarWrite, S, 2, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_as_string( VAR_FLG, VarRead, S, 2, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_STRING_EQUAL( S, "-42" );
+
+  strcpy( S, "200" );
+  ret = vc_as_string( VAR_FLG, VarWrite, S, 2, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidValue );
+}
+
+static void min_max8(void)
+{
+  S8 Min;
+  S8 Max;
+  S8 Mx;
+  ErrCode ret;
+
+  ret = vc_get_min( VAR_FLG, (U8*)&Min, 0 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( Min, -100 );
+
+  Mx = 50;
+  ret = vc_set_max( VAR_FLG, (U8*)&Mx, 0 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_get_max( VAR_FLG, (U8*)&Max, 0 );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( Max, 50 );
+
+  Mx = 60;
+  ret = vc_as_int8( VAR_FLG, VarWrite, &Mx, 0, REQ_PRG );
+  ret = vc_as_int8( VAR_FLG, VarRead, &Mx, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( Mx, 50 );
+
+  /* other channels keep their limit */
+  ret = vc_get_max( VAR_FLG, (U8*)&Max, 1 );
+  CU_ASSERT_EQUAL( Max, 100 );
+}
+
+static void type8(void)
+{
+  S8  n8 = 0;
+  S16 n16 = 0;
+  ErrCode ret;
+
+  ret = vc_as_int8( VAR_TP1, VarRead, &n8, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidType );
+  ret = vc_as_int16( VAR_FLG, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidType );
+
+  vc_reset();
+}
+
+static CU_TestInfo tests_rdwr8[] = {
+  { "S8, RD",           rd8 },
+  { "S8, WR clip",      wr8_clip },
+  { "S8, AS string",    as_str8 },
+  { "S8, SET MIN/MAX",  min_max8 },
+  { "S8, type",         type8 },
+	CU_TEST_INFO_NULL,
+};
+
+
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "variable S8",  suite_init, suite_clean, NULL, NULL, tests_rdwr8 },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_s8(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
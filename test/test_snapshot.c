@@ -0,0 +1,197 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <varcore.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** snapshot tests *********************************************************/
+
+static double s_snap[2][1024];
+
+static void snapshot_size(void) {
+  size_t size;
+  size_t hist = sizeof(VC_HIST_RING) * g_var_data.hist_ring_cnt +
+                sizeof(VC_HIST_CELL) * g_var_data.hist_cell_cnt;
+
+  /* the histories aren't part of a snapshot */
+  size = vc_snapshot_size();
+  CU_ASSERT( size > ( vc_ctx_storage_size( &g_var_data ) - hist ) / 2 );
+  CU_ASSERT( size <= sizeof(s_snap[0]) );
+
+  CU_ASSERT_EQUAL( vc_snapshot( NULL ), kErrInvalidArg );
+  CU_ASSERT_EQUAL( vc_restore( NULL ), kErrInvalidArg );
+}
+
+static void snapshot_restore(void) {
+  ErrCode ret;
+  S16     n16;
+  S32     n32;
+  F32     f;
+  STRBUF  s;
+
+  n16 = 42;
+  ret = vc_as_int16( VAR_CO_NODEID, VarWrite, &n16, 0, REQ_PRG );
+  n32 = 7;
+  ret = vc_as_int32( VAR_POW, VarWrite, &n32, 2, REQ_PRG );
+  f = 2.5f;
+  ret = vc_as_float( VAR_VOL, VarWrite, &f, 4, REQ_PRG );
+  memset( s, 0, sizeof(s) );
+  strcpy( s, "snap" );
+  ret = vc_as_string( VAR_UAS, VarWrite, s, 0, REQ_PRG );
+
+  ret = vc_snapshot( s_snap[0] );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  vc_reset();
+  ret = vc_as_int16( VAR_CO_NODEID, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 1 );
+
+  ret = vc_restore( s_snap[0] );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  ret = vc_as_int16( VAR_CO_NODEID, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 42 );
+  ret = vc_as_int32( VAR_POW, VarRead, &n32, 2, REQ_PRG );
+  CU_ASSERT_EQUAL( n32, 7 );
+  ret = vc_as_float( VAR_VOL, VarRead, &f, 4, REQ_PRG );
+  CU_ASSERT_DOUBLE_EQUAL( f, 2.5, 0.001 );
+  ret = vc_as_string( VAR_UAS, VarRead, s, 0, REQ_PRG );
+  CU_ASSERT_STRING_EQUAL( s, "snap" );
+
+  vc_reset();
+}
+
+static void snapshot_ctx(void) {
+  VC_CTX  ctx;
+  ErrCode ret;
+  S16     n16;
+
+  n16 = 5;
+  ret = vc_as_int16( VAR_CO_NODEID, VarWrite, &n16, 0, REQ_PRG );
+  ret = vc_snapshot( s_snap[0] );
+  vc_reset();
+
+  // same layout, other instance
+  vc_ctx_init_storage( &ctx, &g_var_data, s_snap[1], sizeof(s_snap[1]) );
+  ret = vc_ctx_restore( &ctx, s_snap[0] );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_ctx_as_int16( &ctx, VAR_CO_NODEID, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 5 );
+  ret = vc_as_int16( VAR_CO_NODEID, VarRead, &n16, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( n16, 1 );
+}
+
+static void snapshot_invalid(void) {
+  ErrCode ret;
+  U32     hdr[4];
+  U32     bad[4];
+
+  ret = vc_snapshot( s_snap[0] );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  memcpy( hdr, s_snap[0], sizeof(hdr) );
+
+  // corrupt magic
+  memcpy( bad, hdr, sizeof(bad) );
+  bad[0] ^= 1u;
+  memcpy( s_snap[0], bad, sizeof(bad) );
+  ret = vc_restore( s_snap[0] );
+  CU_ASSERT_EQUAL( ret, kErrInvalidValue );
+
+  // other layout
+  memcpy( bad, hdr, sizeof(bad) );
+  bad[1] ^= 1u;
+  memcpy( s_snap[0], bad, sizeof(bad) );
+  ret = vc_restore( s_snap[0] );
+  CU_ASSERT_EQUAL( ret, kErrLayout );
+
+  // other size
+  memcpy( bad, hdr, sizeof(bad) );
+  bad[2] += 8u;
+  memcpy( s_snap[0], bad, sizeof(bad) );
+  ret = vc_restore( s_snap[0] );
+  CU_ASSERT_EQUAL( ret, kErrLayout );
+
+  memcpy( s_snap[0], hdr, sizeof(hdr) );
+  ret = vc_restore( s_snap[0] );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+}
+
+static CU_TestInfo tests_snapshot[] = {
+  { "Snapshot size",      snapshot_size },
+  { "Snapshot restore",   snapshot_restore },
+  { "Snapshot context",   snapshot_ctx },
+  { "Snapshot invalid",   snapshot_invalid },
+	CU_TEST_INFO_NULL,
+};
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "snapshot",  suite_init, suite_clean, NULL, NULL, tests_snapshot },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_snapshot(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
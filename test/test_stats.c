@@ -0,0 +1,227 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <varcore.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** statistics tests *******************************************************/
+
+static char   s_out[8192];
+static size_t s_out_len;
+
+static ErrCode wr_out( void *arg, char const *data, size_t len ) {
+  (void) arg;
+  if( s_out_len + len >= sizeof(s_out) ) {
+    return kErrSizeTooBig;
+  }
+  memcpy( &s_out[s_out_len], data, len );
+  s_out_len += len;
+  s_out[s_out_len] = 0;
+  return kErrNone;
+}
+
+#ifdef VC_STATISTICS
+static U64 calls( U64 const *bucket ) {
+  U64 sum = 0;
+
+  for( int b = 0; b < VC_STATS_BUCKETS; b++ ) {
+    sum += bucket[b];
+  }
+  return sum;
+}
+#endif
+
+static void stats_counters(void) {
+  VC_STATS st;
+  S16 n16;
+
+  vc_stats_reset();
+  for( int i = 0; i < 3; i++ ) {
+    CU_ASSERT_EQUAL( vc_as_int16( VAR_CO_NODEID, VarRead, &n16, 0, REQ_PRG ), kErrNone );
+  }
+  CU_ASSERT_EQUAL( vc_as_int16( VAR_CO_NODEID, VarWrite, &n16, 0, REQ_PRG ), kErrNone );
+  CU_ASSERT_NOT_EQUAL( vc_as_int16( VAR_CO_NODEID, VarRead, &n16, 3, REQ_PRG ), kErrNone );
+
+#ifdef VC_STATISTICS
+  CU_ASSERT_EQUAL( vc_stats_var( VAR_CO_NODEID, &st ), kErrNone );
+  CU_ASSERT_EQUAL( st.reads, 4 );
+  CU_ASSERT_EQUAL( st.writes, 1 );
+  CU_ASSERT_EQUAL( st.errors, 1 );
+
+  vc_stats_reset();
+  CU_ASSERT_EQUAL( vc_stats_var( VAR_CO_NODEID, &st ), kErrNone );
+  CU_ASSERT_EQUAL( st.reads, 0 );
+#else
+  CU_ASSERT_EQUAL( vc_stats_var( VAR_CO_NODEID, &st ), kErrEmpty );
+  CU_ASSERT_EQUAL( st.reads, 0 );
+#endif
+
+  CU_ASSERT_EQUAL( vc_stats_var( 0x7fff, &st ), kErrUnknownCmd );
+  CU_ASSERT_EQUAL( vc_stats_var( VAR_CO_NODEID, NULL ), kErrInvalidArg );
+}
+
+static void stats_latency(void) {
+  U64 bucket[VC_STATS_BUCKETS];
+  F32 f;
+
+  vc_stats_reset();
+  for( int i = 0; i < 5; i++ ) {
+    CU_ASSERT_EQUAL( vc_as_float( VAR_CUR, VarRead, &f, 0, REQ_PRG ), kErrNone );
+  }
+  CU_ASSERT_NOT_EQUAL( vc_get_hnd( "CO:NODEID" ), 0x7fff );
+
+#ifdef VC_STATISTICS
+  CU_ASSERT_EQUAL( vc_stats_latency( VC_STAT_AS_FLOAT, bucket ), kErrNone );
+  CU_ASSERT_EQUAL( calls( bucket ), 5 );
+  CU_ASSERT_EQUAL( vc_stats_type( TYPE_FLOAT, bucket ), kErrNone );
+  CU_ASSERT_EQUAL( calls( bucket ), 5 );
+  CU_ASSERT_EQUAL( vc_stats_latency( VC_STAT_GET_HND, bucket ), kErrNone );
+  CU_ASSERT_EQUAL( calls( bucket ), 1 );
+  CU_ASSERT_EQUAL( vc_stats_latency( VC_STAT_AS_INT16, bucket ), kErrNone );
+  CU_ASSERT_EQUAL( calls( bucket ), 0 );
+#else
+  CU_ASSERT_EQUAL( vc_stats_latency( VC_STAT_AS_FLOAT, bucket ), kErrEmpty );
+  CU_ASSERT_EQUAL( vc_stats_type( TYPE_FLOAT, bucket ), kErrEmpty );
+#endif
+
+  CU_ASSERT_EQUAL( vc_stats_latency( VC_STAT_LAST, bucket ), kErrInvalidArg );
+  CU_ASSERT_EQUAL( vc_stats_latency( VC_STAT_RESET, NULL ), kErrInvalidArg );
+  CU_ASSERT_EQUAL( vc_stats_type( TYPE_LAST, bucket ), kErrInvalidArg );
+}
+
+static void stats_many(void) {
+  HND      hnd[] = { VAR_CO_NODEID, VAR_CUR, 0x7fff };
+  VC_VALUE val[countof(hnd)];
+  ErrCode  err[countof(hnd)];
+  VC_STATS st;
+
+  vc_stats_reset();
+  (void) vc_read_many( hnd, NULL, val, err, countof(hnd), REQ_PRG );
+  CU_ASSERT_EQUAL( err[0], kErrNone );
+  CU_ASSERT_EQUAL( err[1], kErrNone );
+
+#ifdef VC_STATISTICS
+  U64 bucket[VC_STATS_BUCKETS];
+
+  CU_ASSERT_EQUAL( vc_stats_var( VAR_CO_NODEID, &st ), kErrNone );
+  CU_ASSERT_EQUAL( st.reads, 1 );
+  CU_ASSERT_EQUAL( st.errors, 0 );
+  CU_ASSERT_EQUAL( vc_stats_var( VAR_CUR, &st ), kErrNone );
+  CU_ASSERT_EQUAL( st.reads, 1 );
+  CU_ASSERT_EQUAL( vc_stats_latency( VC_STAT_READ_MANY, bucket ), kErrNone );
+  CU_ASSERT_EQUAL( calls( bucket ), 1 );
+#else
+  CU_ASSERT_EQUAL( vc_stats_var( VAR_CUR, &st ), kErrEmpty );
+#endif
+}
+
+static void stats_dump(void) {
+  S16 n16;
+
+  vc_stats_reset();
+  CU_ASSERT_EQUAL( vc_as_int16( VAR_CO_NODEID, VarRead, &n16, 0, REQ_PRG ), kErrNone );
+
+  s_out_len = 0;
+  s_out[0]  = 0;
+#ifdef VC_STATISTICS
+  CU_ASSERT_EQUAL( vc_stats_dump( wr_out, NULL, VC_DUMP_TEXT ), kErrNone );
+  CU_ASSERT_PTR_NOT_NULL( strstr( s_out, "vc_as_int16: calls 1," ));
+  CU_ASSERT_PTR_NOT_NULL( strstr( s_out, "TYPE_INT16: calls 1," ));
+  CU_ASSERT_PTR_NOT_NULL( strstr( s_out, "CO:NODEID (0xe): reads 1, writes 0, errors 0\n" ));
+  CU_ASSERT_PTR_NULL( strstr( s_out, "vc_as_int32" ));
+
+  s_out_len = 0;
+  CU_ASSERT_EQUAL( vc_stats_dump( wr_out, NULL, VC_DUMP_JSON ), kErrNone );
+  CU_ASSERT_EQUAL( strncmp( s_out, "{\"functions\":[{\"name\":\"vc_as_int16\",\"calls\":1,", 46 ), 0 );
+  CU_ASSERT_PTR_NOT_NULL( strstr( s_out,
+      "\"variables\":[{\"hnd\":14,\"scpi\":\"CO:NODEID\",\"reads\":1,\"writes\":0,\"errors\":0}]}\n" ));
+#else
+  CU_ASSERT_EQUAL( vc_stats_dump( wr_out, NULL, VC_DUMP_TEXT ), kErrEmpty );
+  CU_ASSERT_EQUAL( s_out_len, 0 );
+#endif
+
+  CU_ASSERT_NOT_EQUAL( vc_stats_dump( NULL, NULL, VC_DUMP_TEXT ), kErrNone );
+  CU_ASSERT_NOT_EQUAL( vc_stats_dump( wr_out, NULL, 7 ), kErrNone );
+}
+
+static CU_TestInfo tests_stats[] = {
+  { "Counters",             stats_counters },
+  { "Latency",              stats_latency },
+  { "Many",                 stats_many },
+  { "Dump",                 stats_dump },
+	CU_TEST_INFO_NULL,
+};
+
+
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "statistics",  suite_init, suite_clean, NULL, NULL, tests_stats },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_stats(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
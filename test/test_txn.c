@@ -0,0 +1,245 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <varcore.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+/*** transaction tests ******************************************************/
+
+static int s_events;
+
+static void on_change( VC_EVENT const *ev, void *arg ) {
+  (void) ev;
+  (void) arg;
+  s_events++;
+}
+
+static void txn_commit(void) {
+  VC_TXN   txn;
+  VC_VALUE v;
+  S16      tp1;
+  S32      pow;
+  F64      frq;
+  S64      cnt;
+  S16      lod;
+  HND      bad = 0;
+  int      id;
+
+  CU_ASSERT_EQUAL( vc_txn_begin( &txn, REQ_PRG ), kErrNone );
+
+  v.s16 = 10;
+  CU_ASSERT_EQUAL( vc_txn_write( &txn, VAR_TP1, 1, &v ), kErrNone );
+  v.s32 = 500;
+  CU_ASSERT_EQUAL( vc_txn_write( &txn, VAR_POW, 3, &v ), kErrNone );
+  v.f64 = 60.0;
+  CU_ASSERT_EQUAL( vc_txn_write( &txn, VAR_FRQ, 0, &v ), kErrNone );
+  v.s64 = 1LL << 40;
+  CU_ASSERT_EQUAL( vc_txn_write( &txn, VAR_CNT, 0, &v ), kErrNone );
+  v.s16 = 1;
+  CU_ASSERT_EQUAL( vc_txn_write( &txn, VAR_LOD, 0, &v ), kErrNone );
+  /* replaces the first write */
+  v.s16 = 20;
+  CU_ASSERT_EQUAL( vc_txn_write( &txn, VAR_TP1, 1, &v ), kErrNone );
+
+  /* nothing is visible before the commit */
+  vc_as_int16( VAR_TP1, VarRead, &tp1, 1, REQ_PRG );
+  CU_ASSERT_EQUAL( tp1, 0 );
+
+  s_events = 0;
+  vc_subscribe( VAR_TP1, VC_ALL_CHAN, NULL, on_change, NULL, &id );
+  CU_ASSERT_EQUAL( vc_txn_commit( &txn, &bad ), kErrNone );
+  CU_ASSERT_EQUAL( bad, HNON );
+  CU_ASSERT_EQUAL( s_events, 1 );
+  vc_unsubscribe( id );
+
+  vc_as_int16( VAR_TP1, VarRead, &tp1, 1, REQ_PRG );
+  CU_ASSERT_EQUAL( tp1, 20 );
+  vc_as_int32( VAR_POW, VarRead, &pow, 3, REQ_PRG );
+  CU_ASSERT_EQUAL( pow, 500 );
+  vc_as_double( VAR_FRQ, VarRead, &frq, 0, REQ_PRG );
+  CU_ASSERT( frq == 60.0 );
+  vc_as_int64( VAR_CNT, VarRead, &cnt, 0, REQ_PRG );
+  CU_ASSERT( cnt == ( 1LL << 40 ));
+  vc_as_int16( VAR_LOD, VarRead, &lod, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( lod, 1 );
+
+  vc_reset();
+}
+
+static void txn_limit(void) {
+  VC_TXN   txn;
+  VC_VALUE v;
+  S16      tp1;
+  S32      pow;
+  HND      bad = 0;
+
+  vc_txn_begin( &txn, REQ_PRG );
+  /* FLAG_CLIP */
+  v.s16 = 1000;
+  vc_txn_write( &txn, VAR_TP1, 0, &v );
+  v.s32 = 5;
+  vc_txn_write( &txn, VAR_POW, 0, &v );
+  CU_ASSERT_EQUAL( vc_txn_commit( &txn, &bad ), kErrNone );
+  vc_as_int16( VAR_TP1, VarRead, &tp1, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( tp1, 105 );
+
+  /* FLAG_LIMIT, nothing is written */
+  v.s16 = 7;
+  vc_txn_write( &txn, VAR_TP1, 0, &v );
+  v.s32 = 100001;
+  vc_txn_write( &txn, VAR_POW, 0, &v );
+  CU_ASSERT_EQUAL( vc_txn_commit( &txn, &bad ), kErrUpperLimit );
+  CU_ASSERT_EQUAL( bad, VAR_POW );
+  vc_as_int16( VAR_TP1, VarRead, &tp1, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( tp1, 105 );
+  vc_as_int32( VAR_POW, VarRead, &pow, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( pow, 5 );
+
+  /* not a member of the enum */
+  v.s16 = 5;
+  vc_txn_write( &txn, VAR_LOD, 0, &v );
+  CU_ASSERT_EQUAL( vc_txn_commit( &txn, NULL ), kErrInvalidEnum );
+
+  vc_reset();
+}
+
+static void txn_write_error(void) {
+  VC_TXN   txn;
+  VC_VALUE v;
+  S16      tp1;
+  HND      bad = 0;
+
+  v.s32 = 1;
+  vc_txn_begin( &txn, REQ_PRG );
+  CU_ASSERT_EQUAL( vc_txn_write( &txn, VAR_TP1, 0, &v ), kErrNone );
+  CU_ASSERT_EQUAL( vc_txn_write( &txn, 0xfff0, 0, &v ), kErrUnknownCmd );
+  CU_ASSERT_EQUAL( vc_txn_write( &txn, VAR_NAS, 0, &v ), kErrInvalidType );
+  CU_ASSERT_EQUAL( vc_txn_write( &txn, VAR_SER, 0, &v ), kErrAccessDenied );
+  CU_ASSERT_EQUAL( vc_txn_write( &txn, VAR_TP1, VEC_LEM, &v ), kErrInvalidChan );
+  CU_ASSERT_EQUAL( vc_txn_write( NULL, VAR_TP1, 0, &v ), kErrInvalidArg );
+
+  /* the first failed write fails the commit */
+  CU_ASSERT_EQUAL( vc_txn_commit( &txn, &bad ), kErrUnknownCmd );
+  CU_ASSERT_EQUAL( bad, 0xfff0 );
+  vc_as_int16( VAR_TP1, VarRead, &tp1, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( tp1, 0 );
+
+  /* the transaction can be used again */
+  v.s16 = 3;
+  CU_ASSERT_EQUAL( vc_txn_write( &txn, VAR_TP1, 0, &v ), kErrNone );
+  CU_ASSERT_EQUAL( vc_txn_commit( &txn, &bad ), kErrNone );
+  vc_as_int16( VAR_TP1, VarRead, &tp1, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( tp1, 3 );
+
+  vc_reset();
+}
+
+static void txn_abort(void) {
+  static HND const hnd[] = { VAR_YNU, VAR_ZNU, VAR_TP1, VAR_IAB };
+  VC_TXN   txn;
+  VC_VALUE v;
+  S16      val;
+  int      n = 0;
+
+  /* 4 vectors of VEC_LEM fill the default VC_TXN_MAX */
+  vc_txn_begin( &txn, REQ_PRG );
+  v.s16 = -1;
+  for( int h = 0; h < 4; h++ ) {
+    for( U16 i = 0; i < VEC_LEM; i++ ) {
+      n += ( vc_txn_write( &txn, hnd[h], i, &v ) == kErrNone ) ? 1 : 0;
+    }
+  }
+  CU_ASSERT_EQUAL( n, VC_TXN_MAX );
+  CU_ASSERT_EQUAL( vc_txn_write( &txn, VAR_UAB, 0, &v ), kErrFull );
+
+  vc_txn_abort( &txn );
+  for( U16 i = 0; i < VEC_LEM; i++ ) {
+    vc_as_int16( VAR_YNU, VarRead, &val, i, REQ_PRG );
+    CU_ASSERT_EQUAL( val, -2 );
+  }
+  CU_ASSERT_EQUAL( vc_txn_commit( &txn, NULL ), kErrNone );
+  vc_as_int16( VAR_TP1, VarRead, &val, 0, REQ_PRG );
+  CU_ASSERT_EQUAL( val, 0 );
+}
+
+static CU_TestInfo tests_txn[] = {
+  { "Commit",               txn_commit },
+  { "Limits",               txn_limit },
+  { "Write errors",         txn_write_error },
+  { "Abort",                txn_abort },
+	CU_TEST_INFO_NULL,
+};
+
+
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "transaction",  suite_init, suite_clean, NULL, NULL, tests_txn },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_txn(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
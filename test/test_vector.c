@@ -0,0 +1,327 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CUnit/CUnit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <varcore.h>
+
+#include "vardefs.h"
+
+extern VC_DATA g_var_data;
+
+#include "test_utils.h"
+
+/* Suite initialization/cleanup functions */
+static int suite_init(void) {
+  vc_init(&g_var_data);
+  return 0;
+}
+
+static int suite_clean(void) {
+  return 0; 
+}
+
+
+static void vector_rdwr_s16(void) {
+  S16 wr[VEC_LEM];
+  S16 rd[VEC_LEM];
+  ErrCode ret;
+
+  for( int i = 0; i < VEC_LEM; i++ ) {
+    wr[i] = (S16)( 10 * i - 30 );
+  }
+  ret = vc_write_vector( VAR_UAB, 0, VEC_LEM, wr, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  memset( rd, 0, sizeof(rd));
+  ret = vc_read_vector( VAR_UAB, 0, VEC_LEM, rd, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT( memcmp( rd, wr, sizeof(rd)) == 0 );
+
+  /* same values as the single channel accessor */
+  for( int i = 0; i < VEC_LEM; i++ ) {
+    S16 v = 0;
+    ret = vc_as_int16( VAR_UAB, VarRead, &v, i, REQ_PRG );
+    CU_ASSERT_EQUAL( ret, kErrNone );
+    CU_ASSERT_EQUAL( v, wr[i] );
+  }
+
+  /* sub range */
+  ret = vc_read_vector( VAR_UAB, 2, 3, rd, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( rd[0], wr[2] );
+  CU_ASSERT_EQUAL( rd[2], wr[4] );
+}
+
+static void vector_limit(void) {
+  S16 s16[VEC_LEM];
+  S32 s32[VEC_LEM];
+  F32 f32[VEC_LEM];
+  S16 rd[VEC_LEM];
+  ErrCode ret;
+
+  for( int i = 0; i < VEC_LEM; i++ ) {
+    s16[i] = 1;
+    s32[i] = 2;
+    f32[i] = 3.0f;
+  }
+  ret = vc_write_vector( VAR_IAB, 0, VEC_LEM, s16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_write_vector( VAR_POW, 0, VEC_LEM, s32, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_write_vector( VAR_CUR, 0, VEC_LEM, f32, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  /* one value out of range, nothing is written */
+  s16[5] = 1001;
+  s16[0] = 7;
+  ret = vc_write_vector( VAR_IAB, 0, VEC_LEM, s16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrUpperLimit );
+  ret = vc_read_vector( VAR_IAB, 0, VEC_LEM, rd, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( rd[0], 1 );
+  CU_ASSERT_EQUAL( rd[5], 1 );
+
+  s16[5] = -1001;
+  ret = vc_write_vector( VAR_IAB, 0, VEC_LEM, s16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrLowerLimit );
+
+  s32[7] = 100001;
+  ret = vc_write_vector( VAR_POW, 0, VEC_LEM, s32, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrUpperLimit );
+
+  f32[3] = -1000.5f;
+  ret = vc_write_vector( VAR_CUR, 0, VEC_LEM, f32, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrLowerLimit );
+}
+
+static void vector_clip(void) {
+  S16 s16[VEC_LEM];
+  S32 s32[VEC_LEM];
+  S32 rd[VEC_LEM];
+  ErrCode ret;
+
+  for( int i = 0; i < VEC_LEM; i++ ) {
+    s16[i] = (S16)( 40 * i - 120 );
+    s32[i] = 50000 * i - 200000;
+  }
+  ret = vc_write_vector( VAR_TP1, 0, VEC_LEM, s16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( s16[0], -80 );
+  CU_ASSERT_EQUAL( s16[1], -80 );
+  CU_ASSERT_EQUAL( s16[2], -40 );
+  CU_ASSERT_EQUAL( s16[6], 105 );
+  CU_ASSERT_EQUAL( s16[7], 105 );
+
+  ret = vc_write_vector( VAR_PAB, 0, VEC_LEM, s32, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_read_vector( VAR_PAB, 0, VEC_LEM, rd, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL32( rd[0], -100000 );
+  CU_ASSERT_EQUAL32( rd[3], -50000 );
+  CU_ASSERT_EQUAL32( rd[7], 100000 );
+}
+
+static void vector_enum(void) {
+  S16 wr[3] = { -2, 0, -1 };
+  S16 rd[3];
+  ErrCode ret;
+
+  ret = vc_write_vector( VAR_YNU, 5, 3, wr, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_read_vector( VAR_YNU, 5, 3, rd, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT( memcmp( rd, wr, sizeof(rd)) == 0 );
+
+  wr[1] = 1;
+  ret = vc_write_vector( VAR_YNU, 5, 3, wr, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidEnum );
+}
+
+/* different limits in every channel, the SIMD paths split the
+ * {min, max} pairs of several channels into vectors */
+static void vector_chan_limits(void) {
+  S16 s16[VEC_LEM];
+  S32 s32[VEC_LEM];
+  F32 f32[VEC_LEM];
+  ErrCode ret;
+
+  for( U16 i = 0; i < VEC_LEM; i++ ) {
+    S16 mn16 = (S16)( -10 * ( i + 1 ));
+    S16 mx16 = (S16)( 10 * ( i + 1 ));
+    S32 mn32 = -1000 * ( i + 1 );
+    S32 mx32 = 1000 * ( i + 1 );
+    F32 mnf  = -10.5f * (F32)( i + 1 );
+    F32 mxf  = 10.5f * (F32)( i + 1 );
+
+    vc_set_min( VAR_TP1, (U8*) &mn16, i );
+    vc_set_max( VAR_TP1, (U8*) &mx16, i );
+    vc_set_min( VAR_IAB, (U8*) &mn16, i );
+    vc_set_max( VAR_IAB, (U8*) &mx16, i );
+    vc_set_min( VAR_PAB, (U8*) &mn32, i );
+    vc_set_max( VAR_PAB, (U8*) &mx32, i );
+    vc_set_min( VAR_CUR_NMAX, (U8*) &mnf, i );
+    vc_set_max( VAR_CUR_NMAX, (U8*) &mxf, i );
+  }
+
+  /* FLAG_CLIP, even channels above, odd ones below the limits */
+  for( int i = 0; i < VEC_LEM; i++ ) {
+    s16[i] = ( i % 2 ) ? -100 : 100;
+    s32[i] = ( i % 2 ) ? -50000 : 50000;
+    f32[i] = ( i % 2 ) ? -500.0f : 500.0f;
+  }
+  ret = vc_write_vector( VAR_TP1, 0, VEC_LEM, s16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_write_vector( VAR_PAB, 0, VEC_LEM, s32, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_write_vector( VAR_CUR_NMAX, 0, VEC_LEM, f32, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  for( int i = 0; i < VEC_LEM; i++ ) {
+    int sign = ( i % 2 ) ? -1 : 1;
+
+    CU_ASSERT_EQUAL( s16[i], sign * 10 * ( i + 1 ));
+    CU_ASSERT_EQUAL( s32[i], sign * 1000 * ( i + 1 ));
+    CU_ASSERT_DOUBLE_EQUAL( f32[i], sign * 10.5 * ( i + 1 ), 1e-6 );
+  }
+
+  /* FLAG_LIMIT, only channel 6 is above its own maximum */
+  for( int i = 0; i < VEC_LEM; i++ ) {
+    s16[i] = (S16)( 10 * ( i + 1 ));
+  }
+  s16[6] = 71;
+  ret = vc_write_vector( VAR_IAB, 0, VEC_LEM, s16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrUpperLimit );
+  s16[6] = -71;
+  ret = vc_write_vector( VAR_IAB, 0, VEC_LEM, s16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrLowerLimit );
+  s16[6] = -70;
+  ret = vc_write_vector( VAR_IAB, 0, VEC_LEM, s16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  vc_reset();
+}
+
+static int s_notified;
+
+static void vector_cb( VC_EVENT const *ev, void *arg ) {
+  (void) arg;
+  s_notified |= 1 << ev->chan;
+}
+
+static void vector_notify(void) {
+  S16 wr[VEC_LEM];
+  ErrCode ret;
+  int id;
+
+  ret = vc_read_vector( VAR_UAB, 0, VEC_LEM, wr, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  ret = vc_subscribe( VAR_UAB, VC_ALL_CHAN, NULL, vector_cb, NULL, &id );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+
+  s_notified = 0;
+  wr[1] += 1;
+  wr[6] += 1;
+  ret = vc_write_vector( VAR_UAB, 0, VEC_LEM, wr, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  CU_ASSERT_EQUAL( s_notified, ( 1 << 1 ) | ( 1 << 6 ));
+
+  ret = vc_unsubscribe( id );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+}
+
+static void vector_invalid(void) {
+  S32 s32[VEC_LEM];
+  S16 s16[VEC_LEM];
+  STRBUF buf;
+  ErrCode ret;
+
+  memset( s32, 0, sizeof(s32));
+  memset( s16, 0, sizeof(s16));
+
+  ret = vc_read_vector( VAR_UAB, 4, VEC_LEM - 3, s16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidChan );
+  ret = vc_read_vector( VAR_UAB, VEC_LEM, 1, s16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidChan );
+  ret = vc_read_vector( VAR_UAB, 0, 0, s16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidArg );
+  ret = vc_read_vector( VAR_UAB, 0, 1, NULL, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidArg );
+  ret = vc_read_vector( VAR_NAS, 0, 1, buf, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrInvalidType );
+
+  /* scalar variable */
+  ret = vc_read_vector( VAR_CO_NODEID, 0, 1, s16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNone );
+  ret = vc_read_vector( VAR_CO_NODEID, 0, 2, s16, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrNoVector );
+
+  /* admin variable */
+  ret = vc_write_vector( VAR_SER, 0, 1, s32, REQ_PRG );
+  CU_ASSERT_EQUAL( ret, kErrAccessDenied );
+}
+
+static CU_TestInfo tests_vector[] = {
+  { "Vector read/write int16",  vector_rdwr_s16 },
+  { "Vector FLAG_LIMIT",        vector_limit },
+  { "Vector FLAG_CLIP",         vector_clip },
+  { "Vector channel limits",    vector_chan_limits },
+  { "Vector enum",              vector_enum },
+  { "Vector notify",            vector_notify },
+  { "Vector invalid",           vector_invalid },
+	CU_TEST_INFO_NULL,
+};
+
+/*** Suite definition  ******************************************************/
+
+static CU_SuiteInfo suites[] = {
+  { "vector",  suite_init, suite_clean, NULL, NULL, tests_vector },
+	CU_SUITE_INFO_NULL,
+};
+
+void test_add_vector(void)
+{
+  assert(NULL != CU_get_registry());
+  assert(!CU_is_test_running());
+
+	/* Register suites. */
+	if (CU_register_suites(suites) != CUE_SUCCESS) {
+		fprintf(stderr, "suite registration failed - %s\n",
+			CU_get_error_msg());
+		exit(EXIT_FAILURE);
+	}
+}
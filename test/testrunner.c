@@ -57,10 +57,30 @@ int main(int argc, char* argv[])
       test_add_s16();
       test_add_s32();
       test_add_f32();
+      test_add_s8();
+      test_add_s64();
+      test_add_f64();
       test_add_string();
       test_add_enum();
       test_add_dump();
       test_add_misc();
+      test_add_batch();
+      test_add_atomic();
+      test_add_notify();
+      test_add_ctx();
+      test_add_snapshot();
+      test_add_flush();
+      test_add_fmt();
+      test_add_parse();
+      test_add_vector();
+      test_add_reset();
+      test_add_txn();
+      test_add_acc();
+      test_add_cpp();
+      test_add_derive();
+      test_add_action();
+      test_add_hist();
+      test_add_stats();
 
       if( ConsoleOutput ) {
         // CU_console_run_tests();
@@ -39,10 +39,30 @@ extern "C" {
 void test_add_s16(void);
 void test_add_s32(void);
 void test_add_f32(void);
+void test_add_s8(void);
+void test_add_s64(void);
+void test_add_f64(void);
 void test_add_string(void);
 void test_add_enum(void);
 void test_add_dump(void);
 void test_add_misc(void);
+void test_add_batch(void);
+void test_add_atomic(void);
+void test_add_notify(void);
+void test_add_ctx(void);
+void test_add_snapshot(void);
+void test_add_flush(void);
+void test_add_fmt(void);
+void test_add_parse(void);
+void test_add_vector(void);
+void test_add_reset(void);
+void test_add_txn(void);
+void test_add_acc(void);
+void test_add_cpp(void);
+void test_add_derive(void);
+void test_add_action(void);
+void test_add_hist(void);
+void test_add_stats(void);
 
 #ifdef __cplusplus
 }
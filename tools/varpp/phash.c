@@ -0,0 +1,235 @@
+/*
+ *  Copyright (c) 2020, Ruediger Haertel
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *  TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * phash.c
+ *
+ * Build a collision free ("perfect") hash table for the SCPI strings.
+ *
+ * The keys are distributed into buckets. Starting with the largest
+ * bucket, a displacement is searched that moves all keys of the
+ * bucket into free slots. If a bucket can't be placed, the whole
+ * table is rebuilt with another seed.
+ */
+
+#include "phash.h"
+#include "log.h"
+#include "../../lib/varhash.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+  MaxAttempts   = 64,
+  MaxDisp       = 0xffff,
+  MaxBucketSize = 64,
+  KeysPerBucket = 4
+};
+
+typedef struct {
+  uint32_t bucket;
+  uint32_t cnt;
+  uint32_t first;
+} BUCKET;
+
+static uint32_t *s_hash;
+static uint32_t *s_keys;    /* key indices, sorted by bucket */
+
+static int cmp_bucket( void const *a, void const *b ) {
+  BUCKET const *A = (BUCKET const *) a;
+  BUCKET const *B = (BUCKET const *) b;
+
+  if( A->cnt != B->cnt ) {
+    return (A->cnt < B->cnt) ? 1 : -1;
+  }
+  return (A->bucket < B->bucket) ? -1 : (A->bucket > B->bucket);
+}
+
+/*** place_bucket ***********************************************************/
+/**
+ *   Search a displacement for all keys of one bucket.
+ *
+ *   @return 0 on success.
+ */
+static int place_bucket( PHASH *ph, BUCKET const *b ) {
+  uint32_t slot[MaxBucketSize];
+
+  for( uint32_t i = 0; i < b->cnt; i++ ) {
+    for( uint32_t j = 0; j < i; j++ ) {
+      if( s_hash[s_keys[b->first + i]] == s_hash[s_keys[b->first + j]] ) {
+        /* full hash collision: no displacement can separate the keys */
+        return -1;
+      }
+    }
+  }
+
+  for( uint32_t d = 0; d < MaxDisp; d++ ) {
+    uint32_t i;
+
+    for( i = 0; i < b->cnt; i++ ) {
+      uint32_t h = s_hash[s_keys[b->first + i]];
+      uint32_t s = vc_hash_mix( h, d + 1u ) % (uint32_t) ph->slot_cnt;
+      uint32_t j;
+
+      if( ph->slots[s] != PHASH_EMPTY ) {
+        break;
+      }
+      for( j = 0; j < i; j++ ) {
+        if( slot[j] == s ) {
+          break;
+        }
+      }
+      if( j < i ) {
+        break;
+      }
+      slot[i] = s;
+    }
+
+    if( i == b->cnt ) {
+      for( i = 0; i < b->cnt; i++ ) {
+        ph->slots[slot[i]] = (uint16_t) s_keys[b->first + i];
+      }
+      ph->disp[b->bucket] = (uint16_t) d;
+      return 0;
+    }
+  }
+
+  return -1;
+}
+
+/*** try_seed ***************************************************************/
+/**
+ *   Build the table with the given seed.
+ *
+ *   @return 0 on success.
+ */
+static int try_seed( PHASH *ph, char const **keys, size_t n, BUCKET *buckets ) {
+  uint32_t disp_cnt = (uint32_t) ph->disp_cnt;
+
+  memset( buckets, 0, sizeof(BUCKET) * disp_cnt );
+  memset( ph->disp, 0, sizeof(uint16_t) * disp_cnt );
+  memset( ph->slots, 0xff, sizeof(uint16_t) * ph->slot_cnt );
+
+  for( size_t i = 0; i < n; i++ ) {
+    s_hash[i] = vc_hash_str( keys[i], ph->seed );
+    buckets[ vc_hash_mix( s_hash[i], 0 ) % disp_cnt ].cnt++;
+  }
+
+  /* counting sort of the keys by bucket */
+  uint32_t first = 0;
+  for( uint32_t b = 0; b < disp_cnt; b++ ) {
+    if( buckets[b].cnt > MaxBucketSize ) {
+      return -1;
+    }
+    buckets[b].bucket = b;
+    buckets[b].first = first;
+    first += buckets[b].cnt;
+    buckets[b].cnt = 0;
+  }
+  for( size_t i = 0; i < n; i++ ) {
+    BUCKET *b = &buckets[ vc_hash_mix( s_hash[i], 0 ) % disp_cnt ];
+    s_keys[b->first + b->cnt] = (uint32_t) i;
+    b->cnt++;
+  }
+
+  qsort( buckets, disp_cnt, sizeof(BUCKET), cmp_bucket );
+
+  for( uint32_t b = 0; b < disp_cnt && buckets[b].cnt > 0; b++ ) {
+    if( place_bucket( ph, &buckets[b] ) != 0 ) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/*** phash_build ************************************************************/
+/**
+ *   Build a perfect hash table for keys.
+ *
+ *   @param ph     table, must be freed with phash_free
+ *   @param keys   list of unique strings
+ *   @param n      number of strings
+ *
+ *   @return 0 on success.
+ */
+int phash_build( PHASH *ph, char const **keys, size_t n ) {
+  BUCKET *buckets;
+  int res = -1;
+
+  memset( ph, 0, sizeof(PHASH) );
+
+  if( n > PHASH_MAX_KEY ) {
+    log_printf( LogErr, 0, "Too many keys for perfect hash: %zu", n );
+    return -1;
+  }
+
+  ph->disp_cnt = n / KeysPerBucket + 1;
+  ph->slot_cnt = n + n / 4 + 1;
+  if( ph->slot_cnt > PHASH_MAX_KEY ) {
+    ph->slot_cnt = PHASH_MAX_KEY;
+  }
+
+  ph->disp  = (uint16_t*) calloc( ph->disp_cnt, sizeof(uint16_t) );
+  ph->slots = (uint16_t*) calloc( ph->slot_cnt, sizeof(uint16_t) );
+  s_hash    = (uint32_t*) calloc( n + 1, sizeof(uint32_t) );
+  s_keys    = (uint32_t*) calloc( n + 1, sizeof(uint32_t) );
+  buckets   = (BUCKET*) calloc( ph->disp_cnt, sizeof(BUCKET) );
+
+  if( ph->disp && ph->slots && s_hash && s_keys && buckets ) {
+    for( uint32_t attempt = 0; attempt < MaxAttempts; attempt++ ) {
+      ph->seed = attempt * 0x9e3779b9u;
+      if( try_seed( ph, keys, n, buckets ) == 0 ) {
+        res = 0;
+        break;
+      }
+    }
+  }
+
+  if( res != 0 ) {
+    log_printf( LogErr, 0, "Failed to build perfect hash for %zu keys.", n );
+  }
+
+  free( buckets );
+  free( s_keys );
+  free( s_hash );
+  s_keys = NULL;
+  s_hash = NULL;
+
+  return res;
+}
+
+void phash_free( PHASH *ph ) {
+  free( ph->disp );
+  free( ph->slots );
+  memset( ph, 0, sizeof(PHASH) );
+}
@@ -38,11 +38,13 @@
 #include "defs.h"
 #include "loc.h"
 #include "log.h"
+#include "phash.h"
 #include "strpool.h"
 #include "utils.h"
 #include "utlist.h"
 #include "uthash.h"
 #include "../../lib/varcore.h"
+#include "../../lib/varhash.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -80,17 +82,34 @@ typedef enum {
   kSecStrings
 } Section;
 
+enum {
+  MaxHistTiers = 4
+};
+
+/* history of a variable, see #pragma history */
+typedef struct _PP_HIST {
+  int      tier_cnt;
+  unsigned period[MaxHistTiers];  /* 0 for the samples */
+  unsigned cnt[MaxHistTiers];     /* cells per channel */
+} PP_HIST;
+
 typedef struct {
   Section section;
   char const *prefix;
   size_t prefix_len;
   int init_data;
+  int accessors;
+  int cpp;
+  PP_HIST const *hist;            /* NULL, when off */
 } Config;
 
 typedef struct _DATA_NUMBER {
   double def_value;
   double min;
   double max;
+  long long def_int;    /* TYPE_INT8 ... TYPE_INT64, exact */
+  long long min_int;
+  long long max_int;
 } PP_DATA_NUMBER;
 
 typedef struct _ENUM_MBR_DESC {
@@ -111,6 +130,23 @@ typedef struct _PP_DATA_STRING {
   int flags;
 } PP_DATA_STRING;
 
+enum {
+  MaxDrvCode = 128,
+  MaxDrvConst = 32
+};
+
+/* derived variable, see derive_build() */
+typedef struct _PP_DERIVE {
+  char  *expr;                /* expression, without '=' */
+  LOC    loc;
+  int    idx;                 /* index in g_derive */
+  int    code[MaxDrvCode];    /* program, VC_DRV_*, constants index konst */
+  int    code_len;
+  double konst[MaxDrvConst];
+  int    konst_cnt;
+  int    state;               /* 0: unchecked, 1: in progress, 2: done */
+} PP_DERIVE;
+
 typedef struct _DataItem {
   STRBUF hnd;
   STRBUF scpi;
@@ -127,6 +163,9 @@ typedef struct _DataItem {
     PP_DATA_STRING data_string;
   } data;
 
+  PP_DERIVE *derive;          /* NULL, when not derived */
+  PP_HIST const *hist;        /* NULL, when without history */
+
   struct _DataItem *next;
 } DataItem;
 
@@ -169,16 +208,36 @@ typedef char CSV_BUF[MaxCsvColumns][LineSize];
 static int parse_number( DataItem *, size_t, CSV_BUF* );
 static int parse_string( DataItem *, size_t, CSV_BUF* );
 static int parse_enum( DataItem *, size_t, CSV_BUF* );
+static int derive_build( DataItem * );
+static DataItem *drv_item( DataItem *, int );
 
 int  read_csv_file( DataItem **, char * );
 int  save_inc_file( DataItem *, char * );
 int  save_var_file( DataItem *, char * );
+int  save_acc_file( DataItem *, char * );
+int  save_cpp_file( DataItem *, char * );
 int  save_data_int( FILE *fp, DataItem *head, char const *name, int type, int );
-int  save_data_string( FILE *fp, DataItem *head, char const *name, int type );
+
+/* what save_data_int() writes */
+enum {
+  kDataValue,     /* current values */
+  kDataDescr,     /* descriptor: default, min, max */
+  kDataLimit,     /* current limits: min, max */
+  kDataDflt,      /* defaults image of the values, see vc_reset() */
+  kDataDfltLimit  /* defaults image of the limits */
+};
+int  save_data_string( FILE *fp, DataItem *head, char const *name, int type, int );
 int  save_data_const_string( FILE *fp, DataItem *head, char const *name, int type );
-int  save_data_enum( FILE *fp, DataItem *head, char const *name, int type );
+int  save_data_enum( FILE *fp, DataItem *head, char const *name, int type, int );
 int  save_data_enum_mbr( FILE *fp, DataItem *head, char const *name, int type );
+int  save_data_enum_sym( FILE *fp, char const *name );
+int  enum_set_span( PP_DATA_ENUM const *data, int *min );
+int  enum_sym_slots( PP_DATA_ENUM const *data );
+int  enum_descr_size( PP_DATA_ENUM const *data );
 int  serialize_enum( char *, size_t, PP_DATA_ENUM * );
+int  save_scpi_hash( FILE *fp, DataItem *head, char const *disp_name, char const *hash_name );
+int  save_derive( FILE *fp, DataItem *head );
+int  save_hist( FILE *fp, DataItem *head );
 int  save_vc_def( FILE *fp, DataItem *head );
 
 void handle_pragma( char const*, LOC const* );
@@ -212,6 +271,16 @@ StringPool    s_StrPools[spMax];
  * The enum pool ist the key to remove duplicate enuum descriptors.
  */
 StringPool    s_EnumPool;
+/**
+ * Symbols of the enum members. The offset is the index of the
+ * symbol in g_enum_sym, s_SymLen is the size of g_enum_sym.
+ */
+StringPool    s_SymPool;
+int           s_SymLen = 0;
+/**
+ * Perfect hash of the SCPI strings. The slots contain the handles.
+ */
+PHASH         s_ScpiHash;
 Stats         s_Stats;
 Config        s_Cfg;
 
@@ -219,14 +288,26 @@ Config        s_Cfg;
 static int s_nVarCnt = 0;
 static int s_nTypeCnt[TYPE_LAST] = { 0 };
 
+/* derived variables and dependency graph, see derive_build() */
+static int  s_DrvCnt = 0;
+static int  s_StaleCnt = 0;
+static int *s_DrvFirst = NULL;      /* var_cnt+1 entries */
+static int *s_DrvList = NULL;
+static int  s_DrvListLen = 0;
+
+/* histories, see save_hist() */
+static int      s_HistCnt = 0;
+static unsigned s_HistRingCnt = 0;
+static unsigned s_HistCellCnt = 0;
+
 typedef struct {
   S32 Major;
   S32 Minor;
   S32 Patch;
-  S8  *Name;
-  S8  *Shortname;
-  S8  *Copyright;
-  S8  *Date;
+  char *Name;
+  char *Shortname;
+  char *Copyright;
+  char *Date;
 } VERSION;
 
 static VERSION s_Version = {
@@ -249,6 +330,9 @@ static void print_cfg( Config *C ) {
   log_printf(LogDebug, 0, "Pragmas:");
   log_printf(LogDebug, 0, "  prefix     : %s", C->prefix );
   log_printf(LogDebug, 0, "  init_data  : %s", C->init_data ? "on" : "off" );
+  log_printf(LogDebug, 0, "  accessors  : %s", C->accessors ? "on" : "off" );
+  log_printf(LogDebug, 0, "  cpp        : %s", C->cpp ? "on" : "off" );
+  log_printf(LogDebug, 0, "  history    : %s", C->hist ? "on" : "off" );
 }
 
 /**
@@ -273,11 +357,15 @@ int main( int argc, char **argv )
   strpool_Init( &s_StrPools[spScpi], STRPOOL_DUP_FAIL );
   strpool_Init( &s_StrPools[spStrings], STRPOOL_DUP_ALLOW );
   strpool_Init( &s_EnumPool, 0 );
+  strpool_Init( &s_SymPool, STRPOOL_DUP_ALLOW );
 
   /* initializes s_Cfg */
   handle_pragma( "#pragma section var", 0 );
   handle_pragma( "#pragma prefix VAR_", 0 );
   handle_pragma( "#pragma init_data off", 0 );
+  handle_pragma( "#pragma accessors off", 0 );
+  handle_pragma( "#pragma cpp off", 0 );
+  handle_pragma( "#pragma history off", 0 );
 
   puts_version();
   print_cfg( &s_Cfg );
@@ -302,9 +390,18 @@ int main( int argc, char **argv )
   log_printf( LogInfo, 0, "Output path: %s", get_path( path, fname ));
 
   res = read_csv_file( &s_Data, fname );
+  if( res == 0 ) {
+    res = derive_build( s_Data );
+  }
   if( res == 0 ) {
     save_inc_file( s_Data, join_path( oname, path, "vardefs.h"));
     save_var_file( s_Data, join_path( oname, path, "vardef.inc"));
+    if( s_Cfg.accessors ) {
+      save_acc_file( s_Data, join_path( oname, path, "varacc.h"));
+    }
+    if( s_Cfg.cpp ) {
+      save_cpp_file( s_Data, join_path( oname, path, "vardefs.hpp"));
+    }
   }
 
   free( oname );
@@ -496,8 +593,10 @@ int read_csv_file( DataItem **head, char * szFilename)
 
       case TYPE_FLOAT:
       case TYPE_DOUBLE:
+      case TYPE_INT8:
       case TYPE_INT16:
       case TYPE_INT32:
+      case TYPE_INT64:
         parse_number( item, uCols, &cols );
         break;
 
@@ -506,6 +605,16 @@ int read_csv_file( DataItem **head, char * szFilename)
         break;
     }
 
+    /* the number and enum variables get the current history */
+    if( s_Cfg.hist && (( item->type & TYPE_MASK ) <= TYPE_ENUM )) {
+      if( item->type & TYPE_DERIVED ) {
+        log_printf( LogWarn, loc_cur(), "%s: derived variables have no history.", item->hnd );
+      }
+      else {
+        item->hist = s_Cfg.hist;
+      }
+    }
+
     LL_APPEND( *head, item );
   }
 
@@ -693,8 +802,10 @@ int save_var_file( DataItem *head, char *szFilename )
              descr_idx, data_idx );
     i++;
     switch( type ) {
+      case TYPE_INT8:
       case TYPE_INT16:
       case TYPE_INT32:
+      case TYPE_INT64:
       case TYPE_FLOAT:
       case TYPE_DOUBLE:
         data_cnt[type] += item->vec_items;
@@ -715,11 +826,16 @@ int save_var_file( DataItem *head, char *szFilename )
 
       case TYPE_ENUM:
         if( incr_descr ) {
-          descr_cnt[type] += 3* item->data.data_enum.cnt +2;
+          descr_cnt[type] += enum_descr_size( &item->data.data_enum );
         }
         data_cnt[type] += item->vec_items;
         break;
 
+      case TYPE_ACTION:
+        /* slot in g_var_action */
+        data_cnt[type]++;
+        break;
+
       default:
         UNHANDLED_CASE( type );
     }
@@ -727,24 +843,55 @@ int save_var_file( DataItem *head, char *szFilename )
 
   fputs( "\n};\n\n", fp );
 
-  save_data_int( fp, head, "g_descr_int16", TYPE_INT16, 1 );
-  save_data_int( fp, head, "g_data_int16", TYPE_INT16, 0 );
-
-  save_data_int( fp, head, "g_descr_int32", TYPE_INT32, 1 );
-  save_data_int( fp, head, "g_data_int32", TYPE_INT32, 0 );
-
-  save_data_int( fp, head, "g_descr_float", TYPE_FLOAT, 1 );
-  save_data_int( fp, head, "g_data_float", TYPE_FLOAT, 0 );
-
-  save_data_int( fp, head, "g_descr_double", TYPE_DOUBLE, 1 );
-  save_data_int( fp, head, "g_data_double", TYPE_DOUBLE, 0 );
-
-  save_data_string( fp, head, "g_data_string", TYPE_STRING );
+  save_data_int( fp, head, "g_descr_int16", TYPE_INT16, kDataDescr );
+  save_data_int( fp, head, "g_data_int16", TYPE_INT16, kDataValue );
+  save_data_int( fp, head, "g_lim_int16", TYPE_INT16, kDataLimit );
+  save_data_int( fp, head, "g_dflt_int16", TYPE_INT16, kDataDflt );
+  save_data_int( fp, head, "g_dflt_lim_int16", TYPE_INT16, kDataDfltLimit );
+
+  save_data_int( fp, head, "g_descr_int32", TYPE_INT32, kDataDescr );
+  save_data_int( fp, head, "g_data_int32", TYPE_INT32, kDataValue );
+  save_data_int( fp, head, "g_lim_int32", TYPE_INT32, kDataLimit );
+  save_data_int( fp, head, "g_dflt_int32", TYPE_INT32, kDataDflt );
+  save_data_int( fp, head, "g_dflt_lim_int32", TYPE_INT32, kDataDfltLimit );
+
+  save_data_int( fp, head, "g_descr_float", TYPE_FLOAT, kDataDescr );
+  save_data_int( fp, head, "g_data_float", TYPE_FLOAT, kDataValue );
+  save_data_int( fp, head, "g_lim_float", TYPE_FLOAT, kDataLimit );
+  save_data_int( fp, head, "g_dflt_float", TYPE_FLOAT, kDataDflt );
+  save_data_int( fp, head, "g_dflt_lim_float", TYPE_FLOAT, kDataDfltLimit );
+
+  save_data_int( fp, head, "g_descr_double", TYPE_DOUBLE, kDataDescr );
+  save_data_int( fp, head, "g_data_double", TYPE_DOUBLE, kDataValue );
+  save_data_int( fp, head, "g_lim_double", TYPE_DOUBLE, kDataLimit );
+  save_data_int( fp, head, "g_dflt_double", TYPE_DOUBLE, kDataDflt );
+  save_data_int( fp, head, "g_dflt_lim_double", TYPE_DOUBLE, kDataDfltLimit );
+
+  save_data_int( fp, head, "g_descr_int8", TYPE_INT8, kDataDescr );
+  save_data_int( fp, head, "g_data_int8", TYPE_INT8, kDataValue );
+  save_data_int( fp, head, "g_lim_int8", TYPE_INT8, kDataLimit );
+  save_data_int( fp, head, "g_dflt_int8", TYPE_INT8, kDataDflt );
+  save_data_int( fp, head, "g_dflt_lim_int8", TYPE_INT8, kDataDfltLimit );
+
+  save_data_int( fp, head, "g_descr_int64", TYPE_INT64, kDataDescr );
+  save_data_int( fp, head, "g_data_int64", TYPE_INT64, kDataValue );
+  save_data_int( fp, head, "g_lim_int64", TYPE_INT64, kDataLimit );
+  save_data_int( fp, head, "g_dflt_int64", TYPE_INT64, kDataDflt );
+  save_data_int( fp, head, "g_dflt_lim_int64", TYPE_INT64, kDataDfltLimit );
+
+  save_data_string( fp, head, "g_data_string", TYPE_STRING, kDataValue );
+  save_data_string( fp, head, "g_dflt_string", TYPE_STRING, kDataDflt );
   save_data_const_string( fp, head, "g_data_const_string", TYPE_STRING );
 
-  save_data_enum( fp, head, "g_data_enum", TYPE_ENUM );
+  save_data_enum( fp, head, "g_data_enum", TYPE_ENUM, kDataValue );
+  save_data_enum( fp, head, "g_dflt_enum", TYPE_ENUM, kDataDflt );
   save_data_enum_mbr( fp, head, "g_enum_mbr", TYPE_ENUM );
+  save_data_enum_sym( fp, "g_enum_sym" );
 
+  save_scpi_hash( fp, head, "g_scpi_disp", "g_scpi_hash" );
+
+  save_derive( fp, head );
+  save_hist( fp, head );
   save_vc_def( fp, head );
 
 
@@ -754,63 +901,451 @@ int save_var_file( DataItem *head, char *szFilename )
   return nRet;
 }
 
+/* types with accessors, see save_acc_file() */
+typedef struct {
+  int         type;
+  char const *ctype;    /* value */
+  char const *ltype;    /* limits, NULL without limits */
+  char const *name;     /* suffix of g_data_* and g_lim_* */
+  char const *sfx;      /* suffix of the accessors and member of VC_VALUE */
+  char const *as;       /* vc_as_*() */
+} AccType;
+
+static AccType const s_AccTypes[] = {
+  { TYPE_INT8,   "S8",  "LIM_S8",  "int8",   "s8",   "vc_as_int8"   },
+  { TYPE_INT16,  "S16", "LIM_S16", "int16",  "s16",  "vc_as_int16"  },
+  { TYPE_INT32,  "S32", "LIM_S32", "int32",  "s32",  "vc_as_int32"  },
+  { TYPE_INT64,  "S64", "LIM_S64", "int64",  "s64",  "vc_as_int64"  },
+  { TYPE_FLOAT,  "F32", "LIM_F32", "float",  "f32",  "vc_as_float"  },
+  { TYPE_DOUBLE, "F64", "LIM_F64", "double", "f64",  "vc_as_double" },
+  { TYPE_ENUM,   "S16", NULL,      "enum",   "enum", "vc_as_int16"  },
+};
+
+static AccType const *acc_type( int type ) {
+  for( size_t i = 0; i < countof( s_AccTypes ); i++ ) {
+    if( s_AccTypes[i].type == type ) {
+      return &s_AccTypes[i];
+    }
+  }
+  return NULL;
+}
+
+/*** save_acc_kernel ********************************************************/
+/**
+ *   Write the getter and setter of a data type, the accessors of
+ *   the variables call them with constant arguments. With VC_THREAD_SAFE
+ *   they go through vc_as_*() as REQ_PRG_R and REQ_PRG_W, save_acc_file()
+ *   only writes the accessors these rights allow.
+ */
+static void save_acc_kernel( FILE *fp, AccType const *t ) {
+  char const *member = ( TYPE_ENUM == t->type ) ? "s16" : t->sfx;
+
+  fprintf( fp,
+    "extern %s g_data_%s[];\n", t->ctype, t->name );
+  if( t->ltype ) {
+    fprintf( fp,
+    "extern %s g_lim_%s[];\n", t->ltype, t->name );
+  }
+
+  fprintf( fp,
+    "\n"
+    "static inline %s vc_acc_get_%s( HND hnd, U16 idx, U16 cnt, U16 chan, U16 acc ) {\n"
+    "#ifdef VC_THREAD_SAFE\n"
+    "\t%s val = 0;\n"
+    "\t(void) idx;\n"
+    "\t(void) cnt;\n"
+    "\t(void) acc;\n"
+    "\t(void) %s( hnd, VarRead, &val, chan, REQ_PRG_R );\n"
+    "\treturn val;\n"
+    "#else\n"
+    "\t(void) hnd;\n"
+    "\t(void) cnt;\n"
+    "\t(void) acc;\n"
+    "\tassert( chan < cnt );\n"
+    "\treturn g_data_%s[idx + chan];\n"
+    "#endif\n"
+    "}\n\n",
+    t->ctype, t->sfx, t->ctype, t->as, t->name );
+
+  fprintf( fp,
+    "static inline ErrCode vc_acc_set_%s( HND hnd, U16 idx, U16 cnt, U16 chan, U16 acc, %s val ) {\n"
+    "#ifdef VC_THREAD_SAFE\n"
+    "\t(void) idx;\n"
+    "\t(void) cnt;\n"
+    "\t(void) acc;\n"
+    "\treturn %s( hnd, VarWrite, &val, chan, REQ_PRG_W );\n"
+    "#else\n"
+    "\t%s *data = &g_data_%s[idx + chan];\n"
+    "\tVC_VALUE v;\n",
+    t->sfx, t->ctype, t->as, t->ctype, t->name );
+
+  if( t->ltype ) {
+    fprintf( fp,
+    "\t%s const *lim = &g_lim_%s[idx + chan];\n"
+    "\n"
+    "\t(void) cnt;\n"
+    "\tassert( chan < cnt );\n"
+    "\tif(( acc & FLAG_LIMIT ) != 0u ) {\n"
+    "\t\tif( val > lim->max ) {\n"
+    "\t\t\treturn kErrUpperLimit;\n"
+    "\t\t}\n"
+    "\t\tif( val < lim->min ) {\n"
+    "\t\t\treturn kErrLowerLimit;\n"
+    "\t\t}\n"
+    "\t}\n"
+    "\telse if(( acc & FLAG_CLIP ) != 0u ) {\n"
+    "\t\tval = ( val > lim->max ) ? lim->max : (( val < lim->min ) ? lim->min : val );\n"
+    "\t}\n",
+    t->ltype, t->name );
+  }
+  else {
+    fprintf( fp,
+    "\n"
+    "\t(void) cnt;\n"
+    "\t(void) acc;\n"
+    "\tassert( chan < cnt );\n" );
+  }
+
+  fprintf( fp,
+    "\tv.%s = val;\n"
+    "\tif( *data != val ) {\n"
+    "\t\t*data = val;\n"
+    "\t\t(void) vc_notify( hnd, chan, &v, 1 );\n"
+    "\t}\n"
+    "\telse {\n"
+    "\t\t(void) vc_notify( hnd, chan, &v, 0 );\n"
+    "\t}\n"
+    "\treturn kErrNone;\n"
+    "#endif\n"
+    "}\n\n",
+    member );
+}
+
+/*** save_acc_file **********************************************************/
+/**
+ *   Write the typed accessors of the variables, #pragma accessors on.
+ *
+ *   Each variable of a number or enum type gets vc_get_<name>() and
+ *   vc_set_<name>(), <name> is the handle without the prefix. Vectors
+ *   have a channel argument. The index into g_data_*, the number of
+ *   channels, FLAG_LIMIT / FLAG_CLIP and the enum members are
+ *   constants, so an accessor compiles to an array access.
+ *   Derived variables are read with vc_as_*() and have no setter.
+ *
+ *   The accessors don't check the access rights. A getter is only
+ *   written for a variable with REQ_PRG_R, a setter for one with
+ *   REQ_PRG_W and without REQ_ADMIN, so they allow the same as a
+ *   REQ_PRG request with VC_THREAD_SAFE.
+ */
+int save_acc_file( DataItem *head, char *szFilename )
+{
+  DataItem *item;
+  int data_cnt[TYPE_LAST];
+  int used[TYPE_LAST];
+
+  memset( data_cnt, 0, sizeof(data_cnt));
+  memset( used, 0, sizeof(used));
+
+  FILE *fp = fopen( szFilename, "w+");
+  if( !fp ) {
+    log_printf( LogErr, 0, "Can't open %s.", szFilename );
+    return 0;
+  }
+  write_header( fp, 0 );
+
+  fputs( "/*\n"
+         " * Typed accessors of the variables in the default context, see vc_init().\n"
+         " *\n"
+         " * They read and write the g_data_* arrays of vardef.inc without\n"
+         " * checking the handle and the access rights, the limits are applied\n"
+         " * like FLAG_LIMIT or FLAG_CLIP of the variable. Every accepted write\n"
+         " * calls vc_notify(), which adds the value to the history and reports\n"
+         " * a change. With VC_THREAD_SAFE the accessors call vc_as_*() instead.\n"
+         " */\n\n"
+         "#pragma once\n\n"
+         "#include \"varcore.h\"\n"
+         "#include \"vardefs.h\"\n\n"
+         "#include <assert.h>\n\n", fp );
+
+  LL_FOREACH( head, item ) {
+    int type = item->type & TYPE_MASK;
+    if( acc_type( type ) && !( item->type & TYPE_CONST )) {
+      used[type] = 1;
+    }
+  }
+
+  for( size_t i = 0; i < countof( s_AccTypes ); i++ ) {
+    if( used[s_AccTypes[i].type] ) {
+      save_acc_kernel( fp, &s_AccTypes[i] );
+    }
+  }
+
+  LL_FOREACH( head, item ) {
+    int type = item->type & TYPE_MASK;
+    AccType const *t = acc_type( type );
+    int data_idx = data_cnt[type];
+    char const *name = item->hnd;
+    int vec = ( item->type & TYPE_VECTOR ) != 0;
+    int rd;
+    int wr;
+    char args[BufSize];
+
+    if( !t ) {
+      continue;
+    }
+    data_cnt[type] += item->vec_items;
+
+    if( item->type & TYPE_CONST ) {
+      continue;
+    }
+
+    if( 0 == strncmp( name, s_Cfg.prefix, s_Cfg.prefix_len )) {
+      name += s_Cfg.prefix_len;
+    }
+    rd = ( item->acc_rights & REQ_PRG_R ) != 0;
+    wr = (( item->acc_rights & REQ_PRG_W ) != 0 ) && !( item->acc_rights & REQ_ADMIN );
+    if( !rd && !wr ) {
+      continue;
+    }
+
+    snprintf( args, sizeof(args), "%s, %du, %du, %s, 0x%04xu",
+              item->hnd, data_idx, item->vec_items, vec ? "chan" : "0u",
+              (U16) item->acc_rights );
+
+    if( item->type & TYPE_DERIVED ) {
+      /* computed when read, no setter */
+      if( !rd ) {
+        continue;
+      }
+      fprintf( fp, "/* %s \"%s\" = %s */\n", item->hnd, item->scpi, item->derive->expr );
+      fprintf( fp, "static inline %s vc_get_%s( %s ) {\n"
+                   "\t%s val = 0;\n"
+                   "\t(void) %s( %s, VarRead, &val, %s, REQ_PRG_R );\n"
+                   "\treturn val;\n"
+                   "}\n\n",
+               t->ctype, name, vec ? "U16 chan" : "void", t->ctype,
+               t->as, item->hnd, vec ? "chan" : "0u" );
+      continue;
+    }
+
+    fprintf( fp, "/* %s \"%s\" */\n", item->hnd, item->scpi );
+    if( rd ) {
+      fprintf( fp, "static inline %s vc_get_%s( %s ) {\n"
+                   "\treturn vc_acc_get_%s( %s );\n"
+                   "}\n\n",
+               t->ctype, name, vec ? "U16 chan" : "void", t->sfx, args );
+    }
+    if( !wr ) {
+      continue;
+    }
+
+    fprintf( fp, "static inline ErrCode vc_set_%s( %s%s val ) {\n",
+             name, vec ? "U16 chan, " : "", t->ctype );
+
+    if( TYPE_ENUM == type ) {
+      ENUM_MBR_DESC *mbr;
+      ENUM_MBR_DESC *prev;
+
+      fputs( "\tswitch( val ) {\n", fp );
+      for( mbr = item->data.data_enum.items; mbr; mbr = mbr->next ) {
+        for( prev = item->data.data_enum.items; prev != mbr; prev = prev->next ) {
+          if( prev->value == mbr->value ) {
+            break;
+          }
+        }
+        if( prev == mbr ) {
+          fprintf( fp, "\t\tcase %d:\n", mbr->value );
+        }
+      }
+      fprintf( fp, "\t\t\treturn vc_acc_set_%s( %s, val );\n"
+                   "\t\tdefault:\n"
+                   "\t\t\treturn kErrInvalidEnum;\n"
+                   "\t}\n", t->sfx, args );
+    }
+    else {
+      fprintf( fp, "\treturn vc_acc_set_%s( %s, val );\n", t->sfx, args );
+    }
+    fputs( "}\n\n", fp );
+  }
+
+  fputs("/*** EOF *********/\n", fp );
+  fclose( fp );
+
+  return 1;
+}
+
+/*** save_cpp_file **********************************************************/
+/**
+ *   Write the variables as constexpr objects of varcore.hpp,
+ *   #pragma cpp on.
+ *
+ *   The objects are in a namespace named after the prefix, VAR_CUR
+ *   becomes var::CUR. TYPE_ACTION has no object.
+ */
+int save_cpp_file( DataItem *head, char *szFilename )
+{
+  static char const *const ctype[TYPE_LAST] = {
+    "S8", "S16", "S32", "S64", "F32", "F64", NULL, NULL, NULL
+  };
+  DataItem *item;
+  char ns[BufSize];
+  size_t len = 0;
+
+  for( char const *p = s_Cfg.prefix; *p && ( *p != '_' ) && ( len < sizeof(ns) - 1 ); p++ ) {
+    ns[len++] = (char) tolower( (unsigned char) *p );
+  }
+  ns[len] = '\0';
+  if( 0 == len ) {
+    strcpy( ns, "var" );
+  }
+
+  FILE *fp = fopen( szFilename, "w+");
+  if( !fp ) {
+    log_printf( LogErr, 0, "Can't open %s.", szFilename );
+    return 0;
+  }
+  write_header( fp, 0 );
+
+  fprintf( fp, "#pragma once\n\n"
+               "#include \"varcore.hpp\"\n"
+               "#include \"vardefs.h\"\n\n"
+               "namespace %s {\n\n", ns );
+
+  LL_FOREACH( head, item ) {
+    int type = item->type & TYPE_MASK;
+    char const *name = item->hnd;
+    char obj[BufSize];
+
+    if( 0 == strncmp( name, s_Cfg.prefix, s_Cfg.prefix_len )) {
+      name += s_Cfg.prefix_len;
+    }
+
+    switch( type ) {
+      case TYPE_INT8:
+      case TYPE_INT16:
+      case TYPE_INT32:
+      case TYPE_INT64:
+      case TYPE_FLOAT:
+      case TYPE_DOUBLE:
+        snprintf( obj, sizeof(obj), "vc::Var<%s, %d>", ctype[type], item->vec_items );
+        break;
+
+      case TYPE_ENUM:
+        snprintf( obj, sizeof(obj), "vc::Enum<%d>", item->vec_items );
+        break;
+
+      case TYPE_STRING:
+        snprintf( obj, sizeof(obj), "vc::Str<%d%s>", item->vec_items,
+                  ( item->type & TYPE_CONST ) ? ", true" : "" );
+        break;
+
+      default:
+        obj[0] = '\0';
+        break;
+    }
+
+    if( obj[0] ) {
+      fprintf( fp, "inline constexpr %s %s{ %s };\n", obj, name, item->hnd );
+    }
+  }
+
+  fprintf( fp, "\n} /* namespace %s */\n\n", ns );
+  fputs("/*** EOF *********/\n", fp );
+  fclose( fp );
+
+  return 1;
+}
+
+/*** fmt_int64 **************************************************************/
+/**
+ *   Write a 64 bit constant for the C compiler, "-5LL". The smallest
+ *   value has no literal and is written as an expression.
+ *
+ *   @param buf        buffer, at least 32 characters
+ *   @param n          value
+ */
+static void fmt_int64( char *buf, long long n ) {
+  if( n == LLONG_MIN ) {
+    strcpy( buf, "(-9223372036854775807LL - 1)" );
+  }
+  else {
+    sprintf( buf, "%lldLL", n );
+  }
+}
+
 /*** save_data_int ***************************************************/
 /**
- *   Save data or descriptor of integeral (int16,int32,float/double) variabes.
+ *   Save data or descriptor of integeral (int8,int16,int32,int64,float/double) variabes.
  *
  *   Writes the data of the variables to the file pointer.
- *   If descr_flag is set, then the content of the data items
- *   is always written to the file. When descr_flag is unset (= 0)
- *   then the #pragma init_data specifies if the data content
- *   is written to the file. This is useful to reduce flash space
- *   in embedded devices. The #pragma init_data on is useful for debugging.
+ *   A descriptor is always written to the file. The values and
+ *   limits are only written with #pragma init_data on, otherwise
+ *   the arrays are declared without initializer and vc_init() sets
+ *   them. This is useful to reduce flash space in embedded devices.
+ *   The #pragma init_data on is useful for debugging.
+ *
+ *   The values and the limits are separate arrays: reading a value
+ *   doesn't load its limits into the cache.
+ *
+ *   kDataDflt and kDataDfltLimit write constant copies of the values
+ *   and limits after vc_init(). vc_reset() copies them with one
+ *   memcpy per array.
  *
  *   @param fp         file pointer
  *   @param head       poiter to head of data items (aka variables)
  *   @param name       variable name
  *   @param type       data type of the data items
- *   @param descr_flag this flag tells if a descriptor or the data
- *                       of the variables show be written to fp
+ *   @param kind       kDataValue, kDataDescr, kDataLimit, kDataDflt
+ *                     or kDataDfltLimit
  */
 
-int  save_data_int( FILE *fp, DataItem *head, char const *name, int type, int descr_flag ) {
+int  save_data_int( FILE *fp, DataItem *head, char const *name, int type, int kind ) {
   int i = 1;
   int init_data;
   int data_cnt = 0;
   char const *ztype;
-  char const *zfmt;
-  char const *zmod = (descr_flag) ? "const" : "";
+  char const *zmod = (( kDataValue == kind ) || ( kDataLimit == kind )) ? "" : " const";
+  int is_float = 0;
   DataItem *item;
 
-  switch( type ) {
-    case TYPE_INT16:
-      ztype = "DATA_S16";
-      zfmt = "  { %d, %d, %d }";
-      break;
-
-    case TYPE_INT32:
-      ztype = "DATA_S32";
-      zfmt = "  { %d, %d, %d }";
-      break;
+  /* value, descriptor and limit type */
+  static char const *s_types[][3] = {
+    { "S16", "DATA_S16", "LIM_S16" },
+    { "S32", "DATA_S32", "LIM_S32" },
+    { "F32", "DATA_F32", "LIM_F32" },
+    { "F64", "DATA_F64", "LIM_F64" },
+    { "S8",  "DATA_S8",  "LIM_S8" },
+    { "S64", "DATA_S64", "LIM_S64" }
+  };
 
-    case TYPE_FLOAT:
-      ztype = "DATA_F32";
-      zfmt = "  { %f, %f, %f }";
-      break;
+  /* an image has the type of the values or limits */
+  if( kDataDflt == kind ) {
+    kind = kDataValue;
+    init_data = 1;
+  }
+  else if( kDataDfltLimit == kind ) {
+    kind = kDataLimit;
+    init_data = 1;
+  }
+  else {
+    init_data = ( kDataDescr == kind ) || s_Cfg.init_data;
+  }
 
-    case TYPE_DOUBLE:
-      ztype = "DATA_F64";
-      zfmt = "  { %g, %g, %g }";
-      break;
+  switch( type ) {
+    case TYPE_INT16:  ztype = s_types[0][kind]; break;
+    case TYPE_INT32:  ztype = s_types[1][kind]; break;
+    case TYPE_FLOAT:  ztype = s_types[2][kind]; is_float = 1; break;
+    case TYPE_DOUBLE: ztype = s_types[3][kind]; is_float = 1; break;
+    case TYPE_INT8:   ztype = s_types[4][kind]; break;
+    case TYPE_INT64:  ztype = s_types[5][kind]; break;
 
     default:
       log_printf( LogErr, 0, "%s:%d Type: %d not supported", __FILE__, __LINE__, type );
       return -1;
   }
 
-  init_data = descr_flag || s_Cfg.init_data;
   if( init_data ) {
-    fprintf( fp, "%s %s %s[] = {\n", ztype, zmod, name );
+    fprintf( fp, "%s%s %s[] = {\n", ztype, zmod, name );
   }
   else
   {
@@ -840,26 +1375,64 @@ int  save_data_int( FILE *fp, DataItem *head, char const *name, int type, int de
 
     fprintf(fp, "  /* %s%s */", item->hnd, spaces );
     for( int j = 0; j < item->vec_items; j++ ) {
-      S32 min, max, def_value;
       if( j > 0 ) {
         fputs( ",\n", fp );
         spaces = srepeat( ' ', 10 + s_Stats.max_var_hnd_len );
         fputs( spaces, fp );
       }
 
-      switch( type ) {
-        case TYPE_INT16:
-        case TYPE_INT32:
-          min = (S32)data_number->min;
-          max = (S32)data_number->max;
-          def_value = (S32)data_number->def_value;
-          fprintf( fp, zfmt, def_value, min, max );
-          break;
-
-        case TYPE_FLOAT:
-        case TYPE_DOUBLE:
-          fprintf( fp, zfmt, data_number->def_value, data_number->min, data_number->max );
-          break;
+      if( is_float ) {
+        char const *zfmt = ( TYPE_FLOAT == type ) ? "%f" : "%.17g";
+        switch( kind ) {
+          case kDataValue:
+            fputs( "  ", fp );
+            fprintf( fp, zfmt, data_number->def_value );
+            break;
+
+          case kDataLimit:
+            fputs( "  { ", fp );
+            fprintf( fp, zfmt, data_number->min );
+            fputs( ", ", fp );
+            fprintf( fp, zfmt, data_number->max );
+            fputs( " }", fp );
+            break;
+
+          default:
+            fputs( "  { ", fp );
+            fprintf( fp, zfmt, data_number->def_value );
+            fputs( ", ", fp );
+            fprintf( fp, zfmt, data_number->min );
+            fputs( ", ", fp );
+            fprintf( fp, zfmt, data_number->max );
+            fputs( " }", fp );
+            break;
+        }
+      }
+      else if( TYPE_INT64 == type ) {
+        char zmin[32];
+        char zmax[32];
+        char zdef[32];
+
+        fmt_int64( zmin, data_number->min_int );
+        fmt_int64( zmax, data_number->max_int );
+        fmt_int64( zdef, data_number->def_int );
+
+        switch( kind ) {
+          case kDataValue: fprintf( fp, "  %s", zdef ); break;
+          case kDataLimit: fprintf( fp, "  { %s, %s }", zmin, zmax ); break;
+          default:         fprintf( fp, "  { %s, %s, %s }", zdef, zmin, zmax ); break;
+        }
+      }
+      else {
+        S32 min = (S32)data_number->min;
+        S32 max = (S32)data_number->max;
+        S32 def_value = (S32)data_number->def_value;
+
+        switch( kind ) {
+          case kDataValue: fprintf( fp, "  %d", def_value ); break;
+          case kDataLimit: fprintf( fp, "  { %d, %d }", min, max ); break;
+          default:         fprintf( fp, "  { %d, %d, %d }", def_value, min, max ); break;
+        }
       }
     }
 
@@ -870,7 +1443,7 @@ int  save_data_int( FILE *fp, DataItem *head, char const *name, int type, int de
     if( 1 == i ) {
       // No item was declared.
       // Emit a 0 value. This prohibts a warning from the compiler.
-      fputs( "  { 0, 0, 0 }", fp );
+      fputs(( kDataValue == kind ) ? "  0" : "  { 0 }", fp );
     }
     fputs( "\n};\n\n", fp );
   }
@@ -884,7 +1457,13 @@ int  save_data_int( FILE *fp, DataItem *head, char const *name, int type, int de
   return 0;
 }
 
-int  save_data_string( FILE *fp, DataItem *head, char const *name, int type )
+/*** save_data_string ******************************************************/
+/**
+ *   Save the buffers of the strings, see save_data_int().
+ *
+ *   @param kind       kDataValue or kDataDflt (defaults image)
+ */
+int  save_data_string( FILE *fp, DataItem *head, char const *name, int type, int kind )
 {
   int i = 1;
   char const *ztype;
@@ -894,7 +1473,7 @@ int  save_data_string( FILE *fp, DataItem *head, char const *name, int type )
 
   switch( type ) {
     case TYPE_STRING:
-      ztype = "DATA_STRING";
+      ztype = ( kDataDflt == kind ) ? "DATA_STRING const" : "DATA_STRING";
       break;
 
     default:
@@ -902,7 +1481,7 @@ int  save_data_string( FILE *fp, DataItem *head, char const *name, int type )
       return -1;
   }
 
-  init_data = s_Cfg.init_data;
+  init_data = ( kDataDflt == kind ) || s_Cfg.init_data;
   if( init_data ) {
     fprintf( fp, "%s %s[] = {\n", ztype, name );
   }
@@ -956,6 +1535,10 @@ int  save_data_string( FILE *fp, DataItem *head, char const *name, int type )
   }
 
   if( init_data ) {
+    if( 1 == i ) {
+      // No item was declared, see save_data_int()
+      fputs( "  0", fp );
+    }
     fputs( "\n};\n\n", fp );
   }
   else {
@@ -1053,17 +1636,23 @@ int enum_get_def( PP_DATA_ENUM const *data ) {
   return mbr->value;
 }
 
-int  save_data_enum( FILE *fp, DataItem *head, char const *name, int type )
+/*** save_data_enum ********************************************************/
+/**
+ *   Save the values of the enums, see save_data_int().
+ *
+ *   @param kind       kDataValue or kDataDflt (defaults image)
+ */
+int  save_data_enum( FILE *fp, DataItem *head, char const *name, int type, int kind )
 {
   int i = 1;
   char const *ztype;
   DataItem *item;
-  int init_data = s_Cfg.init_data;
+  int init_data = ( kDataDflt == kind ) || s_Cfg.init_data;
   int data_cnt = 0;
 
   switch( type ) {
     case TYPE_ENUM:
-      ztype = "S16";
+      ztype = ( kDataDflt == kind ) ? "S16 const" : "S16";
       break;
 
     default:
@@ -1109,6 +1698,10 @@ int  save_data_enum( FILE *fp, DataItem *head, char const *name, int type )
   }
 
   if( init_data ) {
+    if( 1 == i ) {
+      // No item was declared, see save_data_int()
+      fputs( "  0", fp );
+    }
     fputs( "\n};\n\n", fp );
   }
   else {
@@ -1118,6 +1711,82 @@ int  save_data_enum( FILE *fp, DataItem *head, char const *name, int type )
   return 0;
 }
 
+/*** enum_set_span **********************************************************/
+/**
+ *   Compute the range of the membership set that follows an enum
+ *   descriptor, see DESCR_ENUM.
+ *
+ *   @param data   enum
+ *   @param min    smallest member value
+ *
+ *   @return number of bits in the set, 0 if the values span more
+ *           than VC_ENUM_SET_MAX.
+ */
+int enum_set_span( PP_DATA_ENUM const *data, int *min ) {
+  ENUM_MBR_DESC *mbr;
+  int max;
+
+  *min = data->items->value;
+  max = *min;
+  LL_FOREACH( data->items, mbr ) {
+    if( mbr->value < *min ) {
+      *min = mbr->value;
+    }
+    if( mbr->value > max ) {
+      max = mbr->value;
+    }
+  }
+
+  if( max - *min >= VC_ENUM_SET_MAX ) {
+    return 0;
+  }
+  return max - *min + 1;
+}
+
+/*** enum_sym_slots *********************************************************/
+/**
+ *   Number of slots of the symbol index of an enum, see DESCR_ENUM.
+ *
+ *   @param data   enum
+ *
+ *   @return power of 2 with at least twice as many slots as
+ *           symbols, 0 if no member has a symbol.
+ */
+int enum_sym_slots( PP_DATA_ENUM const *data ) {
+  ENUM_MBR_DESC *mbr;
+  int cnt = 0;
+  int slots = 1;
+
+  LL_FOREACH( data->items, mbr ) {
+    if( strlen( mbr->string ) > 0 ) {
+      cnt++;
+    }
+  }
+
+  if( cnt == 0 ) {
+    return 0;
+  }
+  while( slots < 2 * cnt ) {
+    slots *= 2;
+  }
+  return slots;
+}
+
+/*** enum_descr_size ********************************************************/
+/**
+ *   Number of S16 of an enum descriptor in g_enum_mbr.
+ *
+ *   @param data   enum
+ */
+int enum_descr_size( PP_DATA_ENUM const *data ) {
+  int min;
+  int span = enum_set_span( data, &min );
+
+  return 2 + 3 * data->cnt
+       + 2 + ( span + 15 ) / 16
+       + 1 + enum_sym_slots( data );
+}
+
 int  save_data_enum_mbr( FILE *fp, DataItem *head, char const *name, int type )
 {
   enum { kBufSize = 1024 };
@@ -1175,9 +1844,57 @@ int  save_data_enum_mbr( FILE *fp, DataItem *head, char const *name, int type )
       else {
         fprintf(fp, ",\n    " );
       }
-      fprintf(fp, "%s,%s % 4d, % 4d", mbr->hnd, spaces, mbr->value, -1 );
+      int sym = -1;
+      if( strlen( mbr->string ) > 0 ) {
+        sym = strpool_Get( &s_SymPool, mbr->string )->offset;
+      }
+      fprintf(fp, "%s,%s % 4d, % 4d", mbr->hnd, spaces, mbr->value, sym );
       mbr = mbr->next;
     }
+
+    {
+      int min;
+      int span = enum_set_span( data, &min );
+      int words = ( span + 15 ) / 16;
+      U16 *set = (U16*) calloc( (size_t) words + 1, sizeof(U16) );
+
+      LL_FOREACH( data->items, mbr ) {
+        if( span > 0 ) {
+          int bit = mbr->value - min;
+          set[bit / 16] |= (U16)( 1u << ( bit % 16 ));
+        }
+      }
+      fprintf(fp, ",\n    /* set */ %d, %d", min, span );
+      for( int k = 0; k < words; k++ ) {
+        fprintf(fp, "%s%d", ( k % 8 ) ? ", " : ",\n    ", (S16) set[k] );
+      }
+      free( set );
+    }
+
+    {
+      int slots = enum_sym_slots( data );
+      int *slot = (int*) calloc( (size_t) slots + 1, sizeof(int) );
+      int k = 0;
+
+      for( int j = 0; j < slots; j++ ) {
+        slot[j] = -1;
+      }
+      LL_FOREACH( data->items, mbr ) {
+        if( strlen( mbr->string ) > 0 ) {
+          U32 h = vc_hash_str( mbr->string, 0 ) & (U32)( slots - 1 );
+          while( slot[h] != -1 ) {
+            h = ( h + 1u ) & (U32)( slots - 1 );
+          }
+          slot[h] = k;
+        }
+        k++;
+      }
+      fprintf(fp, ",\n    /* sym */ %d", slots );
+      for( int j = 0; j < slots; j++ ) {
+        fprintf(fp, "%s%d", ( j % 8 ) ? ", " : ",\n    ", slot[j] );
+      }
+      free( slot );
+    }
     si->offset = -2;
 
     i++;
@@ -1189,9 +1906,255 @@ int  save_data_enum_mbr( FILE *fp, DataItem *head, char const *name, int type )
   return 0;
 }
 
-int save_vc_def( FILE *fp, DataItem *head )
+/*** save_data_enum_sym ****************************************************/
+/**
+ *   Write the symbols of the enum members, each one zero terminated.
+ *   ENUM_MBR.symbol is the index of the symbol.
+ *
+ *   @param fp     output file
+ *   @param name   name of the array
+ */
+int  save_data_enum_sym( FILE *fp, char const *name )
 {
-enum {
+  spool_iter iter;
+  StringItem *si;
+
+  fprintf( fp, "char const %s[] = {\n", name );
+  strpool_iter( &iter, &s_SymPool );
+  while( strpool_next2( &iter, &si )) {
+    fputs( "  ", fp );
+    for( char *p = si->buf; *p != '\0'; p++ ) {
+      fprintf( fp, "'%c', ", *p );
+    }
+    fputs( "0,\n", fp );
+  }
+  /* never empty */
+  fputs( "  0\n};\n\n", fp );
+
+  return 0;
+}
+
+/*** save_scpi_hash *********************************************************/
+/**
+ *   Save the perfect hash table of the SCPI strings.
+ *
+ *   vc_get_hnd() hashes the requested string, reads the handle from
+ *   the slot and compares the string of this handle only once.
+ *   Hidden variables (SCPI "---") are not part of the table.
+ *
+ *   @param fp         file pointer
+ *   @param head       poiter to head of data items (aka variables)
+ *   @param disp_name  name of the displacement table
+ *   @param hash_name  name of the slot table
+ */
+int save_scpi_hash( FILE *fp, DataItem *head, char const *disp_name, char const *hash_name )
+{
+  DataItem *item;
+  char const **keys;
+  U16 *hnds;
+  size_t n = 0;
+  int hnd = 0;
+  int res;
+
+  keys = (char const **) calloc( s_nVarCnt + 1, sizeof(char const *) );
+  hnds = (U16 *) calloc( s_nVarCnt + 1, sizeof(U16) );
+  if( !keys || !hnds ) {
+    free( keys );
+    free( hnds );
+    return -1;
+  }
+
+  LL_FOREACH( head, item ) {
+    if( !is_hidden_scpi( item->scpi )) {
+      keys[n] = item->scpi;
+      hnds[n] = (U16) hnd;
+      n++;
+    }
+    hnd++;
+  }
+
+  res = phash_build( &s_ScpiHash, keys, n );
+  if( res != 0 ) {
+    /* An empty table makes vc_get_hnd() fall back to a linear search. */
+    log_printf( LogWarn, 0, "No SCPI hash table generated." );
+    phash_free( &s_ScpiHash );
+    fprintf( fp, "U16 const %s[] = { 0 };\n\n", disp_name );
+    fprintf( fp, "HND const %s[] = { HNON };\n\n", hash_name );
+    free( keys );
+    free( hnds );
+    return res;
+  }
+
+  log_printf( LogDebug, 0, "SCPI hash: %zu keys, %zu slots, %zu buckets, seed 0x%08x",
+              n, s_ScpiHash.slot_cnt, s_ScpiHash.disp_cnt, s_ScpiHash.seed );
+
+  fprintf( fp, "U16 const %s[] = {", disp_name );
+  for( size_t i = 0; i < s_ScpiHash.disp_cnt; i++ ) {
+    fprintf( fp, "%s%s%u", (i > 0) ? "," : "", (i % 16) ? " " : "\n  ", s_ScpiHash.disp[i] );
+  }
+  fputs( "\n};\n\n", fp );
+
+  fprintf( fp, "HND const %s[] = {", hash_name );
+  for( size_t i = 0; i < s_ScpiHash.slot_cnt; i++ ) {
+    U16 slot = s_ScpiHash.slots[i];
+    if( slot != PHASH_EMPTY ) {
+      slot = hnds[slot];
+    }
+    fprintf( fp, "%s%s0x%04x", (i > 0) ? "," : "", (i % 8) ? " " : "\n  ", slot );
+  }
+  fputs( "\n};\n\n", fp );
+
+  free( keys );
+  free( hnds );
+
+  return 0;
+}
+
+/*** save_derive ************************************************************/
+/**
+ *   Write the derived variables, their programs and the dependency
+ *   graph, see derive_build(). Nothing is written without derived
+ *   variables, the pointers in VC_DATA are 0 then.
+ */
+int save_derive( FILE *fp, DataItem *head )
+{
+  static char const *const ops[] = {
+    "VC_DRV_END", "VC_DRV_VAR", "VC_DRV_CONST", "VC_DRV_ADD",
+    "VC_DRV_SUB", "VC_DRV_MUL", "VC_DRV_DIV", "VC_DRV_NEG"
+  };
+  DataItem *item;
+  int code = 0;
+  int konst = 0;
+  int stale = 0;
+  int var_cnt = 0;
+
+  if( 0 == s_DrvCnt ) {
+    return 0;
+  }
+
+  fputs( "VC_DERIVE const g_derive[] = {\n", fp );
+  LL_FOREACH( head, item ) {
+    var_cnt++;
+    if( item->derive ) {
+      fprintf( fp, "  { %s, %d, %d },\n", item->hnd, code, stale );
+      code += item->derive->code_len;
+      stale += item->vec_items;
+    }
+  }
+  fputs( "};\n\n", fp );
+
+  fputs( "U16 const g_derive_code[] = {\n", fp );
+  LL_FOREACH( head, item ) {
+    PP_DERIVE *drv = item->derive;
+    if( !drv ) {
+      continue;
+    }
+
+    fprintf( fp, "  /* %s = %s */\n ", item->hnd, drv->expr );
+    for( int i = 0; i < drv->code_len; i++ ) {
+      int op = drv->code[i];
+
+      fprintf( fp, " %s,", ops[op] );
+      if( VC_DRV_VAR == op ) {
+        fprintf( fp, " %s,", drv_item( head, drv->code[++i] )->hnd );
+      }
+      else if( VC_DRV_CONST == op ) {
+        fprintf( fp, " %d,", konst + drv->code[++i] );
+      }
+    }
+    fputs( "\n", fp );
+    konst += drv->konst_cnt;
+  }
+  fputs( "};\n\n", fp );
+
+  fputs( "F64 const g_derive_const[] = {\n", fp );
+  LL_FOREACH( head, item ) {
+    for( int i = 0; item->derive && ( i < item->derive->konst_cnt ); i++ ) {
+      fprintf( fp, "  %.17g,\n", item->derive->konst[i] );
+    }
+  }
+  if( 0 == konst ) {
+    fputs( "  0\n", fp );
+  }
+  fputs( "};\n\n", fp );
+
+  fputs( "U16 const g_derive_first[] = {", fp );
+  for( int i = 0; i <= var_cnt; i++ ) {
+    fprintf( fp, "%s%d,", ( i % 16 ) ? " " : "\n  ", s_DrvFirst[i] );
+  }
+  fputs( "\n};\n\n", fp );
+
+  fputs( "U16 const g_derive_list[] = {", fp );
+  for( int i = 0; i < s_DrvListLen; i++ ) {
+    fprintf( fp, "%s%d,", ( i % 16 ) ? " " : "\n  ", s_DrvList[i] );
+  }
+  if( 0 == s_DrvListLen ) {
+    fputs( "\n  0", fp );
+  }
+  fputs( "\n};\n\n", fp );
+
+  fprintf( fp, "VC_SEQ g_var_stale[%d];\n\n", s_StaleCnt );
+
+  return 0;
+}
+
+/**
+ *   Write the histories, see #pragma history: g_hist, g_hist_tier
+ *   and the rings and cells. Each tier has one ring of cells per
+ *   channel, the cells of the channels follow each other.
+ */
+int save_hist( FILE *fp, DataItem *head )
+{
+  DataItem *item;
+  int tier = 0;
+
+  s_HistCnt = 0;
+  s_HistRingCnt = 0;
+  s_HistCellCnt = 0;
+  LL_FOREACH( head, item ) {
+    if( item->hist ) {
+      s_HistCnt++;
+    }
+  }
+  if( 0 == s_HistCnt ) {
+    return 0;
+  }
+
+  fputs( "VC_HIST const g_hist[] = {\n", fp );
+  LL_FOREACH( head, item ) {
+    if( item->hist ) {
+      fprintf( fp, "  { %s, %d, %d },\n", item->hnd, tier, item->hist->tier_cnt );
+      tier += item->hist->tier_cnt;
+    }
+  }
+  fputs( "};\n\n", fp );
+
+  fputs( "VC_HIST_TIER const g_hist_tier[] = {\n", fp );
+  LL_FOREACH( head, item ) {
+    PP_HIST const *hist = item->hist;
+    if( !hist ) {
+      continue;
+    }
+
+    fprintf( fp, "  /* %s */\n", item->hnd );
+    for( int i = 0; i < hist->tier_cnt; i++ ) {
+      fprintf( fp, "  { %u, %u, %u, %u },\n",
+               hist->period[i], hist->cnt[i], s_HistCellCnt, s_HistRingCnt );
+      s_HistCellCnt += hist->cnt[i] * (unsigned) item->vec_items;
+      s_HistRingCnt += (unsigned) item->vec_items;
+    }
+  }
+  fputs( "};\n\n", fp );
+
+  fprintf( fp, "VC_HIST_RING g_hist_ring[%u];\n\n", s_HistRingCnt );
+  fprintf( fp, "VC_HIST_CELL g_hist_cell[%u];\n\n", s_HistCellCnt );
+
+  return 0;
+}
+
+int save_vc_def( FILE *fp, DataItem *head )
+{
+enum {
     kTypeConstString = TYPE_LAST,
     kTypeEnumMbr,
 
@@ -1199,6 +2162,7 @@ enum {
   };
 
   size_t cnt_total = 0;
+  size_t cnt_action = 0;
   size_t cnt_data[kTypeLastPP+1];
   size_t cnt_descr[kTypeLastPP+1];
   DataItem *item;
@@ -1217,6 +2181,9 @@ enum {
 
     cnt_total++;
     cnt_descr[type]++;
+    if( TYPE_ACTION == type ) {
+      cnt_action++;
+    }
 
     switch( type ) {
       case kTypeConstString:
@@ -1242,6 +2209,23 @@ enum {
   }
 
 
+  fprintf( fp, "#ifdef VC_THREAD_SAFE\n"
+               "VC_SEQ g_var_seq[%zu];\n"
+               "#endif\n\n",
+               (cnt_total > 0) ? cnt_total : 1u );
+
+  fprintf( fp, "VC_DIRTY g_var_dirty[VC_DIRTY_WORDS(%zu)];\n\n",
+               (cnt_total > 0) ? cnt_total : 1u );
+
+  fprintf( fp, "#ifdef VC_STATISTICS\n"
+               "VC_STATS_VAR g_var_stats[VC_STATS_SHARDS * %zu];\n"
+               "#endif\n\n",
+               (cnt_total > 0) ? cnt_total : 1u );
+
+  if( cnt_action > 0 ) {
+    fprintf( fp, "VC_ACTION_SLOT g_var_action[%zu];\n\n", cnt_action );
+  }
+
   fputs( "VC_DATA g_var_data = {\n", fp );
   fprintf( fp, "  g_vars,\n"
                "  %zu,\n"
@@ -1249,10 +2233,12 @@ enum {
                "  g_descr_int16,\n"
                "  %zu,\n"
                "  g_data_int16,\n"
+               "  g_lim_int16,\n"
                "  %zu,\n"
                "  g_descr_int32,\n"
                "  %zu,\n"
                "  g_data_int32,\n"
+               "  g_lim_int32,\n"
                "  %zu,\n"
                "  g_data_string,\n"
                "  %zu,\n"
@@ -1265,12 +2251,50 @@ enum {
                "  g_descr_float,\n"
                "  %zu,\n"
                "  g_data_float,\n"
+               "  g_lim_float,\n"
                "  %zu,\n"
                "  g_descr_double,\n"
                "  %zu,\n"
                "  g_data_double,\n"
+               "  g_lim_double,\n"
+               "  %zu,\n"
+               "  g_descr_int8,\n"
+               "  %zu,\n"
+               "  g_data_int8,\n"
+               "  g_lim_int8,\n"
+               "  %zu,\n"
+               "  g_descr_int64,\n"
                "  %zu,\n"
-               "};\n",
+               "  g_data_int64,\n"
+               "  g_lim_int64,\n"
+               "  %zu,\n"
+               "  g_scpi_disp,\n"
+               "  %zu,\n"
+               "  g_scpi_hash,\n"
+               "  %zu,\n"
+               "  0x%08xu,\n"
+               "#ifdef VC_THREAD_SAFE\n"
+               "  g_var_seq,\n"
+               "#else\n"
+               "  0,\n"
+               "#endif\n"
+               "  g_var_dirty,\n"
+               "  g_enum_sym,\n"
+               "  %d,\n"
+               "  g_dflt_int16,\n"
+               "  g_dflt_int32,\n"
+               "  g_dflt_float,\n"
+               "  g_dflt_double,\n"
+               "  g_dflt_int8,\n"
+               "  g_dflt_int64,\n"
+               "  g_dflt_enum,\n"
+               "  g_dflt_string,\n"
+               "  g_dflt_lim_int16,\n"
+               "  g_dflt_lim_int32,\n"
+               "  g_dflt_lim_float,\n"
+               "  g_dflt_lim_double,\n"
+               "  g_dflt_lim_int8,\n"
+               "  g_dflt_lim_int64,\n",
                cnt_total,
                cnt_descr[TYPE_INT16],
                cnt_data[TYPE_INT16],
@@ -1287,8 +2311,63 @@ enum {
                cnt_data[TYPE_FLOAT],
 
                cnt_descr[TYPE_DOUBLE],
-               cnt_data[TYPE_DOUBLE]
+               cnt_data[TYPE_DOUBLE],
+
+               cnt_descr[TYPE_INT8],
+               cnt_data[TYPE_INT8],
+
+               cnt_descr[TYPE_INT64],
+               cnt_data[TYPE_INT64],
+
+               s_ScpiHash.disp_cnt,
+               s_ScpiHash.slot_cnt,
+               s_ScpiHash.seed,
+               s_SymLen +1
          );
+
+  if( s_DrvCnt > 0 ) {
+    fprintf( fp, "  g_derive,\n"
+                 "  %d,\n"
+                 "  g_derive_code,\n"
+                 "  g_derive_const,\n"
+                 "  g_derive_first,\n"
+                 "  g_derive_list,\n"
+                 "  g_var_stale,\n"
+                 "  %d,\n",
+                 s_DrvCnt, s_StaleCnt );
+  }
+  else {
+    fputs( "  0, 0, 0, 0, 0, 0, 0, 0,\n", fp );
+  }
+
+  if( cnt_action > 0 ) {
+    fprintf( fp, "  g_var_action,\n"
+                 "  %zu,\n",
+                 cnt_action );
+  }
+  else {
+    fputs( "  0, 0,\n", fp );
+  }
+
+  if( s_HistCnt > 0 ) {
+    fprintf( fp, "  g_hist,\n"
+                 "  %d,\n"
+                 "  g_hist_tier,\n"
+                 "  g_hist_ring,\n"
+                 "  %u,\n"
+                 "  g_hist_cell,\n"
+                 "  %u,\n",
+                 s_HistCnt, s_HistRingCnt, s_HistCellCnt );
+  }
+  else {
+    fputs( "  0, 0, 0, 0, 0, 0, 0,\n", fp );
+  }
+  fputs( "#ifdef VC_STATISTICS\n"
+         "  g_var_stats,\n"
+         "#else\n"
+         "  0,\n"
+         "#endif\n", fp );
+  fputs( "};\n", fp );
     return 0;
 }
 
@@ -1314,8 +2393,10 @@ static int map_search( Map_t const *map, size_t n, char const *needle )
 int  get_type( char *pType , int *pValue )
 {
   static Map_t Types[] = {
+    _MAP( TYPE_INT8 ),
     _MAP( TYPE_INT16 ),
     _MAP( TYPE_INT32 ),
+    _MAP( TYPE_INT64 ),
 
     _MAP( TYPE_FLOAT ),
     _MAP( TYPE_DOUBLE ),
@@ -1522,14 +2603,383 @@ static int parse_number( DataItem *item, size_t col_cnt, CSV_BUF *cols )
   }
 
   PP_DATA_NUMBER *d = &item->data.data_number;
+
+  /* "=<expression>": derived variable, the default is 0 */
+  char *expr = skip_space( CSV_COL(cols, colDefault));
+  if( '=' == *expr ) {
+    item->derive = (PP_DERIVE*) calloc( sizeof(PP_DERIVE), 1 );
+    item->derive->expr = strdup( expr + 1 );
+    memcpy( &item->derive->loc, loc_cur(), sizeof(LOC));
+    item->type |= TYPE_DERIVED;
+    strcpy( CSV_COL(cols, colDefault), "0" );
+  }
+
   d->def_value = strton( CSV_COL(cols, colDefault), 0 );
   d->min = strton( CSV_COL(cols, colMin), 0 );
   d->max = strton( CSV_COL(cols, colMax), 0 );
 
+  switch( item->type & TYPE_MASK ) {
+    case TYPE_INT8:
+    case TYPE_INT64:
+      /* a double holds 53 bits only */
+      d->def_int = strtoll( CSV_COL(cols, colDefault), 0, 0 );
+      d->min_int = strtoll( CSV_COL(cols, colMin), 0, 0 );
+      d->max_int = strtoll( CSV_COL(cols, colMax), 0, 0 );
+      d->def_value = (double) d->def_int;
+      d->min = (double) d->min_int;
+      d->max = (double) d->max_int;
+      break;
+
+    default:
+      break;
+  }
+
+  if(( TYPE_INT8 == ( item->type & TYPE_MASK )) &&
+     (( d->min_int < SCHAR_MIN ) || ( d->max_int > SCHAR_MAX ) ||
+      ( d->def_int < SCHAR_MIN ) || ( d->def_int > SCHAR_MAX ))) {
+    log_printf( LogErr, loc_cur(), "%s: value out of range of TYPE_INT8.", CSV_COL(cols, 0 ));
+    return -1;
+  }
+
   return 0;
 }
 
 
+/*** derived variables ******************************************************/
+/*
+ *  The expression of a derived variable is compiled into a program
+ *  for a stack machine, see VC_DRV_* in varcore.h:
+ *
+ *    expr    := term { ('+' | '-') term }
+ *    term    := unary { ('*' | '/') unary }
+ *    unary   := '-' unary | primary
+ *    primary := number | #define | handle | '(' expr ')'
+ *
+ *  A handle is read in the channel of the derived variable, a scalar
+ *  in channel 0. The inputs are vectors of the same size or scalars.
+ */
+typedef struct {
+  char       *p;          /* next character */
+  DataItem   *head;
+  DataItem   *item;       /* derived variable */
+  int         sp;         /* stack depth */
+  int         err;
+} DrvParser;
+
+static void drv_expr( DrvParser * );
+
+/*** drv_error **************************************************************/
+static void drv_error( DrvParser *P, char const *msg, char const *arg ) {
+  if( !P->err ) {
+    log_printf( LogErr, &P->item->derive->loc, "%s: %s%s", P->item->hnd, msg, arg );
+  }
+  P->err = 1;
+}
+
+/*** drv_emit ***************************************************************/
+/**
+ *   Append an operation to the program, arg is the operand of
+ *   VC_DRV_VAR and VC_DRV_CONST.
+ */
+static void drv_emit( DrvParser *P, int op, int arg ) {
+  PP_DERIVE *drv = P->item->derive;
+  int len = (( VC_DRV_VAR == op ) || ( VC_DRV_CONST == op )) ? 2 : 1;
+
+  if( drv->code_len + len > MaxDrvCode ) {
+    drv_error( P, "expression too long", "" );
+    return;
+  }
+  drv->code[drv->code_len++] = op;
+  if( len > 1 ) {
+    drv->code[drv->code_len++] = arg;
+  }
+
+  if( len > 1 ) {
+    P->sp++;
+    if( P->sp > VC_DRV_STACK ) {
+      drv_error( P, "expression too deep", "" );
+    }
+  }
+  else if(( op != VC_DRV_NEG ) && ( op != VC_DRV_END )) {
+    P->sp--;
+  }
+}
+
+/*** drv_const **************************************************************/
+static void drv_const( DrvParser *P, double val ) {
+  PP_DERIVE *drv = P->item->derive;
+
+  if( drv->konst_cnt >= MaxDrvConst ) {
+    drv_error( P, "too many constants", "" );
+    return;
+  }
+  drv->konst[drv->konst_cnt] = val;
+  drv_emit( P, VC_DRV_CONST, drv->konst_cnt++ );
+}
+
+/*** drv_input **************************************************************/
+/**
+ *   Find the variable of a handle in the expression.
+ *
+ *   @return handle, -1 when name isn't a variable.
+ */
+static int drv_input( DrvParser *P, char const *name ) {
+  DataItem *item;
+  int hnd = 0;
+
+  LL_FOREACH( P->head, item ) {
+    if( 0 == strcmp( item->hnd, name )) {
+      break;
+    }
+    hnd++;
+  }
+  if( !item ) {
+    return -1;
+  }
+
+  switch( item->type & TYPE_MASK ) {
+    case TYPE_INT8:
+    case TYPE_INT16:
+    case TYPE_INT32:
+    case TYPE_INT64:
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+    case TYPE_ENUM:
+      break;
+
+    default:
+      drv_error( P, "input is not a number: ", name );
+      return hnd;
+  }
+
+  if(( item->vec_items != 1 ) && ( item->vec_items != P->item->vec_items )) {
+    drv_error( P, "input is a vector of another size: ", name );
+  }
+  return hnd;
+}
+
+/*** drv_primary ************************************************************/
+static void drv_primary( DrvParser *P ) {
+  char name[BufSize];
+  char *endp;
+  size_t len = 0;
+
+  P->p = skip_space( P->p );
+
+  if( '(' == *P->p ) {
+    P->p++;
+    drv_expr( P );
+    P->p = skip_space( P->p );
+    if( ')' != *P->p ) {
+      drv_error( P, "missing ')'", "" );
+      return;
+    }
+    P->p++;
+  }
+  else if( isdigit( (unsigned char) *P->p ) || ( '.' == *P->p )) {
+    double val = strton( P->p, &endp );
+    if( endp == P->p ) {
+      drv_error( P, "invalid number: ", P->p );
+      return;
+    }
+    P->p = endp;
+    drv_const( P, val );
+  }
+  else if( isalpha( (unsigned char) *P->p ) || ( '_' == *P->p )) {
+    while(( isalnum( (unsigned char) *P->p ) || ( '_' == *P->p )) && ( len < sizeof(name) - 1 )) {
+      name[len++] = *P->p++;
+    }
+    name[len] = '\0';
+
+    int hnd = drv_input( P, name );
+    if( hnd >= 0 ) {
+      drv_emit( P, VC_DRV_VAR, hnd );
+      return;
+    }
+
+    DEF *def = defs_get( name );
+    if( def ) {
+      double val = strton( def->value, &endp );
+      if(( endp != def->value ) && ( '\0' == *skip_space( endp ))) {
+        drv_const( P, val );
+        return;
+      }
+    }
+    drv_error( P, "unknown variable or define: ", name );
+  }
+  else {
+    drv_error( P, "syntax error at: ", ( *P->p ) ? P->p : "end of expression" );
+  }
+}
+
+/*** drv_unary **************************************************************/
+static void drv_unary( DrvParser *P ) {
+  P->p = skip_space( P->p );
+  if( '-' == *P->p ) {
+    P->p++;
+    drv_unary( P );
+    drv_emit( P, VC_DRV_NEG, 0 );
+  }
+  else {
+    drv_primary( P );
+  }
+}
+
+/*** drv_term ***************************************************************/
+static void drv_term( DrvParser *P ) {
+  drv_unary( P );
+  for(;;) {
+    P->p = skip_space( P->p );
+    if(( '*' != *P->p ) && ( '/' != *P->p )) {
+      break;
+    }
+    int op = ( '*' == *P->p++ ) ? VC_DRV_MUL : VC_DRV_DIV;
+    drv_unary( P );
+    drv_emit( P, op, 0 );
+  }
+}
+
+/*** drv_expr ***************************************************************/
+static void drv_expr( DrvParser *P ) {
+  drv_term( P );
+  for(;;) {
+    P->p = skip_space( P->p );
+    if(( '+' != *P->p ) && ( '-' != *P->p )) {
+      break;
+    }
+    int op = ( '+' == *P->p++ ) ? VC_DRV_ADD : VC_DRV_SUB;
+    drv_term( P );
+    drv_emit( P, op, 0 );
+  }
+}
+
+/*** drv_item ***************************************************************/
+static DataItem *drv_item( DataItem *head, int hnd ) {
+  DataItem *item;
+
+  LL_FOREACH( head, item ) {
+    if( 0 == hnd-- ) {
+      break;
+    }
+  }
+  return item;
+}
+
+/*** drv_visit **************************************************************/
+/**
+ *   Collect the inputs of a derived variable, including the inputs
+ *   of derived inputs, in its row of reach. Detects cycles.
+ *
+ *   @param reach   one row of var_cnt flags per derived variable
+ */
+static int drv_visit( DataItem *head, DataItem *item, unsigned char *reach, int var_cnt ) {
+  PP_DERIVE *drv = item->derive;
+  unsigned char *row = &reach[drv->idx * var_cnt];
+  int res = 0;
+
+  if( 2 == drv->state ) {
+    return 0;
+  }
+  if( 1 == drv->state ) {
+    log_printf( LogErr, &drv->loc, "%s: circular dependency.", item->hnd );
+    return -1;
+  }
+
+  drv->state = 1;
+  for( int i = 0; ( 0 == res ) && ( i < drv->code_len ); i++ ) {
+    int op = drv->code[i];
+
+    if( VC_DRV_CONST == op ) {
+      i++;
+    }
+    else if( VC_DRV_VAR == op ) {
+      int hnd = drv->code[++i];
+      DataItem *input = drv_item( head, hnd );
+
+      row[hnd] = 1;
+      if( input->derive ) {
+        res = drv_visit( head, input, reach, var_cnt );
+        for( int k = 0; k < var_cnt; k++ ) {
+          row[k] |= reach[input->derive->idx * var_cnt + k];
+        }
+      }
+    }
+  }
+  drv->state = 2;
+
+  return res;
+}
+
+/*** derive_build ***********************************************************/
+/**
+ *   Compile the expressions of the derived variables and build the
+ *   dependency graph: for each variable the derived variables that
+ *   depend on it, directly or through other derived variables.
+ *
+ *   @return 0, or -7 on an error.
+ */
+static int derive_build( DataItem *head )
+{
+  DataItem *item;
+  int var_cnt = 0;
+  int res = 0;
+
+  LL_FOREACH( head, item ) {
+    var_cnt++;
+    if( !item->derive ) {
+      continue;
+    }
+
+    DrvParser P;
+    memset( &P, 0, sizeof(P));
+    P.p = item->derive->expr;
+    P.head = head;
+    P.item = item;
+
+    item->derive->idx = s_DrvCnt++;
+    s_StaleCnt += item->vec_items;
+
+    if(( item->type & MSK_STORAGE ) != RAM_VOLATILE ) {
+      drv_error( &P, "derived variables are RAM_VOLATILE", "" );
+    }
+    drv_expr( &P );
+    if( '\0' != *skip_space( P.p )) {
+      drv_error( &P, "syntax error at: ", P.p );
+    }
+    drv_emit( &P, VC_DRV_END, 0 );
+    if( P.err ) {
+      res = -7;
+    }
+  }
+
+  if(( 0 != res ) || ( 0 == s_DrvCnt )) {
+    return res;
+  }
+
+  unsigned char *reach = (unsigned char*) calloc( (size_t) s_DrvCnt * var_cnt, 1 );
+  LL_FOREACH( head, item ) {
+    if( item->derive && drv_visit( head, item, reach, var_cnt )) {
+      res = -7;
+      break;
+    }
+  }
+
+  s_DrvFirst = (int*) calloc( var_cnt + 1, sizeof(int));
+  s_DrvList = (int*) calloc( (size_t) s_DrvCnt * var_cnt + 1, sizeof(int));
+  for( int hnd = 0; hnd < var_cnt; hnd++ ) {
+    s_DrvFirst[hnd] = s_DrvListLen;
+    for( int d = 0; d < s_DrvCnt; d++ ) {
+      if( reach[d * var_cnt + hnd] ) {
+        s_DrvList[s_DrvListLen++] = d;
+      }
+    }
+  }
+  s_DrvFirst[var_cnt] = s_DrvListLen;
+  free( reach );
+
+  return res;
+}
+
 /** parse_enum **************************************************************/
 /**
  *  @param item
@@ -1605,6 +3055,12 @@ static int parse_enum( DataItem *item, size_t col_cnt, CSV_BUF *cols )
       if( si ) {
         si->constant = 1;
       }
+
+      si = strpool_Add( &s_SymPool, s, 0 );
+      if( si && si->offset == -1 ) {
+        si->offset = s_SymLen;
+        s_SymLen += (int) strlen( s ) +1;
+      }
     }
 
     d->cnt++;
@@ -1647,10 +3103,8 @@ int serialize_enum( char *Buf, size_t BufSize, PP_DATA_ENUM *enm ) {
     s += n;
     rest -= n;
 
-#if 0
-    // Don't append the symbol.
-    // This could even further reduce the number
-    // of enum mbr descriptors.
+    // Append the symbol, the symbol index is part
+    // of the descriptor.
     if( strlen(mbr->string) > 0 ) {
       n = snprintf( s, rest, "=%s", mbr->string );
       if( n <= 0 ) {
@@ -1660,7 +3114,6 @@ int serialize_enum( char *Buf, size_t BufSize, PP_DATA_ENUM *enm ) {
       s += n;
       rest -= n;
     }
-#endif
     n = snprintf( s, rest, ";" );
     s += n;
     rest -= n;
@@ -1708,9 +3161,71 @@ static int find_opt( char const *p, char const **opt_list, char **endp, int *idx
   return found;
 }
 
+/**
+ *   Parse the tiers of #pragma history: the cells of the samples,
+ *   followed by up to MaxHistTiers-1 downsampled tiers <period>:<cells>,
+ *   eg. "3600 1000:3600 60000:1440". The periods are in the unit of
+ *   the clock, see vc_set_clock(), and increasing.
+ *
+ *   @return NULL for "off" or an error.
+ */
+static PP_HIST *parse_hist( char const *s, LOC const *loc ) {
+  PP_HIST *hist;
+  char *endp;
+
+  if( 0 == strcmp( s, "off" )) {
+    return NULL;
+  }
+
+  hist = (PP_HIST*) calloc( 1, sizeof(PP_HIST));
+  if( !hist ) {
+    return NULL;
+  }
+
+  for( ;; ) {
+    unsigned long period = 0;
+    unsigned long cnt;
+
+    s = skip_space( (char*) s );
+    if( '\0' == *s ) {
+      break;
+    }
+
+    if( hist->tier_cnt > 0 ) {
+      period = strtoul( s, &endp, 10 );
+      if(( endp == s ) || ( *endp != ':' ) || ( 0 == period ) ||
+         ( period <= hist->period[hist->tier_cnt - 1] )) {
+        break;
+      }
+      s = endp + 1;
+    }
+
+    cnt = strtoul( s, &endp, 10 );
+    if(( endp == s ) || ( 0 == cnt ) || ( hist->tier_cnt == MaxHistTiers )) {
+      break;
+    }
+    hist->period[hist->tier_cnt] = (unsigned) period;
+    hist->cnt[hist->tier_cnt] = (unsigned) cnt;
+    hist->tier_cnt++;
+    s = endp;
+  }
+
+  if(( '\0' != *s ) || ( 0 == hist->tier_cnt )) {
+    size_t buf_size = (size_t) (PATH_MAX * 1.5);
+    char *buf = (char*)calloc( buf_size, sizeof(char));
+    loc_fmt( buf, buf_size, loc );
+    log_printf( LogErr, 0, "%s Invalid history: %s.", buf, s );
+    free( buf );
+    free( hist );
+    return NULL;
+  }
+
+  return hist;
+}
+
 void handle_pragma( char const *line, LOC const *loc ) {
-  enum { kSection, kPrefix, kInitData };
-  static char const* Pragmas[] = { "section", "prefix", "init_data", NULL };
+  enum { kSection, kPrefix, kInitData, kAccessors, kCpp, kHistory };
+  static char const* Pragmas[] = { "section", "prefix", "init_data", "accessors", "cpp", "history", NULL };
 
   char *endp = NULL;
   int idx = -1;
@@ -1742,6 +3257,18 @@ void handle_pragma( char const *line, LOC const *loc ) {
       s_Cfg.init_data = (0 == strcmp( endp, "on")) ? 1 : 0;
       break;
 
+    case kAccessors:
+      s_Cfg.accessors = (0 == strcmp( endp, "on")) ? 1 : 0;
+      break;
+
+    case kCpp:
+      s_Cfg.cpp = (0 == strcmp( endp, "on")) ? 1 : 0;
+      break;
+
+    case kHistory:
+      s_Cfg.hist = parse_hist( endp, loc );
+      break;
+
     default:
       UNHANDLED_CASE( idx );
   }